@@ -4647,6 +4647,42 @@ BEGIN
 
 END$$
 
+DROP PROCEDURE IF EXISTS `product_catalog_count`$$
+CREATE DEFINER=`@db_user@`@`localhost` PROCEDURE `product_catalog_count`()
+BEGIN
+
+  SELECT COUNT(*) FROM product
+
+    WHERE deactivated != 1 AND bar_code IS NOT NULL;
+
+END$$
+
+DROP PROCEDURE IF EXISTS `product_catalog_get`$$
+CREATE DEFINER=`@db_user@`@`localhost` PROCEDURE `product_catalog_get`(IN inStartItem INT, IN inItemsPerPage INT)
+BEGIN
+
+  PREPARE statement FROM
+
+    "SELECT bar_code, name, price FROM product
+
+      WHERE deactivated != 1 AND bar_code IS NOT NULL
+
+      ORDER BY bar_code
+
+      LIMIT ?, ?";
+
+
+
+  SET @p1 = inStartItem;
+
+  SET @p2 = inItemsPerPage;
+
+
+
+  EXECUTE statement USING @p1, @p2;
+
+END$$
+
 DROP PROCEDURE IF EXISTS `product_counting_template_get`$$
 CREATE DEFINER=`@db_user@`@`localhost` PROCEDURE `product_counting_template_get`(IN inFirst VARCHAR(50), IN inLast VARCHAR(50))
 BEGIN
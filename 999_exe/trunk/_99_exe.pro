@@ -6,7 +6,40 @@ QT += core \
     xmlpatterns \
     network \
     webkit
-HEADERS += cancel_invoice_dialog/cancel_invoice_dialog.h \
+HEADERS += http_request/request_scheduler.h \
+    reference_data/reference_data.h \
+    web_cache/web_cache.h \
+    section/page_state.h \
+    record_list/radio_button_delegate.h \
+    record_list/record_list_model.h \
+    customer_dialog/customer_cache.h \
+    scanner/scan_coalescer.h \
+    scanner/scan_queue.h \
+    scanner/scanner_reader.h \
+    validation/validation_rule_engine.h \
+    xml_transformer/validation_rule_list_xml_transformer.h \
+    xml_transformer/product_catalog_xml_transformer.h \
+    pricing/pricing_engine.h \
+    xml_transformer/invoice_totals_xml_transformer.h \
+    xml_transformer/object_property_xml_transformer.h \
+    diagnostics/allocation_tracker.h \
+    logger/logger.h \
+    diagnostics/stall_detector.h \
+    traffic_capture/traffic_recorder.h \
+    traffic_capture/traffic_log_reader.h \
+    diagnostics/trace_recorder.h \
+    diagnostics/trace_span.h \
+    diagnostics/latency_histogram.h \
+    diagnostics/latency_recorder.h \
+    diagnostics/latency_timer.h \
+    diagnostics_dialog/diagnostics_dialog.h \
+    sales_journal/product_catalog.h \
+    sales_journal/sales_journal.h \
+    sales_journal/offline_invoice.h \
+    sales_journal/journal_replayer.h \
+    document_cache/document_snapshot_cache.h \
+    document_cache/document_prefetcher.h \
+    cancel_invoice_dialog/cancel_invoice_dialog.h \
     xml_transformer/correlative_warning_xml_transformer.h \
     section/working_day_section.h \
     section/report_section.h \
@@ -80,7 +113,40 @@ HEADERS += cancel_invoice_dialog/cancel_invoice_dialog.h \
     console/console.h \
     xml_response_handler/xml_response_handler.h \
     http_request/http_request.h
-SOURCES += cancel_invoice_dialog/cancel_invoice_dialog.cpp \
+SOURCES += http_request/request_scheduler.cpp \
+    reference_data/reference_data.cpp \
+    web_cache/web_cache.cpp \
+    section/page_state.cpp \
+    record_list/radio_button_delegate.cpp \
+    record_list/record_list_model.cpp \
+    customer_dialog/customer_cache.cpp \
+    scanner/scan_coalescer.cpp \
+    scanner/scan_queue.cpp \
+    scanner/scanner_reader.cpp \
+    validation/validation_rule_engine.cpp \
+    xml_transformer/validation_rule_list_xml_transformer.cpp \
+    xml_transformer/product_catalog_xml_transformer.cpp \
+    pricing/pricing_engine.cpp \
+    xml_transformer/invoice_totals_xml_transformer.cpp \
+    xml_transformer/object_property_xml_transformer.cpp \
+    diagnostics/allocation_tracker.cpp \
+    logger/logger.cpp \
+    diagnostics/stall_detector.cpp \
+    traffic_capture/traffic_recorder.cpp \
+    traffic_capture/traffic_log_reader.cpp \
+    diagnostics/trace_recorder.cpp \
+    diagnostics/trace_span.cpp \
+    diagnostics/latency_histogram.cpp \
+    diagnostics/latency_recorder.cpp \
+    diagnostics/latency_timer.cpp \
+    diagnostics_dialog/diagnostics_dialog.cpp \
+    sales_journal/product_catalog.cpp \
+    sales_journal/sales_journal.cpp \
+    sales_journal/offline_invoice.cpp \
+    sales_journal/journal_replayer.cpp \
+    document_cache/document_snapshot_cache.cpp \
+    document_cache/document_prefetcher.cpp \
+    cancel_invoice_dialog/cancel_invoice_dialog.cpp \
     xml_transformer/correlative_warning_xml_transformer.cpp \
     section/working_day_section.cpp \
     section/report_section.cpp \
@@ -153,7 +219,8 @@ SOURCES += cancel_invoice_dialog/cancel_invoice_dialog.cpp \
     xml_response_handler/xml_response_handler.cpp \
     http_request/http_request.cpp \
     main.cpp
-FORMS += cancel_invoice_dialog/cancel_invoice_dialog.ui \
+FORMS += diagnostics_dialog/diagnostics_dialog.ui \
+    cancel_invoice_dialog/cancel_invoice_dialog.ui \
     search_deposit_dialog/search_deposit_dialog.ui \
     available_cash_dialog/available_cash_dialog.ui \
     consult_product_dialog/consult_product_dialog.ui \
@@ -167,4 +234,7 @@ FORMS += cancel_invoice_dialog/cancel_invoice_dialog.ui \
     section/section.ui \
     mainwindow.ui
 RESOURCES += resources.qrc
+win32:LIBS += -ldbghelp \
+    -lpsapi
+unix:allocation_accounting:DEFINES += ALLOCATION_ACCOUNTING
 TRANSLATIONS = qt_es.ts
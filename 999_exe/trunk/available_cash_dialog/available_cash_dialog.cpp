@@ -1,15 +1,16 @@
 #include "available_cash_dialog.h"
 
-#include <QRadioButton>
-#include <QSignalMapper>
 #include "../console/console_factory.h"
 #include "../enter_key_event_filter/enter_key_event_filter.h"
 #include "../xml_transformer/xml_transformer_factory.h"
+#include "../validation/validation_rule_engine.h"
+#include "../record_list/radio_button_delegate.h"
 
 /**
  * @class AvailableCashDialog
  * Dialog for displaying and adding available cash from the cash receipts to a
- * deposit document on the server.
+ * deposit document on the server. The receipts are shown on a model with a
+ * painted radio button, only the rows scrolled to are laid out.
  */
 
 /**
@@ -28,19 +29,26 @@ AvailableCashDialog::AvailableCashDialog(QNetworkCookieJar *jar, QUrl *url,
 
 	setConsole();
 
-	QStringList headers;
+	QStringList fields, headers;
+	fields << "" << "id" << "serial_number-number" << "received_cash"
+			<< "available_cash";
 	headers << "" << "Recibo No." << "Factura" << "Total efectivo" << "Disponible";
-	ui.availableCashReceiptTreeWidget->setColumnCount(5);
-	ui.availableCashReceiptTreeWidget->setHeaderLabels(headers);
+
+	m_Model = new RecordListModel(this);
+	m_Model->setColumns(fields, headers);
+
+	ui.availableCashReceiptTreeView->setModel(m_Model);
+	ui.availableCashReceiptTreeView->setItemDelegateForColumn(0,
+			new RadioButtonDelegate(this));
 
 	m_Request = new HttpRequest(jar, this);
 	m_Handler = new XmlResponseHandler(this);
 
 	connect(m_Handler, SIGNAL(sessionStatusChanged(bool)), this,
 			SIGNAL(sessionStatusChanged(bool)));
-	connect(ui.availableCashReceiptTreeWidget,
-			SIGNAL(itemActivated(QTreeWidgetItem*, int)), this,
-			SLOT(selectRadioButton(QTreeWidgetItem*, int)));
+	connect(ui.availableCashReceiptTreeView->selectionModel(),
+			SIGNAL(selectionChanged(const QItemSelection&, const QItemSelection&)),
+			this, SLOT(selectCashReceipt()));
 	connect(ui.okPushButton, SIGNAL(clicked()), this, SLOT(addCashDeposit()));
 }
 
@@ -53,10 +61,13 @@ AvailableCashDialog::~AvailableCashDialog()
 }
 
 /**
- * Populates the the cash list with all the cash receipts available.
+ * Populates the the cash list with all the cash receipts available and obtains
+ * the validation rules if they were not loaded yet.
  */
 void AvailableCashDialog::init()
 {
+	ValidationRuleEngine::instance()->fetch(m_Request, m_Handler, *m_ServerUrl);
+
 	QUrl url(*m_ServerUrl);
 	url.addQueryItem("cmd", "get_available_cash_receipt_list");
 	url.addQueryItem("key", m_CashRegisterKey);
@@ -71,7 +82,7 @@ void AvailableCashDialog::init()
 	if (m_Handler->handle(content, transformer, &errorMsg) ==
 			XmlResponseHandler::Success) {
 
-		populateList(transformer->content());
+		populateList(transformer);
 
 	} else {
 		m_Console->displayError(errorMsg);
@@ -81,7 +92,7 @@ void AvailableCashDialog::init()
 }
 
 /**
- * Sets the receipt id to the selected id from the tree widget.
+ * Sets the receipt id to the selected id from the list.
  */
 void AvailableCashDialog::setCashReceiptId(const QString id)
 {
@@ -89,21 +100,34 @@ void AvailableCashDialog::setCashReceiptId(const QString id)
 }
 
 /**
- * Obtains the radio button on the activated item and fires its clicked signal.
+ * Sets the receipt id of the selected row, the same one the radio button shows
+ * checked. With no row selected the id is empty.
  */
-void AvailableCashDialog::selectRadioButton(QTreeWidgetItem *item, int column)
+void AvailableCashDialog::selectCashReceipt()
 {
-	QRadioButton *button =
-			dynamic_cast<QRadioButton*>(ui.availableCashReceiptTreeWidget->
-					itemWidget(item, 0));
-	button->click();
+	QModelIndexList rows =
+			ui.availableCashReceiptTreeView->selectionModel()->selectedRows();
+
+	setCashReceiptId(!rows.isEmpty() ? m_Model->value(rows[0].row(), "id") : "");
 }
 
 /**
- * Adds cash to the deposit on the server.
+ * Adds cash to the deposit on the server. The values are checked with the
+ * validation rules first.
  */
 void AvailableCashDialog::addCashDeposit()
 {
+	QMap<QString, QString> values;
+	values.insert("cash_receipt_id", m_CashReceiptId);
+	values.insert("amount", ui.amountLineEdit->text());
+
+	QString errorMsg, elementId;
+	if (!ValidationRuleEngine::instance()->validate("cash_deposit", values,
+			&errorMsg, &elementId)) {
+		displayFailure(errorMsg, elementId);
+		return;
+	}
+
 	QUrl url(*m_ServerUrl);
 	url.addQueryItem("cmd", "add_cash_deposit");
 	url.addQueryItem("cash_receipt_id", m_CashReceiptId);
@@ -115,20 +139,13 @@ void AvailableCashDialog::addCashDeposit()
 
 	XmlTransformer *transformer = XmlTransformerFactory::instance()->create("stub");
 
-	QString errorMsg, elementId;
 	XmlResponseHandler::ResponseType response =
 			m_Handler->handle(content, transformer, &errorMsg, &elementId);
 
 	if (response == XmlResponseHandler::Success) {
 		accept();
 	} else if (response == XmlResponseHandler::Failure) {
-		m_Console->reset();
-		m_Console->displayFailure(errorMsg, elementId);
-
-		if (elementId == "amount") {
-			ui.amountLineEdit->setFocus();
-		}
-
+		displayFailure(errorMsg, elementId);
 	} else {
 		m_Console->displayError(errorMsg);
 	}
@@ -136,6 +153,19 @@ void AvailableCashDialog::addCashDeposit()
 	delete transformer;
 }
 
+/**
+ * Displays the failure message and puts the focus on the amount if it failed.
+ */
+void AvailableCashDialog::displayFailure(QString message, QString elementId)
+{
+	m_Console->reset();
+	m_Console->displayFailure(message, elementId);
+
+	if (elementId == "amount") {
+		ui.amountLineEdit->setFocus();
+	}
+}
+
 /**
  * Sets the Console object.
  */
@@ -150,35 +180,15 @@ void AvailableCashDialog::setConsole()
 }
 
 /**
- * Populates the tree widget with the cash receipt available list.
+ * Populates the list with the cash receipts available. The model takes the
+ * transformer's content.
  */
-void AvailableCashDialog::populateList(QList<QMap<QString, QString>*> list)
+void AvailableCashDialog::populateList(XmlTransformer *transformer)
 {
-	QTreeWidgetItem *item;
-	QRadioButton *button;
-
-	QSignalMapper *mapper = new QSignalMapper(this);
+	m_Model->setList(transformer->takeContent());
 
-	connect(mapper, SIGNAL(mapped(const QString)), this,
-			SLOT(setCashReceiptId(const QString)));
+	ui.availableCashReceiptTreeView->resizeColumnToContents(0);
 
-	for (int i = 0; i < list.size(); i++) {
-		item = new QTreeWidgetItem(ui.availableCashReceiptTreeWidget);
-		item->setText(1, list.at(i)->value("id"));
-		item->setText(2, list.at(i)->value("serial_number") + "-" +
-				list.at(i)->value("number"));
-		item->setText(3, list.at(i)->value("received_cash"));
-		item->setText(4, list.at(i)->value("available_cash"));
-
-		ui.availableCashReceiptTreeWidget->addTopLevelItem(item);
-
-		button = new QRadioButton(ui.availableCashReceiptTreeWidget);
-		button->setFocusPolicy(Qt::NoFocus);
-
-		connect(button, SIGNAL(clicked()), mapper, SLOT(map()));
-
-		mapper->setMapping(button, list.at(i)->value("id"));
-
-		ui.availableCashReceiptTreeWidget->setItemWidget(item, 0, button);
-	}
+	// The reset of the model clears the selection without signaling it.
+	selectCashReceipt();
 }
@@ -9,6 +9,7 @@
 #include "../console/console.h"
 #include "../http_request/http_request.h"
 #include "../xml_response_handler/xml_response_handler.h"
+#include "../record_list/record_list_model.h"
 
 class AvailableCashDialog : public QDialog
 {
@@ -22,7 +23,7 @@ public:
 
 public slots:
 	void setCashReceiptId(const QString id);
-	void selectRadioButton(QTreeWidgetItem *item, int column);
+	void selectCashReceipt();
 	void addCashDeposit();
 
 signals:
@@ -34,12 +35,14 @@ private:
 	Console *m_Console;
 	HttpRequest *m_Request;
 	XmlResponseHandler *m_Handler;
+	RecordListModel *m_Model;
 	QString m_CashRegisterKey;
 	QString m_DepositKey;
 	QString m_CashReceiptId;
 
 	void setConsole();
-	void populateList(QList<QMap<QString, QString>*> list);
+	void populateList(XmlTransformer *transformer);
+	void displayFailure(QString message, QString elementId);
 };
 
 #endif // AVAILABLE_CASH_DIALOG_H
@@ -2,6 +2,7 @@
 
 #include "../xml_transformer/xml_transformer_factory.h"
 #include "../console/console_factory.h"
+#include "../reference_data/reference_data.h"
 
 /**
  * @class CashRegisterDialog
@@ -38,36 +39,24 @@ CashRegisterDialog::~CashRegisterDialog()
 }
 
 /**
- * Populates the combo box with a list of all the shifts available.
+ * Populates the combo box with the shifts kept on the ReferenceData, it is
+ * refilled if they change while the dialog is open.
  */
 void CashRegisterDialog::init()
 {
-	QUrl url(*m_ServerUrl);
-	url.addQueryItem("cmd", "get_shift_list");
-	url.addQueryItem("type", "xml");
-
-	QString content = m_Request->get(url);
-
-	XmlTransformer *transformer = XmlTransformerFactory::instance()
-			->create("shift_list");
+	ReferenceData *data = ReferenceData::instance();
+	data->fill(ui.shiftIdComboBox, "shift_list");
 
-	QString errorMsg;
-	if (m_Handler->handle(content, transformer, &errorMsg) ==
-			XmlResponseHandler::Success) {
-		QList<QMap<QString, QString>*> list = transformer->content();
-
-		ui.shiftIdComboBox->addItem("", "");
-		QMap<QString, QString> *shift;
-		for (int i = 0; i < list.size(); i++) {
-			shift = list[i];
-			ui.shiftIdComboBox->addItem(shift->value("name"),
-					shift->value("shift_id"));
-		}
-	} else {
-		m_Console->displayError(errorMsg);
-	}
+	connect(data, SIGNAL(listChanged(QString)), this, SLOT(updateList(QString)));
+}
 
-	delete transformer;
+/**
+ * Refills the combo box if the shifts changed.
+ */
+void CashRegisterDialog::updateList(QString name)
+{
+	if (name == "shift_list")
+		ReferenceData::instance()->fill(ui.shiftIdComboBox, name);
 }
 
 /**
@@ -23,6 +23,7 @@ public:
 
 public slots:
 	void fetchKey();
+	void updateList(QString name);
 
 signals:
 	void sessionStatusChanged(bool isActive);
@@ -7,6 +7,8 @@
 
 #include "console.h"
 
+#include "../diagnostics/allocation_tracker.h"
+
 /**
  * @class Console
  * Use to display messages to the user.
@@ -25,6 +27,8 @@ void Console::setFrame(QWebFrame *frame)
  */
 void Console::displayFailure(QString msg, QString elementId)
 {
+	AllocationScope scope(AllocationTracker::Console);
+
 	QString newP = "<p id=\"failed-" + elementId + "\" class=\"failure\">"
 			+ msg + "</p>";
 
@@ -53,6 +57,8 @@ void Console::cleanFailure(QString elementId)
  */
 void Console::displayError(QString msg)
 {
+	AllocationScope scope(AllocationTracker::Console);
+
 	QWebElement elementP = m_Div.findFirst("#error");
 	// If there was a message.
 	if (!elementP.isNull())
@@ -3,6 +3,7 @@
 #include <QSignalMapper>
 #include "../console/console_factory.h"
 #include "../enter_key_event_filter/enter_key_event_filter.h"
+#include "../web_cache/web_cache.h"
 
 /**
  * @class ConsultProductDialog
@@ -93,6 +94,7 @@ void ConsultProductDialog::fetchProduct(QString value, bool isBarCode)
 		QHBoxLayout *layout = new QHBoxLayout(&dialog);
 
 		QWebView view;
+		WebCache::instance()->install(view.page());
 		view.page()->networkAccessManager()->setCookieJar(m_Jar);
 		m_Jar->setParent(0);
 		view.load(url);
@@ -0,0 +1,453 @@
+/*
+ * customer_cache.cpp
+ *
+ *  Created on: 24/10/2011
+ *      Author: pc
+ */
+
+#include "customer_cache.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QRegExp>
+#include <QMap>
+#include "../registry.h"
+#include "../xml_transformer/xml_transformer_factory.h"
+#include "../logger/logger.h"
+
+/**
+ * @class CustomerCache
+ * Keeps the name of the customers already used on the customer_cache.txt file
+ * located in the same path of the exe, so the customer dialog shows them without
+ * asking the server. Each line has the nit, the times the customer was used, the
+ * order of its last use, when it was last checked with the server and the name,
+ * separated by "|". When the limit is reached the least recently used customer
+ * is removed. The customers found are revalidated in the background with the
+ * get_customer_name command, the most frequent ones when the section starts.
+ * The changes are written to the file a moment later, all together, so a crash
+ * loses at most the last SAVE_DELAY of them. The file is replaced whole so it
+ * is never left half written.
+ */
+
+// Seconds after which a customer found is checked with the server again.
+static const uint REVALIDATE_INTERVAL = 3600;
+
+// Milliseconds the changes wait before being written to the file.
+static const int SAVE_DELAY = 2000;
+
+CustomerCache* CustomerCache::m_Instance = 0;
+
+/**
+ * Constructs the cache with the limit read from the Registry. The file is read
+ * the first time it is needed.
+ */
+CustomerCache::CustomerCache(QObject *parent) : QObject(parent)
+{
+	m_MaxCount = Registry::instance()->customerCacheSize();
+	m_LastUse = 0;
+	m_Hits = 0;
+	m_Misses = 0;
+	m_IsLoaded = false;
+
+	m_Request = 0;
+	m_Handler = new XmlResponseHandler(this);
+
+	m_SaveTimer.setSingleShot(true);
+	m_SaveTimer.setInterval(SAVE_DELAY);
+
+	connect(&m_SaveTimer, SIGNAL(timeout()), this, SLOT(save()));
+	connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(flush()));
+}
+
+/**
+ * Writes the changes still waiting.
+ */
+CustomerCache::~CustomerCache()
+{
+	flush();
+}
+
+/**
+ * Returns the only instance.
+ */
+CustomerCache* CustomerCache::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new CustomerCache(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Copies the name of the customer with the nit. Returns false if it is not on
+ * the cache. The customer is revalidated if it was not checked for a while.
+ */
+bool CustomerCache::find(QString nit, QString *name)
+{
+	if (!m_IsLoaded)
+		load();
+
+	if (!m_Customers.contains(nit)) {
+		m_Misses++;
+		return false;
+	}
+
+	CachedCustomer customer = m_Customers.value(nit);
+	*name = customer.name;
+	m_Hits++;
+
+	if (QDateTime::currentDateTime().toTime_t() - customer.validatedAt
+			> REVALIDATE_INTERVAL)
+		revalidate(nit);
+
+	return true;
+}
+
+/**
+ * Stores the customer as just used, counting one more use if it was already on
+ * the cache.
+ */
+void CustomerCache::insert(QString nit, QString name)
+{
+	if (!isCacheable(nit) || name.trimmed() == "" || m_MaxCount == 0)
+		return;
+
+	if (!m_IsLoaded)
+		load();
+
+	CachedCustomer customer = m_Customers.value(nit);
+	customer.name = name.simplified();
+	customer.uses = m_Customers.contains(nit) ? customer.uses + 1 : 1;
+	customer.lastUse = ++m_LastUse;
+	customer.validatedAt = QDateTime::currentDateTime().toTime_t();
+
+	m_Customers.insert(nit, customer);
+
+	evict();
+	scheduleSave();
+}
+
+/**
+ * Removes the customer because it does not exist on the server anymore.
+ */
+void CustomerCache::remove(QString nit)
+{
+	if (!m_IsLoaded)
+		load();
+
+	if (m_Customers.remove(nit) > 0)
+		scheduleSave();
+}
+
+/**
+ * Returns the nits of the most used customers, the most used first.
+ */
+QStringList CustomerCache::frequentNits(int count)
+{
+	if (!m_IsLoaded)
+		load();
+
+	// Ordered by uses, the most recent first on a tie.
+	QMap<qint64, QString> nits;
+	QHashIterator<QString, CachedCustomer> i(m_Customers);
+	while (i.hasNext()) {
+		i.next();
+		nits.insert(qint64(i.value().uses) * (m_LastUse + 1) + i.value().lastUse,
+				i.key());
+	}
+
+	QStringList list = nits.values();
+	QStringList result;
+	for (int j = list.size() - 1; j >= 0 && result.size() < count; j--)
+		result << list[j];
+
+	return result;
+}
+
+/**
+ * Sets the session and server to use for revalidating the customers.
+ */
+void CustomerCache::setServer(QNetworkCookieJar *jar, QUrl url)
+{
+	if (m_Request == 0) {
+		m_Request = new HttpRequest(jar, this);
+
+		connect(m_Request, SIGNAL(finished(QString)), this,
+				SLOT(revalidated(QString)), Qt::QueuedConnection);
+	}
+
+	m_ServerUrl = url;
+}
+
+/**
+ * Revalidates the most used customers in the background.
+ */
+void CustomerCache::prefetch(int count)
+{
+	QStringList nits = frequentNits(count);
+
+	Logger::log(Logger::Info, "customer_prefetch", "count",
+			QString::number(nits.size()));
+
+	for (int i = 0; i < nits.size(); i++)
+		revalidate(nits[i]);
+}
+
+/**
+ * Queues the customer for fetching its name from the server. Only one request
+ * is sent at a time.
+ */
+void CustomerCache::revalidate(QString nit)
+{
+	if (m_Request == 0 || nit == m_RevalidatingNit || m_PendingNits.contains(nit))
+		return;
+
+	m_PendingNits << nit;
+
+	if (m_RevalidatingNit == "")
+		sendRevalidation();
+}
+
+/**
+ * Sets the limit of customers kept, the least recently used are removed.
+ */
+void CustomerCache::setMaxCount(int count)
+{
+	m_MaxCount = count;
+
+	if (m_IsLoaded) {
+		evict();
+		scheduleSave();
+	}
+}
+
+/**
+ * Returns the limit of customers kept.
+ */
+int CustomerCache::maxCount()
+{
+	return m_MaxCount;
+}
+
+/**
+ * Returns the number of customers kept.
+ */
+int CustomerCache::count()
+{
+	if (!m_IsLoaded)
+		load();
+
+	return m_Customers.size();
+}
+
+/**
+ * Returns how many times a customer was found.
+ */
+int CustomerCache::hits()
+{
+	return m_Hits;
+}
+
+/**
+ * Returns how many times a customer was not found.
+ */
+int CustomerCache::misses()
+{
+	return m_Misses;
+}
+
+/**
+ * Returns false for the final consumer, it has no name of its own.
+ */
+bool CustomerCache::isCacheable(QString nit)
+{
+	return !QRegExp("[cC][\\\\/.]?[fF]\\.?").exactMatch(nit);
+}
+
+/**
+ * Updates the customer with the name from the server or removes it if it does
+ * not exist anymore. Connection errors keep it as it was.
+ */
+void CustomerCache::revalidated(QString content)
+{
+	QString nit = m_RevalidatingNit;
+
+	XmlTransformer *transformer = XmlTransformerFactory::instance()
+			->create("object_property");
+
+	QString errorMsg;
+	XmlResponseHandler::ResponseType response =
+			m_Handler->handle(content, transformer, &errorMsg);
+
+	if (response == XmlResponseHandler::Success) {
+		QString name = transformer->content()[0]->value("value").simplified();
+
+		if (m_Customers.contains(nit)) {
+			CachedCustomer &customer = m_Customers[nit];
+
+			if (customer.name != name)
+				Logger::log(Logger::Info, "customer_renamed", "nit", nit);
+
+			customer.name = name;
+			customer.validatedAt = QDateTime::currentDateTime().toTime_t();
+			scheduleSave();
+		}
+	} else if (response == XmlResponseHandler::Failure) {
+		Logger::log(Logger::Info, "customer_removed", "nit", nit, "message",
+				errorMsg);
+		remove(nit);
+	} else {
+		// The server is not there, do not insist.
+		m_PendingNits.clear();
+	}
+
+	delete transformer;
+
+	m_RevalidatingNit = "";
+	sendRevalidation();
+}
+
+/**
+ * Reads the customers from the file.
+ */
+void CustomerCache::load()
+{
+	m_IsLoaded = true;
+
+	QFile file(fileName());
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	while (!stream.atEnd()) {
+		QString line = stream.readLine().trimmed();
+
+		if (line == "" || line.startsWith("#"))
+			continue;
+
+		// The name goes last because it could have the separator.
+		QString name = line.section("|", 4);
+
+		if (name == "")
+			continue;
+
+		CachedCustomer customer;
+		customer.name = name;
+		customer.uses = line.section("|", 1, 1).toInt();
+		customer.lastUse = line.section("|", 2, 2).toLongLong();
+		customer.validatedAt = line.section("|", 3, 3).toUInt();
+
+		m_Customers.insert(line.section("|", 0, 0), customer);
+		m_LastUse = qMax(m_LastUse, customer.lastUse);
+	}
+
+	file.close();
+
+	evict();
+}
+
+/**
+ * Writes the file once the changes made meanwhile are done.
+ */
+void CustomerCache::scheduleSave()
+{
+	if (!m_SaveTimer.isActive())
+		m_SaveTimer.start();
+}
+
+/**
+ * Writes the file now if there are changes waiting.
+ */
+void CustomerCache::flush()
+{
+	if (m_SaveTimer.isActive())
+		save();
+}
+
+/**
+ * Writes all the customers to a temporary file that then replaces the cache file.
+ */
+void CustomerCache::save()
+{
+	m_SaveTimer.stop();
+
+	QFile file(fileName() + ".tmp");
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate
+			| QIODevice::Text)) {
+		Logger::log(Logger::Warning, "customer_cache_failed", "file",
+				file.fileName());
+		return;
+	}
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	QHashIterator<QString, CachedCustomer> i(m_Customers);
+	while (i.hasNext()) {
+		i.next();
+		stream << i.key() << "|" << i.value().uses << "|" << i.value().lastUse
+				<< "|" << i.value().validatedAt << "|" << i.value().name << "\n";
+	}
+
+	stream.flush();
+	file.close();
+
+	QFile::remove(fileName());
+	if (!file.rename(fileName()))
+		Logger::log(Logger::Warning, "customer_cache_failed", "file", fileName());
+}
+
+/**
+ * Removes the least recently used customers above the limit.
+ */
+void CustomerCache::evict()
+{
+	while (m_Customers.size() > m_MaxCount) {
+		QString oldest;
+		qint64 lastUse = 0;
+
+		QHashIterator<QString, CachedCustomer> i(m_Customers);
+		while (i.hasNext()) {
+			i.next();
+
+			if (oldest == "" || i.value().lastUse < lastUse) {
+				oldest = i.key();
+				lastUse = i.value().lastUse;
+			}
+		}
+
+		m_Customers.remove(oldest);
+	}
+}
+
+/**
+ * Asks the server for the name of the next customer on the queue.
+ */
+void CustomerCache::sendRevalidation()
+{
+	if (m_PendingNits.isEmpty())
+		return;
+
+	m_RevalidatingNit = m_PendingNits.takeFirst();
+
+	QUrl url(m_ServerUrl);
+	url.addQueryItem("cmd", "get_customer_name");
+	url.addQueryItem("nit", m_RevalidatingNit);
+	url.addQueryItem("type", "xml");
+
+	m_Request->defer(url);
+}
+
+/**
+ * Returns the path of the cache file.
+ */
+QString CustomerCache::fileName()
+{
+	return QApplication::applicationDirPath() + "/customer_cache.txt";
+}
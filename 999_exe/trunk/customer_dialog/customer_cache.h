@@ -0,0 +1,78 @@
+/*
+ * customer_cache.h
+ *
+ *  Created on: 24/10/2011
+ *      Author: pc
+ */
+
+#ifndef CUSTOMER_CACHE_H_
+#define CUSTOMER_CACHE_H_
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QUrl>
+#include <QNetworkCookieJar>
+#include <QTimer>
+#include "../http_request/http_request.h"
+#include "../xml_response_handler/xml_response_handler.h"
+
+struct CachedCustomer
+{
+	QString name;
+	int uses;
+	qint64 lastUse;
+	uint validatedAt;
+};
+
+class CustomerCache : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~CustomerCache();
+	bool find(QString nit, QString *name);
+	void insert(QString nit, QString name);
+	void remove(QString nit);
+	QStringList frequentNits(int count);
+	void setServer(QNetworkCookieJar *jar, QUrl url);
+	void prefetch(int count);
+	void revalidate(QString nit);
+	void setMaxCount(int count);
+	int maxCount();
+	int count();
+	int hits();
+	int misses();
+	static bool isCacheable(QString nit);
+	static CustomerCache* instance();
+
+private slots:
+	void revalidated(QString content);
+	void save();
+	void flush();
+
+private:
+	QHash<QString, CachedCustomer> m_Customers;
+	int m_MaxCount;
+	qint64 m_LastUse;
+	int m_Hits;
+	int m_Misses;
+	bool m_IsLoaded;
+	QTimer m_SaveTimer;
+
+	HttpRequest *m_Request;
+	XmlResponseHandler *m_Handler;
+	QUrl m_ServerUrl;
+	QStringList m_PendingNits;
+	QString m_RevalidatingNit;
+	static CustomerCache *m_Instance;
+
+	CustomerCache(QObject *parent = 0);
+	void load();
+	void scheduleSave();
+	void evict();
+	void sendRevalidation();
+	QString fileName();
+};
+
+#endif /* CUSTOMER_CACHE_H_ */
@@ -5,6 +5,7 @@
 #include "not_fetched_customer_state.h"
 #include "fetched_customer_state.h"
 #include "../enter_key_event_filter/enter_key_event_filter.h"
+#include "../validation/validation_rule_engine.h"
 
 /**
  * @class CustomerDialog
@@ -14,7 +15,7 @@
 /**
  * Constructs the dialog.
  * Installs the filter for the push buttons for the enter key functinality. Also it
- * sets the 3 states.
+ * sets the 3 states and obtains the validation rules if they were not loaded yet.
  */
 CustomerDialog::CustomerDialog(QNetworkCookieJar *jar, QUrl *url, QWidget *parent,
 		Qt::WindowFlags f) : QDialog(parent, f), m_ServerUrl(url)
@@ -32,6 +33,8 @@ CustomerDialog::CustomerDialog(QNetworkCookieJar *jar, QUrl *url, QWidget *paren
 	connect(m_Handler, SIGNAL(sessionStatusChanged(bool)), this,
 			SIGNAL(sessionStatusChanged(bool)));
 
+	ValidationRuleEngine::instance()->fetch(m_Request, m_Handler, *m_ServerUrl);
+
 	m_NotFetchedState = new NotFetchedCustomerState(this, this);
 	m_FetchedState = new FetchedCustomerState(this, this);
 	m_State = m_NotFetchedState;
@@ -49,7 +52,8 @@ CustomerDialog::CustomerDialog(QNetworkCookieJar *jar, QUrl *url, QWidget *paren
  */
 CustomerDialog::~CustomerDialog()
 {
-	if (result() == QDialog::Accepted) {
+	// Cached customers have no session object.
+	if (result() == QDialog::Accepted && customerKey() != "") {
 		// Remove the customer object from the session on the server.
 		QUrl url(*m_ServerUrl);
 		url.addQueryItem("cmd", "remove_session_object");
@@ -119,7 +123,8 @@ XmlResponseHandler* CustomerDialog::xmlResponseHandler()
 }
 
 /**
- * Sets the customer session key.
+ * Sets the customer session key, empty if the customer was taken from the
+ * CustomerCache.
  */
 void CustomerDialog::setCustomerKey(QString key)
 {
@@ -8,6 +8,8 @@
 #include "customer_state.h"
 
 #include "../xml_transformer/xml_transformer_factory.h"
+#include "../validation/validation_rule_engine.h"
+#include "customer_cache.h"
 
 /**
  * @class CustomerState
@@ -24,11 +26,43 @@ CustomerState::CustomerState(CustomerDialog *dialog, QObject *parent)
 }
 
 /**
- * Fetchs a customer from the server.
+ * Fetchs a customer from the CustomerCache or else from the server.
  * If it succeeds it changes to FetchedState as the actual state on the dialog. If
- * it fails it changes to NotFetchedState as the actual state on the dialog.
+ * it fails it changes to NotFetchedState as the actual state on the dialog. A nit
+ * that does not pass the validation rules is not sent. A cached customer has no
+ * session object on the server until its name is changed.
  */
 void CustomerState::fetchCustomer(QString nit)
+{
+	QMap<QString, QString> values;
+	values.insert("nit", nit);
+
+	QString errorMsg, elementId;
+	if (!ValidationRuleEngine::instance()->validate("customer", values,
+			&errorMsg, &elementId)) {
+		m_Dialog->console()->displayFailure(errorMsg, elementId);
+		m_Dialog->setState(m_Dialog->notFetchedState());
+		return;
+	}
+
+	QString name;
+	if (CustomerCache::instance()->find(nit, &name)) {
+		m_Dialog->setCustomerKey("");
+	} else if (!requestCustomer(nit, &name)) {
+		m_Dialog->setState(m_Dialog->notFetchedState());
+		return;
+	}
+
+	m_Dialog->nameLineEdit()->setText(name);
+	m_Dialog->setState(m_Dialog->fetchedState());
+	m_Dialog->console()->reset();
+}
+
+/**
+ * Fetchs the customer object from the server and keeps its session key on the
+ * dialog. Returns false and displays the failure if it could not be fetched.
+ */
+bool CustomerState::requestCustomer(QString nit, QString *name)
 {
 	QUrl url = m_Dialog->url();
 	url.addQueryItem("cmd", "get_customer");
@@ -47,16 +81,14 @@ void CustomerState::fetchCustomer(QString nit)
 		QList<QMap<QString, QString>*> list = transformer->content();
 		QMap<QString, QString> *params = list[0];
 		m_Dialog->setCustomerKey(params->value("key"));
-		m_Dialog->nameLineEdit()->setText(params->value("name"));
-		m_Dialog->setState(m_Dialog->fetchedState());
-		m_Dialog->console()->reset();
+		*name = params->value("name");
 	} else if (response == XmlResponseHandler::Failure) {
 		m_Dialog->console()->displayFailure(errorMsg, elementId);
-		m_Dialog->setState(m_Dialog->notFetchedState());
 	} else {
 		m_Dialog->console()->displayError(errorMsg);
-		m_Dialog->setState(m_Dialog->notFetchedState());
 	}
 
 	delete transformer;
+
+	return response == XmlResponseHandler::Success;
 }
@@ -24,6 +24,8 @@ public:
 
 protected:
 	CustomerDialog *m_Dialog;
+
+	bool requestCustomer(QString nit, QString *name);
 };
 
 #endif /* CUSTOMER_STATE_H_ */
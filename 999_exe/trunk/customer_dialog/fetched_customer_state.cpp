@@ -9,6 +9,7 @@
 
 #include <QUrl>
 #include "../xml_transformer/xml_transformer_factory.h"
+#include "../validation/validation_rule_engine.h"
 
 /**
  * @class FetchedCustomerState
@@ -25,10 +26,16 @@ FetchedCustomerState::FetchedCustomerState(CustomerDialog *dialog, QObject *pare
 }
 
 /**
- * Sets the customer name on the server.
+ * Sets the customer name on the server. A cached customer is fetched from the
+ * server first.
  */
 void FetchedCustomerState::setName(QString name)
 {
+	QString serverName;
+	if (m_Dialog->customerKey() == ""
+			&& !requestCustomer(m_Dialog->nitLineEdit()->text(), &serverName))
+		return;
+
 	HttpRequest *request =
 			new HttpRequest(m_Dialog->httpRequest()->cookieJar(), this);
 
@@ -45,12 +52,30 @@ void FetchedCustomerState::setName(QString name)
 }
 
 /**
- * Saves the customer data on the server.
+ * Saves the customer data on the server if the name passes the validation
+ * rules. A cached customer with the same name has nothing to save.
  */
 void FetchedCustomerState::save()
 {
 	m_Dialog->console()->reset();
 
+	QMap<QString, QString> values;
+	values.insert("name", m_Dialog->nameLineEdit()->text());
+
+	QString errorMsg, elementId;
+	if (!ValidationRuleEngine::instance()->validate("customer", values,
+			&errorMsg, &elementId)) {
+		m_Dialog->console()->displayFailure(errorMsg, elementId);
+		m_Dialog->nameLineEdit()->setFocus();
+		m_Dialog->nameLineEdit()->selectAll();
+		return;
+	}
+
+	if (m_Dialog->customerKey() == "") {
+		m_Dialog->accept();
+		return;
+	}
+
 	QUrl url = m_Dialog->url();
 	url.addQueryItem("cmd", "save_object");
 	url.addQueryItem("key", m_Dialog->customerKey());
@@ -61,7 +86,6 @@ void FetchedCustomerState::save()
 	XmlTransformer *transformer = XmlTransformerFactory::instance()
 			->create("stub");
 
-	QString errorMsg, elementId;
 	XmlResponseHandler::ResponseType response =
 			m_Dialog->xmlResponseHandler()
 			->handle(content, transformer, &errorMsg, &elementId);
@@ -0,0 +1,368 @@
+/*
+ * allocation_tracker.cpp
+ *
+ *  Created on: 19/09/2011
+ *      Author: pc
+ */
+
+#include "allocation_tracker.h"
+
+#include <new>
+#include <cstdlib>
+#include <QAtomicInt>
+#include <QTextStream>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cstdio>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+/**
+ * @class AllocationTracker
+ * Attributes the memory alive to the subsystem that allocated it. Only built
+ * with CONFIG+=allocation_accounting, which defines ALLOCATION_ACCOUNTING,
+ * because operator new is replaced and every block carries a small header with
+ * its size and subsystem. Not available on Windows where the Qt dlls would free
+ * blocks allocated by the exe with their own runtime. The subsystem is the one of the innermost
+ * AllocationScope of the thread when the block was allocated. Only what is
+ * allocated with new is counted, the data of QString, QByteArray and the Qt
+ * containers is allocated with qMalloc and only shows on the resident size.
+ * Without the mode every count is zero, only the resident sizes work.
+ */
+
+static const char *subsystemNames[AllocationTracker::SubsystemCount] = {
+	"other", "network", "xml", "details", "console", "search_product",
+	"document_cache", "plugins"
+};
+
+#ifdef ALLOCATION_ACCOUNTING
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+// Keeps the memory given to the caller aligned as malloc does.
+static const size_t HEADER_SIZE = 16;
+static const int HEADER_MAGIC = 0x39393941;
+
+struct AllocationHeader
+{
+	size_t size;
+	int subsystem;
+	int magic;
+};
+
+// Plain structures zeroed before any constructor runs, operator new is called
+// during the static initialization too. Qt has no 64 bit atomic integer, the
+// bytes are added with the compiler's atomic operations.
+static volatile qint64 liveBytesCounters[AllocationTracker::SubsystemCount];
+static QBasicAtomicInt liveCountCounters[AllocationTracker::SubsystemCount];
+static QBasicAtomicInt allocationCount;
+static QBasicAtomicInt allocatedByteCount;
+static THREAD_LOCAL int currentSubsystem;
+
+/**
+ * Adds the value to the counter atomically and returns the new value.
+ */
+static inline qint64 addBytes(volatile qint64 *counter, qint64 value)
+{
+#ifdef _MSC_VER
+	return InterlockedExchangeAdd64(reinterpret_cast<volatile LONGLONG*>(counter),
+			value) + value;
+#else
+	return __sync_add_and_fetch(counter, value);
+#endif
+}
+
+/**
+ * Reserves the memory with room for the header and counts it on the subsystem
+ * of the thread. Returns 0 if there is no memory.
+ */
+static void* allocate(size_t size)
+{
+	char *block = static_cast<char*>(malloc(HEADER_SIZE + size));
+	if (block == 0)
+		return 0;
+
+	int subsystem = currentSubsystem;
+
+	AllocationHeader *header = reinterpret_cast<AllocationHeader*>(block);
+	header->size = size;
+	header->subsystem = subsystem;
+	header->magic = HEADER_MAGIC;
+
+	addBytes(&liveBytesCounters[subsystem], qint64(size));
+	liveCountCounters[subsystem].fetchAndAddRelaxed(1);
+	allocationCount.fetchAndAddRelaxed(1);
+	allocatedByteCount.fetchAndAddRelaxed(int(size));
+
+	return block + HEADER_SIZE;
+}
+
+/**
+ * Discounts the block from its subsystem and frees it.
+ */
+static void release(void *pointer)
+{
+	if (pointer == 0)
+		return;
+
+	char *block = static_cast<char*>(pointer) - HEADER_SIZE;
+	AllocationHeader *header = reinterpret_cast<AllocationHeader*>(block);
+	Q_ASSERT(header->magic == HEADER_MAGIC);
+
+	addBytes(&liveBytesCounters[header->subsystem], -qint64(header->size));
+	liveCountCounters[header->subsystem].fetchAndAddRelaxed(-1);
+
+	free(block);
+}
+
+/**
+ * Reserves the memory of a single object.
+ */
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+	void *pointer = allocate(size);
+	if (pointer == 0)
+		throw std::bad_alloc();
+
+	return pointer;
+}
+
+/**
+ * Reserves the memory the same as a single object.
+ */
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+	return operator new(size);
+}
+
+/**
+ * Reserves the memory of a single object, returns 0 instead of throwing.
+ */
+void* operator new(size_t size, const std::nothrow_t&) throw()
+{
+	return allocate(size);
+}
+
+/**
+ * Reserves the memory of an array, returns 0 instead of throwing.
+ */
+void* operator new[](size_t size, const std::nothrow_t&) throw()
+{
+	return allocate(size);
+}
+
+/**
+ * Frees the memory of a single object.
+ */
+void operator delete(void *pointer) throw()
+{
+	release(pointer);
+}
+
+/**
+ * Frees the memory the same as a single object.
+ */
+void operator delete[](void *pointer) throw()
+{
+	release(pointer);
+}
+
+/**
+ * Frees the memory of a nothrow new, also called if its constructor throws.
+ */
+void operator delete(void *pointer, const std::nothrow_t&) throw()
+{
+	release(pointer);
+}
+
+/**
+ * Frees the memory of a nothrow new[].
+ */
+void operator delete[](void *pointer, const std::nothrow_t&) throw()
+{
+	release(pointer);
+}
+
+#endif
+
+/**
+ * Returns true if the client was built with the allocation accounting mode.
+ */
+bool AllocationTracker::isEnabled()
+{
+#ifdef ALLOCATION_ACCOUNTING
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+ * Returns the bytes allocated by the subsystem still alive.
+ */
+qint64 AllocationTracker::liveBytes(Subsystem subsystem)
+{
+#ifdef ALLOCATION_ACCOUNTING
+	return addBytes(&liveBytesCounters[subsystem], 0);
+#else
+	Q_UNUSED(subsystem);
+	return 0;
+#endif
+}
+
+/**
+ * Returns the number of blocks allocated by the subsystem still alive.
+ */
+int AllocationTracker::liveCount(Subsystem subsystem)
+{
+#ifdef ALLOCATION_ACCOUNTING
+	return liveCountCounters[subsystem].fetchAndAddRelaxed(0);
+#else
+	Q_UNUSED(subsystem);
+	return 0;
+#endif
+}
+
+/**
+ * Returns the bytes alive of all the subsystems.
+ */
+qint64 AllocationTracker::totalLiveBytes()
+{
+	qint64 total = 0;
+
+	for (int i = 0; i < SubsystemCount; i++)
+		total += liveBytes(Subsystem(i));
+
+	return total;
+}
+
+/**
+ * Returns the number of allocations made. The counter wraps around, only the
+ * difference between two readings is meaningful.
+ */
+uint AllocationTracker::allocations()
+{
+#ifdef ALLOCATION_ACCOUNTING
+	return uint(allocationCount.fetchAndAddRelaxed(0));
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Returns the number of bytes allocated. The counter wraps around, only the
+ * difference between two readings is meaningful.
+ */
+uint AllocationTracker::allocatedBytes()
+{
+#ifdef ALLOCATION_ACCOUNTING
+	return uint(allocatedByteCount.fetchAndAddRelaxed(0));
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Returns the actual resident memory of the process in kilobytes.
+ */
+qint64 AllocationTracker::residentSize()
+{
+#ifdef Q_OS_WIN
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.WorkingSetSize / 1024;
+#else
+	FILE *file = fopen("/proc/self/statm", "r");
+	if (file == 0)
+		return 0;
+
+	long size = 0, resident = 0;
+	int fields = fscanf(file, "%ld %ld", &size, &resident);
+	fclose(file);
+
+	return (fields == 2) ? qint64(resident) * sysconf(_SC_PAGESIZE) / 1024 : 0;
+#endif
+}
+
+/**
+ * Returns the peak resident memory of the process in kilobytes.
+ */
+qint64 AllocationTracker::peakResidentSize()
+{
+#ifdef Q_OS_WIN
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+#ifdef Q_OS_MAC
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+/**
+ * Returns the memory alive of every subsystem as name = value lines.
+ */
+QString AllocationTracker::report()
+{
+	QString text;
+	QTextStream stream(&text);
+
+	stream << "resident_kb = " << residentSize() << "\n";
+	stream << "peak_resident_kb = " << peakResidentSize() << "\n";
+
+	if (isEnabled()) {
+		for (int i = 0; i < SubsystemCount; i++) {
+			stream << name(Subsystem(i)) << "_live_kb = "
+					<< liveBytes(Subsystem(i)) / 1024 << "\n";
+			stream << name(Subsystem(i)) << "_live_count = "
+					<< liveCount(Subsystem(i)) << "\n";
+		}
+	}
+
+	stream.flush();
+
+	return text;
+}
+
+/**
+ * Returns the name of the subsystem for reports.
+ */
+const char* AllocationTracker::name(Subsystem subsystem)
+{
+	return subsystemNames[subsystem];
+}
+
+/**
+ * Makes the thread allocate for the subsystem. Returns the previous one. Use
+ * an AllocationScope instead.
+ */
+AllocationTracker::Subsystem AllocationTracker::enter(Subsystem subsystem)
+{
+#ifdef ALLOCATION_ACCOUNTING
+	Subsystem previous = Subsystem(currentSubsystem);
+	currentSubsystem = subsystem;
+	return previous;
+#else
+	Q_UNUSED(subsystem);
+	return Other;
+#endif
+}
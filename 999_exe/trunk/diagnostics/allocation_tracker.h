@@ -0,0 +1,56 @@
+/*
+ * allocation_tracker.h
+ *
+ *  Created on: 19/09/2011
+ *      Author: pc
+ */
+
+#ifndef ALLOCATION_TRACKER_H_
+#define ALLOCATION_TRACKER_H_
+
+#include <QString>
+
+class AllocationTracker
+{
+public:
+	enum Subsystem {Other, Network, Xml, Details, Console, SearchProduct,
+		DocumentCache, Plugins, SubsystemCount};
+	static bool isEnabled();
+	static qint64 liveBytes(Subsystem subsystem);
+	static int liveCount(Subsystem subsystem);
+	static qint64 totalLiveBytes();
+	static uint allocations();
+	static uint allocatedBytes();
+	static qint64 residentSize();
+	static qint64 peakResidentSize();
+	static QString report();
+	static const char* name(Subsystem subsystem);
+	static Subsystem enter(Subsystem subsystem);
+};
+
+#ifdef ALLOCATION_ACCOUNTING
+
+class AllocationScope
+{
+public:
+	AllocationScope(AllocationTracker::Subsystem subsystem)
+	{
+		m_Previous = AllocationTracker::enter(subsystem);
+	}
+	~AllocationScope() { AllocationTracker::enter(m_Previous); }
+
+private:
+	AllocationTracker::Subsystem m_Previous;
+};
+
+#else
+
+class AllocationScope
+{
+public:
+	AllocationScope(AllocationTracker::Subsystem) {};
+};
+
+#endif
+
+#endif /* ALLOCATION_TRACKER_H_ */
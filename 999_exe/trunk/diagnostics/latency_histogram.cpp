@@ -0,0 +1,155 @@
+/*
+ * latency_histogram.cpp
+ *
+ *  Created on: 18/07/2011
+ *      Author: pc
+ */
+
+#include "latency_histogram.h"
+
+/**
+ * @class LatencyHistogram
+ * Counts durations in microseconds on logarithmic buckets. Each power of 2 is
+ * split in 8 buckets, so the percentiles have an error below 12.5% using a
+ * fixed amount of memory no matter how many values are added.
+ */
+
+// Values below this one have a bucket each.
+static const int LINEAR_BUCKETS = 16;
+// Buckets for every power of 2 above the linear ones.
+static const int SUB_BUCKETS = 8;
+// Enough for durations up to 2^40 microseconds.
+static const int BUCKETS = LINEAR_BUCKETS + (40 - 4) * SUB_BUCKETS;
+
+/**
+ * Constructs an empty histogram.
+ */
+LatencyHistogram::LatencyHistogram() : m_Buckets(BUCKETS, 0)
+{
+	clear();
+}
+
+/**
+ * Adds a duration with the bytes received and sent.
+ */
+void LatencyHistogram::add(qint64 usecs, qint64 bytesIn, qint64 bytesOut)
+{
+	if (usecs < 0)
+		usecs = 0;
+
+	m_Buckets[bucket(usecs)]++;
+	m_Count++;
+	m_Sum += usecs;
+	m_Max = (usecs > m_Max) ? usecs : m_Max;
+	m_BytesIn += bytesIn;
+	m_BytesOut += bytesOut;
+}
+
+/**
+ * Removes all the values.
+ */
+void LatencyHistogram::clear()
+{
+	m_Buckets.fill(0);
+	m_Count = 0;
+	m_Sum = 0;
+	m_Max = 0;
+	m_BytesIn = 0;
+	m_BytesOut = 0;
+}
+
+/**
+ * Returns the number of values added.
+ */
+qint64 LatencyHistogram::count()
+{
+	return m_Count;
+}
+
+/**
+ * Returns the duration below which the percent of the values are.
+ */
+qint64 LatencyHistogram::percentile(double percent)
+{
+	if (m_Count == 0)
+		return 0;
+
+	qint64 rank = qint64(m_Count * percent / 100.0 + 0.5);
+	rank = (rank < 1) ? 1 : rank;
+
+	qint64 accumulated = 0;
+	for (int i = 0; i < BUCKETS; i++) {
+		accumulated += m_Buckets[i];
+
+		if (accumulated >= rank) {
+			qint64 value = bucketValue(i);
+			return (value > m_Max) ? m_Max : value;
+		}
+	}
+
+	return m_Max;
+}
+
+/**
+ * Returns the longest duration.
+ */
+qint64 LatencyHistogram::max()
+{
+	return m_Max;
+}
+
+/**
+ * Returns the average duration.
+ */
+qint64 LatencyHistogram::average()
+{
+	return (m_Count == 0) ? 0 : m_Sum / m_Count;
+}
+
+/**
+ * Returns the total bytes received.
+ */
+qint64 LatencyHistogram::bytesIn()
+{
+	return m_BytesIn;
+}
+
+/**
+ * Returns the total bytes sent.
+ */
+qint64 LatencyHistogram::bytesOut()
+{
+	return m_BytesOut;
+}
+
+/**
+ * Returns the index of the bucket for the duration.
+ */
+int LatencyHistogram::bucket(qint64 usecs)
+{
+	if (usecs < LINEAR_BUCKETS)
+		return int(usecs);
+
+	int exponent = 0;
+	while ((usecs >> exponent) > 1)
+		exponent++;
+
+	int sub = int((usecs >> (exponent - 3)) & (SUB_BUCKETS - 1));
+	int index = LINEAR_BUCKETS + (exponent - 4) * SUB_BUCKETS + sub;
+
+	return (index < BUCKETS) ? index : BUCKETS - 1;
+}
+
+/**
+ * Returns the highest duration the bucket holds.
+ */
+qint64 LatencyHistogram::bucketValue(int index)
+{
+	if (index < LINEAR_BUCKETS)
+		return index;
+
+	int exponent = (index - LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+	int sub = (index - LINEAR_BUCKETS) % SUB_BUCKETS;
+
+	return (qint64(SUB_BUCKETS + sub + 1) << (exponent - 3)) - 1;
+}
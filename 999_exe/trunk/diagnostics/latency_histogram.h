@@ -0,0 +1,39 @@
+/*
+ * latency_histogram.h
+ *
+ *  Created on: 18/07/2011
+ *      Author: pc
+ */
+
+#ifndef LATENCY_HISTOGRAM_H_
+#define LATENCY_HISTOGRAM_H_
+
+#include <QVector>
+
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+	virtual ~LatencyHistogram() {};
+	void add(qint64 usecs, qint64 bytesIn = 0, qint64 bytesOut = 0);
+	void clear();
+	qint64 count();
+	qint64 percentile(double percent);
+	qint64 max();
+	qint64 average();
+	qint64 bytesIn();
+	qint64 bytesOut();
+
+private:
+	QVector<qint64> m_Buckets;
+	qint64 m_Count;
+	qint64 m_Sum;
+	qint64 m_Max;
+	qint64 m_BytesIn;
+	qint64 m_BytesOut;
+
+	static int bucket(qint64 usecs);
+	static qint64 bucketValue(int index);
+};
+
+#endif /* LATENCY_HISTOGRAM_H_ */
@@ -0,0 +1,182 @@
+/*
+ * latency_recorder.cpp
+ *
+ *  Created on: 18/07/2011
+ *      Author: pc
+ */
+
+#include "latency_recorder.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QApplication>
+#include "trace_recorder.h"
+#include "stall_detector.h"
+
+/**
+ * @class LatencyRecorder
+ * Keeps a LatencyHistogram for every stage and server command, e.g. the request,
+ * the response parsing, the xslt evaluation or the page update of the
+ * get_invoice_details command. The stages after the request are recorded under
+ * the command of the last response received, which is the one being processed
+ * because everything runs on the main thread. Every sample is also added as a
+ * span to the TraceRecorder.
+ */
+
+LatencyRecorder* LatencyRecorder::m_Instance = 0;
+
+/**
+ * Constructs the recorder and starts its clock.
+ */
+LatencyRecorder::LatencyRecorder(QObject *parent) : QObject(parent)
+{
+	m_Clock.start();
+}
+
+/**
+ * Destroys the histograms.
+ */
+LatencyRecorder::~LatencyRecorder()
+{
+	qDeleteAll(m_Histograms);
+}
+
+/**
+ * Returns the only instance.
+ */
+LatencyRecorder* LatencyRecorder::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new LatencyRecorder(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Adds the duration in microseconds of the stage of the command.
+ */
+void LatencyRecorder::record(QString stage, QString command, qint64 usecs,
+		qint64 bytesIn, qint64 bytesOut)
+{
+	QString key = stage + " " + command;
+
+	LatencyHistogram *histogram = m_Histograms.value(key);
+	if (histogram == 0) {
+		histogram = new LatencyHistogram();
+		m_Histograms.insert(key, histogram);
+	}
+
+	histogram->add(usecs, bytesIn, bytesOut);
+
+	TraceRecorder::instance()->add(key, now() - usecs, usecs);
+}
+
+/**
+ * Adds the duration in microseconds of the stage of the actual command.
+ */
+void LatencyRecorder::record(QString stage, qint64 usecs)
+{
+	record(stage, m_Command, usecs);
+}
+
+/**
+ * Sets the command whose response is being processed.
+ */
+void LatencyRecorder::setCommand(QString command)
+{
+	m_Command = command;
+	StallDetector::instance()->setCommand(command);
+}
+
+/**
+ * Returns the command whose response is being processed.
+ */
+QString LatencyRecorder::command()
+{
+	return m_Command;
+}
+
+/**
+ * Returns the microseconds elapsed since the recorder was created.
+ */
+qint64 LatencyRecorder::now()
+{
+	return m_Clock.nsecsElapsed() / 1000;
+}
+
+/**
+ * Returns the stage and command keys sorted.
+ */
+QStringList LatencyRecorder::keys()
+{
+	return m_Histograms.keys();
+}
+
+/**
+ * Returns the histogram of the key or 0 if there is none.
+ */
+LatencyHistogram* LatencyRecorder::histogram(QString key)
+{
+	return m_Histograms.value(key);
+}
+
+/**
+ * Returns a text table with the percentiles in milliseconds of every key.
+ */
+QString LatencyRecorder::report()
+{
+	QString text;
+	QTextStream stream(&text);
+
+	stream << QDateTime::currentDateTime().toString("dd/MM/yyyy hh:mm:ss") << "\n";
+	stream << qSetFieldWidth(40) << left << "etapa comando" << qSetFieldWidth(10)
+			<< right << "cantidad" << "p50" << "p95" << "p99" << "max"
+			<< "recibido" << "enviado" << qSetFieldWidth(0) << "\n";
+
+	QMapIterator<QString, LatencyHistogram*> i(m_Histograms);
+	while (i.hasNext()) {
+		i.next();
+		LatencyHistogram *histogram = i.value();
+
+		stream << qSetFieldWidth(40) << left << i.key() << qSetFieldWidth(10)
+				<< right << histogram->count()
+				<< QString::number(histogram->percentile(50) / 1000.0, 'f', 1)
+				<< QString::number(histogram->percentile(95) / 1000.0, 'f', 1)
+				<< QString::number(histogram->percentile(99) / 1000.0, 'f', 1)
+				<< QString::number(histogram->max() / 1000.0, 'f', 1)
+				<< histogram->bytesIn() << histogram->bytesOut()
+				<< qSetFieldWidth(0) << "\n";
+	}
+
+	stream.flush();
+
+	return text;
+}
+
+/**
+ * Appends the report to the file.
+ */
+bool LatencyRecorder::save(QString fileName)
+{
+	QFile file(fileName);
+
+	if (!file.open(QIODevice::Append | QIODevice::Text))
+		return false;
+
+	QTextStream stream(&file);
+	stream << report() << "\n";
+
+	file.close();
+
+	return true;
+}
+
+/**
+ * Removes all the histograms.
+ */
+void LatencyRecorder::clear()
+{
+	qDeleteAll(m_Histograms);
+	m_Histograms.clear();
+}
@@ -0,0 +1,46 @@
+/*
+ * latency_recorder.h
+ *
+ *  Created on: 18/07/2011
+ *      Author: pc
+ */
+
+#ifndef LATENCY_RECORDER_H_
+#define LATENCY_RECORDER_H_
+
+#include <QObject>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+#include "latency_histogram.h"
+
+class LatencyRecorder : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~LatencyRecorder();
+	void record(QString stage, QString command, qint64 usecs, qint64 bytesIn = 0,
+			qint64 bytesOut = 0);
+	void record(QString stage, qint64 usecs);
+	void setCommand(QString command);
+	QString command();
+	qint64 now();
+	QStringList keys();
+	LatencyHistogram* histogram(QString key);
+	QString report();
+	bool save(QString fileName);
+	void clear();
+	static LatencyRecorder* instance();
+
+private:
+	QMap<QString, LatencyHistogram*> m_Histograms;
+	QString m_Command;
+	QElapsedTimer m_Clock;
+	static LatencyRecorder *m_Instance;
+
+	LatencyRecorder(QObject *parent = 0);
+};
+
+#endif /* LATENCY_RECORDER_H_ */
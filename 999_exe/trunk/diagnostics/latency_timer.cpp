@@ -0,0 +1,36 @@
+/*
+ * latency_timer.cpp
+ *
+ *  Created on: 18/07/2011
+ *      Author: pc
+ */
+
+#include "latency_timer.h"
+
+#include "latency_recorder.h"
+
+/**
+ * @class LatencyTimer
+ * Measures the time from its construction to its destruction and records it on
+ * the LatencyRecorder for the stage of the actual command. Meant to be created
+ * on the stack at the beginning of the block to measure. The time is recorded
+ * when the block is left by any way, a return included, so the block must end
+ * where the stage does.
+ */
+
+/**
+ * Starts measuring.
+ */
+LatencyTimer::LatencyTimer(QString stage) : m_Stage(stage)
+{
+	m_Start = LatencyRecorder::instance()->now();
+}
+
+/**
+ * Records the time elapsed.
+ */
+LatencyTimer::~LatencyTimer()
+{
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+	recorder->record(m_Stage, recorder->now() - m_Start);
+}
@@ -0,0 +1,24 @@
+/*
+ * latency_timer.h
+ *
+ *  Created on: 18/07/2011
+ *      Author: pc
+ */
+
+#ifndef LATENCY_TIMER_H_
+#define LATENCY_TIMER_H_
+
+#include <QString>
+
+class LatencyTimer
+{
+public:
+	LatencyTimer(QString stage);
+	virtual ~LatencyTimer();
+
+private:
+	QString m_Stage;
+	qint64 m_Start;
+};
+
+#endif /* LATENCY_TIMER_H_ */
@@ -0,0 +1,417 @@
+/*
+ * stall_detector.cpp
+ *
+ *  Created on: 29/08/2011
+ *      Author: pc
+ */
+
+#include "stall_detector.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include "latency_recorder.h"
+#include "../registry.h"
+#if defined(Q_OS_LINUX)
+#include <execinfo.h>
+#include <signal.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#elif defined(Q_OS_WIN32)
+#include <windows.h>
+#include <dbghelp.h>
+#endif
+
+/**
+ * @class StallDetector
+ * Watchdog thread that notices when the event loop of the main thread stops
+ * running. A timer on the main thread beats every third of the threshold; if
+ * the watchdog sees no beat for longer than the threshold it writes on
+ * stalls.log the trace span, server command and section being run along with
+ * the stack of the main thread, so the code that froze the screen can be
+ * found. Once the loop runs again the duration is added to the entry and the
+ * stall is recorded on the LatencyRecorder under the stage stall.
+ * The span, command and section are published by the main thread on a buffer
+ * guarded with a sequence number, so neither thread ever waits for the other.
+ * The stack is taken with a signal handler on Linux and by suspending the
+ * thread on Windows; on other systems it is left out.
+ */
+
+StallDetector* StallDetector::m_Instance = 0;
+
+// Deepest stack taken.
+static const int MAX_FRAMES = 48;
+
+static void *stackFrames[MAX_FRAMES];
+static int stackSize = 0;
+static QAtomicInt isStackReady;
+
+#if defined(Q_OS_LINUX)
+static pthread_t mainThread;
+
+/**
+ * Takes the stack of the thread receiving the signal.
+ */
+static void captureStack(int)
+{
+	int error = errno;
+	stackSize = backtrace(stackFrames, MAX_FRAMES);
+	isStackReady.fetchAndStoreRelease(1);
+	errno = error;
+}
+#elif defined(Q_OS_WIN32)
+static HANDLE mainThread = 0;
+#endif
+
+/**
+ * Constructs the detector and starts watching if the threshold is not zero.
+ * Must be created on the main thread.
+ */
+StallDetector::StallDetector(int threshold, QObject *parent) : QThread(parent),
+		m_Threshold(threshold)
+{
+	m_Interval = qMax(m_Threshold / 3, 10);
+	m_StallCount = 0;
+	m_FileName = QApplication::applicationDirPath() + "/stalls.log";
+
+	m_Context.sequence = 0;
+	m_Context.span[0] = '\0';
+	m_Context.command[0] = '\0';
+	m_Context.section[0] = '\0';
+
+	if (m_Threshold == 0)
+		return;
+
+	prepareStack();
+
+	m_Clock.start();
+	m_LastBeat = 0;
+
+	connect(&m_Timer, SIGNAL(timeout()), this, SLOT(beat()));
+	m_Timer.start(m_Interval);
+
+	start(QThread::HighPriority);
+}
+
+/**
+ * Stops the watchdog.
+ */
+StallDetector::~StallDetector()
+{
+	m_IsStopping.fetchAndStoreOrdered(1);
+	wait();
+
+#if defined(Q_OS_WIN32)
+	if (mainThread != 0)
+		CloseHandle(mainThread);
+#endif
+}
+
+/**
+ * Returns the only instance.
+ */
+StallDetector* StallDetector::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new StallDetector(Registry::instance()->stallThreshold(),
+				qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Returns false if the threshold is zero.
+ */
+bool StallDetector::isEnabled()
+{
+	return m_Threshold > 0;
+}
+
+/**
+ * Sets the span the main thread entered.
+ */
+void StallDetector::enterSpan(QString name)
+{
+	if (m_Threshold == 0 || QThread::currentThread() != thread())
+		return;
+
+	m_Spans << name;
+	publish(m_Context.span, name);
+}
+
+/**
+ * Goes back to the span the main thread was in before the last one.
+ */
+void StallDetector::leaveSpan()
+{
+	if (m_Threshold == 0 || QThread::currentThread() != thread()
+			|| m_Spans.isEmpty())
+		return;
+
+	m_Spans.removeLast();
+	publish(m_Context.span, m_Spans.isEmpty() ? "" : m_Spans.last());
+}
+
+/**
+ * Sets the server command being handled.
+ */
+void StallDetector::setCommand(QString command)
+{
+	if (m_Threshold == 0 || QThread::currentThread() != thread())
+		return;
+
+	publish(m_Context.command, command);
+}
+
+/**
+ * Sets the section on the screen.
+ */
+void StallDetector::setSection(QString section)
+{
+	if (m_Threshold == 0 || QThread::currentThread() != thread())
+		return;
+
+	publish(m_Context.section, section);
+}
+
+/**
+ * Returns the number of stalls since the start.
+ */
+int StallDetector::stallCount()
+{
+	return m_StallCount;
+}
+
+/**
+ * Waits for the beats of the main thread and writes an entry when they stop.
+ */
+void StallDetector::run()
+{
+	int stalledBeat = -1;
+
+	while (int(m_IsStopping) == 0) {
+		msleep(m_Interval);
+
+		int lastBeat = m_LastBeat.fetchAndAddAcquire(0);
+
+		if (stalledBeat == -1) {
+			if (m_Clock.elapsed() - lastBeat <= m_Threshold + m_Interval)
+				continue;
+
+			stalledBeat = lastBeat;
+
+			QString span, command, section;
+			context(&span, &command, &section);
+			QStringList frames = stack();
+
+			QString text;
+			QTextStream stream(&text);
+			stream << QDateTime::currentDateTime().toString("dd/MM/yyyy hh:mm:ss")
+					<< " stall\n";
+			stream << "threshold_ms = " << m_Threshold << "\n";
+			stream << "span = " << span << "\n";
+			stream << "command = " << command << "\n";
+			stream << "section = " << section << "\n";
+			for (int i = 0; i < frames.size(); i++)
+				stream << "frame = " << frames[i] << "\n";
+			stream.flush();
+
+			write(text);
+		} else if (lastBeat != stalledBeat) {
+			write("duration_ms = "
+					+ QString::number(lastBeat - stalledBeat - m_Interval) + "\n\n");
+			stalledBeat = -1;
+		}
+	}
+}
+
+/**
+ * Notes the main thread is running. A beat late by more than the threshold is
+ * recorded as a stall of the actual command.
+ */
+void StallDetector::beat()
+{
+	int now = int(m_Clock.elapsed());
+	int gap = now - int(m_LastBeat) - m_Interval;
+
+	m_LastBeat.fetchAndStoreRelease(now);
+
+	if (gap > m_Threshold) {
+		m_StallCount++;
+		LatencyRecorder::instance()->record("stall", qint64(gap) * 1000);
+	}
+}
+
+/**
+ * Copies the value on the field of the context.
+ */
+void StallDetector::publish(char *field, QString value)
+{
+	QByteArray text = value.toLatin1();
+
+	m_Context.sequence.fetchAndAddOrdered(1);
+	qstrncpy(field, text.constData(), STALL_CONTEXT_SIZE);
+	m_Context.sequence.fetchAndAddOrdered(1);
+}
+
+/**
+ * Reads the context, trying again if the main thread was writing it.
+ */
+void StallDetector::context(QString *span, QString *command, QString *section)
+{
+	char spanText[STALL_CONTEXT_SIZE];
+	char commandText[STALL_CONTEXT_SIZE];
+	char sectionText[STALL_CONTEXT_SIZE];
+
+	for (int i = 0; i < 100; i++) {
+		int sequence = m_Context.sequence.fetchAndAddAcquire(0);
+		if (sequence % 2 != 0)
+			continue;
+
+		qMemCopy(spanText, m_Context.span, STALL_CONTEXT_SIZE);
+		qMemCopy(commandText, m_Context.command, STALL_CONTEXT_SIZE);
+		qMemCopy(sectionText, m_Context.section, STALL_CONTEXT_SIZE);
+
+		if (m_Context.sequence.fetchAndAddOrdered(0) == sequence)
+			break;
+	}
+
+	spanText[STALL_CONTEXT_SIZE - 1] = '\0';
+	commandText[STALL_CONTEXT_SIZE - 1] = '\0';
+	sectionText[STALL_CONTEXT_SIZE - 1] = '\0';
+
+	*span = QString::fromLatin1(spanText);
+	*command = QString::fromLatin1(commandText);
+	*section = QString::fromLatin1(sectionText);
+}
+
+/**
+ * Gets ready for taking the stack of the main thread. Called on it.
+ */
+void StallDetector::prepareStack()
+{
+#if defined(Q_OS_LINUX)
+	mainThread = pthread_self();
+
+	// The first call loads the library, not safe inside the handler.
+	void *frames[1];
+	backtrace(frames, 1);
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = captureStack;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(SIGUSR2, &action, 0);
+#elif defined(Q_OS_WIN32)
+	DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(),
+			&mainThread, THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT
+			| THREAD_QUERY_INFORMATION, FALSE, 0);
+
+	SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS);
+	SymInitialize(GetCurrentProcess(), 0, TRUE);
+#endif
+}
+
+/**
+ * Returns the functions on the stack of the main thread, empty if it could not
+ * be taken.
+ */
+QStringList StallDetector::stack()
+{
+	QStringList frames;
+	stackSize = 0;
+
+#if defined(Q_OS_LINUX)
+	isStackReady.fetchAndStoreOrdered(0);
+
+	if (pthread_kill(mainThread, SIGUSR2) != 0)
+		return frames;
+
+	for (int i = 0; i < 100 && isStackReady.fetchAndAddAcquire(0) == 0; i++)
+		msleep(1);
+
+	if (isStackReady.fetchAndAddAcquire(0) == 0)
+		return frames;
+
+	char **symbols = backtrace_symbols(stackFrames, stackSize);
+	if (symbols == 0)
+		return frames;
+
+	for (int i = 0; i < stackSize; i++)
+		frames << QString::fromLocal8Bit(symbols[i]);
+
+	free(symbols);
+#elif defined(Q_OS_WIN32)
+	if (mainThread == 0 || SuspendThread(mainThread) == (DWORD) -1)
+		return frames;
+
+	// Nothing is allocated while the thread is suspended, it may hold the heap.
+	CONTEXT context;
+	memset(&context, 0, sizeof(context));
+	context.ContextFlags = CONTEXT_CONTROL;
+
+	if (GetThreadContext(mainThread, &context)) {
+		STACKFRAME64 frame;
+		memset(&frame, 0, sizeof(frame));
+#ifdef _WIN64
+		DWORD machine = IMAGE_FILE_MACHINE_AMD64;
+		frame.AddrPC.Offset = context.Rip;
+		frame.AddrFrame.Offset = context.Rbp;
+		frame.AddrStack.Offset = context.Rsp;
+#else
+		DWORD machine = IMAGE_FILE_MACHINE_I386;
+		frame.AddrPC.Offset = context.Eip;
+		frame.AddrFrame.Offset = context.Ebp;
+		frame.AddrStack.Offset = context.Esp;
+#endif
+		frame.AddrPC.Mode = AddrModeFlat;
+		frame.AddrFrame.Mode = AddrModeFlat;
+		frame.AddrStack.Mode = AddrModeFlat;
+
+		while (stackSize < MAX_FRAMES && StackWalk64(machine, GetCurrentProcess(),
+				mainThread, &frame, &context, 0, SymFunctionTableAccess64,
+				SymGetModuleBase64, 0) && frame.AddrPC.Offset != 0)
+			stackFrames[stackSize++] = (void*) frame.AddrPC.Offset;
+	}
+
+	ResumeThread(mainThread);
+
+	char buffer[sizeof(SYMBOL_INFO) + 256];
+	SYMBOL_INFO *symbol = (SYMBOL_INFO*) buffer;
+
+	for (int i = 0; i < stackSize; i++) {
+		DWORD64 address = (DWORD64) stackFrames[i];
+		DWORD64 displacement = 0;
+
+		memset(buffer, 0, sizeof(buffer));
+		symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		symbol->MaxNameLen = 255;
+
+		if (SymFromAddr(GetCurrentProcess(), address, &displacement, symbol))
+			frames << QString::fromLocal8Bit(symbol->Name) + "+0x"
+					+ QString::number(displacement, 16);
+		else
+			frames << "0x" + QString::number(address, 16);
+	}
+#endif
+
+	return frames;
+}
+
+/**
+ * Appends the text to the log.
+ */
+void StallDetector::write(QString text)
+{
+	QFile file(m_FileName);
+
+	if (!file.open(QIODevice::Append | QIODevice::Text))
+		return;
+
+	file.write(text.toUtf8());
+	file.close();
+}
@@ -0,0 +1,69 @@
+/*
+ * stall_detector.h
+ *
+ *  Created on: 29/08/2011
+ *      Author: pc
+ */
+
+#ifndef STALL_DETECTOR_H_
+#define STALL_DETECTOR_H_
+
+#include <QThread>
+#include <QTimer>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QStringList>
+
+// Longest name kept for the span, command and section.
+const int STALL_CONTEXT_SIZE = 64;
+
+struct StallContext
+{
+	QAtomicInt sequence;
+	char span[STALL_CONTEXT_SIZE];
+	char command[STALL_CONTEXT_SIZE];
+	char section[STALL_CONTEXT_SIZE];
+};
+
+class StallDetector : public QThread
+{
+	Q_OBJECT
+
+public:
+	virtual ~StallDetector();
+	bool isEnabled();
+	void enterSpan(QString name);
+	void leaveSpan();
+	void setCommand(QString command);
+	void setSection(QString section);
+	int stallCount();
+	static StallDetector* instance();
+
+protected:
+	void run();
+
+private slots:
+	void beat();
+
+private:
+	int m_Threshold;
+	int m_Interval;
+	QTimer m_Timer;
+	QElapsedTimer m_Clock;
+	QAtomicInt m_LastBeat;
+	QAtomicInt m_IsStopping;
+	StallContext m_Context;
+	QStringList m_Spans;
+	int m_StallCount;
+	QString m_FileName;
+	static StallDetector *m_Instance;
+
+	StallDetector(int threshold, QObject *parent = 0);
+	void publish(char *field, QString value);
+	void context(QString *span, QString *command, QString *section);
+	void prepareStack();
+	QStringList stack();
+	void write(QString text);
+};
+
+#endif /* STALL_DETECTOR_H_ */
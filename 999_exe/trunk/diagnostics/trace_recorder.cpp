@@ -0,0 +1,177 @@
+/*
+ * trace_recorder.cpp
+ *
+ *  Created on: 25/07/2011
+ *      Author: pc
+ */
+
+#include "trace_recorder.h"
+
+#include <QApplication>
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
+#include <QMap>
+#include <string.h>
+#include "latency_recorder.h"
+#include "../registry.h"
+
+/**
+ * @class TraceRecorder
+ * Keeps the last spans recorded on a ring buffer and saves them in the Chrome
+ * trace format, viewable on chrome://tracing. Every span carries the correlation
+ * id of the operation it belongs to, e.g. a scan or the saving of a cash receipt,
+ * so the request, parsing, xslt and page update of each one can be followed.
+ * Writers take a slot with an atomic counter and never wait for each other; a
+ * slot being written while saving is skipped. The slots hold only plain data,
+ * the name is copied into a fixed buffer, so a slot read while it is rewritten
+ * gives torn values, which are dropped, and never a dangling pointer.
+ */
+
+TraceRecorder* TraceRecorder::m_Instance = 0;
+
+// Sequence of a slot never written or being written.
+static const int EMPTY_SLOT = -1;
+
+/**
+ * Constructs the recorder with room for capacity spans.
+ */
+TraceRecorder::TraceRecorder(int capacity, QObject *parent) : QObject(parent),
+		m_Capacity(capacity)
+{
+	m_Events = (m_Capacity > 0) ? new TraceEvent[m_Capacity] : 0;
+
+	for (int i = 0; i < m_Capacity; i++)
+		m_Events[i].sequence = EMPTY_SLOT;
+}
+
+/**
+ * Destroys the buffer.
+ */
+TraceRecorder::~TraceRecorder()
+{
+	delete[] m_Events;
+}
+
+/**
+ * Returns the only instance.
+ */
+TraceRecorder* TraceRecorder::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new TraceRecorder(Registry::instance()->traceBufferSize(),
+				qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Returns false if the buffer size is zero.
+ */
+bool TraceRecorder::isEnabled()
+{
+	return m_Capacity > 0;
+}
+
+/**
+ * Adds a span with the actual correlation id. Times in microseconds.
+ */
+void TraceRecorder::add(QString name, qint64 start, qint64 duration)
+{
+	if (m_Capacity == 0)
+		return;
+
+	int ticket = m_Next.fetchAndAddOrdered(1) & 0x7FFFFFFF;
+	TraceEvent &event = m_Events[ticket % m_Capacity];
+
+	event.sequence.fetchAndStoreOrdered(EMPTY_SLOT);
+	qstrncpy(event.name, name.toUtf8().constData(), TRACE_NAME_SIZE);
+	event.start = start;
+	event.duration = duration;
+	event.correlation = int(m_Correlation);
+	event.thread = qint64(quintptr(QThread::currentThreadId()));
+	event.sequence.fetchAndStoreRelease(ticket);
+}
+
+/**
+ * Starts a new operation and returns its correlation id.
+ */
+int TraceRecorder::startCorrelation()
+{
+	return m_Correlation.fetchAndAddOrdered(1) + 1;
+}
+
+/**
+ * Returns the correlation id of the actual operation.
+ */
+int TraceRecorder::correlation()
+{
+	return int(m_Correlation);
+}
+
+/**
+ * Returns the microseconds on the same clock the LatencyRecorder uses.
+ */
+qint64 TraceRecorder::now()
+{
+	return LatencyRecorder::instance()->now();
+}
+
+/**
+ * Writes the spans on the file as Chrome trace json.
+ */
+bool TraceRecorder::save(QString fileName)
+{
+	QFile file(fileName);
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+		return false;
+
+	// Sorted by the order they were written.
+	QMap<int, int> order;
+	for (int i = 0; i < m_Capacity; i++) {
+		int sequence = int(m_Events[i].sequence);
+		if (sequence != EMPTY_SLOT)
+			order.insert(sequence, i);
+	}
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+	stream << "{\"traceEvents\":[";
+
+	bool isFirst = true;
+	QMapIterator<int, int> i(order);
+	while (i.hasNext()) {
+		i.next();
+		TraceEvent &event = m_Events[i.value()];
+
+		// Copied first, the slot is dropped if it was written meanwhile.
+		char buffer[TRACE_NAME_SIZE];
+		memcpy(buffer, event.name, TRACE_NAME_SIZE);
+		buffer[TRACE_NAME_SIZE - 1] = '\0';
+		qint64 start = event.start;
+		qint64 duration = event.duration;
+		qint64 thread = event.thread;
+		int correlation = event.correlation;
+
+		if (event.sequence.fetchAndAddAcquire(0) != i.key())
+			continue;
+
+		QString name = QString::fromUtf8(buffer);
+		name.replace("\\", "\\\\").replace("\"", "\\\"");
+
+		stream << (isFirst ? "\n" : ",\n") << "{\"name\":\"" << name
+				<< "\",\"cat\":\"pos\",\"ph\":\"X\",\"ts\":" << start
+				<< ",\"dur\":" << duration << ",\"pid\":1,\"tid\":"
+				<< thread << ",\"args\":{\"correlation\":" << correlation
+				<< "}}";
+
+		isFirst = false;
+	}
+
+	stream << "\n]}\n";
+
+	file.close();
+
+	return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * trace_recorder.h
+ *
+ *  Created on: 25/07/2011
+ *      Author: pc
+ */
+
+#ifndef TRACE_RECORDER_H_
+#define TRACE_RECORDER_H_
+
+#include <QObject>
+#include <QString>
+#include <QAtomicInt>
+
+// Bytes kept of a span's name, the rest is cut off.
+static const int TRACE_NAME_SIZE = 64;
+
+struct TraceEvent
+{
+	char name[TRACE_NAME_SIZE];
+	qint64 start;
+	qint64 duration;
+	int correlation;
+	qint64 thread;
+	QAtomicInt sequence;
+};
+
+class TraceRecorder : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~TraceRecorder();
+	bool isEnabled();
+	void add(QString name, qint64 start, qint64 duration);
+	int startCorrelation();
+	int correlation();
+	qint64 now();
+	bool save(QString fileName);
+	static TraceRecorder* instance();
+
+private:
+	TraceEvent *m_Events;
+	int m_Capacity;
+	QAtomicInt m_Next;
+	QAtomicInt m_Correlation;
+	static TraceRecorder *m_Instance;
+
+	TraceRecorder(int capacity, QObject *parent = 0);
+};
+
+#endif /* TRACE_RECORDER_H_ */
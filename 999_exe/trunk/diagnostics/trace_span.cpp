@@ -0,0 +1,49 @@
+/*
+ * trace_span.cpp
+ *
+ *  Created on: 25/07/2011
+ *      Author: pc
+ */
+
+#include "trace_span.h"
+
+#include "trace_recorder.h"
+#include "stall_detector.h"
+
+/**
+ * @class TraceSpan
+ * Records on the TraceRecorder the time from its construction to its
+ * destruction. Meant to be created on the stack at the beginning of the block.
+ * The StallDetector is told which span the main thread is in.
+ */
+
+/**
+ * Starts the span. If isNewCorrelation is true a new operation starts with it.
+ */
+TraceSpan::TraceSpan(QString name, bool isNewCorrelation) : m_Start(-1)
+{
+	TraceRecorder *recorder = TraceRecorder::instance();
+
+	if (recorder->isEnabled()) {
+		if (isNewCorrelation)
+			recorder->startCorrelation();
+
+		m_Name = name;
+		m_Start = recorder->now();
+	}
+
+	StallDetector::instance()->enterSpan(name);
+}
+
+/**
+ * Adds the span to the recorder.
+ */
+TraceSpan::~TraceSpan()
+{
+	StallDetector::instance()->leaveSpan();
+
+	if (m_Start != -1) {
+		TraceRecorder *recorder = TraceRecorder::instance();
+		recorder->add(m_Name, m_Start, recorder->now() - m_Start);
+	}
+}
@@ -0,0 +1,24 @@
+/*
+ * trace_span.h
+ *
+ *  Created on: 25/07/2011
+ *      Author: pc
+ */
+
+#ifndef TRACE_SPAN_H_
+#define TRACE_SPAN_H_
+
+#include <QString>
+
+class TraceSpan
+{
+public:
+	TraceSpan(QString name, bool isNewCorrelation = false);
+	virtual ~TraceSpan();
+
+private:
+	QString m_Name;
+	qint64 m_Start;
+};
+
+#endif /* TRACE_SPAN_H_ */
@@ -0,0 +1,116 @@
+#include "diagnostics_dialog.h"
+
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include "../diagnostics/latency_recorder.h"
+#include "../diagnostics/trace_recorder.h"
+#include "../diagnostics/allocation_tracker.h"
+
+/**
+ * @class DiagnosticsDialog
+ * Dialog showing the latency percentiles of every server command and the stalls
+ * of the main thread found by the StallDetector. It also saves the recorded
+ * spans for viewing them on chrome://tracing. The saved values end with the
+ * memory used, by subsystem if the client was built with allocation accounting.
+ */
+
+/**
+ * Constructs the dialog.
+ */
+DiagnosticsDialog::DiagnosticsDialog(QWidget *parent, Qt::WindowFlags f)
+    : QDialog(parent, f)
+{
+	ui.setupUi(this);
+
+	connect(ui.refreshPushButton, SIGNAL(clicked()), this, SLOT(refresh()));
+	connect(ui.savePushButton, SIGNAL(clicked()), this, SLOT(save()));
+	connect(ui.clearPushButton, SIGNAL(clicked()), this, SLOT(clear()));
+	connect(ui.traceSavePushButton, SIGNAL(clicked()), this, SLOT(saveTrace()));
+
+	ui.traceSavePushButton->setEnabled(TraceRecorder::instance()->isEnabled());
+
+	refresh();
+}
+
+/**
+ * Fills the table with the actual values. Durations in milliseconds.
+ */
+void DiagnosticsDialog::refresh()
+{
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+	QStringList keys = recorder->keys();
+
+	ui.tableWidget->setRowCount(keys.size());
+
+	for (int i = 0; i < keys.size(); i++) {
+		LatencyHistogram *histogram = recorder->histogram(keys[i]);
+
+		QStringList values;
+		values << keys[i].section(' ', 0, 0) << keys[i].section(' ', 1)
+				<< QString::number(histogram->count())
+				<< QString::number(histogram->percentile(50) / 1000.0, 'f', 1)
+				<< QString::number(histogram->percentile(95) / 1000.0, 'f', 1)
+				<< QString::number(histogram->percentile(99) / 1000.0, 'f', 1)
+				<< QString::number(histogram->max() / 1000.0, 'f', 1)
+				<< QString::number(histogram->bytesIn())
+				<< QString::number(histogram->bytesOut());
+
+		for (int j = 0; j < values.size(); j++)
+			ui.tableWidget->setItem(i, j, new QTableWidgetItem(values[j]));
+	}
+
+	ui.tableWidget->resizeColumnsToContents();
+}
+
+/**
+ * Saves the values on a file.
+ */
+void DiagnosticsDialog::save()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Guardar",
+			QApplication::applicationDirPath() + "/diagnostics_"
+			+ QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".txt");
+
+	if (fileName == "")
+		return;
+
+	if (!LatencyRecorder::instance()->save(fileName)) {
+		QMessageBox::critical(this, "Guardar", "No se pudo guardar el archivo.");
+		return;
+	}
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::Append | QIODevice::Text)) {
+		QMessageBox::critical(this, "Guardar", "No se pudo guardar el archivo.");
+		return;
+	}
+
+	QTextStream stream(&file);
+	stream << "\n" << AllocationTracker::report();
+}
+
+/**
+ * Saves the recorded spans on a Chrome trace file.
+ */
+void DiagnosticsDialog::saveTrace()
+{
+	QString fileName = QFileDialog::getSaveFileName(this, "Guardar traza",
+			QApplication::applicationDirPath() + "/trace_"
+			+ QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".json");
+
+	if (fileName != "" && !TraceRecorder::instance()->save(fileName))
+		QMessageBox::critical(this, "Guardar", "No se pudo guardar el archivo.");
+}
+
+/**
+ * Removes all the values.
+ */
+void DiagnosticsDialog::clear()
+{
+	LatencyRecorder::instance()->clear();
+	refresh();
+}
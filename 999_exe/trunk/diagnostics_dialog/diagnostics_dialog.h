@@ -0,0 +1,25 @@
+#ifndef DIAGNOSTICS_DIALOG_H
+#define DIAGNOSTICS_DIALOG_H
+
+#include <QtGui/QDialog>
+#include "ui_diagnostics_dialog.h"
+
+class DiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    DiagnosticsDialog(QWidget *parent = 0, Qt::WindowFlags f = 0);
+    ~DiagnosticsDialog() {};
+
+public slots:
+	void refresh();
+	void save();
+	void saveTrace();
+	void clear();
+
+private:
+    Ui::DiagnosticsDialogClass ui;
+};
+
+#endif // DIAGNOSTICS_DIALOG_H
@@ -0,0 +1,226 @@
+/*
+ * document_prefetcher.cpp
+ *
+ *  Created on: 04/07/2011
+ *      Author: pc
+ */
+
+#include "document_prefetcher.h"
+
+#include "document_snapshot_cache.h"
+#include "../section/page_state.h"
+#include "../xml_transformer/xml_transformer_factory.h"
+#include "../diagnostics/latency_timer.h"
+
+/**
+ * @class DocumentPrefetcher
+ * Fetches in the background the details of the documents next to the one on
+ * display and stores them in the DocumentSnapshotCache. Only one request is on
+ * the wire at a time so the cashier's own requests are not delayed.
+ */
+
+/**
+ * Constructs the prefetcher.
+ */
+DocumentPrefetcher::DocumentPrefetcher(QNetworkCookieJar *jar, QUrl *serverUrl,
+		QObject *parent) : QObject(parent), m_ServerUrl(serverUrl)
+{
+	m_Request = new HttpRequest(jar, this);
+	m_Handler = new XmlResponseHandler(this);
+	m_Query = new QXmlQuery(QXmlQuery::XSLT20);
+	m_Status = Idle;
+
+	// Queued so the next request is not issued while the HttpRequest is still
+	// finishing the previous one.
+	connect(m_Request, SIGNAL(finished(QString)), this,
+			SLOT(requestFinished(QString)), Qt::QueuedConnection);
+}
+
+/**
+ * Destroys the query object.
+ */
+DocumentPrefetcher::~DocumentPrefetcher()
+{
+	delete m_Query;
+}
+
+/**
+ * Sets the cash register key the documents belong to.
+ */
+void DocumentPrefetcher::setCashRegisterKey(QString key)
+{
+	m_CashRegisterKey = key;
+}
+
+/**
+ * Sets the command for fetching a document. Also used as the cache document type.
+ */
+void DocumentPrefetcher::setGetDocumentCmd(QString cmd)
+{
+	m_GetDocumentCmd = cmd;
+}
+
+/**
+ * Sets the command for fetching the document details.
+ */
+void DocumentPrefetcher::setGetDocumentDetailsCmd(QString cmd)
+{
+	m_GetDocumentDetailsCmd = cmd;
+}
+
+/**
+ * Sets the xslt style sheet used for rendering the details.
+ */
+void DocumentPrefetcher::setStyleSheet(QString styleSheet)
+{
+	m_StyleSheet = styleSheet;
+}
+
+/**
+ * Replaces the pending documents with the ids passed. The ones already on the
+ * cache are skipped.
+ */
+void DocumentPrefetcher::prefetch(QStringList ids)
+{
+	DocumentSnapshotCache *cache = DocumentSnapshotCache::instance();
+
+	m_Ids.clear();
+	for (int i = 0; i < ids.size(); i++) {
+		if (!cache->contains(m_GetDocumentCmd, ids[i]))
+			m_Ids.enqueue(ids[i]);
+	}
+
+	if (m_Status == Idle)
+		fetchNext();
+}
+
+/**
+ * Discards the pending documents. The request on the wire finishes normally.
+ */
+void DocumentPrefetcher::stop()
+{
+	m_Ids.clear();
+}
+
+/**
+ * Dispatches the response depending on the actual status.
+ */
+void DocumentPrefetcher::requestFinished(QString content)
+{
+	switch (m_Status) {
+		case FetchingDocument:
+			documentFetched(content);
+			break;
+
+		case FetchingDetails:
+			detailsFetched(content);
+			break;
+
+		case RemovingDocument:
+			fetchNext();
+			break;
+
+		default:;
+	}
+}
+
+/**
+ * Fetches the next pending document form from the server.
+ */
+void DocumentPrefetcher::fetchNext()
+{
+	m_DocumentKey = "";
+
+	if (m_Ids.isEmpty() || m_StyleSheet == "") {
+		m_Status = Idle;
+		return;
+	}
+
+	m_DocumentId = m_Ids.dequeue();
+
+	// It may have been stored while waiting.
+	if (DocumentSnapshotCache::instance()->contains(m_GetDocumentCmd,
+			m_DocumentId)) {
+		fetchNext();
+		return;
+	}
+
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", m_GetDocumentCmd);
+	url.addQueryItem("id", m_DocumentId);
+	url.addQueryItem("register_key", m_CashRegisterKey);
+
+	m_Status = FetchingDocument;
+	m_Request->defer(url);
+}
+
+/**
+ * Reads the session key and the status of the document from the page. Only
+ * finished or cancelled documents are stored.
+ */
+void DocumentPrefetcher::documentFetched(QString content)
+{
+	PageState state = PageState::parse(content);
+
+	if (state.objectKey == "") {
+		fetchNext();
+		return;
+	}
+
+	m_DocumentKey = state.objectKey;
+
+	// Same values as the DocumentSection::DocumentStatus enum, 0 is Edit.
+	if (state.documentStatus == 0) {
+		removeDocumentFromSession();
+		return;
+	}
+
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", m_GetDocumentDetailsCmd);
+	url.addQueryItem("key", m_DocumentKey);
+	url.addQueryItem("type", "xml");
+
+	m_Status = FetchingDetails;
+	m_Request->defer(url);
+}
+
+/**
+ * Renders the details and stores them on the cache.
+ */
+void DocumentPrefetcher::detailsFetched(QString content)
+{
+	XmlTransformer *transformer = XmlTransformerFactory::instance()
+			->create("stub");
+
+	if (m_Handler->handle(content, transformer) == XmlResponseHandler::Success) {
+		LatencyTimer timer("xslt");
+
+		// Must copy object to be reentrant and thread safe.
+		QXmlQuery qry(*m_Query);
+		qry.setFocus(content);
+		qry.setQuery(m_StyleSheet);
+
+		QString result;
+		if (qry.evaluateTo(&result))
+			DocumentSnapshotCache::instance()->insert(m_GetDocumentCmd,
+					m_DocumentId, result);
+	}
+
+	delete transformer;
+
+	removeDocumentFromSession();
+}
+
+/**
+ * Removes the fetched document object from the session on the server.
+ */
+void DocumentPrefetcher::removeDocumentFromSession()
+{
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", "remove_session_object");
+	url.addQueryItem("key", m_DocumentKey);
+	url.addQueryItem("type", "xml");
+
+	m_Status = RemovingDocument;
+	m_Request->defer(url);
+}
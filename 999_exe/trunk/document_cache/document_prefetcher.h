@@ -0,0 +1,60 @@
+/*
+ * document_prefetcher.h
+ *
+ *  Created on: 04/07/2011
+ *      Author: pc
+ */
+
+#ifndef DOCUMENT_PREFETCHER_H_
+#define DOCUMENT_PREFETCHER_H_
+
+#include <QObject>
+#include <QQueue>
+#include <QStringList>
+#include <QUrl>
+#include <QXmlQuery>
+#include "../http_request/http_request.h"
+#include "../xml_response_handler/xml_response_handler.h"
+
+class DocumentPrefetcher : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum PrefetchStatus {Idle, FetchingDocument, FetchingDetails, RemovingDocument};
+	DocumentPrefetcher(QNetworkCookieJar *jar, QUrl *serverUrl,
+			QObject *parent = 0);
+	virtual ~DocumentPrefetcher();
+	void setCashRegisterKey(QString key);
+	void setGetDocumentCmd(QString cmd);
+	void setGetDocumentDetailsCmd(QString cmd);
+	void setStyleSheet(QString styleSheet);
+	void prefetch(QStringList ids);
+	void stop();
+
+public slots:
+	void requestFinished(QString content);
+
+private:
+	QUrl *m_ServerUrl;
+	HttpRequest *m_Request;
+	XmlResponseHandler *m_Handler;
+	QXmlQuery *m_Query;
+	QString m_StyleSheet;
+
+	QString m_CashRegisterKey;
+	QString m_GetDocumentCmd;
+	QString m_GetDocumentDetailsCmd;
+
+	QQueue<QString> m_Ids;
+	QString m_DocumentId;
+	QString m_DocumentKey;
+	PrefetchStatus m_Status;
+
+	void fetchNext();
+	void documentFetched(QString content);
+	void detailsFetched(QString content);
+	void removeDocumentFromSession();
+};
+
+#endif /* DOCUMENT_PREFETCHER_H_ */
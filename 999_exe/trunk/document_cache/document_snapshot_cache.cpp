@@ -0,0 +1,191 @@
+/*
+ * document_snapshot_cache.cpp
+ *
+ *  Created on: 04/07/2011
+ *      Author: pc
+ */
+
+#include "document_snapshot_cache.h"
+
+#include <QApplication>
+#include "../registry.h"
+#include "../diagnostics/allocation_tracker.h"
+
+/**
+ * @class DocumentSnapshotCache
+ * Keeps the rendered details of the documents that can not change anymore (finished
+ * or cancelled) so they are not fetched from the server on every visit. The least
+ * recently used snapshots are evicted when the memory limit is reached.
+ */
+
+DocumentSnapshotCache* DocumentSnapshotCache::m_Instance = 0;
+
+/**
+ * Constructs the cache with the size limit read from the Registry.
+ */
+DocumentSnapshotCache::DocumentSnapshotCache(QObject *parent) : QObject(parent)
+{
+	m_Hits = 0;
+	m_Misses = 0;
+	m_Evictions = 0;
+
+	setMaxSize(Registry::instance()->documentCacheSize());
+}
+
+/**
+ * Returns the only instance.
+ */
+DocumentSnapshotCache* DocumentSnapshotCache::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new DocumentSnapshotCache(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Returns true if there is a snapshot of the document. Does not count as a hit.
+ */
+bool DocumentSnapshotCache::contains(QString documentType, QString id)
+{
+	return m_Snapshots.contains(cacheKey(documentType, id));
+}
+
+/**
+ * Copies the document snapshot into the snapshot parameter if it was found.
+ * Returns true on a hit.
+ */
+bool DocumentSnapshotCache::find(QString documentType, QString id,
+		QString *snapshot)
+{
+	// QCache::object() also marks the entry as the most recently used.
+	QString *value = m_Snapshots.object(cacheKey(documentType, id));
+
+	if (value != 0) {
+		*snapshot = *value;
+		m_Hits++;
+	} else {
+		m_Misses++;
+	}
+
+	emit statisticsChanged();
+
+	return (value != 0);
+}
+
+/**
+ * Stores the snapshot of the document. Its cost is its size in bytes.
+ */
+void DocumentSnapshotCache::insert(QString documentType, QString id,
+		QString snapshot)
+{
+	AllocationScope scope(AllocationTracker::DocumentCache);
+
+	QString key = cacheKey(documentType, id);
+	int cost = snapshot.size() * sizeof(QChar);
+
+	// Bigger than the whole cache, QCache would discard it anyway.
+	if (cost > m_Snapshots.maxCost())
+		return;
+
+	int expected = m_Snapshots.count() + (m_Snapshots.contains(key) ? 0 : 1);
+
+	m_Snapshots.insert(key, new QString(snapshot), cost);
+
+	m_Evictions += expected - m_Snapshots.count();
+
+	emit statisticsChanged();
+}
+
+/**
+ * Removes the snapshot of the document because it has changed.
+ */
+void DocumentSnapshotCache::invalidate(QString documentType, QString id)
+{
+	if (m_Snapshots.remove(cacheKey(documentType, id)))
+		emit statisticsChanged();
+}
+
+/**
+ * Removes all the snapshots.
+ */
+void DocumentSnapshotCache::clear()
+{
+	m_Snapshots.clear();
+	emit statisticsChanged();
+}
+
+/**
+ * Sets the memory limit in kilobytes.
+ */
+void DocumentSnapshotCache::setMaxSize(int kilobytes)
+{
+	int count = m_Snapshots.count();
+	m_Snapshots.setMaxCost(kilobytes * 1024);
+	m_Evictions += count - m_Snapshots.count();
+}
+
+/**
+ * Returns the memory limit in kilobytes.
+ */
+int DocumentSnapshotCache::maxSize()
+{
+	return m_Snapshots.maxCost() / 1024;
+}
+
+/**
+ * Returns the memory used by the snapshots in kilobytes.
+ */
+int DocumentSnapshotCache::size()
+{
+	return m_Snapshots.totalCost() / 1024;
+}
+
+/**
+ * Returns the number of snapshots stored.
+ */
+int DocumentSnapshotCache::count()
+{
+	return m_Snapshots.count();
+}
+
+/**
+ * Returns how many times a snapshot was found.
+ */
+int DocumentSnapshotCache::hits()
+{
+	return m_Hits;
+}
+
+/**
+ * Returns how many times a snapshot was not found.
+ */
+int DocumentSnapshotCache::misses()
+{
+	return m_Misses;
+}
+
+/**
+ * Returns how many snapshots were discarded for lack of memory.
+ */
+int DocumentSnapshotCache::evictions()
+{
+	return m_Evictions;
+}
+
+/**
+ * Returns the percentage of lookups that found a snapshot.
+ */
+double DocumentSnapshotCache::hitRate()
+{
+	int total = m_Hits + m_Misses;
+	return (total > 0) ? (m_Hits * 100.0) / total : 0;
+}
+
+/**
+ * Returns the key to use for the document. Invoices and deposits ids may repeat.
+ */
+QString DocumentSnapshotCache::cacheKey(QString documentType, QString id)
+{
+	return documentType + ":" + id;
+}
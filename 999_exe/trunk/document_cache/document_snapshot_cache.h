@@ -0,0 +1,50 @@
+/*
+ * document_snapshot_cache.h
+ *
+ *  Created on: 04/07/2011
+ *      Author: pc
+ */
+
+#ifndef DOCUMENT_SNAPSHOT_CACHE_H_
+#define DOCUMENT_SNAPSHOT_CACHE_H_
+
+#include <QObject>
+#include <QCache>
+#include <QString>
+
+class DocumentSnapshotCache : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~DocumentSnapshotCache() {};
+	bool contains(QString documentType, QString id);
+	bool find(QString documentType, QString id, QString *snapshot);
+	void insert(QString documentType, QString id, QString snapshot);
+	void invalidate(QString documentType, QString id);
+	void clear();
+	void setMaxSize(int kilobytes);
+	int maxSize();
+	int size();
+	int count();
+	int hits();
+	int misses();
+	int evictions();
+	double hitRate();
+	static DocumentSnapshotCache* instance();
+
+signals:
+	void statisticsChanged();
+
+private:
+	QCache<QString, QString> m_Snapshots;
+	int m_Hits;
+	int m_Misses;
+	int m_Evictions;
+	static DocumentSnapshotCache *m_Instance;
+
+	DocumentSnapshotCache(QObject *parent = 0);
+	QString cacheKey(QString documentType, QString id);
+};
+
+#endif /* DOCUMENT_SNAPSHOT_CACHE_H_ */
@@ -8,10 +8,27 @@
 #include "http_request.h"
 
 #include <QEventLoop>
+#include <QTimer>
+#include "../registry.h"
+#include "../diagnostics/latency_recorder.h"
+#include "../traffic_capture/traffic_recorder.h"
+#include "../logger/logger.h"
+#include "../diagnostics/allocation_tracker.h"
+#include "request_scheduler.h"
 
 /**
  * @class HttpRequest
  * Handles synchronous or asynchronous communication with the server.
+ * Every request has a deadline, after it the request is aborted and an empty
+ * content is returned, the same as if the connection was lost. The pending
+ * asynchronous requests are cancelled when the object is destroyed, which
+ * happens with its parent, so their responses never reach a deleted owner.
+ * The duration and size of every request are recorded on the LatencyRecorder
+ * and, if capture is enabled, the whole request on the TrafficRecorder. Failed
+ * requests are logged, and so are the errors on asynchronous responses nobody
+ * is waiting for. The replies are deleted once handled or cancelled. Every
+ * request is interactive except the deferred ones, which the RequestScheduler
+ * holds while an interactive request is in flight.
  */
 
 /**
@@ -22,35 +39,193 @@ HttpRequest::HttpRequest(QNetworkCookieJar *jar, QObject *parent)
 {
 	m_Manager.setCookieJar(jar);
 	jar->setParent(0);
-	m_IsBusy = false;
+	m_LatestReply = 0;
+	m_HasPendingUrl = false;
+	m_PendingTimeout = -1;
+	m_Timeout = Registry::instance()->requestTimeout() * 1000;
+	m_IsTimedOut = false;
+	m_DeferredCount = 0;
+}
+
+/**
+ * Cancels the pending requests.
+ */
+HttpRequest::~HttpRequest()
+{
+	cancel();
 }
 
 /**
  * Gets the information from the server.
  * If isAsync is true the finished signal is emitted sending the data received.
+ * The timeout is in milliseconds, -1 means the one set on the object.
  */
-QString HttpRequest::get(QUrl url, bool isAsync)
+QString HttpRequest::get(QUrl url, bool isAsync, int timeout)
 {
+	AllocationScope scope(AllocationTracker::Network);
+
 	if (!isAsync) {
+		LatencyRecorder *recorder = LatencyRecorder::instance();
+		qint64 start = recorder->now();
+
 		QEventLoop loop;
+		QTimer timer;
+		timer.setSingleShot(true);
+
+		RequestScheduler *scheduler = RequestScheduler::instance();
+		scheduler->beginInteractive();
 
 		QNetworkReply *reply = m_Manager.get(QNetworkRequest(url));
 
 		connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+		connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+
+		timeout = (timeout == -1) ? m_Timeout : timeout;
+		if (timeout > 0)
+			timer.start(timeout);
 
 		loop.exec();
-		return QString::fromUtf8(reply->readAll());
-	}
 
-	connect(&m_Manager, SIGNAL(finished(QNetworkReply*)), this,
-			SLOT(loadFinished(QNetworkReply*)));
+		QString content;
+		m_IsTimedOut = !reply->isFinished();
+
+		if (m_IsTimedOut) {
+			reply->disconnect(&loop);
+			reply->abort();
+		} else {
+			content = QString::fromUtf8(reply->readAll());
+		}
 
-	m_Manager.get(QNetworkRequest(url));
-	m_IsBusy = true;
+		reply->deleteLater();
+		scheduler->endInteractive();
+
+		qint64 duration = recorder->now() - start;
+		QString cmd = command(url);
+		recorder->record("request", cmd, duration, content.size(),
+				url.toEncoded().size());
+		recorder->setCommand(cmd);
+		TrafficRecorder::instance()->record(url, start, duration, content);
+
+		if (content == "")
+			logFailure(cmd);
+
+		return content;
+	}
+
+	send(url, timeout);
 
 	return NULL;
 }
 
+/**
+ * Gets the information from the server asynchronously, the latest value wins.
+ * If a previous superseding request is still waiting for its response, the url
+ * waits until it finishes and only the last url passed is sent. The response of
+ * a superseded request is not emitted.
+ */
+void HttpRequest::supersede(QUrl url, int timeout)
+{
+	if (m_LatestReply == 0) {
+		m_LatestReply = send(url, timeout);
+	} else {
+		m_PendingUrl = url;
+		m_PendingTimeout = timeout;
+		m_HasPendingUrl = true;
+	}
+}
+
+/**
+ * Gets the information from the server asynchronously, the latest value wins.
+ * Unlike supersede the previous request still waiting for its response is
+ * aborted and the url is sent at once. The aborted one does not emit finished.
+ */
+void HttpRequest::replace(QUrl url, int timeout)
+{
+	if (m_LatestReply != 0) {
+		m_Replies.removeOne(m_LatestReply);
+		m_LatestReply->disconnect(this);
+		m_LatestReply->abort();
+		m_LatestReply->deleteLater();
+		release(m_LatestReply);
+
+		Logger::log(Logger::Debug, "request_replaced", "cmd",
+				command(m_LatestReply->url()));
+	}
+
+	m_HasPendingUrl = false;
+	m_LatestReply = send(url, timeout);
+}
+
+/**
+ * Gets the information from the server asynchronously as background traffic.
+ * The RequestScheduler sends it once no interactive request is in flight. The
+ * finished signal is emitted as with any asynchronous request.
+ */
+void HttpRequest::defer(QUrl url, int timeout)
+{
+	m_DeferredCount++;
+	RequestScheduler::instance()->enqueue(this, url, timeout);
+}
+
+/**
+ * Sends the deferred request when the RequestScheduler gives it its turn.
+ */
+void HttpRequest::sendDeferred(QUrl url, int timeout)
+{
+	if (m_DeferredCount > 0)
+		m_DeferredCount--;
+
+	send(url, timeout, true);
+}
+
+/**
+ * Aborts all the asynchronous requests waiting for a response and drops the
+ * deferred ones not sent yet. The finished signal is not emitted for them.
+ */
+void HttpRequest::cancel()
+{
+	QList<QNetworkReply*> replies = m_Replies;
+	m_Replies.clear();
+	m_LatestReply = 0;
+	m_HasPendingUrl = false;
+
+	if (m_DeferredCount > 0) {
+		m_DeferredCount = 0;
+		RequestScheduler::instance()->remove(this);
+	}
+
+	for (int i = 0; i < replies.size(); i++) {
+		replies[i]->disconnect(this);
+		replies[i]->abort();
+		replies[i]->deleteLater();
+		release(replies[i]);
+	}
+}
+
+/**
+ * Sets the default timeout in milliseconds. Zero means no timeout.
+ */
+void HttpRequest::setTimeout(int timeout)
+{
+	m_Timeout = timeout;
+}
+
+/**
+ * Returns the default timeout in milliseconds.
+ */
+int HttpRequest::timeout()
+{
+	return m_Timeout;
+}
+
+/**
+ * Returns true if the last request ran out of time.
+ */
+bool HttpRequest::isTimedOut()
+{
+	return m_IsTimedOut;
+}
+
 /**
  * Returns the CookieJar object use by this request.
  */
@@ -60,22 +235,134 @@ QNetworkCookieJar* HttpRequest::cookieJar()
 }
 
 /**
- * Returns true if the request object is busy waiting a response.
+ * Returns true if the request object is busy waiting a response or has a
+ * deferred request waiting for its turn.
  */
 bool HttpRequest::isBusy()
 {
-	return m_IsBusy;
+	return !m_Replies.isEmpty() || m_DeferredCount > 0;
 }
 
 /**
  * Handles the response in case the communication was made asynchronously.
- * Emits the finished signal.
+ * Emits the finished signal unless a newer superseding url is waiting.
+ */
+void HttpRequest::loadFinished()
+{
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (reply == 0 || !m_Replies.removeOne(reply))
+		return;
+
+	reply->deleteLater();
+	release(reply);
+
+	// Only the deadline timer aborts a reply still on the list.
+	m_IsTimedOut = (reply->error() == QNetworkReply::OperationCanceledError);
+	QString content = m_IsTimedOut ? "" : QString::fromUtf8(reply->readAll());
+
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+	qint64 start = reply->property("start_time").toLongLong();
+	qint64 duration = recorder->now() - start;
+	QString cmd = command(reply->url());
+	recorder->record("request", cmd, duration, content.size(),
+			reply->url().toEncoded().size());
+	recorder->setCommand(cmd);
+	TrafficRecorder::instance()->record(reply->url(), start, duration, content);
+
+	if (content == "")
+		logFailure(cmd);
+	else if (receivers(SIGNAL(finished(QString))) == 0)
+		logUnhandledError(cmd, content);
+
+	if (reply == m_LatestReply) {
+		m_LatestReply = 0;
+
+		if (m_HasPendingUrl) {
+			m_HasPendingUrl = false;
+			m_LatestReply = send(m_PendingUrl, m_PendingTimeout);
+			return;
+		}
+	}
+
+	emit finished(content);
+}
+
+/**
+ * Sends the asynchronous request and starts its deadline timer. Interactive
+ * requests hold the background ones until they are released.
+ */
+QNetworkReply* HttpRequest::send(QUrl url, int timeout, bool isBackground)
+{
+	AllocationScope scope(AllocationTracker::Network);
+
+	if (!isBackground)
+		RequestScheduler::instance()->beginInteractive();
+
+	QNetworkReply *reply = m_Manager.get(QNetworkRequest(url));
+	reply->setProperty("start_time", LatencyRecorder::instance()->now());
+	reply->setProperty("is_background", isBackground);
+	m_Replies << reply;
+
+	connect(reply, SIGNAL(finished()), this, SLOT(loadFinished()));
+
+	timeout = (timeout == -1) ? m_Timeout : timeout;
+	if (timeout > 0) {
+		QTimer *timer = new QTimer(reply);
+		timer->setSingleShot(true);
+		connect(timer, SIGNAL(timeout()), reply, SLOT(abort()));
+		timer->start(timeout);
+	}
+
+	return reply;
+}
+
+/**
+ * Tells the RequestScheduler the reply is no longer in flight.
+ */
+void HttpRequest::release(QNetworkReply *reply)
+{
+	if (reply->property("is_background").toBool()) {
+		RequestScheduler::instance()->backgroundFinished();
+	} else {
+		RequestScheduler::instance()->endInteractive();
+	}
+}
+
+/**
+ * Returns the server command of the url, or the file name if it is not a
+ * command.
+ */
+QString HttpRequest::command(QUrl url)
+{
+	QString cmd = url.queryItemValue("cmd");
+
+	return (cmd != "") ? cmd : url.path().section('/', -1);
+}
+
+/**
+ * Logs the request that got no response.
+ */
+void HttpRequest::logFailure(QString cmd)
+{
+	if (Logger::isEnabled(Logger::Warning))
+		Logger::log(Logger::Warning, "request_failed", "cmd", cmd, "timed_out",
+				m_IsTimedOut ? "true" : "false");
+}
+
+/**
+ * Logs the error or failure on a response nobody handles, like the ones of the
+ * requests for removing objects from the session.
  */
-void HttpRequest::loadFinished(QNetworkReply *reply)
+void HttpRequest::logUnhandledError(QString cmd, QString content)
 {
-	emit finished(QString::fromUtf8(reply->readAll()));
+	if (!Logger::isEnabled(Logger::Warning)
+			|| (!content.contains("<error") && !content.contains("<success>0")))
+		return;
 
-	m_IsBusy = false;
+	QString message = content.section("<message>", 1).section("</message>", 0, 0)
+			.remove("<![CDATA[").remove("]]>");
 
-	m_Manager.disconnect(this);
+	Logger::log(Logger::Warning, "unhandled_response_error", "cmd", cmd,
+			"message", message);
 }
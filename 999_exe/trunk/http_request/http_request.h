@@ -12,6 +12,7 @@
 #include <QNetworkAccessManager>
 #include <QUrl>
 #include <QNetworkReply>
+#include <QList>
 
 class HttpRequest : public QObject
 {
@@ -19,20 +20,41 @@ class HttpRequest : public QObject
 
 public:
 	HttpRequest(QNetworkCookieJar *jar, QObject *parent = 0);
-	virtual ~HttpRequest() {};
-	QString get(QUrl url, bool isAsync = false);
+	virtual ~HttpRequest();
+	QString get(QUrl url, bool isAsync = false, int timeout = -1);
+	void supersede(QUrl url, int timeout = -1);
+	void replace(QUrl url, int timeout = -1);
+	void defer(QUrl url, int timeout = -1);
+	void sendDeferred(QUrl url, int timeout);
+	void cancel();
+	void setTimeout(int timeout);
+	int timeout();
+	bool isTimedOut();
 	QNetworkCookieJar* cookieJar();
 	bool isBusy();
 
 private slots:
-	void loadFinished(QNetworkReply *reply);
+	void loadFinished();
 
 signals:
 	void finished(QString content);
 
 private:
 	QNetworkAccessManager m_Manager;
-	bool m_IsBusy;
+	QList<QNetworkReply*> m_Replies;
+	QNetworkReply *m_LatestReply;
+	QUrl m_PendingUrl;
+	int m_PendingTimeout;
+	bool m_HasPendingUrl;
+	int m_Timeout;
+	bool m_IsTimedOut;
+	int m_DeferredCount;
+
+	QNetworkReply* send(QUrl url, int timeout, bool isBackground = false);
+	void release(QNetworkReply *reply);
+	QString command(QUrl url);
+	void logFailure(QString cmd);
+	void logUnhandledError(QString cmd, QString content);
 };
 
 #endif /* HTTPREQUEST_H_ */
@@ -0,0 +1,192 @@
+/*
+ * request_scheduler.cpp
+ *
+ *  Created on: 12/12/2011
+ *      Author: pc
+ */
+
+#include "request_scheduler.h"
+
+#include <QApplication>
+#include "http_request.h"
+#include "../registry.h"
+#include "../logger/logger.h"
+#include "../diagnostics/latency_recorder.h"
+
+/**
+ * @class RequestScheduler
+ * Keeps the background requests, like the removal of objects from the session,
+ * the status checks and the prefetches, away from the cashier's actions. The
+ * server attends the requests of a session one at a time, so a background
+ * request sent while an interactive one is waiting only delays it. The
+ * background requests are queued while any interactive request is in flight
+ * and sent once none is left, up to the limit on the Registry at a time. A
+ * request never waits more than MAX_WAIT for its turn.
+ */
+
+// Milliseconds a background request waits at most for the interactive ones.
+static const int MAX_WAIT = 2000;
+
+RequestScheduler* RequestScheduler::m_Instance = 0;
+
+/**
+ * Constructs the scheduler with the limit read from the Registry.
+ */
+RequestScheduler::RequestScheduler(QObject *parent) : QObject(parent)
+{
+	m_InteractiveCount = 0;
+	m_BackgroundCount = 0;
+	m_BackgroundLimit = Registry::instance()->backgroundRequestLimit();
+
+	m_WaitTimer.setSingleShot(true);
+
+	connect(&m_WaitTimer, SIGNAL(timeout()), this, SLOT(dispatch()));
+}
+
+/**
+ * Returns the only instance.
+ */
+RequestScheduler* RequestScheduler::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new RequestScheduler(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Counts an interactive request sent, the background ones wait until it ends.
+ */
+void RequestScheduler::beginInteractive()
+{
+	m_InteractiveCount++;
+}
+
+/**
+ * Counts an interactive request that got its response or was cancelled.
+ */
+void RequestScheduler::endInteractive()
+{
+	if (m_InteractiveCount > 0)
+		m_InteractiveCount--;
+
+	if (m_InteractiveCount == 0)
+		scheduleDispatch();
+}
+
+/**
+ * Queues the background request of the object. It is sent at once if nothing
+ * else is in flight.
+ */
+void RequestScheduler::enqueue(HttpRequest *request, QUrl url, int timeout)
+{
+	DeferredRequest deferred;
+	deferred.request = request;
+	deferred.url = url;
+	deferred.timeout = timeout;
+	deferred.queuedAt = LatencyRecorder::instance()->now();
+
+	m_Queue << deferred;
+
+	if (m_InteractiveCount == 0 && m_BackgroundCount < m_BackgroundLimit) {
+		dispatch();
+	} else if (!m_WaitTimer.isActive()) {
+		m_WaitTimer.start(MAX_WAIT);
+	}
+}
+
+/**
+ * Removes the requests queued by the object, it does not want them anymore.
+ */
+void RequestScheduler::remove(HttpRequest *request)
+{
+	for (int i = m_Queue.size() - 1; i >= 0; i--)
+		if (m_Queue[i].request == request || m_Queue[i].request.isNull())
+			m_Queue.removeAt(i);
+}
+
+/**
+ * Counts a background request that got its response or was cancelled.
+ */
+void RequestScheduler::backgroundFinished()
+{
+	if (m_BackgroundCount > 0)
+		m_BackgroundCount--;
+
+	scheduleDispatch();
+}
+
+/**
+ * Sets how many background requests can be in flight at a time.
+ */
+void RequestScheduler::setBackgroundLimit(int limit)
+{
+	m_BackgroundLimit = qMax(limit, 1);
+	scheduleDispatch();
+}
+
+/**
+ * Returns the number of interactive requests in flight.
+ */
+int RequestScheduler::interactiveCount()
+{
+	return m_InteractiveCount;
+}
+
+/**
+ * Returns the number of background requests in flight.
+ */
+int RequestScheduler::backgroundCount()
+{
+	return m_BackgroundCount;
+}
+
+/**
+ * Returns the number of background requests waiting for their turn.
+ */
+int RequestScheduler::queuedCount()
+{
+	return m_Queue.size();
+}
+
+/**
+ * Sends the queued requests the limit allows if no interactive request is in
+ * flight. The oldest one is sent anyway if it waited too long.
+ */
+void RequestScheduler::dispatch()
+{
+	qint64 now = LatencyRecorder::instance()->now();
+
+	while (!m_Queue.isEmpty() && m_BackgroundCount < m_BackgroundLimit) {
+		// LatencyRecorder::now is in microseconds.
+		qint64 waited = (now - m_Queue.first().queuedAt) / 1000;
+
+		if (m_InteractiveCount > 0 && waited < MAX_WAIT)
+			break;
+
+		DeferredRequest deferred = m_Queue.takeFirst();
+		if (deferred.request.isNull())
+			continue;
+
+		if (m_InteractiveCount > 0)
+			Logger::log(Logger::Debug, "background_request_forced", "cmd",
+					deferred.url.queryItemValue("cmd"), "waited_ms",
+					QString::number(waited));
+
+		m_BackgroundCount++;
+		deferred.request->sendDeferred(deferred.url, deferred.timeout);
+	}
+
+	if (!m_Queue.isEmpty() && !m_WaitTimer.isActive())
+		m_WaitTimer.start(MAX_WAIT);
+}
+
+/**
+ * Dispatches once the event loop returns, so a response that leads to a new
+ * interactive request keeps the background ones waiting.
+ */
+void RequestScheduler::scheduleDispatch()
+{
+	if (!m_Queue.isEmpty())
+		QMetaObject::invokeMethod(this, "dispatch", Qt::QueuedConnection);
+}
@@ -0,0 +1,59 @@
+/*
+ * request_scheduler.h
+ *
+ *  Created on: 12/12/2011
+ *      Author: pc
+ */
+
+#ifndef REQUEST_SCHEDULER_H_
+#define REQUEST_SCHEDULER_H_
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QTimer>
+#include <QUrl>
+
+class HttpRequest;
+
+struct DeferredRequest
+{
+	QPointer<HttpRequest> request;
+	QUrl url;
+	int timeout;
+	qint64 queuedAt;
+};
+
+class RequestScheduler : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~RequestScheduler() {};
+	void beginInteractive();
+	void endInteractive();
+	void enqueue(HttpRequest *request, QUrl url, int timeout);
+	void remove(HttpRequest *request);
+	void backgroundFinished();
+	void setBackgroundLimit(int limit);
+	int interactiveCount();
+	int backgroundCount();
+	int queuedCount();
+	static RequestScheduler* instance();
+
+private slots:
+	void dispatch();
+
+private:
+	QList<DeferredRequest> m_Queue;
+	int m_InteractiveCount;
+	int m_BackgroundCount;
+	int m_BackgroundLimit;
+	QTimer m_WaitTimer;
+	static RequestScheduler *m_Instance;
+
+	RequestScheduler(QObject *parent = 0);
+	void scheduleDispatch();
+};
+
+#endif /* REQUEST_SCHEDULER_H_ */
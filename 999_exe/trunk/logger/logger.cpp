@@ -0,0 +1,445 @@
+/*
+ * logger.cpp
+ *
+ *  Created on: 05/09/2011
+ *      Author: pc
+ */
+
+#include "logger.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QFile>
+#include "../registry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#ifdef Q_OS_WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @class Logger
+ * Writes structured entries, an event name plus up to three key and value
+ * fields, on client.log next to the exe. Any thread adds entries to a ring
+ * buffer without locking: it takes a slot with an atomic counter and copies the
+ * values into it, so nothing is allocated on the calling thread. A background
+ * thread writes them on the file and starts a new one when it grows past the
+ * log_file_size preference, keeping the two previous ones. If the buffer is full
+ * the entry is dropped and counted. Below the log_level preference a call costs
+ * only a comparison. When the program crashes the entries still on the buffer,
+ * the last log_buffer_size ones, are written on crash.log. The Qt warning and
+ * fatal messages are logged too.
+ */
+
+Logger::Level Logger::m_Level = Logger::Off;
+Logger* Logger::m_Instance = 0;
+
+// Milliseconds the writer sleeps when there is nothing to write.
+static const int WRITE_INTERVAL = 50;
+
+// Previous files kept when rotating.
+static const int ROTATED_FILES = 2;
+
+static const char *LEVEL_NAMES[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+
+// File name for the crash dump, ready before anything can go wrong.
+static char crashFileName[1024];
+
+/**
+ * Logs the Qt debug, warning and fatal messages.
+ */
+static void handleMessage(QtMsgType type, const char *msg)
+{
+	fprintf(stderr, "%s\n", msg);
+
+	Logger::Level level = (type == QtDebugMsg) ? Logger::Debug :
+			(type == QtWarningMsg) ? Logger::Warning : Logger::Error;
+
+	if (Logger::isEnabled(level))
+		Logger::log(level, "qt_message", "message", QString::fromLocal8Bit(msg));
+
+	if (type == QtFatalMsg)
+		abort();
+}
+
+/**
+ * Dumps the buffer when a signal ends the program and raises it again.
+ */
+static void handleSignal(int signal)
+{
+	Logger::crashed(signal);
+	raise(signal);
+}
+
+#ifdef Q_OS_WIN32
+/**
+ * Dumps the buffer on an unhandled exception.
+ */
+static LONG WINAPI handleException(EXCEPTION_POINTERS *exception)
+{
+	Logger::crashed(int(exception->ExceptionRecord->ExceptionCode));
+	return EXCEPTION_CONTINUE_SEARCH;
+}
+#endif
+
+/**
+ * Writes the text on the file without allocating, safe on a signal handler.
+ */
+static void writeText(int fd, const char *text, int size = -1)
+{
+	if (size == -1)
+		size = int(qstrlen(text));
+
+#ifdef Q_OS_WIN32
+	_write(fd, text, size);
+#else
+	if (write(fd, text, size) < 0)
+		return;
+#endif
+}
+
+/**
+ * Writes the number on the file without allocating.
+ */
+static void writeNumber(int fd, qint64 number)
+{
+	char text[24];
+	int i = sizeof(text);
+	bool isNegative = (number < 0);
+	quint64 value = isNegative ? quint64(-number) : quint64(number);
+
+	do {
+		text[--i] = char('0' + value % 10);
+		value /= 10;
+	} while (value > 0);
+
+	if (isNegative)
+		text[--i] = '-';
+
+	writeText(fd, text + i, sizeof(text) - i);
+}
+
+/**
+ * Constructs the logger with room for capacity entries, rounded up to a power of
+ * two, and starts the writer.
+ */
+Logger::Logger(int capacity, qint64 maxFileSize, QObject *parent)
+		: QThread(parent), m_MaxFileSize(maxFileSize)
+{
+	m_Capacity = 16;
+	while (m_Capacity < capacity)
+		m_Capacity *= 2;
+	m_Mask = m_Capacity - 1;
+
+	m_Entries = new LogEntry[m_Capacity];
+	for (int i = 0; i < m_Capacity; i++)
+		m_Entries[i].sequence = i;
+
+	m_Head = 0;
+	m_Tail = 0;
+	m_FileName = QApplication::applicationDirPath() + "/client.log";
+
+	qstrncpy(crashFileName, QFile::encodeName(QApplication::applicationDirPath()
+			+ "/crash.log").constData(), sizeof(crashFileName));
+
+	QThread::start(QThread::LowPriority);
+}
+
+/**
+ * Writes the entries left and stops the writer.
+ */
+Logger::~Logger()
+{
+	m_Level = Off;
+	m_IsStopping.fetchAndStoreOrdered(1);
+	wait();
+
+	m_Instance = 0;
+	delete[] m_Entries;
+}
+
+/**
+ * Creates the logger with the preferences and starts logging, unless the level
+ * is off.
+ */
+void Logger::init()
+{
+	if (m_Instance != 0)
+		return;
+
+	Registry *registry = Registry::instance();
+	QString level = registry->logLevel().toLower();
+
+	Level minimum = (level == "debug") ? Debug : (level == "info") ? Info :
+			(level == "error") ? Error : (level == "off") ? Off : Warning;
+
+	if (minimum == Off)
+		return;
+
+	m_Instance = new Logger(registry->logBufferSize(),
+			qint64(registry->logFileSize()) * 1024, qApp);
+
+	installCrashHandlers();
+	qInstallMsgHandler(handleMessage);
+
+	m_Level = minimum;
+}
+
+/**
+ * Returns the number of entries dropped because the buffer was full.
+ */
+int Logger::droppedCount()
+{
+	return int(m_Dropped);
+}
+
+/**
+ * Writes the entries on the file as they arrive.
+ */
+void Logger::run()
+{
+	QFile file(m_FileName);
+	file.open(QIODevice::Append);
+
+	bool isStopping = false;
+
+	while (!isStopping) {
+		isStopping = (m_IsStopping.fetchAndAddAcquire(0) != 0);
+
+		int written = 0;
+		int dropped = m_Dropped.fetchAndStoreOrdered(0);
+
+		for (;;) {
+			LogEntry *entry = &m_Entries[m_Tail & m_Mask];
+
+			if (entry->sequence.fetchAndAddAcquire(0) != m_Tail + 1)
+				break;
+
+			file.write(format(entry));
+			entry->sequence.fetchAndStoreRelease(m_Tail + m_Capacity);
+			m_Tail++;
+			written++;
+		}
+
+		if (dropped > 0) {
+			file.write(QDateTime::currentDateTime()
+					.toString("dd/MM/yyyy hh:mm:ss.zzz").toAscii()
+					+ " WARNING log_dropped count=\"" + QByteArray::number(dropped)
+					+ "\"\n");
+			written++;
+		}
+
+		if (written > 0) {
+			file.flush();
+
+			if (file.size() > m_MaxFileSize) {
+				file.close();
+				rotate();
+				file.open(QIODevice::Append);
+			}
+		}
+
+		if (!isStopping)
+			msleep(WRITE_INTERVAL);
+	}
+
+	file.close();
+}
+
+/**
+ * Copies the entry on the next free slot, or drops it if there is none.
+ */
+void Logger::add(Level level, const char *event, int fieldCount,
+		const char *key1, const QString *value1, const char *key2,
+		const QString *value2, const char *key3, const QString *value3)
+{
+	int position = m_Head.fetchAndAddAcquire(0);
+	LogEntry *entry;
+
+	for (;;) {
+		entry = &m_Entries[position & m_Mask];
+		int difference = entry->sequence.fetchAndAddAcquire(0) - position;
+
+		if (difference == 0) {
+			if (m_Head.testAndSetOrdered(position, position + 1))
+				break;
+		} else if (difference < 0) {
+			// The writer has not reached this slot yet.
+			m_Dropped.fetchAndAddRelaxed(1);
+			return;
+		}
+
+		position = m_Head.fetchAndAddAcquire(0);
+	}
+
+	entry->time = QDateTime::currentMSecsSinceEpoch();
+	entry->level = level;
+	entry->event = event;
+	entry->fieldCount = fieldCount;
+
+	const char *keys[] = {key1, key2, key3};
+	const QString *values[] = {value1, value2, value3};
+
+	for (int i = 0; i < fieldCount; i++) {
+		entry->keys[i] = keys[i];
+
+		const QChar *data = values[i]->unicode();
+		int size = qMin(values[i]->size(), LOG_VALUE_SIZE - 1);
+		char *value = entry->values[i];
+
+		for (int j = 0; j < size; j++) {
+			ushort code = data[j].unicode();
+			value[j] = (code < 0x20 || code > 0xFF) ? ' ' : char(code);
+		}
+		value[size] = '\0';
+	}
+
+	entry->sequence.fetchAndStoreRelease(position + 1);
+}
+
+/**
+ * Returns the entry as a line of text.
+ */
+QByteArray Logger::format(LogEntry *entry)
+{
+	QByteArray line = QDateTime::fromMSecsSinceEpoch(entry->time)
+			.toString("dd/MM/yyyy hh:mm:ss.zzz").toAscii();
+
+	line += ' ';
+	line += LEVEL_NAMES[entry->level];
+	line += ' ';
+	line += entry->event;
+
+	for (int i = 0; i < entry->fieldCount; i++) {
+		QByteArray value(entry->values[i]);
+		value.replace('"', '\'');
+
+		line += ' ';
+		line += entry->keys[i];
+		line += "=\"" + value + '"';
+	}
+
+	line += '\n';
+
+	return line;
+}
+
+/**
+ * Renames the file to client.1.log, the previous one to client.2.log and so on.
+ */
+void Logger::rotate()
+{
+	QString base = m_FileName.left(m_FileName.size() - 4);
+
+	QFile::remove(base + "." + QString::number(ROTATED_FILES) + ".log");
+
+	for (int i = ROTATED_FILES - 1; i > 0; i--)
+		QFile::rename(base + "." + QString::number(i) + ".log",
+				base + "." + QString::number(i + 1) + ".log");
+
+	QFile::rename(m_FileName, base + ".1.log");
+}
+
+/**
+ * Writes the entries on the buffer from the oldest to the newest, written or
+ * not. Nothing is allocated, it runs while crashing.
+ */
+void Logger::dump(int fd)
+{
+	int head = m_Head.fetchAndAddAcquire(0);
+
+	for (int i = 0; i < m_Capacity; i++) {
+		int slot = (head + i) & m_Mask;
+		LogEntry *entry = &m_Entries[slot];
+		int sequence = entry->sequence.fetchAndAddAcquire(0);
+
+		// Skips the slots never written. One being filled again at the moment of
+		// the crash may show mixed values.
+		bool isWritten = ((sequence - 1) & m_Mask) == slot
+				|| (sequence >= m_Capacity && ((sequence - m_Capacity) & m_Mask)
+						== slot);
+		if (!isWritten)
+			continue;
+
+		writeNumber(fd, entry->time);
+		writeText(fd, " ");
+		writeText(fd, LEVEL_NAMES[entry->level]);
+		writeText(fd, " ");
+		writeText(fd, entry->event);
+
+		for (int j = 0; j < entry->fieldCount; j++) {
+			writeText(fd, " ");
+			writeText(fd, entry->keys[j]);
+			writeText(fd, "=\"");
+			writeText(fd, entry->values[j],
+					int(qstrnlen(entry->values[j], LOG_VALUE_SIZE)));
+			writeText(fd, "\"");
+		}
+
+		writeText(fd, "\n");
+	}
+}
+
+/**
+ * Appends the entries on the buffer to crash.log. Time in milliseconds since
+ * 1970.
+ */
+void Logger::crashed(int cause)
+{
+	if (m_Instance == 0)
+		return;
+
+#ifdef Q_OS_WIN32
+	int fd = _open(crashFileName, _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY,
+			0644);
+#else
+	int fd = open(crashFileName, O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+
+	if (fd < 0)
+		return;
+
+	writeText(fd, "crash cause=");
+	writeNumber(fd, cause);
+	writeText(fd, " dropped=");
+	writeNumber(fd, int(m_Instance->m_Dropped));
+	writeText(fd, "\n");
+
+	m_Instance->dump(fd);
+
+	writeText(fd, "\n");
+
+#ifdef Q_OS_WIN32
+	_close(fd);
+#else
+	close(fd);
+#endif
+}
+
+/**
+ * Dumps the buffer when the program crashes.
+ */
+void Logger::installCrashHandlers()
+{
+#ifdef Q_OS_WIN32
+	SetUnhandledExceptionFilter(handleException);
+	signal(SIGABRT, handleSignal);
+#else
+	int signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+	for (int i = 0; i < int(sizeof(signals) / sizeof(signals[0])); i++) {
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler = handleSignal;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = SA_RESETHAND;
+		sigaction(signals[i], &action, 0);
+	}
+#endif
+}
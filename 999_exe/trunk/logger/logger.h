@@ -0,0 +1,108 @@
+/*
+ * logger.h
+ *
+ *  Created on: 05/09/2011
+ *      Author: pc
+ */
+
+#ifndef LOGGER_H_
+#define LOGGER_H_
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QString>
+
+// Fields every entry can carry and the characters kept of each value.
+const int LOG_MAX_FIELDS = 3;
+const int LOG_VALUE_SIZE = 80;
+
+struct LogEntry
+{
+	QAtomicInt sequence;
+	qint64 time;
+	int level;
+	const char *event;
+	int fieldCount;
+	const char *keys[LOG_MAX_FIELDS];
+	char values[LOG_MAX_FIELDS][LOG_VALUE_SIZE];
+};
+
+class Logger : public QThread
+{
+	Q_OBJECT
+
+public:
+	enum Level {Debug, Info, Warning, Error, Off};
+
+	virtual ~Logger();
+	int droppedCount();
+	static void init();
+	static void crashed(int cause);
+
+	/**
+	 * Returns true if the entries of the level are written.
+	 */
+	static inline bool isEnabled(Level level)
+	{
+		return level >= m_Level;
+	}
+
+	/**
+	 * Logs the event. The event and keys must be string literals.
+	 */
+	static inline void log(Level level, const char *event)
+	{
+		if (level >= m_Level)
+			m_Instance->add(level, event, 0, 0, 0, 0, 0, 0, 0);
+	}
+
+	static inline void log(Level level, const char *event, const char *key1,
+			const QString &value1)
+	{
+		if (level >= m_Level)
+			m_Instance->add(level, event, 1, key1, &value1, 0, 0, 0, 0);
+	}
+
+	static inline void log(Level level, const char *event, const char *key1,
+			const QString &value1, const char *key2, const QString &value2)
+	{
+		if (level >= m_Level)
+			m_Instance->add(level, event, 2, key1, &value1, key2, &value2, 0, 0);
+	}
+
+	static inline void log(Level level, const char *event, const char *key1,
+			const QString &value1, const char *key2, const QString &value2,
+			const char *key3, const QString &value3)
+	{
+		if (level >= m_Level)
+			m_Instance->add(level, event, 3, key1, &value1, key2, &value2, key3,
+					&value3);
+	}
+
+protected:
+	void run();
+
+private:
+	LogEntry *m_Entries;
+	int m_Capacity;
+	int m_Mask;
+	QAtomicInt m_Head;
+	int m_Tail;
+	QAtomicInt m_Dropped;
+	QAtomicInt m_IsStopping;
+	QString m_FileName;
+	qint64 m_MaxFileSize;
+	static Level m_Level;
+	static Logger *m_Instance;
+
+	Logger(int capacity, qint64 maxFileSize, QObject *parent = 0);
+	void add(Level level, const char *event, int fieldCount, const char *key1,
+			const QString *value1, const char *key2, const QString *value2,
+			const char *key3, const QString *value3);
+	QByteArray format(LogEntry *entry);
+	void rotate();
+	void dump(int fd);
+	static void installCrashHandlers();
+};
+
+#endif /* LOGGER_H_ */
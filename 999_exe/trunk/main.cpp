@@ -1,4 +1,5 @@
 #include "main_window.h"
+#include "logger/logger.h"
 
 #include <QtGui>
 #include <QApplication>
@@ -7,6 +8,7 @@
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    Logger::init();
 
     QTranslator translator;
     translator.load(":/resources/qt_es.qm");
@@ -4,6 +4,7 @@
 #include <QUrl>
 #include <QCloseEvent>
 #include <QDesktopServices>
+#include <QShortcut>
 #include "registry.h"
 #include "section/main_section.h"
 #include "cash_register_dialog/cash_register_dialog.h"
@@ -13,6 +14,10 @@
 #include "section/working_day_section.h"
 #include "../consult_product_dialog/consult_product_dialog.h"
 #include "../search_product/search_product_model.h"
+#include "diagnostics_dialog/diagnostics_dialog.h"
+#include "diagnostics/stall_detector.h"
+#include "web_cache/web_cache.h"
+#include "reference_data/reference_data.h"
 
 /**
  * @class MainWindow
@@ -30,18 +35,38 @@ MainWindow::MainWindow(QWidget *parent)
 	QWebSettings::globalSettings()->
 			setAttribute(QWebSettings::PluginsEnabled, true);
 
+	// Hidden shortcut, it is not on any menu.
+	QShortcut *shortcut = new QShortcut(QKeySequence(tr("Ctrl+Alt+D")), this);
+	connect(shortcut, SIGNAL(activated()), this, SLOT(showDiagnostics()));
+
+	// Starts watching the event loop.
+	StallDetector::instance();
+
 	m_IsSessionActive = false;
 	m_ServerUrl = Registry::instance()->serverUrl();
+
+	// Gets the styles and scripts on the disk cache for the first page.
+	WebCache::instance()->prewarm(*m_ServerUrl);
+
 	loadMainSection();
 }
 
 /**
  * Sets the isSessionActive property to the isActive boolean value.
- * The MainWindow will not close if the session still active.
+ * The MainWindow will not close if the session still active. The reference
+ * data is kept up to date only while the session is active.
  */
 void MainWindow::setIsSessionActive(bool isActive)
 {
 	m_IsSessionActive = isActive;
+
+	ReferenceData *data = ReferenceData::instance();
+	if (isActive) {
+		data->setServer(&m_CookieJar, *m_ServerUrl);
+		data->start();
+	} else {
+		data->stop();
+	}
 }
 
 /**
@@ -191,6 +216,15 @@ void MainWindow::openHelp()
 	QDesktopServices::openUrl(*(Registry::instance()->helpUrl()));
 }
 
+/**
+ * Shows the dialog with the latency of the server commands.
+ */
+void MainWindow::showDiagnostics()
+{
+	DiagnosticsDialog dialog(this, Qt::WindowTitleHint);
+	dialog.exec();
+}
+
 /**
  * Override closeEvent method for avoiding closing the MainWindow if the session
  * still active.
@@ -214,5 +248,6 @@ void MainWindow::setSection(Section *section)
 	connect(section, SIGNAL(sessionStatusChanged(bool)), this,
 				SLOT(setIsSessionActive(bool)));
 
+	StallDetector::instance()->setSection(section->metaObject()->className());
 	setCentralWidget(section);
 }
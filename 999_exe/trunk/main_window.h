@@ -25,6 +25,7 @@ public slots:
 	void loadWorkingDaySection();
 	void consultProduct();
 	void openHelp();
+	void showDiagnostics();
 
 protected:
 	void closeEvent(QCloseEvent *event);
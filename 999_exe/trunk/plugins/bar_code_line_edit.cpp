@@ -9,6 +9,9 @@
 
 #include <QPalette>
 #include <QRegExpValidator>
+#include "../diagnostics/trace_span.h"
+#include "../logger/logger.h"
+#include "../scanner/scanner_reader.h"
 
 /**
  * @class BarCodeLineEdit
@@ -20,6 +23,9 @@
  */
 BarCodeLineEdit::BarCodeLineEdit(QWidget *parent) : QLineEdit(parent)
 {
+	QRegExp rx("[^\\*]+\\*?[^\\*]*");
+	setValidator(new QRegExpValidator(rx, this));
+
 	connect(this, SIGNAL(returnPressed()), this, SLOT(returnKeyPressed()));
 }
 
@@ -36,10 +42,6 @@ void BarCodeLineEdit::init(const QStringList &argumentNames,
 	setPalette(pale);
 
 	setMaxLength(105);
-
-	QRegExp rx("[^\\*]+\\*?[^\\*]*");
-	QValidator *validator = new QRegExpValidator(rx, this);
-	setValidator(validator);
 }
 
 /**
@@ -47,17 +49,12 @@ void BarCodeLineEdit::init(const QStringList &argumentNames,
  */
 void BarCodeLineEdit::returnKeyPressed()
 {
-	QString barCode, quantity;
+	TraceSpan span("scan", true);
 
-	QStringList values = text().split("*");
+	QString barCode, quantity;
+	ScannerReader::parse(text(), &barCode, &quantity);
 
-	if (values.length() > 1) {
-		quantity = values[0];
-		barCode = values[1];
-	} else {
-		quantity = "1";
-		barCode = values [0];
-	}
+	Logger::log(Logger::Debug, "scan", "bar_code", barCode, "quantity", quantity);
 
 	emit returnPressedBarCode(barCode, quantity);
 }
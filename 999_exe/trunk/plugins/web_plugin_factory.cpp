@@ -10,6 +10,10 @@
 /**
  * @class PluginFactory
  * Class in charge of creating or passing widgets to the QWebPage for display.
+ * The installed widgets wait on the factory until a page asks for them. Once
+ * given the page owns the widget and deletes it when it is unloaded, so the
+ * widget is removed from the factory. The ones no page took are kept for the
+ * next load, the sections ask for them with widget() before creating new ones.
  */
 
 /**
@@ -20,16 +24,18 @@ WebPluginFactory::WebPluginFactory(QObject *parent) : QWebPluginFactory(parent)
 }
 
 /**
- * Returns the widget of the passed mime type.
+ * Returns the widget of the passed mime type. The widget is given to the page.
  */
 QObject* WebPluginFactory::create(const QString &mimeType, const QUrl &url,
 		const QStringList &argumentNames,
 		const QStringList &argumentValues) const
 {
-	if (m_Plugins.contains(mimeType)) {
-		PluginWidget *widget = m_Plugins[mimeType];
+	QObject *object = m_Plugins.take(mimeType);
+
+	if (object != NULL) {
+		PluginWidget *widget = dynamic_cast<PluginWidget*>(object);
 		widget->init(argumentNames, argumentValues);
-		return dynamic_cast<QObject*>(widget);
+		return object;
 	} else {
 		return NULL;
 	}
@@ -49,7 +55,7 @@ QList<QWebPluginFactory::Plugin> WebPluginFactory::plugins() const
  */
 void WebPluginFactory::install(QString mimeType, PluginWidget *widget)
 {
-	m_Plugins[mimeType] = widget;
+	m_Plugins[mimeType] = dynamic_cast<QObject*>(widget);
 }
 
 /**
@@ -59,3 +65,12 @@ void WebPluginFactory::remove(QString mimeType)
 {
 	m_Plugins.remove(mimeType);
 }
+
+/**
+ * Returns the widget of the passed mime type no page has taken yet or 0 if there
+ * is none.
+ */
+PluginWidget* WebPluginFactory::widget(QString mimeType)
+{
+	return dynamic_cast<PluginWidget*>(m_Plugins.value(mimeType).data());
+}
@@ -10,6 +10,7 @@
 
 #include <QWebPluginFactory>
 #include <QMap>
+#include <QPointer>
 #include "plugin_widget.h"
 
 class WebPluginFactory : public QWebPluginFactory
@@ -23,9 +24,10 @@ public:
 	QList<QWebPluginFactory::Plugin> plugins() const;
 	void install(QString mimeType, PluginWidget *widget);
 	void remove(QString mimeType);
+	PluginWidget* widget(QString mimeType);
 
 private:
-	QMap<QString, PluginWidget*> m_Plugins;
+	mutable QMap<QString, QPointer<QObject> > m_Plugins;
 };
 
 #endif /* WEB_PLUGIN_FACTORY_H_ */
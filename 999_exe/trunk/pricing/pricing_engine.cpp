@@ -0,0 +1,206 @@
+/*
+ * pricing_engine.cpp
+ *
+ *  Created on: 26/09/2011
+ *      Author: pc
+ */
+
+#include "pricing_engine.h"
+
+#include <QApplication>
+#include <QStringList>
+#include "../logger/logger.h"
+
+/**
+ * @class PricingEngine
+ * Computes the invoice amounts on the client with the same rounding rules the
+ * server uses, so they can be shown without waiting for a response. Amounts are
+ * kept in cents and percentages in hundredths of percent, there are no floating
+ * point operations. The rules mirrored are:
+ * line total = quantity * price,
+ * sub total = sum of the line totals, bonus lines included,
+ * discount = sub total * discount percentage / 100 rounded to cents,
+ * total = sub total - discount,
+ * vat = (sub total - unrounded discount) * vat percentage / 100 rounded to cents,
+ * change = cash + vouchers - total, never below zero.
+ * The results can be compared with the ones of the server, every difference is
+ * logged.
+ */
+
+PricingEngine* PricingEngine::m_Instance = 0;
+
+/**
+ * Constructs the engine without a V.A.T. percentage.
+ */
+PricingEngine::PricingEngine(QObject *parent) : QObject(parent)
+{
+	m_VatPercentage = -1;
+	m_DivergenceCount = 0;
+}
+
+/**
+ * Sets the V.A.T. percentage as returned by the server, e.g. 12.00.
+ */
+void PricingEngine::setVatPercentage(QString percentage)
+{
+	m_VatPercentage = PricingEngine::toCents(percentage);
+}
+
+/**
+ * Returns true if the V.A.T. percentage was obtained from the server.
+ */
+bool PricingEngine::hasVatPercentage()
+{
+	return m_VatPercentage >= 0;
+}
+
+/**
+ * Returns the V.A.T. percentage in hundredths, or -1 if it is unknown.
+ */
+qint64 PricingEngine::vatPercentage()
+{
+	return m_VatPercentage;
+}
+
+/**
+ * Computes the totals of the rows with quantity and price values and the
+ * discount percentage. The vat is 0 if the percentage is unknown.
+ */
+InvoiceTotals PricingEngine::invoiceTotals(QList<QMap<QString, QString>*> rows,
+		QString discountPercentage)
+{
+	qint64 percentage = PricingEngine::toCents(discountPercentage);
+
+	InvoiceTotals totals;
+	totals.subTotal = 0;
+
+	for (int i = 0; i < rows.size(); i++)
+		totals.subTotal += lineTotal(rows[i]->value("quantity").toInt(),
+				PricingEngine::toCents(rows[i]->value("price")));
+
+	totals.discount = discount(totals.subTotal, percentage);
+	totals.total = totals.subTotal - totals.discount;
+	totals.vat = hasVatPercentage()
+			? vat(totals.subTotal, percentage, m_VatPercentage) : 0;
+
+	return totals;
+}
+
+/**
+ * Compares the local amount in cents with the formatted one from the server.
+ * Logs the difference and returns false if they do not match.
+ */
+bool PricingEngine::crossCheck(const char *name, qint64 local, QString server)
+{
+	if (local == PricingEngine::toCents(server))
+		return true;
+
+	m_DivergenceCount++;
+	Logger::log(Logger::Warning, "pricing_divergence", "amount", name, "local",
+			PricingEngine::fromCents(local), "server", server);
+
+	return false;
+}
+
+/**
+ * Returns the number of differences found with the server.
+ */
+int PricingEngine::divergenceCount()
+{
+	return m_DivergenceCount;
+}
+
+/**
+ * Returns the only instance.
+ */
+PricingEngine* PricingEngine::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new PricingEngine(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Returns the total of a line in cents.
+ */
+qint64 PricingEngine::lineTotal(int quantity, qint64 price)
+{
+	return price * quantity;
+}
+
+/**
+ * Returns the discount in cents for the percentage in hundredths.
+ */
+qint64 PricingEngine::discount(qint64 subTotal, qint64 percentage)
+{
+	return roundedDivide(subTotal * percentage, 10000);
+}
+
+/**
+ * Returns the vat in cents of the sub total less the discount. The discount is
+ * not rounded first, as the server does it.
+ */
+qint64 PricingEngine::vat(qint64 subTotal, qint64 discountPercentage,
+		qint64 vatPercentage)
+{
+	return roundedDivide(subTotal * (10000 - discountPercentage) * vatPercentage,
+			100000000);
+}
+
+/**
+ * Returns the change in cents for the cash and vouchers received.
+ */
+qint64 PricingEngine::change(qint64 cash, qint64 vouchers, qint64 total)
+{
+	return qMax(cash + vouchers - total, Q_INT64_C(0));
+}
+
+/**
+ * Divides rounding half away from zero, the same as the server's round and
+ * number_format functions.
+ */
+qint64 PricingEngine::roundedDivide(qint64 dividend, qint64 divisor)
+{
+	qint64 half = divisor / 2;
+
+	return dividend >= 0 ? (dividend + half) / divisor
+			: -((-dividend + half) / divisor);
+}
+
+/**
+ * Returns the amount in cents. The amount can have thousands separators.
+ */
+qint64 PricingEngine::toCents(QString amount)
+{
+	amount = amount.remove(",").trimmed();
+
+	bool negative = amount.startsWith("-");
+	if (negative)
+		amount = amount.mid(1);
+
+	QStringList parts = amount.split(".");
+	qint64 cents = parts[0].toLongLong() * 100;
+
+	if (parts.size() > 1)
+		cents += (parts[1] + "00").left(2).toLongLong();
+
+	return negative ? -cents : cents;
+}
+
+/**
+ * Returns the cents as an amount with 2 decimals and thousands separators.
+ */
+QString PricingEngine::fromCents(qint64 cents)
+{
+	bool negative = cents < 0;
+	if (negative)
+		cents = -cents;
+
+	QString units = QString::number(cents / 100);
+	for (int i = units.size() - 3; i > 0; i -= 3)
+		units.insert(i, ",");
+
+	return (negative ? "-" : "") + units + "."
+			+ QString::number(cents % 100).rightJustified(2, '0');
+}
@@ -0,0 +1,56 @@
+/*
+ * pricing_engine.h
+ *
+ *  Created on: 26/09/2011
+ *      Author: pc
+ */
+
+#ifndef PRICING_ENGINE_H_
+#define PRICING_ENGINE_H_
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+struct InvoiceTotals
+{
+	qint64 subTotal;
+	qint64 discount;
+	qint64 total;
+	qint64 vat;
+};
+
+class PricingEngine : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~PricingEngine() {};
+	void setVatPercentage(QString percentage);
+	bool hasVatPercentage();
+	qint64 vatPercentage();
+	InvoiceTotals invoiceTotals(QList<QMap<QString, QString>*> rows,
+			QString discountPercentage);
+	bool crossCheck(const char *name, qint64 local, QString server);
+	int divergenceCount();
+	static PricingEngine* instance();
+
+	static qint64 lineTotal(int quantity, qint64 price);
+	static qint64 discount(qint64 subTotal, qint64 percentage);
+	static qint64 vat(qint64 subTotal, qint64 discountPercentage,
+			qint64 vatPercentage);
+	static qint64 change(qint64 cash, qint64 vouchers, qint64 total);
+	static qint64 roundedDivide(qint64 dividend, qint64 divisor);
+	static qint64 toCents(QString amount);
+	static QString fromCents(qint64 cents);
+
+private:
+	qint64 m_VatPercentage;
+	int m_DivergenceCount;
+	static PricingEngine *m_Instance;
+
+	PricingEngine(QObject *parent = 0);
+};
+
+#endif /* PRICING_ENGINE_H_ */
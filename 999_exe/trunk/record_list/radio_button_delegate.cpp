@@ -0,0 +1,70 @@
+/*
+ * radio_button_delegate.cpp
+ *
+ *  Created on: 14/11/2011
+ *      Author: pc
+ */
+
+#include "radio_button_delegate.h"
+
+#include <QApplication>
+#include <QStyle>
+#include <QStyleOptionButton>
+#include <QPainter>
+
+/**
+ * @class RadioButtonDelegate
+ * Paints a radio button on the column, checked if the row is selected, instead
+ * of having a QRadioButton widget on every row. The view must select whole rows
+ * one at a time.
+ */
+
+/**
+ * Constructs the delegate.
+ */
+RadioButtonDelegate::RadioButtonDelegate(QObject *parent)
+		: QStyledItemDelegate(parent)
+{
+
+}
+
+/**
+ * Paints the background of the item and the radio button centered on it.
+ */
+void RadioButtonDelegate::paint(QPainter *painter,
+		const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	Q_UNUSED(index);
+
+	QStyledItemDelegate::paint(painter, option, QModelIndex());
+
+	QStyle *style = QApplication::style();
+
+	QStyleOptionButton button;
+	button.state = QStyle::State_Enabled;
+	button.state |= (option.state & QStyle::State_Selected) ? QStyle::State_On
+			: QStyle::State_Off;
+
+	QRect indicator = style->subElementRect(QStyle::SE_RadioButtonIndicator,
+			&button);
+	button.rect = QStyle::alignedRect(option.direction, Qt::AlignCenter,
+			indicator.size(), option.rect);
+
+	style->drawPrimitive(QStyle::PE_IndicatorRadioButton, &button, painter);
+}
+
+/**
+ * Returns the size of the radio button with some margin.
+ */
+QSize RadioButtonDelegate::sizeHint(const QStyleOptionViewItem &option,
+		const QModelIndex &index) const
+{
+	Q_UNUSED(option);
+	Q_UNUSED(index);
+
+	QStyleOptionButton button;
+	QRect indicator = QApplication::style()
+			->subElementRect(QStyle::SE_RadioButtonIndicator, &button);
+
+	return indicator.size() + QSize(8, 4);
+}
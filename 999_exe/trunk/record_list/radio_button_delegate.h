@@ -0,0 +1,26 @@
+/*
+ * radio_button_delegate.h
+ *
+ *  Created on: 14/11/2011
+ *      Author: pc
+ */
+
+#ifndef RADIO_BUTTON_DELEGATE_H_
+#define RADIO_BUTTON_DELEGATE_H_
+
+#include <QStyledItemDelegate>
+
+class RadioButtonDelegate : public QStyledItemDelegate
+{
+	Q_OBJECT
+
+public:
+	RadioButtonDelegate(QObject *parent = 0);
+	virtual ~RadioButtonDelegate() {};
+	void paint(QPainter *painter, const QStyleOptionViewItem &option,
+			const QModelIndex &index) const;
+	QSize sizeHint(const QStyleOptionViewItem &option,
+			const QModelIndex &index) const;
+};
+
+#endif /* RADIO_BUTTON_DELEGATE_H_ */
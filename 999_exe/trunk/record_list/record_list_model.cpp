@@ -0,0 +1,160 @@
+/*
+ * record_list_model.cpp
+ *
+ *  Created on: 14/11/2011
+ *      Author: pc
+ */
+
+#include "record_list_model.h"
+
+/**
+ * @class RecordListModel
+ * Read only model for the lists received from the server, each row is one of
+ * the maps returned by the xml transformer. The columns show the values of the
+ * fields set, a field could be several joined with "-". The rows are given to
+ * the view in batches as it scrolls down, so nothing is created for the ones
+ * never shown.
+ */
+
+// Rows given to the view each time it asks for more.
+static const int BATCH_SIZE = 50;
+
+/**
+ * Constructs the model empty.
+ */
+RecordListModel::RecordListModel(QObject *parent) : QAbstractTableModel(parent)
+{
+	m_RowCount = 0;
+	m_BatchSize = BATCH_SIZE;
+}
+
+/**
+ * Destroys the list.
+ */
+RecordListModel::~RecordListModel()
+{
+	qDeleteAll(m_List);
+}
+
+/**
+ * Sets the fields shown on each column and their titles. A field like
+ * "serial_number-number" shows both values joined with "-".
+ */
+void RecordListModel::setColumns(QStringList fields, QStringList headers)
+{
+	beginResetModel();
+	m_Fields = fields;
+	m_Headers = headers;
+	endResetModel();
+}
+
+/**
+ * Replaces the rows. Takes ownership of the list.
+ */
+void RecordListModel::setList(QList<QMap<QString, QString>*> list)
+{
+	beginResetModel();
+	qDeleteAll(m_List);
+	m_List = list;
+	m_RowCount = qMin(m_BatchSize, m_List.size());
+	endResetModel();
+}
+
+/**
+ * Sets how many rows are given to the view at a time.
+ */
+void RecordListModel::setBatchSize(int size)
+{
+	m_BatchSize = qMax(size, 1);
+}
+
+/**
+ * Returns the value of the field on the row, shown or not yet.
+ */
+QString RecordListModel::value(int row, QString field) const
+{
+	if (row < 0 || row >= m_List.size())
+		return "";
+
+	if (!field.contains("-"))
+		return m_List.at(row)->value(field);
+
+	QStringList fields = field.split("-");
+	QStringList values;
+	for (int i = 0; i < fields.size(); i++)
+		values << m_List.at(row)->value(fields[i]);
+
+	return values.join("-");
+}
+
+/**
+ * Returns the number of rows on the list, shown or not yet.
+ */
+int RecordListModel::size()
+{
+	return m_List.size();
+}
+
+/**
+ * Returns the number of rows given to the view so far.
+ */
+int RecordListModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : m_RowCount;
+}
+
+/**
+ * Returns the number of fields set.
+ */
+int RecordListModel::columnCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : m_Fields.size();
+}
+
+/**
+ * Returns the value of the column's field on the row.
+ */
+QVariant RecordListModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || role != Qt::DisplayRole)
+		return QVariant();
+
+	return value(index.row(), m_Fields.value(index.column()));
+}
+
+/**
+ * Returns the title of the column.
+ */
+QVariant RecordListModel::headerData(int section, Qt::Orientation orientation,
+		int role) const
+{
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+		return QVariant();
+
+	return m_Headers.value(section);
+}
+
+/**
+ * Returns true while there are rows the view has not got.
+ */
+bool RecordListModel::canFetchMore(const QModelIndex &parent) const
+{
+	return !parent.isValid() && m_RowCount < m_List.size();
+}
+
+/**
+ * Gives the next batch of rows to the view.
+ */
+void RecordListModel::fetchMore(const QModelIndex &parent)
+{
+	if (parent.isValid())
+		return;
+
+	int count = qMin(m_BatchSize, m_List.size() - m_RowCount);
+	if (count <= 0)
+		return;
+
+	beginInsertRows(QModelIndex(), m_RowCount, m_RowCount + count - 1);
+	m_RowCount += count;
+	endInsertRows();
+}
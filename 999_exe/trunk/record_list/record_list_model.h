@@ -0,0 +1,44 @@
+/*
+ * record_list_model.h
+ *
+ *  Created on: 14/11/2011
+ *      Author: pc
+ */
+
+#ifndef RECORD_LIST_MODEL_H_
+#define RECORD_LIST_MODEL_H_
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QMap>
+#include <QStringList>
+
+class RecordListModel : public QAbstractTableModel
+{
+	Q_OBJECT
+
+public:
+	RecordListModel(QObject *parent = 0);
+	virtual ~RecordListModel();
+	void setColumns(QStringList fields, QStringList headers);
+	void setList(QList<QMap<QString, QString>*> list);
+	void setBatchSize(int size);
+	QString value(int row, QString field) const;
+	int size();
+	int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	QVariant headerData(int section, Qt::Orientation orientation,
+			int role = Qt::DisplayRole) const;
+	bool canFetchMore(const QModelIndex &parent) const;
+	void fetchMore(const QModelIndex &parent);
+
+private:
+	QList<QMap<QString, QString>*> m_List;
+	QStringList m_Fields;
+	QStringList m_Headers;
+	int m_RowCount;
+	int m_BatchSize;
+};
+
+#endif /* RECORD_LIST_MODEL_H_ */
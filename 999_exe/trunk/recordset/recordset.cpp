@@ -4,15 +4,27 @@
  * @class Recordset
  * Manages a recordset with the list with the ids of the document in use. It also
  * displays the position in which the recordset is at.
+ * The maps of the list belong to the recordset.
  */
 
 /**
- * Set the list the Recordset will use.
+ * Deletes the list.
+ */
+Recordset::~Recordset()
+{
+	qDeleteAll(m_List);
+}
+
+/**
+ * Set the list the Recordset will use. The previous list is deleted.
  */
 void Recordset::setList(QList<QMap<QString, QString>*> list)
 {
+	qDeleteAll(m_List);
+
 	m_List = list;
 	m_Iterator = m_List.begin();
+	m_Index = 0;
 }
 
 /**
@@ -104,6 +116,34 @@ QString Recordset::text()
 	return m_Text;
 }
 
+/**
+ * Returns the id of the record at the actual position.
+ */
+QString Recordset::currentId()
+{
+	return (m_Index >= 0 && m_Index < m_List.size()) ?
+			m_List.at(m_Index)->value("id") : "";
+}
+
+/**
+ * Returns the ids of the count records after and before the actual position,
+ * ordered by proximity with the next record first.
+ */
+QStringList Recordset::neighbourIds(int count)
+{
+	QStringList ids;
+
+	for (int i = 1; i <= count; i++) {
+		if (m_Index + i < m_List.size())
+			ids << m_List.at(m_Index + i)->value("id");
+
+		if (m_Index - i >= 0)
+			ids << m_List.at(m_Index - i)->value("id");
+	}
+
+	return ids;
+}
+
 /**
  * Sets the searcher this recordset will use.
  */
@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QList>
 #include <QMap>
+#include <QStringList>
 #include "recordset_searcher.h"
 
 class Recordset : public QObject
@@ -11,14 +12,16 @@ class Recordset : public QObject
     Q_OBJECT
 
 public:
-    Recordset() {};
-    ~Recordset() {};
+    Recordset() : m_Index(0), m_Searcher(0) {};
+    ~Recordset();
     void setList(QList<QMap<QString, QString>*> list);
     int size();
     bool isFirst();
     bool isLast();
     void refresh();
     QString text();
+    QString currentId();
+    QStringList neighbourIds(int count);
     void installSearcher(RecordsetSearcher *searcher);
     bool search(QString value);
 
@@ -0,0 +1,348 @@
+/*
+ * reference_data.cpp
+ *
+ *  Created on: 05/12/2011
+ *      Author: pc
+ */
+
+#include "reference_data.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QTextStream>
+#include "../registry.h"
+#include "../logger/logger.h"
+#include "../xml_transformer/xml_transformer_factory.h"
+#include "../sales_journal/product_catalog.h"
+
+/**
+ * @class ReferenceData
+ * Keeps the lists the dialogs choose from, the payment card types and brands,
+ * the banks and the shifts, and the V.A.T. percentage on the
+ * reference_data.txt file. They are fetched from the server in the background
+ * while the session is active, one request at a time, and listChanged is
+ * emitted for every list that is different from the one kept. The dialogs read
+ * them from here so they never wait for the server to open. The product
+ * catalog for pricing without connection is fetched the same way and handed to
+ * the ProductCatalog, which keeps it on its own file.
+ */
+
+struct ReferenceSource
+{
+	const char *name;
+	const char *cmd;
+	const char *transformer;
+	const char *idField;
+	const char *valueField;
+};
+
+// Lists kept and how to fetch them. The V.A.T. is kept as a list of one value
+// and the product catalog is not kept here.
+static const ReferenceSource SOURCES[] = {
+	{"payment_card_type_list", "get_payment_card_type_list",
+			"payment_card_type_list", "payment_card_type_id", "name"},
+	{"payment_card_brand_list", "get_payment_card_brand_list",
+			"payment_card_brand_list", "payment_card_brand_id", "name"},
+	{"bank_list", "get_bank_list", "bank_list", "bank_id", "name"},
+	{"shift_list", "get_shift_list", "shift_list", "shift_id", "name"},
+	{"vat_percentage", "get_vat_percentage", "object_property", "", "value"},
+	{"product_catalog", "get_product_catalog", "product_catalog", "bar_code",
+			"name"},
+	{0, 0, 0, 0, 0}
+};
+
+ReferenceData* ReferenceData::m_Instance = 0;
+
+/**
+ * Returns the index on SOURCES of the list or -1 if it is not there.
+ */
+static int sourceIndex(QString name)
+{
+	for (int i = 0; SOURCES[i].name != 0; i++)
+		if (name == SOURCES[i].name)
+			return i;
+
+	return -1;
+}
+
+/**
+ * Constructs the data with the refresh interval read from the Registry. The
+ * file is read the first time it is needed.
+ */
+ReferenceData::ReferenceData(QObject *parent) : QObject(parent)
+{
+	m_IsLoaded = false;
+
+	m_Request = 0;
+	m_Handler = new XmlResponseHandler(this);
+
+	m_Timer.setInterval(Registry::instance()->referenceSyncInterval() * 60000);
+
+	connect(&m_Timer, SIGNAL(timeout()), this, SLOT(sync()));
+}
+
+/**
+ * Returns the only instance.
+ */
+ReferenceData* ReferenceData::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new ReferenceData(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Sets the session and server to fetch the lists from.
+ */
+void ReferenceData::setServer(QNetworkCookieJar *jar, QUrl url)
+{
+	if (m_Request == 0) {
+		m_Request = new HttpRequest(jar, this);
+
+		connect(m_Request, SIGNAL(finished(QString)), this,
+				SLOT(listFetched(QString)), Qt::QueuedConnection);
+	}
+
+	m_ServerUrl = url;
+}
+
+/**
+ * Fetches all the lists now and then on every interval. Does nothing if it
+ * was already started.
+ */
+void ReferenceData::start()
+{
+	if (m_Timer.isActive())
+		return;
+
+	m_Timer.start();
+	sync();
+}
+
+/**
+ * Stops fetching the lists, the ones kept are still available.
+ */
+void ReferenceData::stop()
+{
+	m_Timer.stop();
+	m_PendingLists.clear();
+}
+
+/**
+ * Returns true if the list was ever fetched.
+ */
+bool ReferenceData::contains(QString name)
+{
+	if (!m_IsLoaded)
+		load();
+
+	return m_Lists.contains(name);
+}
+
+/**
+ * Returns the id and value pairs of the list.
+ */
+ReferenceList ReferenceData::list(QString name)
+{
+	if (!m_IsLoaded)
+		load();
+
+	return m_Lists.value(name);
+}
+
+/**
+ * Returns the V.A.T. percentage or an empty string if it was never fetched.
+ */
+QString ReferenceData::vatPercentage()
+{
+	return list("vat_percentage").value(0).second;
+}
+
+/**
+ * Replaces the items of the combo box with the list after an empty one. The
+ * item selected is kept if it is still on the list. If the list was never
+ * fetched it is asked for, listChanged tells when it arrives.
+ */
+void ReferenceData::fill(QComboBox *comboBox, QString name)
+{
+	if (!contains(name))
+		sync();
+
+	QString current = comboBox->itemData(comboBox->currentIndex()).toString();
+
+	comboBox->clear();
+	comboBox->addItem("", "");
+
+	ReferenceList items = list(name);
+	for (int i = 0; i < items.size(); i++)
+		comboBox->addItem(items[i].second, items[i].first);
+
+	int index = comboBox->findData(current);
+	comboBox->setCurrentIndex(index != -1 ? index : 0);
+}
+
+/**
+ * Queues all the lists for fetching. Only one request is sent at a time.
+ */
+void ReferenceData::sync()
+{
+	if (m_Request == 0)
+		return;
+
+	for (int i = 0; SOURCES[i].name != 0; i++) {
+		QString name = SOURCES[i].name;
+
+		if (name != m_FetchingList && !m_PendingLists.contains(name))
+			m_PendingLists << name;
+	}
+
+	if (m_FetchingList == "")
+		sendFetch();
+}
+
+/**
+ * Keeps the list received if it changed. Failures and connection errors keep
+ * the list as it was.
+ */
+void ReferenceData::listFetched(QString content)
+{
+	int source = sourceIndex(m_FetchingList);
+	if (source == -1)
+		return;
+
+	XmlTransformer *transformer = XmlTransformerFactory::instance()
+			->create(SOURCES[source].transformer);
+
+	QString errorMsg;
+	XmlResponseHandler::ResponseType response =
+			m_Handler->handle(content, transformer, &errorMsg);
+
+	if (response == XmlResponseHandler::Success
+			&& m_FetchingList == "product_catalog") {
+		ProductCatalog::instance()->update(transformer->content());
+	} else if (response == XmlResponseHandler::Success) {
+		QList<QMap<QString, QString>*> rows = transformer->content();
+
+		ReferenceList items;
+		for (int i = 0; i < rows.size(); i++)
+			items << qMakePair(rows[i]->value(SOURCES[source].idField),
+					rows[i]->value(SOURCES[source].valueField));
+
+		if (!m_IsLoaded)
+			load();
+
+		if (!m_Lists.contains(m_FetchingList)
+				|| m_Lists.value(m_FetchingList) != items) {
+			m_Lists.insert(m_FetchingList, items);
+			save();
+
+			Logger::log(Logger::Info, "reference_list_changed", "list",
+					m_FetchingList, "count", QString::number(items.size()));
+
+			emit listChanged(m_FetchingList);
+		}
+	} else {
+		Logger::log(Logger::Warning, "reference_sync_failed", "list",
+				m_FetchingList, "message", errorMsg);
+
+		// The server is not there, wait for the next interval.
+		if (response == XmlResponseHandler::Error)
+			m_PendingLists.clear();
+	}
+
+	delete transformer;
+
+	m_FetchingList = "";
+	sendFetch();
+}
+
+/**
+ * Reads the lists from the file.
+ */
+void ReferenceData::load()
+{
+	m_IsLoaded = true;
+
+	QFile file(fileName());
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	while (!stream.atEnd()) {
+		QString line = stream.readLine();
+
+		if (line.trimmed() == "" || line.startsWith("#"))
+			continue;
+
+		// An empty list is kept as a line with only its name.
+		QString name = line.section("|", 0, 0);
+		ReferenceList &items = m_Lists[name];
+
+		// The value goes last because it could have the separator.
+		if (line.contains("|"))
+			items << qMakePair(line.section("|", 1, 1), line.section("|", 2));
+	}
+
+	file.close();
+}
+
+/**
+ * Writes all the lists to the file.
+ */
+void ReferenceData::save()
+{
+	QFile file(fileName());
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate
+			| QIODevice::Text)) {
+		Logger::log(Logger::Warning, "reference_data_failed", "file", fileName());
+		return;
+	}
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	QHashIterator<QString, ReferenceList> i(m_Lists);
+	while (i.hasNext()) {
+		i.next();
+
+		if (i.value().isEmpty())
+			stream << i.key() << "\n";
+
+		for (int j = 0; j < i.value().size(); j++)
+			stream << i.key() << "|" << i.value()[j].first << "|"
+					<< i.value()[j].second << "\n";
+	}
+
+	file.close();
+}
+
+/**
+ * Asks the server for the next list on the queue.
+ */
+void ReferenceData::sendFetch()
+{
+	if (m_PendingLists.isEmpty())
+		return;
+
+	m_FetchingList = m_PendingLists.takeFirst();
+	int source = sourceIndex(m_FetchingList);
+
+	QUrl url(m_ServerUrl);
+	url.addQueryItem("cmd", SOURCES[source].cmd);
+	url.addQueryItem("type", "xml");
+
+	m_Request->defer(url);
+}
+
+/**
+ * Returns the path of the data file.
+ */
+QString ReferenceData::fileName()
+{
+	return QApplication::applicationDirPath() + "/reference_data.txt";
+}
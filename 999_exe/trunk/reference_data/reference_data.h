@@ -0,0 +1,68 @@
+/*
+ * reference_data.h
+ *
+ *  Created on: 05/12/2011
+ *      Author: pc
+ */
+
+#ifndef REFERENCE_DATA_H_
+#define REFERENCE_DATA_H_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+#include <QComboBox>
+#include <QNetworkCookieJar>
+#include "../http_request/http_request.h"
+#include "../xml_response_handler/xml_response_handler.h"
+
+typedef QList<QPair<QString, QString> > ReferenceList;
+
+class ReferenceData : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~ReferenceData() {};
+	void setServer(QNetworkCookieJar *jar, QUrl url);
+	void start();
+	void stop();
+	bool contains(QString name);
+	ReferenceList list(QString name);
+	QString vatPercentage();
+	void fill(QComboBox *comboBox, QString name);
+	static ReferenceData* instance();
+
+public slots:
+	void sync();
+
+signals:
+	void listChanged(QString name);
+
+private slots:
+	void listFetched(QString content);
+
+private:
+	QHash<QString, ReferenceList> m_Lists;
+	bool m_IsLoaded;
+
+	HttpRequest *m_Request;
+	XmlResponseHandler *m_Handler;
+	QUrl m_ServerUrl;
+	QTimer m_Timer;
+	QStringList m_PendingLists;
+	QString m_FetchingList;
+	static ReferenceData *m_Instance;
+
+	ReferenceData(QObject *parent = 0);
+	void load();
+	void save();
+	void sendFetch();
+	QString fileName();
+};
+
+#endif /* REFERENCE_DATA_H_ */
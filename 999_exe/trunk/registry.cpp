@@ -31,6 +31,25 @@ Registry::Registry(QObject *parent) : QObject(parent)
 	QString helpUrl;
 	QString printerName;
 	bool isTMUPrinter = IS_TMU_PRINTER;
+	int documentCacheSize = DOCUMENT_CACHE_SIZE;
+	int documentPrefetchCount = DOCUMENT_PREFETCH_COUNT;
+	int requestTimeout = REQUEST_TIMEOUT;
+	int traceBufferSize = TRACE_BUFFER_SIZE;
+	bool captureTraffic = CAPTURE_TRAFFIC;
+	int stallThreshold = STALL_THRESHOLD;
+	QString logLevel;
+	int logFileSize = LOG_FILE_SIZE;
+	int logBufferSize = LOG_BUFFER_SIZE;
+	bool pricingCrossCheck = PRICING_CROSS_CHECK;
+	QString scannerDevice;
+	QString scannerType;
+	int scannerBaudRate = SCANNER_BAUD_RATE;
+	int scanMergeInterval = SCAN_MERGE_INTERVAL;
+	int customerCacheSize = CUSTOMER_CACHE_SIZE;
+	int customerPrefetchCount = CUSTOMER_PREFETCH_COUNT;
+	int webCacheSize = WEB_CACHE_SIZE;
+	int referenceSyncInterval = REFERENCE_SYNC_INTERVAL;
+	int backgroundRequestLimit = BACKGROUND_REQUEST_LIMIT;
 
 	QFile file(QApplication::applicationDirPath() + "/preferences.txt");
 
@@ -65,6 +84,73 @@ Registry::Registry(QObject *parent) : QObject(parent)
 					printerName = params[1].trimmed();
 				} else if (params[0].trimmed() == "is_tmu_printer") {
 					isTMUPrinter = (params[1].trimmed() == "true");
+				} else if (params[0].trimmed() == "document_cache_size") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					documentCacheSize = (ok && value >= 0) ? value : documentCacheSize;
+				} else if (params[0].trimmed() == "document_prefetch_count") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					documentPrefetchCount =
+							(ok && value >= 0) ? value : documentPrefetchCount;
+				} else if (params[0].trimmed() == "request_timeout") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					requestTimeout = (ok && value >= 1) ? value : requestTimeout;
+				} else if (params[0].trimmed() == "trace_buffer_size") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					traceBufferSize = (ok && value >= 0) ? value : traceBufferSize;
+				} else if (params[0].trimmed() == "capture_traffic") {
+					captureTraffic = (params[1].trimmed() == "true");
+				} else if (params[0].trimmed() == "stall_threshold") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					stallThreshold = (ok && value >= 0) ? value : stallThreshold;
+				} else if (params[0].trimmed() == "log_level") {
+					logLevel = params[1].trimmed();
+				} else if (params[0].trimmed() == "log_file_size") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					logFileSize = (ok && value >= 1) ? value : logFileSize;
+				} else if (params[0].trimmed() == "log_buffer_size") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					logBufferSize = (ok && value >= 16) ? value : logBufferSize;
+				} else if (params[0].trimmed() == "pricing_cross_check") {
+					pricingCrossCheck = (params[1].trimmed() == "true");
+				} else if (params[0].trimmed() == "scanner_device") {
+					scannerDevice = params[1].trimmed();
+				} else if (params[0].trimmed() == "scanner_type") {
+					scannerType = params[1].trimmed();
+				} else if (params[0].trimmed() == "scanner_baud_rate") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					scannerBaudRate = (ok && value >= 1) ? value : scannerBaudRate;
+				} else if (params[0].trimmed() == "scan_merge_interval") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					scanMergeInterval = (ok && value >= 0) ? value : scanMergeInterval;
+				} else if (params[0].trimmed() == "customer_cache_size") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					customerCacheSize = (ok && value >= 0) ? value : customerCacheSize;
+				} else if (params[0].trimmed() == "customer_prefetch_count") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					customerPrefetchCount = (ok && value >= 0) ? value : customerPrefetchCount;
+				} else if (params[0].trimmed() == "web_cache_size") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					webCacheSize = (ok && value >= 1) ? value : webCacheSize;
+				} else if (params[0].trimmed() == "reference_sync_interval") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					referenceSyncInterval = (ok && value >= 1) ? value : referenceSyncInterval;
+				} else if (params[0].trimmed() == "background_request_limit") {
+					bool ok;
+					int value = params[1].trimmed().toInt(&ok);
+					backgroundRequestLimit = (ok && value >= 1) ? value : backgroundRequestLimit;
 				}
 			}
 		}
@@ -81,6 +167,25 @@ Registry::Registry(QObject *parent) : QObject(parent)
 	m_HelpUrl = new QUrl("http://" + helpUrl);
 	m_PrinterName = (printerName != "") ? printerName : PRINTER_NAME;
 	m_IsTMUPrinter = isTMUPrinter;
+	m_DocumentCacheSize = documentCacheSize;
+	m_DocumentPrefetchCount = documentPrefetchCount;
+	m_RequestTimeout = requestTimeout;
+	m_TraceBufferSize = traceBufferSize;
+	m_CaptureTraffic = captureTraffic;
+	m_StallThreshold = stallThreshold;
+	m_LogLevel = (logLevel != "") ? logLevel : LOG_LEVEL;
+	m_LogFileSize = logFileSize;
+	m_LogBufferSize = logBufferSize;
+	m_PricingCrossCheck = pricingCrossCheck;
+	m_ScannerDevice = scannerDevice;
+	m_ScannerType = (scannerType != "") ? scannerType : SCANNER_TYPE;
+	m_ScannerBaudRate = scannerBaudRate;
+	m_ScanMergeInterval = scanMergeInterval;
+	m_CustomerCacheSize = customerCacheSize;
+	m_CustomerPrefetchCount = customerPrefetchCount;
+	m_WebCacheSize = webCacheSize;
+	m_ReferenceSyncInterval = referenceSyncInterval;
+	m_BackgroundRequestLimit = backgroundRequestLimit;
 }
 
 /**
@@ -143,3 +248,160 @@ bool Registry::isTMUPrinter()
 {
 	return m_IsTMUPrinter;
 }
+
+/**
+ * Returns the maximum size in kilobytes of the document snapshot cache.
+ */
+int Registry::documentCacheSize()
+{
+	return m_DocumentCacheSize;
+}
+
+/**
+ * Returns how many documents before and after the actual one are prefetched.
+ */
+int Registry::documentPrefetchCount()
+{
+	return m_DocumentPrefetchCount;
+}
+
+/**
+ * Returns the seconds to wait for a response from the server.
+ */
+int Registry::requestTimeout()
+{
+	return m_RequestTimeout;
+}
+
+/**
+ * Returns how many spans the trace recorder keeps, zero disables it.
+ */
+int Registry::traceBufferSize()
+{
+	return m_TraceBufferSize;
+}
+
+/**
+ * Returns true if the requests to the server must be written on a traffic log.
+ */
+bool Registry::captureTraffic()
+{
+	return m_CaptureTraffic;
+}
+
+/**
+ * Returns the milliseconds without events that make a stall, 0 disables it.
+ */
+int Registry::stallThreshold()
+{
+	return m_StallThreshold;
+}
+
+/**
+ * Returns the lowest level of the messages written on the log.
+ */
+QString Registry::logLevel()
+{
+	return m_LogLevel;
+}
+
+/**
+ * Returns the kilobytes the log can grow before it is rotated.
+ */
+int Registry::logFileSize()
+{
+	return m_LogFileSize;
+}
+
+/**
+ * Returns the number of log entries kept in memory, also dumped on a crash.
+ */
+int Registry::logBufferSize()
+{
+	return m_LogBufferSize;
+}
+
+/**
+ * Returns true if the totals computed on the client are checked against the
+ * server ones.
+ */
+bool Registry::pricingCrossCheck()
+{
+	return m_PricingCrossCheck;
+}
+
+/**
+ * Returns the device the bar code scanner is read from, empty if it is read as
+ * keyboard input.
+ */
+QString Registry::scannerDevice()
+{
+	return m_ScannerDevice;
+}
+
+/**
+ * Returns how the scanner device is read: serial or evdev.
+ */
+QString Registry::scannerType()
+{
+	return m_ScannerType;
+}
+
+/**
+ * Returns the speed of the serial scanner.
+ */
+int Registry::scannerBaudRate()
+{
+	return m_ScannerBaudRate;
+}
+
+/**
+ * Returns the milliseconds a bar code waits for being scanned again before it is
+ * added, 0 if every scan is added at once.
+ */
+int Registry::scanMergeInterval()
+{
+	return m_ScanMergeInterval;
+}
+
+/**
+ * Returns the number of customers kept on the disk cache, 0 if they are not
+ * cached.
+ */
+int Registry::customerCacheSize()
+{
+	return m_CustomerCacheSize;
+}
+
+/**
+ * Returns the number of most frequent customers revalidated when the section
+ * starts.
+ */
+int Registry::customerPrefetchCount()
+{
+	return m_CustomerPrefetchCount;
+}
+
+/**
+ * Returns the size in megabytes of the disk cache for the web pages.
+ */
+int Registry::webCacheSize()
+{
+	return m_WebCacheSize;
+}
+
+/**
+ * Returns the minutes between each refresh of the reference data.
+ */
+int Registry::referenceSyncInterval()
+{
+	return m_ReferenceSyncInterval;
+}
+
+/**
+ * Returns how many background requests can wait for a response at a time.
+ */
+int Registry::backgroundRequestLimit()
+{
+	return m_BackgroundRequestLimit;
+}
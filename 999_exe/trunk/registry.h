@@ -16,6 +16,24 @@ const QString XSL_URL = "127.0.0.1/bobs/xsl/";
 const QString HELP_URL = "127.0.0.1/bobs/";
 const QString PRINTER_NAME = "EPSON TM-U220 Receipt";
 const bool IS_TMU_PRINTER = true;
+const int DOCUMENT_CACHE_SIZE = 4096;
+const int DOCUMENT_PREFETCH_COUNT = 2;
+const int REQUEST_TIMEOUT = 30;
+const int TRACE_BUFFER_SIZE = 4096;
+const bool CAPTURE_TRAFFIC = false;
+const int STALL_THRESHOLD = 150;
+const QString LOG_LEVEL = "warning";
+const int LOG_FILE_SIZE = 1024;
+const int LOG_BUFFER_SIZE = 1024;
+const bool PRICING_CROSS_CHECK = false;
+const QString SCANNER_TYPE = "serial";
+const int SCANNER_BAUD_RATE = 9600;
+const int SCAN_MERGE_INTERVAL = 400;
+const int CUSTOMER_CACHE_SIZE = 500;
+const int CUSTOMER_PREFETCH_COUNT = 50;
+const int WEB_CACHE_SIZE = 50;
+const int REFERENCE_SYNC_INTERVAL = 30;
+const int BACKGROUND_REQUEST_LIMIT = 1;
 
 class Registry : public QObject
 {
@@ -28,6 +46,25 @@ public:
 	QUrl* helpUrl();
 	QString printerName();
 	bool isTMUPrinter();
+	int documentCacheSize();
+	int documentPrefetchCount();
+	int requestTimeout();
+	int traceBufferSize();
+	bool captureTraffic();
+	int stallThreshold();
+	QString logLevel();
+	int logFileSize();
+	int logBufferSize();
+	bool pricingCrossCheck();
+	QString scannerDevice();
+	QString scannerType();
+	int scannerBaudRate();
+	int scanMergeInterval();
+	int customerCacheSize();
+	int customerPrefetchCount();
+	int webCacheSize();
+	int referenceSyncInterval();
+	int backgroundRequestLimit();
 	static Registry* instance();
 
 private:
@@ -36,6 +73,25 @@ private:
 	QUrl *m_HelpUrl;
 	QString m_PrinterName;
 	bool m_IsTMUPrinter;
+	int m_DocumentCacheSize;
+	int m_DocumentPrefetchCount;
+	int m_RequestTimeout;
+	int m_TraceBufferSize;
+	bool m_CaptureTraffic;
+	int m_StallThreshold;
+	QString m_LogLevel;
+	int m_LogFileSize;
+	int m_LogBufferSize;
+	bool m_PricingCrossCheck;
+	QString m_ScannerDevice;
+	QString m_ScannerType;
+	int m_ScannerBaudRate;
+	int m_ScanMergeInterval;
+	int m_CustomerCacheSize;
+	int m_CustomerPrefetchCount;
+	int m_WebCacheSize;
+	int m_ReferenceSyncInterval;
+	int m_BackgroundRequestLimit;
 	static Registry *m_Instance;
 
 	Registry(QObject *parent = 0);
@@ -0,0 +1,258 @@
+/*
+ * journal_replayer.cpp
+ *
+ *  Created on: 11/07/2011
+ *      Author: pc
+ */
+
+#include "journal_replayer.h"
+
+#include "sales_journal.h"
+#include "../xml_transformer/xml_transformer_factory.h"
+
+/**
+ * @class JournalReplayer
+ * Sends the invoices on the sales journal to the server in the order they were
+ * made. Every invoice is created again with the same commands the SalesSection
+ * uses. Whatever the server does not accept is reported as a conflict and
+ * recorded on the journal, so the invoice is never sent twice.
+ */
+
+/**
+ * Constructs the replayer.
+ */
+JournalReplayer::JournalReplayer(QNetworkCookieJar *jar, QUrl *serverUrl,
+		QObject *parent) : QObject(parent), m_ServerUrl(serverUrl)
+{
+	m_Request = new HttpRequest(jar, this);
+	m_Handler = new XmlResponseHandler(this);
+
+	connect(m_Handler, SIGNAL(sessionStatusChanged(bool)), this,
+			SIGNAL(sessionStatusChanged(bool)));
+}
+
+/**
+ * Sends all the pending invoices. Stops if the connection or the session are
+ * lost. Returns the number of invoices created on the server.
+ */
+int JournalReplayer::replay()
+{
+	QList<OfflineInvoice*> invoices = SalesJournal::instance()->pendingInvoices();
+	int count = 0;
+	bool isInterrupted = false;
+
+	for (int i = 0; i < invoices.size() && !isInterrupted; i++) {
+		OfflineInvoice *invoice = invoices[i];
+		QString invoiceId;
+
+		switch (replayInvoice(invoice, &invoiceId)) {
+			case Replayed:
+				count++;
+				emit invoiceReplayed(invoice->id(), invoiceId);
+				break;
+
+			case Interrupted:
+				isInterrupted = true;
+				break;
+
+			default:;
+		}
+	}
+
+	qDeleteAll(invoices);
+
+	return count;
+}
+
+/**
+ * Creates the invoice on the server.
+ */
+JournalReplayer::ReplayStatus JournalReplayer::replayInvoice(
+		OfflineInvoice *invoice, QString *invoiceId)
+{
+	QString errorMsg;
+	QMap<QString, QString> params;
+
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", "create_invoice");
+	url.addQueryItem("register_key", invoice->registerKey());
+	url.addQueryItem("type", "xml");
+
+	// Nothing was sent yet, it can be tried again later.
+	if (execute(url, "invoice", &errorMsg, &params) != XmlResponseHandler::Success)
+		return Interrupted;
+
+	QString invoiceKey = params.value("key");
+
+	// From now on the invoice could be saved on the server, so an interruption
+	// must not be replayed again.
+	record("replaying", invoice->id());
+
+	if (invoice->nit() != "") {
+		url = *m_ServerUrl;
+		url.addQueryItem("cmd", "get_customer");
+		url.addQueryItem("nit", invoice->nit());
+		url.addQueryItem("type", "xml");
+
+		if (execute(url, "customer", &errorMsg, &params) ==
+				XmlResponseHandler::Success) {
+			QString customerKey = params.value("key");
+
+			if (invoice->name() != "" && invoice->name() != params.value("name")) {
+				url = *m_ServerUrl;
+				url.addQueryItem("cmd", "set_name_object");
+				url.addQueryItem("value", invoice->name());
+				url.addQueryItem("key", customerKey);
+				url.addQueryItem("type", "xml");
+
+				execute(url, "stub", &errorMsg);
+			}
+
+			url = *m_ServerUrl;
+			url.addQueryItem("cmd", "save_object");
+			url.addQueryItem("key", customerKey);
+			url.addQueryItem("type", "xml");
+
+			if (execute(url, "stub", &errorMsg) == XmlResponseHandler::Success) {
+				url = *m_ServerUrl;
+				url.addQueryItem("cmd", "set_customer_invoice");
+				url.addQueryItem("key", invoiceKey);
+				url.addQueryItem("customer_key", customerKey);
+				url.addQueryItem("type", "xml");
+
+				execute(url, "invoice_customer", &errorMsg);
+			}
+
+			removeFromSession(customerKey);
+		}
+
+		if (errorMsg != "") {
+			record("conflict", invoice->id(), "message", "Cliente " + invoice->nit()
+					+ ": " + errorMsg);
+			emit conflictFound(invoice->id(), errorMsg);
+			errorMsg = "";
+		}
+	}
+
+	QList<QMap<QString, QString>*> lines = invoice->lines();
+	for (int i = 0; i < lines.size(); i++) {
+		url = *m_ServerUrl;
+		url.addQueryItem("cmd", "add_product_invoice");
+		url.addQueryItem("key", invoiceKey);
+		url.addQueryItem("bar_code", lines[i]->value("bar_code"));
+		url.addQueryItem("quantity", lines[i]->value("quantity"));
+		url.addQueryItem("type", "xml");
+
+		if (execute(url, "stub", &errorMsg) != XmlResponseHandler::Success) {
+			QString msg = "Producto " + lines[i]->value("bar_code") + ": " + errorMsg;
+			record("conflict", invoice->id(), "message", msg);
+			emit conflictFound(invoice->id(), msg);
+		}
+	}
+
+	ReplayStatus status = Failed;
+	QString cashReceiptKey;
+
+	url = *m_ServerUrl;
+	url.addQueryItem("cmd", "create_cash_receipt");
+	url.addQueryItem("invoice_key", invoiceKey);
+	url.addQueryItem("type", "xml");
+
+	if (execute(url, "object_key", &errorMsg, &params) ==
+			XmlResponseHandler::Success) {
+		cashReceiptKey = params.value("key");
+
+		url = *m_ServerUrl;
+		url.addQueryItem("cmd", "set_cash_cash_receipt");
+		url.addQueryItem("key", cashReceiptKey);
+		url.addQueryItem("amount", invoice->cash());
+		url.addQueryItem("type", "xml");
+
+		if (execute(url, "change", &errorMsg) == XmlResponseHandler::Success) {
+			url = *m_ServerUrl;
+			url.addQueryItem("cmd", "save_object");
+			url.addQueryItem("key", cashReceiptKey);
+			url.addQueryItem("type", "xml");
+
+			if (execute(url, "object_id", &errorMsg, &params) ==
+					XmlResponseHandler::Success) {
+				*invoiceId = params.value("id");
+				status = Replayed;
+			}
+		}
+	}
+
+	if (status == Replayed) {
+		record("replayed", invoice->id(), "invoice_id", *invoiceId);
+	} else {
+		record("failed", invoice->id(), "message", errorMsg);
+		emit conflictFound(invoice->id(), errorMsg);
+
+		url = *m_ServerUrl;
+		url.addQueryItem("cmd", "discard_document");
+		url.addQueryItem("key", invoiceKey);
+		url.addQueryItem("type", "xml");
+
+		execute(url, "stub", &errorMsg);
+	}
+
+	if (cashReceiptKey != "")
+		removeFromSession(cashReceiptKey);
+	removeFromSession(invoiceKey);
+
+	return status;
+}
+
+/**
+ * Sends the command and handles the response. Copies the first row of the
+ * transformer's content on params.
+ */
+XmlResponseHandler::ResponseType JournalReplayer::execute(QUrl url,
+		QString transformerName, QString *errorMsg, QMap<QString, QString> *params)
+{
+	QString content = m_Request->get(url);
+
+	XmlTransformer *transformer = XmlTransformerFactory::instance()
+			->create(transformerName);
+
+	XmlResponseHandler::ResponseType response =
+			m_Handler->handle(content, transformer, errorMsg);
+
+	if (response == XmlResponseHandler::Success && params != 0) {
+		QList<QMap<QString, QString>*> list = transformer->content();
+		*params = list.isEmpty() ? QMap<QString, QString>() : *list[0];
+	}
+
+	delete transformer;
+
+	return response;
+}
+
+/**
+ * Removes the object from the session on the server.
+ */
+void JournalReplayer::removeFromSession(QString key)
+{
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", "remove_session_object");
+	url.addQueryItem("key", key);
+	url.addQueryItem("type", "xml");
+
+	m_Request->get(url);
+}
+
+/**
+ * Appends a record about the invoice on the journal.
+ */
+void JournalReplayer::record(QString type, QString localId, QString name,
+		QString value)
+{
+	QMap<QString, QString> record;
+	record.insert("type", type);
+	record.insert("invoice", localId);
+
+	if (name != "")
+		record.insert(name, value);
+
+	SalesJournal::instance()->append(record);
+}
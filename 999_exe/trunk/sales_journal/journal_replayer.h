@@ -0,0 +1,46 @@
+/*
+ * journal_replayer.h
+ *
+ *  Created on: 11/07/2011
+ *      Author: pc
+ */
+
+#ifndef JOURNAL_REPLAYER_H_
+#define JOURNAL_REPLAYER_H_
+
+#include <QObject>
+#include <QUrl>
+#include <QNetworkCookieJar>
+#include "../http_request/http_request.h"
+#include "../xml_response_handler/xml_response_handler.h"
+#include "offline_invoice.h"
+
+class JournalReplayer : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum ReplayStatus {Replayed, Failed, Interrupted};
+	JournalReplayer(QNetworkCookieJar *jar, QUrl *serverUrl, QObject *parent = 0);
+	virtual ~JournalReplayer() {};
+	int replay();
+
+signals:
+	void invoiceReplayed(QString localId, QString invoiceId);
+	void conflictFound(QString localId, QString message);
+	void sessionStatusChanged(bool isActive);
+
+private:
+	HttpRequest *m_Request;
+	XmlResponseHandler *m_Handler;
+	QUrl *m_ServerUrl;
+
+	ReplayStatus replayInvoice(OfflineInvoice *invoice, QString *invoiceId);
+	XmlResponseHandler::ResponseType execute(QUrl url, QString transformerName,
+			QString *errorMsg, QMap<QString, QString> *params = 0);
+	void removeFromSession(QString key);
+	void record(QString type, QString localId, QString name = "",
+			QString value = "");
+};
+
+#endif /* JOURNAL_REPLAYER_H_ */
@@ -0,0 +1,216 @@
+/*
+ * offline_invoice.cpp
+ *
+ *  Created on: 11/07/2011
+ *      Author: pc
+ */
+
+#include "offline_invoice.h"
+
+#include "../pricing/pricing_engine.h"
+
+/**
+ * @class OfflineInvoice
+ * Invoice created while there is no connection with the server. The amounts are
+ * computed in cents to avoid rounding errors.
+ */
+
+/**
+ * Constructs the invoice.
+ */
+OfflineInvoice::OfflineInvoice(QString id, QString registerKey,
+		QString dateTime) : m_Id(id), m_RegisterKey(registerKey),
+		m_DateTime(dateTime)
+{
+
+}
+
+/**
+ * Destroys the lines.
+ */
+OfflineInvoice::~OfflineInvoice()
+{
+	qDeleteAll(m_Lines);
+}
+
+/**
+ * Returns the local id.
+ */
+QString OfflineInvoice::id()
+{
+	return m_Id;
+}
+
+/**
+ * Returns the key of the cash register on which the invoice was made.
+ */
+QString OfflineInvoice::registerKey()
+{
+	return m_RegisterKey;
+}
+
+/**
+ * Returns the date and time of creation.
+ */
+QString OfflineInvoice::dateTime()
+{
+	return m_DateTime;
+}
+
+/**
+ * Sets the customer's data.
+ */
+void OfflineInvoice::setCustomer(QString nit, QString name)
+{
+	m_Nit = nit;
+	m_Name = name;
+}
+
+/**
+ * Returns the customer's nit.
+ */
+QString OfflineInvoice::nit()
+{
+	return m_Nit;
+}
+
+/**
+ * Returns the customer's name.
+ */
+QString OfflineInvoice::name()
+{
+	return m_Name;
+}
+
+/**
+ * Adds a line with the product.
+ */
+void OfflineInvoice::addProduct(QString barCode, QString name, int quantity,
+		QString price)
+{
+	QMap<QString, QString> *line = new QMap<QString, QString>();
+	line->insert("bar_code", barCode);
+	line->insert("name", name);
+	line->insert("quantity", QString::number(quantity));
+	line->insert("price", price);
+
+	m_Lines << line;
+}
+
+/**
+ * Removes the line on the row, counting from 1. Returns false if there is not
+ * such row.
+ */
+bool OfflineInvoice::deleteProduct(int row)
+{
+	if (row < 1 || row > m_Lines.size())
+		return false;
+
+	delete m_Lines.takeAt(row - 1);
+
+	return true;
+}
+
+/**
+ * Returns the lines of the invoice.
+ */
+QList<QMap<QString, QString>*> OfflineInvoice::lines()
+{
+	return m_Lines;
+}
+
+/**
+ * Sets the cash amount received.
+ */
+void OfflineInvoice::setCash(QString cash)
+{
+	m_Cash = cash;
+}
+
+/**
+ * Returns the cash amount received.
+ */
+QString OfflineInvoice::cash()
+{
+	return m_Cash;
+}
+
+/**
+ * Returns the invoice total formatted.
+ */
+QString OfflineInvoice::total()
+{
+	return PricingEngine::fromCents(totalCents());
+}
+
+/**
+ * Returns the change for the cash received formatted.
+ */
+QString OfflineInvoice::change()
+{
+	return PricingEngine::fromCents(PricingEngine::change(PricingEngine::toCents(m_Cash), 0, totalCents()));
+}
+
+/**
+ * Returns the sum of the quantities.
+ */
+int OfflineInvoice::totalItems()
+{
+	int items = 0;
+
+	for (int i = 0; i < m_Lines.size(); i++)
+		items += m_Lines[i]->value("quantity").toInt();
+
+	return items;
+}
+
+/**
+ * Returns the details in the same xml format the server uses, so they can be
+ * displayed with the same style sheet.
+ */
+QString OfflineInvoice::detailsXml()
+{
+	QString total = PricingEngine::fromCents(totalCents());
+
+	QString xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?><response>"
+			"<success>1</success><params>"
+			"<sub_total>" + total + "</sub_total>"
+			"<discount_percentage>0.00</discount_percentage>"
+			"<discount>0.00</discount>"
+			"<total>" + total + "</total>"
+			"<total_items>" + QString::number(totalItems()) + "</total_items>"
+			"</params><grid>";
+
+	for (int i = 0; i < m_Lines.size(); i++) {
+		QMap<QString, QString> *line = m_Lines[i];
+		qint64 price = PricingEngine::toCents(line->value("price"));
+		QString pos = QString::number(i + 1);
+
+		xml += "<row><row_pos>" + pos + "</row_pos><is_bonus>0</is_bonus>"
+				"<percentage>0</percentage><detail_id>" + pos + "</detail_id>"
+				"<product><![CDATA[" + line->value("name").left(42) + "]]></product>"
+				"<quantity>" + line->value("quantity") + "</quantity>"
+				"<price>" + PricingEngine::fromCents(price) + "</price>"
+				"<total>" + PricingEngine::fromCents(PricingEngine::lineTotal(
+						line->value("quantity").toInt(), price))
+				+ "</total></row>";
+	}
+
+	xml += "</grid></response>";
+
+	return xml;
+}
+
+/**
+ * Returns the sum of the lines in cents.
+ */
+qint64 OfflineInvoice::totalCents()
+{
+	qint64 total = 0;
+
+	for (int i = 0; i < m_Lines.size(); i++)
+		total += PricingEngine::lineTotal(m_Lines[i]->value("quantity").toInt(),
+				PricingEngine::toCents(m_Lines[i]->value("price")));
+
+	return total;
+}
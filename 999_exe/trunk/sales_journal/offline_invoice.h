@@ -0,0 +1,48 @@
+/*
+ * offline_invoice.h
+ *
+ *  Created on: 11/07/2011
+ *      Author: pc
+ */
+
+#ifndef OFFLINE_INVOICE_H_
+#define OFFLINE_INVOICE_H_
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+class OfflineInvoice
+{
+public:
+	OfflineInvoice(QString id, QString registerKey, QString dateTime);
+	virtual ~OfflineInvoice();
+	QString id();
+	QString registerKey();
+	QString dateTime();
+	void setCustomer(QString nit, QString name);
+	QString nit();
+	QString name();
+	void addProduct(QString barCode, QString name, int quantity, QString price);
+	bool deleteProduct(int row);
+	QList<QMap<QString, QString>*> lines();
+	void setCash(QString cash);
+	QString cash();
+	QString total();
+	QString change();
+	int totalItems();
+	QString detailsXml();
+
+private:
+	QString m_Id;
+	QString m_RegisterKey;
+	QString m_DateTime;
+	QString m_Nit;
+	QString m_Name;
+	QString m_Cash;
+	QList<QMap<QString, QString>*> m_Lines;
+
+	qint64 totalCents();
+};
+
+#endif /* OFFLINE_INVOICE_H_ */
@@ -0,0 +1,188 @@
+/*
+ * product_catalog.cpp
+ *
+ *  Created on: 11/07/2011
+ *      Author: pc
+ */
+
+#include "product_catalog.h"
+
+#include <QApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include "../logger/logger.h"
+
+/**
+ * @class ProductCatalog
+ * Local replica of the products catalog read from the product_catalog.txt file
+ * located in the same path of the exe. Each line has the bar code, the name and
+ * the price of a product separated by "|". Used for pricing when there is no
+ * connection with the server. The ReferenceData replaces it with the one on the
+ * server while the session is active.
+ */
+
+ProductCatalog* ProductCatalog::m_Instance = 0;
+
+/**
+ * Constructs the catalog. The file is read the first time it is needed.
+ */
+ProductCatalog::ProductCatalog(QObject *parent) : QObject(parent)
+{
+	m_IsLoaded = false;
+}
+
+/**
+ * Returns the only instance.
+ */
+ProductCatalog* ProductCatalog::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new ProductCatalog(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Copies the name and price of the product with the bar code. Returns false if
+ * it is not on the catalog.
+ */
+bool ProductCatalog::find(QString barCode, QString *name, QString *price)
+{
+	if (!m_IsLoaded)
+		load();
+
+	if (!m_Prices.contains(barCode))
+		return false;
+
+	*name = m_Names.value(barCode);
+	*price = m_Prices.value(barCode);
+
+	return true;
+}
+
+/**
+ * Returns the number of products on the catalog.
+ */
+int ProductCatalog::size()
+{
+	if (!m_IsLoaded)
+		load();
+
+	return m_Prices.size();
+}
+
+/**
+ * Reads the file again.
+ */
+void ProductCatalog::reload()
+{
+	m_Names.clear();
+	m_Prices.clear();
+	load();
+}
+
+/**
+ * Replaces the products with the ones from the server if they changed. The file
+ * is written aside first and then put in place, so an interruption keeps the
+ * previous catalog. Returns false if it could not be written.
+ */
+bool ProductCatalog::update(QList<QMap<QString, QString>*> products)
+{
+	if (!m_IsLoaded)
+		load();
+
+	QHash<QString, QString> names;
+	QHash<QString, QString> prices;
+
+	for (int i = 0; i < products.size(); i++) {
+		QString barCode = products[i]->value("bar_code").trimmed();
+
+		if (barCode == "")
+			continue;
+
+		names.insert(barCode, products[i]->value("name").simplified());
+		prices.insert(barCode, products[i]->value("price").trimmed());
+	}
+
+	if (names == m_Names && prices == m_Prices)
+		return true;
+
+	QFile file(fileName() + ".tmp");
+
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		Logger::log(Logger::Warning, "product_catalog_failed", "file",
+				file.fileName());
+		return false;
+	}
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	QHashIterator<QString, QString> i(prices);
+	while (i.hasNext()) {
+		i.next();
+		stream << i.key() << "|" << names.value(i.key()).replace("|", " ") << "|"
+				<< i.value() << "\n";
+	}
+
+	stream.flush();
+	file.close();
+
+	QFile::remove(fileName());
+	if (!file.rename(fileName())) {
+		Logger::log(Logger::Warning, "product_catalog_failed", "file",
+				fileName());
+		return false;
+	}
+
+	m_Names = names;
+	m_Prices = prices;
+
+	Logger::log(Logger::Info, "product_catalog_changed", "count",
+			QString::number(m_Prices.size()));
+
+	return true;
+}
+
+/**
+ * Reads the products from the file.
+ */
+void ProductCatalog::load()
+{
+	m_IsLoaded = true;
+
+	QFile file(fileName());
+
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	while (!stream.atEnd()) {
+		QString line = stream.readLine().trimmed();
+
+		if (line == "" || line.startsWith("#"))
+			continue;
+
+		QStringList values = line.split("|");
+
+		if (values.size() < 3)
+			continue;
+
+		QString barCode = values[0].trimmed();
+		m_Names.insert(barCode, values[1].trimmed());
+		m_Prices.insert(barCode, values[2].trimmed());
+	}
+
+	file.close();
+}
+
+/**
+ * Returns the path of the catalog file.
+ */
+QString ProductCatalog::fileName()
+{
+	return QApplication::applicationDirPath() + "/product_catalog.txt";
+}
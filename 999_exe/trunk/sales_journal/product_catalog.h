@@ -0,0 +1,40 @@
+/*
+ * product_catalog.h
+ *
+ *  Created on: 11/07/2011
+ *      Author: pc
+ */
+
+#ifndef PRODUCT_CATALOG_H_
+#define PRODUCT_CATALOG_H_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+class ProductCatalog : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~ProductCatalog() {};
+	bool find(QString barCode, QString *name, QString *price);
+	int size();
+	void reload();
+	bool update(QList<QMap<QString, QString>*> products);
+	static ProductCatalog* instance();
+
+private:
+	QHash<QString, QString> m_Names;
+	QHash<QString, QString> m_Prices;
+	bool m_IsLoaded;
+	static ProductCatalog *m_Instance;
+
+	ProductCatalog(QObject *parent = 0);
+	void load();
+	QString fileName();
+};
+
+#endif /* PRODUCT_CATALOG_H_ */
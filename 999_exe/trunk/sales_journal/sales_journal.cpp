@@ -0,0 +1,274 @@
+/*
+ * sales_journal.cpp
+ *
+ *  Created on: 11/07/2011
+ *      Author: pc
+ */
+
+#include "sales_journal.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QStringList>
+#include <QUrl>
+#include "../logger/logger.h"
+#ifdef Q_OS_WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @class SalesJournal
+ * Append only file where the sales made without connection with the server are
+ * recorded. Every record is a line of key=value pairs and it is written to disk
+ * before returning, so nothing is lost if the application or the computer goes
+ * down. An incomplete last line is ignored when reading and cut off before
+ * writing again.
+ *
+ * Record types: invoice, customer, product, delete_product, cash_receipt,
+ * discard, replaying, replayed, conflict and failed. All of them have the local
+ * invoice id they belong to.
+ */
+
+SalesJournal* SalesJournal::m_Instance = 0;
+
+/**
+ * Constructs the journal on the sales_journal.txt file in the exe's path.
+ */
+SalesJournal::SalesJournal(QObject *parent) : QObject(parent)
+{
+	m_File.setFileName(QApplication::applicationDirPath() + "/sales_journal.txt");
+}
+
+/**
+ * Closes the file.
+ */
+SalesJournal::~SalesJournal()
+{
+	if (m_File.isOpen())
+		m_File.close();
+}
+
+/**
+ * Returns the only instance.
+ */
+SalesJournal* SalesJournal::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new SalesJournal(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Writes the record at the end of the file and waits until it is on the disk.
+ * The time of the record is added.
+ */
+bool SalesJournal::append(QMap<QString, QString> record)
+{
+	if (!m_File.isOpen() && !open())
+		return false;
+
+	record.insert("time", QDateTime::currentDateTime().toString(Qt::ISODate));
+
+	QByteArray line = serialize(record).toAscii() + "\n";
+
+	if (m_File.write(line) != line.size())
+		return false;
+
+	if (!m_File.flush())
+		return false;
+
+#ifdef Q_OS_WIN32
+	return _commit(m_File.handle()) == 0;
+#else
+	return fsync(m_File.handle()) == 0;
+#endif
+}
+
+/**
+ * Opens the file for appending. The bytes after the last end of line were left
+ * by a write that did not finish, they are cut off so the next record starts on
+ * its own line.
+ */
+bool SalesJournal::open()
+{
+	if (m_File.open(QIODevice::ReadWrite)) {
+		QByteArray content = m_File.readAll();
+
+		if (!content.isEmpty() && !content.endsWith('\n')) {
+			int size = content.lastIndexOf('\n') + 1;
+			m_File.resize(size);
+
+			Logger::log(Logger::Warning, "journal_truncated", "bytes",
+					QString::number(content.size() - size));
+		}
+
+		m_File.close();
+	}
+
+	return m_File.open(QIODevice::Append | QIODevice::Text);
+}
+
+/**
+ * Returns all the records on the file in the order they were written.
+ */
+QList<QMap<QString, QString>*> SalesJournal::records()
+{
+	QList<QMap<QString, QString>*> list;
+
+	QFile file(m_File.fileName());
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return list;
+
+	while (!file.atEnd()) {
+		QString line = QString::fromAscii(file.readLine());
+
+		// A line without end was not completely written.
+		if (!line.endsWith("\n"))
+			break;
+
+		QMap<QString, QString> *record = unserialize(line.trimmed());
+		if (record != 0)
+			list << record;
+	}
+
+	file.close();
+
+	return list;
+}
+
+/**
+ * Returns the paid invoices which have not been sent to the server yet. An
+ * invoice whose replay was interrupted is marked as failed instead, because it
+ * could already exist on the server.
+ */
+QList<OfflineInvoice*> SalesJournal::pendingInvoices()
+{
+	QList<QMap<QString, QString>*> list = records();
+	QMap<QString, OfflineInvoice*> invoices;
+	QStringList order;
+	QMap<QString, QString> states;
+
+	for (int i = 0; i < list.size(); i++) {
+		QMap<QString, QString> *record = list[i];
+		QString type = record->value("type");
+		QString id = record->value("invoice");
+
+		if (type == "invoice") {
+			invoices.insert(id, new OfflineInvoice(id,
+					record->value("register_key"), record->value("time")));
+			order << id;
+		} else if (invoices.contains(id)) {
+			OfflineInvoice *invoice = invoices.value(id);
+
+			if (type == "customer") {
+				invoice->setCustomer(record->value("nit"), record->value("name"));
+			} else if (type == "product") {
+				invoice->addProduct(record->value("bar_code"), record->value("name"),
+						record->value("quantity").toInt(), record->value("price"));
+			} else if (type == "delete_product") {
+				invoice->deleteProduct(record->value("row").toInt());
+			} else if (type == "cash_receipt") {
+				invoice->setCash(record->value("cash"));
+				states.insert(id, type);
+			} else if (type == "discard" || type == "replaying"
+					|| type == "replayed" || type == "failed") {
+				states.insert(id, type);
+			}
+		}
+
+		delete record;
+	}
+
+	QList<OfflineInvoice*> pending;
+
+	for (int i = 0; i < order.size(); i++) {
+		QString id = order[i];
+		QString state = states.value(id);
+		OfflineInvoice *invoice = invoices.value(id);
+
+		if (state == "cash_receipt") {
+			pending << invoice;
+		} else {
+			if (state == "replaying") {
+				QMap<QString, QString> record;
+				record.insert("type", "failed");
+				record.insert("invoice", id);
+				record.insert("message", "Envio interrumpido, verifique si la "
+						"factura existe en el servidor.");
+				append(record);
+			}
+
+			delete invoice;
+		}
+	}
+
+	return pending;
+}
+
+/**
+ * Returns the path of the journal's file.
+ */
+QString SalesJournal::fileName()
+{
+	return m_File.fileName();
+}
+
+/**
+ * Closes the file, the next record opens it again.
+ */
+void SalesJournal::close()
+{
+	if (m_File.isOpen())
+		m_File.close();
+}
+
+/**
+ * Returns the record as a line of percent encoded key=value pairs.
+ */
+QString SalesJournal::serialize(QMap<QString, QString> record)
+{
+	QStringList pairs;
+
+	QMapIterator<QString, QString> i(record);
+	while (i.hasNext()) {
+		i.next();
+		pairs << QString(QUrl::toPercentEncoding(i.key())) + "="
+				+ QString(QUrl::toPercentEncoding(i.value()));
+	}
+
+	return pairs.join("&");
+}
+
+/**
+ * Returns the record of the line or 0 if it is not valid.
+ */
+QMap<QString, QString>* SalesJournal::unserialize(QString line)
+{
+	if (line == "")
+		return 0;
+
+	QMap<QString, QString> *record = new QMap<QString, QString>();
+
+	QStringList pairs = line.split("&");
+	for (int i = 0; i < pairs.size(); i++) {
+		QStringList values = pairs[i].split("=");
+
+		if (values.size() != 2) {
+			delete record;
+			return 0;
+		}
+
+		record->insert(QUrl::fromPercentEncoding(values[0].toAscii()),
+				QUrl::fromPercentEncoding(values[1].toAscii()));
+	}
+
+	if (!record->contains("type") || !record->contains("invoice")) {
+		delete record;
+		return 0;
+	}
+
+	return record;
+}
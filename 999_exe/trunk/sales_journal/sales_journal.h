@@ -0,0 +1,41 @@
+/*
+ * sales_journal.h
+ *
+ *  Created on: 11/07/2011
+ *      Author: pc
+ */
+
+#ifndef SALES_JOURNAL_H_
+#define SALES_JOURNAL_H_
+
+#include <QObject>
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include "offline_invoice.h"
+
+class SalesJournal : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~SalesJournal();
+	bool append(QMap<QString, QString> record);
+	QList<QMap<QString, QString>*> records();
+	QList<OfflineInvoice*> pendingInvoices();
+	QString fileName();
+	void close();
+	static SalesJournal* instance();
+
+private:
+	QFile m_File;
+	static SalesJournal *m_Instance;
+
+	SalesJournal(QObject *parent = 0);
+	bool open();
+	QString serialize(QMap<QString, QString> record);
+	QMap<QString, QString>* unserialize(QString line);
+};
+
+#endif /* SALES_JOURNAL_H_ */
@@ -0,0 +1,133 @@
+/*
+ * scan_coalescer.cpp
+ *
+ *  Created on: 17/10/2011
+ *      Author: pc
+ */
+
+#include "scan_coalescer.h"
+
+/**
+ * @class ScanCoalescer
+ * Holds the last scanned bar code while the same one keeps being scanned,
+ * adding up the quantities. Emits timeout when no scan arrived during the
+ * interval and the line must be sent. A different bar code can not be added
+ * until the pending one is taken.
+ */
+
+/**
+ * Constructs the coalescer with nothing pending.
+ */
+ScanCoalescer::ScanCoalescer(QObject *parent) : QObject(parent)
+{
+	m_Quantity = 0;
+	m_Scans = 0;
+
+	m_Timer.setSingleShot(true);
+	connect(&m_Timer, SIGNAL(timeout()), this, SIGNAL(timeout()));
+}
+
+/**
+ * Sets the milliseconds to wait for the same bar code, 0 to not merge at all.
+ */
+void ScanCoalescer::setInterval(int msecs)
+{
+	m_Timer.setInterval(msecs);
+}
+
+/**
+ * Returns the milliseconds to wait for the same bar code.
+ */
+int ScanCoalescer::interval()
+{
+	return m_Timer.interval();
+}
+
+/**
+ * Adds the scan to the pending line and waits the interval again. Returns false
+ * if a different bar code is pending.
+ */
+bool ScanCoalescer::add(QString barCode, int quantity)
+{
+	if (m_Scans > 0 && barCode != m_BarCode)
+		return false;
+
+	m_BarCode = barCode;
+	m_Quantity += quantity;
+	m_Scans++;
+
+	m_Timer.start();
+
+	return true;
+}
+
+/**
+ * Returns the pending line and empties it. Returns false if there was none.
+ */
+bool ScanCoalescer::take(QString *barCode, int *quantity, int *scans)
+{
+	if (m_Scans == 0)
+		return false;
+
+	*barCode = m_BarCode;
+	*quantity = m_Quantity;
+	*scans = m_Scans;
+
+	clear();
+
+	return true;
+}
+
+/**
+ * Waits the interval again without adding a scan, for when the line could not
+ * be sent yet.
+ */
+void ScanCoalescer::restart()
+{
+	if (m_Scans > 0)
+		m_Timer.start();
+}
+
+/**
+ * Discards the pending line.
+ */
+void ScanCoalescer::clear()
+{
+	m_Timer.stop();
+
+	m_BarCode = "";
+	m_Quantity = 0;
+	m_Scans = 0;
+}
+
+/**
+ * Returns true if there is a line waiting to be sent.
+ */
+bool ScanCoalescer::hasPending()
+{
+	return m_Scans > 0;
+}
+
+/**
+ * Returns the bar code of the pending line.
+ */
+QString ScanCoalescer::barCode()
+{
+	return m_BarCode;
+}
+
+/**
+ * Returns the quantity added up on the pending line.
+ */
+int ScanCoalescer::quantity()
+{
+	return m_Quantity;
+}
+
+/**
+ * Returns how many scans were merged on the pending line.
+ */
+int ScanCoalescer::scanCount()
+{
+	return m_Scans;
+}
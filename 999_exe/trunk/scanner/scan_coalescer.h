@@ -0,0 +1,42 @@
+/*
+ * scan_coalescer.h
+ *
+ *  Created on: 17/10/2011
+ *      Author: pc
+ */
+
+#ifndef SCAN_COALESCER_H_
+#define SCAN_COALESCER_H_
+
+#include <QObject>
+#include <QTimer>
+
+class ScanCoalescer : public QObject
+{
+	Q_OBJECT
+
+public:
+	ScanCoalescer(QObject *parent = 0);
+	virtual ~ScanCoalescer() {};
+	void setInterval(int msecs);
+	int interval();
+	bool add(QString barCode, int quantity);
+	bool take(QString *barCode, int *quantity, int *scans);
+	void restart();
+	void clear();
+	bool hasPending();
+	QString barCode();
+	int quantity();
+	int scanCount();
+
+signals:
+	void timeout();
+
+private:
+	QTimer m_Timer;
+	QString m_BarCode;
+	int m_Quantity;
+	int m_Scans;
+};
+
+#endif /* SCAN_COALESCER_H_ */
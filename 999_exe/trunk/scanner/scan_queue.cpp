@@ -0,0 +1,98 @@
+/*
+ * scan_queue.cpp
+ *
+ *  Created on: 10/10/2011
+ *      Author: pc
+ */
+
+#include "scan_queue.h"
+
+#include <string.h>
+
+/**
+ * @class ScanQueue
+ * Lock free queue between the thread reading the scanner and the main thread.
+ * Only one thread can push and only one can pop. The tail is moved by the
+ * producer after the scan is written and the head by the consumer after it is
+ * read, so neither waits for the other. If the queue is full the scan is dropped
+ * and counted, with the main thread blocked for 256 scans something else is
+ * wrong.
+ */
+
+/**
+ * Constructs the queue empty.
+ */
+ScanQueue::ScanQueue() : m_Head(0), m_Tail(0), m_Dropped(0)
+{
+
+}
+
+/**
+ * Adds the scan at the end. Returns false if the queue was full. Must be called
+ * from the producer thread only.
+ */
+bool ScanQueue::push(const QString &barCode, const QString &quantity)
+{
+	int tail = m_Tail.fetchAndAddRelaxed(0);
+
+	if (tail - m_Head.fetchAndAddAcquire(0) == SCAN_QUEUE_SIZE) {
+		m_Dropped.fetchAndAddRelaxed(1);
+		return false;
+	}
+
+	Scan *scan = &m_Scans[tail & (SCAN_QUEUE_SIZE - 1)];
+	copy(scan->barCode, barCode);
+	copy(scan->quantity, quantity);
+
+	m_Tail.fetchAndStoreRelease(tail + 1);
+
+	return true;
+}
+
+/**
+ * Takes the first scan. Returns false if the queue is empty. Must be called from
+ * the consumer thread only.
+ */
+bool ScanQueue::pop(QString *barCode, QString *quantity)
+{
+	int head = m_Head.fetchAndAddRelaxed(0);
+
+	if (head == m_Tail.fetchAndAddAcquire(0))
+		return false;
+
+	Scan *scan = &m_Scans[head & (SCAN_QUEUE_SIZE - 1)];
+	*barCode = QString::fromLatin1(scan->barCode);
+	*quantity = QString::fromLatin1(scan->quantity);
+
+	m_Head.fetchAndStoreRelease(head + 1);
+
+	return true;
+}
+
+/**
+ * Returns true if there are no scans waiting.
+ */
+bool ScanQueue::isEmpty()
+{
+	return m_Head.fetchAndAddAcquire(0) == m_Tail.fetchAndAddAcquire(0);
+}
+
+/**
+ * Returns the number of scans dropped because the queue was full.
+ */
+int ScanQueue::droppedCount()
+{
+	return m_Dropped.fetchAndAddRelaxed(0);
+}
+
+/**
+ * Copies the value truncated to the field size.
+ */
+void ScanQueue::copy(char *destination, const QString &value)
+{
+	QByteArray data = value.toLatin1();
+
+	int size = qMin(data.size(), SCAN_VALUE_SIZE - 1);
+	memcpy(destination, data.constData(), size);
+	destination[size] = '\0';
+}
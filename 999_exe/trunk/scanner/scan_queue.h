@@ -0,0 +1,43 @@
+/*
+ * scan_queue.h
+ *
+ *  Created on: 10/10/2011
+ *      Author: pc
+ */
+
+#ifndef SCAN_QUEUE_H_
+#define SCAN_QUEUE_H_
+
+#include <QAtomicInt>
+#include <QString>
+
+// Scans the queue holds, must be a power of 2, and the characters kept of each
+// value. The bar code line edit takes up to 105 characters.
+const int SCAN_QUEUE_SIZE = 256;
+const int SCAN_VALUE_SIZE = 112;
+
+struct Scan
+{
+	char barCode[SCAN_VALUE_SIZE];
+	char quantity[SCAN_VALUE_SIZE];
+};
+
+class ScanQueue
+{
+public:
+	ScanQueue();
+	bool push(const QString &barCode, const QString &quantity);
+	bool pop(QString *barCode, QString *quantity);
+	bool isEmpty();
+	int droppedCount();
+
+private:
+	Scan m_Scans[SCAN_QUEUE_SIZE];
+	QAtomicInt m_Head;
+	QAtomicInt m_Tail;
+	QAtomicInt m_Dropped;
+
+	static void copy(char *destination, const QString &value);
+};
+
+#endif /* SCAN_QUEUE_H_ */
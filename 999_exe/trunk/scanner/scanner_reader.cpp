@@ -0,0 +1,462 @@
+/*
+ * scanner_reader.cpp
+ *
+ *  Created on: 10/10/2011
+ *      Author: pc
+ */
+
+#include "scanner_reader.h"
+
+#include <QStringList>
+#include "../logger/logger.h"
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/select.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <sys/ioctl.h>
+#include <linux/input.h>
+#endif
+
+/**
+ * @class ScannerReader
+ * Reads the bar code scanner directly from its device on its own thread, so the
+ * scans are not lost while the page is loading or the bar code line edit is
+ * disabled. A serial device (or a pty) sends every bar code followed by a
+ * carriage return or line feed. An evdev device (/dev/input/event*) sends key
+ * presses ending with the enter key, the device is grabbed so the keys are not
+ * typed on the window too. Every bar code is parsed with the same 'qty*code'
+ * syntax as the line edit and put on a lock free queue. The scanned signal is
+ * emitted once until the main thread empties the queue with take.
+ * If the device fails, like when it is unplugged, it is closed and reopened with
+ * an increasing interval. Meanwhile the scanner works as a keyboard, an evdev
+ * device is no longer grabbed. Only available on Unix, elsewhere the scanner must work as a keyboard.
+ */
+
+// Milliseconds the thread waits for data before checking if it must stop.
+static const int POLL_INTERVAL = 200;
+
+// Characters of a bar code, the same as the bar code line edit.
+static const int MAX_SCAN_SIZE = 105;
+
+// Milliseconds between the attempts to reopen a failed device, doubled on every
+// attempt up to the maximum.
+static const int REOPEN_INTERVAL = 500;
+static const int MAX_REOPEN_INTERVAL = 8000;
+
+/**
+ * Constructs the reader without device.
+ */
+ScannerReader::ScannerReader(QObject *parent) : QThread(parent),
+		m_IsStopping(0), m_IsNotified(0), m_ScanCount(0), m_IsConnected(0)
+{
+	m_Descriptor = -1;
+	m_BaudRate = 0;
+	m_IsEvdev = false;
+	m_IsShifted = false;
+}
+
+/**
+ * Stops the thread and closes the device.
+ */
+ScannerReader::~ScannerReader()
+{
+	stop();
+
+#ifdef Q_OS_UNIX
+	if (m_Descriptor != -1)
+		::close(m_Descriptor);
+#endif
+}
+
+/**
+ * Opens the device of the type serial or evdev. Returns false if it could not be
+ * opened, the reason is on the errorString.
+ */
+bool ScannerReader::open(QString device, QString type, int baudRate)
+{
+	m_Device = device;
+	m_Type = type;
+	m_BaudRate = baudRate;
+
+	bool ok = (type == "evdev") ? openEvdev(device)
+			: openSerial(device, baudRate);
+
+	m_IsConnected.fetchAndStoreOrdered(ok ? 1 : 0);
+
+	return ok;
+}
+
+/**
+ * Tells the thread to finish and waits for it.
+ */
+void ScannerReader::stop()
+{
+	m_IsStopping.fetchAndStoreOrdered(1);
+	wait();
+}
+
+/**
+ * Takes the next scan. Returns false if there are none, after that the scanned
+ * signal is emitted again with the next scan. Call it from the main thread only.
+ */
+bool ScannerReader::take(QString *barCode, QString *quantity)
+{
+	if (m_Queue.pop(barCode, quantity))
+		return true;
+
+	// Check again after clearing the flag, a scan could be pushed in between.
+	m_IsNotified.fetchAndStoreOrdered(0);
+
+	return m_Queue.pop(barCode, quantity);
+}
+
+/**
+ * Returns true if there are scans waiting to be taken.
+ */
+bool ScannerReader::hasScans()
+{
+	return !m_Queue.isEmpty();
+}
+
+/**
+ * Returns the number of bar codes read.
+ */
+int ScannerReader::scanCount()
+{
+	return m_ScanCount.fetchAndAddRelaxed(0);
+}
+
+/**
+ * Returns the number of bar codes dropped because the queue was full.
+ */
+int ScannerReader::droppedCount()
+{
+	return m_Queue.droppedCount();
+}
+
+/**
+ * Returns false while the device is failing and the reader is trying to reopen
+ * it.
+ */
+bool ScannerReader::isConnected()
+{
+	return m_IsConnected.fetchAndAddRelaxed(0) != 0;
+}
+
+/**
+ * Returns why the device could not be opened.
+ */
+QString ScannerReader::errorString()
+{
+	return m_Error;
+}
+
+/**
+ * Splits the text on the quantity and the bar code. The quantity is 1 if the
+ * text does not have the 'qty*code' form.
+ */
+void ScannerReader::parse(QString text, QString *barCode, QString *quantity)
+{
+	QStringList values = text.split("*");
+
+	if (values.length() > 1) {
+		*quantity = values[0];
+		*barCode = values[1];
+	} else {
+		*quantity = "1";
+		*barCode = values[0];
+	}
+}
+
+/**
+ * Reads the device until the reader is stopped. A device that fails is closed
+ * and reopened.
+ */
+void ScannerReader::run()
+{
+#ifdef Q_OS_UNIX
+	int interval = REOPEN_INTERVAL;
+
+	while (m_IsStopping.fetchAndAddAcquire(0) == 0) {
+		if (m_Descriptor == -1) {
+			if (reopen(&interval))
+				emit connectionChanged(true);
+			continue;
+		}
+
+		fd_set descriptors;
+		FD_ZERO(&descriptors);
+		FD_SET(m_Descriptor, &descriptors);
+
+		timeval timeout;
+		timeout.tv_sec = 0;
+		timeout.tv_usec = POLL_INTERVAL * 1000;
+
+		int result = select(m_Descriptor + 1, &descriptors, 0, 0, &timeout);
+		if (result == 0 || (result == -1 && errno == EINTR))
+			continue;
+
+		bool ok = (result > 0) && (m_IsEvdev ? readEvdev() : readSerial());
+
+		if (!ok) {
+			// A read of 0 bytes leaves errno untouched, the device hung up.
+			Logger::log(Logger::Error, "scanner_lost", "device", m_Device, "error",
+					(errno != 0) ? QString::fromLocal8Bit(strerror(errno)) : "EOF");
+			closeDevice();
+			emit connectionChanged(false);
+		}
+	}
+#endif
+}
+
+/**
+ * Opens the serial device in raw mode with the speed given.
+ */
+bool ScannerReader::openSerial(QString device, int baudRate)
+{
+#ifdef Q_OS_UNIX
+	m_Descriptor = ::open(device.toLocal8Bit().constData(), O_RDONLY | O_NOCTTY);
+	if (m_Descriptor == -1) {
+		m_Error = "No se pudo abrir el lector " + device + ".";
+		return false;
+	}
+
+	speed_t speed;
+	switch (baudRate) {
+		case 1200: speed = B1200; break;
+		case 2400: speed = B2400; break;
+		case 4800: speed = B4800; break;
+		case 19200: speed = B19200; break;
+		case 38400: speed = B38400; break;
+		case 57600: speed = B57600; break;
+		case 115200: speed = B115200; break;
+		default: speed = B9600;
+	}
+
+	termios options;
+	if (tcgetattr(m_Descriptor, &options) == 0) {
+		cfmakeraw(&options);
+		cfsetispeed(&options, speed);
+		cfsetospeed(&options, speed);
+		options.c_cflag |= CLOCAL | CREAD;
+		tcsetattr(m_Descriptor, TCSANOW, &options);
+	}
+
+	m_IsEvdev = false;
+	return true;
+#else
+	m_Error = "El lector solo puede leerse como teclado en este sistema.";
+	return false;
+#endif
+}
+
+/**
+ * Opens the evdev device and grabs it so its keys go only to the reader.
+ */
+bool ScannerReader::openEvdev(QString device)
+{
+#ifdef Q_OS_LINUX
+	m_Descriptor = ::open(device.toLocal8Bit().constData(), O_RDONLY);
+	if (m_Descriptor == -1) {
+		m_Error = "No se pudo abrir el lector " + device + ".";
+		return false;
+	}
+
+	if (ioctl(m_Descriptor, EVIOCGRAB, 1) != 0)
+		Logger::log(Logger::Warning, "scanner_not_grabbed", "device", device);
+
+	m_IsEvdev = true;
+	return true;
+#else
+	m_Error = "El lector evdev solo esta disponible en Linux.";
+	return false;
+#endif
+}
+
+/**
+ * Waits the interval and opens the device again. Returns true if it could be
+ * opened, if not the interval is doubled. The wait is cut short if the reader
+ * is stopped.
+ */
+bool ScannerReader::reopen(int *interval)
+{
+	for (int waited = 0; waited < *interval; waited += POLL_INTERVAL) {
+		if (m_IsStopping.fetchAndAddAcquire(0) != 0)
+			return false;
+
+		msleep(POLL_INTERVAL);
+	}
+
+	bool ok = (m_Type == "evdev") ? openEvdev(m_Device)
+			: openSerial(m_Device, m_BaudRate);
+
+	if (!ok) {
+		*interval = qMin(*interval * 2, MAX_REOPEN_INTERVAL);
+		return false;
+	}
+
+	Logger::log(Logger::Info, "scanner_reopened", "device", m_Device);
+
+	*interval = REOPEN_INTERVAL;
+	m_IsConnected.fetchAndStoreOrdered(1);
+
+	return true;
+}
+
+/**
+ * Closes the failed device and discards the bar code being read.
+ */
+void ScannerReader::closeDevice()
+{
+#ifdef Q_OS_UNIX
+	::close(m_Descriptor);
+#endif
+
+	m_Descriptor = -1;
+	m_Buffer.clear();
+	m_IsShifted = false;
+	m_IsConnected.fetchAndStoreOrdered(0);
+}
+
+/**
+ * Returns true if the result of a read means the device failed. End of file
+ * is a hang up, like a closed pty.
+ */
+bool ScannerReader::isReadError(int size)
+{
+#ifdef Q_OS_UNIX
+	return size == 0 || (size == -1 && errno != EAGAIN && errno != EINTR);
+#else
+	return size <= 0;
+#endif
+}
+
+/**
+ * Reads the bytes available and frames them on carriage return or line feed.
+ * Returns false if the device failed.
+ */
+bool ScannerReader::readSerial()
+{
+#ifdef Q_OS_UNIX
+	char data[256];
+	errno = 0;
+	int size = ::read(m_Descriptor, data, sizeof(data));
+
+	if (isReadError(size))
+		return false;
+
+	for (int i = 0; i < size; i++) {
+		if (data[i] == '\r' || data[i] == '\n') {
+			endFrame();
+		} else {
+			addCharacter(data[i]);
+		}
+	}
+#endif
+
+	return true;
+}
+
+/**
+ * Reads the key events available and translates the key presses into
+ * characters. The enter key ends the bar code. Returns false if the device
+ * failed.
+ */
+bool ScannerReader::readEvdev()
+{
+#ifdef Q_OS_LINUX
+	// Characters of the keys from KEY_1 to KEY_SLASH, without and with shift.
+	static const char keys[] = "1234567890-=\0\0qwertyuiop[]\0\0asdfghjkl;'`\0\\"
+			"zxcvbnm,./";
+	static const char shiftedKeys[] = "!@#$%^&*()_+\0\0QWERTYUIOP{}\0\0ASDFGHJKL:\"~"
+			"\0|ZXCVBNM<>?";
+
+	input_event events[64];
+	errno = 0;
+	int size = ::read(m_Descriptor, events, sizeof(events));
+
+	if (isReadError(size))
+		return false;
+
+	for (int i = 0; i < size / int(sizeof(input_event)); i++) {
+		input_event &event = events[i];
+
+		if (event.type != EV_KEY)
+			continue;
+
+		if (event.code == KEY_LEFTSHIFT || event.code == KEY_RIGHTSHIFT) {
+			m_IsShifted = (event.value != 0);
+			continue;
+		}
+
+		// Only presses, not releases or repetitions.
+		if (event.value != 1)
+			continue;
+
+		if (event.code == KEY_ENTER || event.code == KEY_KPENTER) {
+			endFrame();
+		} else if (event.code == KEY_KPASTERISK) {
+			addCharacter('*');
+		} else if (event.code == KEY_SPACE) {
+			addCharacter(' ');
+		} else if (event.code >= KEY_KP7 && event.code <= KEY_KPDOT) {
+			addCharacter("789-456+1230."[event.code - KEY_KP7]);
+		} else if (event.code >= KEY_1 && event.code <= KEY_SLASH) {
+			int index = event.code - KEY_1;
+			addCharacter(m_IsShifted ? shiftedKeys[index] : keys[index]);
+		}
+	}
+#endif
+
+	return true;
+}
+
+/**
+ * Adds the character to the bar code being read. Control characters, like the
+ * prefix some scanners send, are ignored.
+ */
+void ScannerReader::addCharacter(char character)
+{
+	if (character < ' ' || character == 127)
+		return;
+
+	m_Buffer.append(character);
+}
+
+/**
+ * Puts the bar code read on the queue and notifies the main thread.
+ */
+void ScannerReader::endFrame()
+{
+	if (m_Buffer.isEmpty())
+		return;
+
+	if (m_Buffer.size() > MAX_SCAN_SIZE) {
+		Logger::log(Logger::Warning, "scan_too_long", "size",
+				QString::number(m_Buffer.size()));
+		m_Buffer.clear();
+		return;
+	}
+
+	QString barCode, quantity;
+	parse(QString::fromLatin1(m_Buffer), &barCode, &quantity);
+	m_Buffer.clear();
+
+	if (!m_Queue.push(barCode, quantity)) {
+		Logger::log(Logger::Warning, "scan_dropped", "bar_code", barCode);
+		return;
+	}
+
+	m_ScanCount.fetchAndAddRelaxed(1);
+
+	// Only one notification until the main thread empties the queue.
+	if (m_IsNotified.testAndSetOrdered(0, 1))
+		emit scanned();
+}
@@ -0,0 +1,66 @@
+/*
+ * scanner_reader.h
+ *
+ *  Created on: 10/10/2011
+ *      Author: pc
+ */
+
+#ifndef SCANNER_READER_H_
+#define SCANNER_READER_H_
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QByteArray>
+#include "scan_queue.h"
+
+class ScannerReader : public QThread
+{
+	Q_OBJECT
+
+public:
+	ScannerReader(QObject *parent = 0);
+	virtual ~ScannerReader();
+	bool open(QString device, QString type, int baudRate);
+	void stop();
+	bool take(QString *barCode, QString *quantity);
+	bool hasScans();
+	int scanCount();
+	int droppedCount();
+	bool isConnected();
+	QString errorString();
+	static void parse(QString text, QString *barCode, QString *quantity);
+
+signals:
+	void scanned();
+	void connectionChanged(bool isConnected);
+
+protected:
+	void run();
+
+private:
+	int m_Descriptor;
+	QString m_Device;
+	QString m_Type;
+	int m_BaudRate;
+	bool m_IsEvdev;
+	bool m_IsShifted;
+	QByteArray m_Buffer;
+	QString m_Error;
+	ScanQueue m_Queue;
+	QAtomicInt m_IsStopping;
+	QAtomicInt m_IsNotified;
+	QAtomicInt m_ScanCount;
+	QAtomicInt m_IsConnected;
+
+	bool openSerial(QString device, int baudRate);
+	bool openEvdev(QString device);
+	bool reopen(int *interval);
+	void closeDevice();
+	bool readSerial();
+	bool readEvdev();
+	bool isReadError(int size);
+	void addCharacter(char character);
+	void endFrame();
+};
+
+#endif /* SCANNER_READER_H_ */
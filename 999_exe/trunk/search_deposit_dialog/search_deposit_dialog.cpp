@@ -1,8 +1,8 @@
 #include "search_deposit_dialog.h"
 
 #include <QSignalMapper>
-#include "../xml_transformer/xml_transformer_factory.h"
 #include "../console/console_factory.h"
+#include "../reference_data/reference_data.h"
 
 /**
  * @class SearchDepositDialog
@@ -21,12 +21,6 @@ SearchDepositDialog::SearchDepositDialog(QNetworkCookieJar *jar, QUrl *url,
 			->createWidgetConsole(QMap<QString, QLabel*>());
 	m_Console->setFrame(ui.webView->page()->mainFrame());
 
-	m_Request = new HttpRequest(jar, this);
-	m_Handler = new XmlResponseHandler(this);
-
-	connect(m_Handler, SIGNAL(sessionStatusChanged(bool)), this,
-			SIGNAL(sessionStatusChanged(bool)));
-
 	QSignalMapper *mapper = new QSignalMapper(this);
 	mapper->setMapping(ui.depositIdPushButton, 0);
 	mapper->setMapping(ui.numberBankPushButton, 1);
@@ -46,36 +40,24 @@ SearchDepositDialog::~SearchDepositDialog()
 }
 
 /**
- * Populates the combo box with a list of all the banks available.
+ * Populates the combo box with the banks kept on the ReferenceData, it is
+ * refilled if they change while the dialog is open.
  */
 void SearchDepositDialog::init()
 {
-	QUrl url(*m_ServerUrl);
-	url.addQueryItem("cmd", "get_bank_list");
-	url.addQueryItem("type", "xml");
-
-	QString content = m_Request->get(url);
-
-	XmlTransformer *transformer = XmlTransformerFactory::instance()
-			->create("bank_list");
-
-	QString errorMsg;
-	if (m_Handler->handle(content, transformer, &errorMsg) ==
-			XmlResponseHandler::Success) {
-		QList<QMap<QString, QString>*> list = transformer->content();
-
-		ui.bankIdComboBox->addItem("", "");
-		QMap<QString, QString> *bank;
-		for (int i = 0; i < list.size(); i++) {
-			bank = list[i];
-			ui.bankIdComboBox->addItem(bank->value("name"),
-					bank->value("bank_id"));
-		}
-	} else {
-		m_Console->displayError(errorMsg);
-	}
+	ReferenceData *data = ReferenceData::instance();
+	data->fill(ui.bankIdComboBox, "bank_list");
 
-	delete transformer;
+	connect(data, SIGNAL(listChanged(QString)), this, SLOT(updateList(QString)));
+}
+
+/**
+ * Refills the combo box if the banks changed.
+ */
+void SearchDepositDialog::updateList(QString name)
+{
+	if (name == "bank_list")
+		ReferenceData::instance()->fill(ui.bankIdComboBox, name);
 }
 
 /**
@@ -7,8 +7,6 @@
 #include <QNetworkCookieJar>
 #include <QUrl>
 #include "../console/console.h"
-#include "../http_request/http_request.h"
-#include "../xml_response_handler/xml_response_handler.h"
 
 class SearchDepositDialog : public QDialog
 {
@@ -27,6 +25,7 @@ public:
 
 public slots:
 	void setSearchMode(int button);
+	void updateList(QString name);
 
 signals:
 	void sessionStatusChanged(bool isActive);
@@ -35,8 +34,6 @@ private:
     Ui::SearchDepositDialogClass ui;
     QUrl *m_ServerUrl;
 	Console *m_Console;
-	HttpRequest *m_Request;
-	XmlResponseHandler *m_Handler;
 	SearchMode m_SearchMode;
 };
 
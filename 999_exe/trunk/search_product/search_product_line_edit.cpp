@@ -11,18 +11,30 @@
 #include <QTreeView>
 #include <QCompleter>
 #include "../xml_transformer/xml_transformer_factory.h"
+#include "../diagnostics/allocation_tracker.h"
 
 /**
  * @class SearchProductLineEdit
  * Widget for searching for a product's bar code by its name.
+ * A keyword is searched on the server once the typing stops for a while, which
+ * is longer the slower the server answers. If a prefix of it was searched before
+ * its products are already on the model and the completer shows them at once.
+ * A new keyword aborts the request of the previous one.
  */
 
+// Milliseconds to wait after a key before searching, at least and at most.
+static const int MIN_DEBOUNCE = 50;
+static const int MAX_DEBOUNCE = 500;
+
+// Round trip in milliseconds assumed before the first response.
+static const int INITIAL_ROUND_TRIP = 300;
+
 /**
  * Constructs the widget.
  */
 SearchProductLineEdit::SearchProductLineEdit(QWidget *parent) : QLineEdit(parent)
 {
-
+	m_RoundTrip = INITIAL_ROUND_TRIP;
 }
 
 /**
@@ -41,7 +53,6 @@ void SearchProductLineEdit::init(QNetworkCookieJar *jar, QUrl *url,
 	connect(m_Request, SIGNAL(finished(QString)), this,
 			SLOT(updateProductModel(QString)));
 
-	m_Keywords = model->keywords();
 	m_Model = model;
 	m_IncludeDeactivated = includeDeactivated;
 
@@ -52,18 +63,18 @@ void SearchProductLineEdit::init(QNetworkCookieJar *jar, QUrl *url,
 	QCompleter *completer = new QCompleter(m_Model, this);
 	completer->setPopup(tree);
 	completer->setCaseSensitivity(Qt::CaseInsensitive);
+	completer->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
 
 	setCompleter(completer);
 
 	tree->setColumnWidth(0, 150);
 	tree->hideColumn(3);
 
-	connect(&m_CheckerTimer, SIGNAL(timeout()), this, SLOT(checkForChanges()));
-	connect(&m_SenderTimer, SIGNAL(timeout()), this, SLOT(fetchProducts()));
+	m_DebounceTimer.setSingleShot(true);
 
-	m_CheckerTimer.setInterval(500);
-	m_SenderTimer.setInterval(500);
-	m_SenderTimer.setSingleShot(true);
+	connect(this, SIGNAL(textEdited(const QString&)), this,
+			SLOT(searchKeyword(const QString&)));
+	connect(&m_DebounceTimer, SIGNAL(timeout()), this, SLOT(checkForChanges()));
 }
 
 /**
@@ -74,43 +85,50 @@ QString SearchProductLineEdit::barCode()
 	return m_BarCode;
 }
 
+/**
+ * Waits for the typing to stop before searching the keyword, half the round
+ * trip of the last searches. Nothing is waited for if the model already has its
+ * products.
+ */
+void SearchProductLineEdit::searchKeyword(const QString &keyword)
+{
+	if (keyword == "" || m_Model->isSearched(keyword)) {
+		m_DebounceTimer.stop();
+		return;
+	}
+
+	m_DebounceTimer.start(qBound(MIN_DEBOUNCE, m_RoundTrip / 2, MAX_DEBOUNCE));
+}
+
 /**
  * Checks if the name has change.
- * If the name value has change and there is no current completion on the completer
- * object then fetch for more products from the server.
+ * If the name value has change and its products are not on the model then fetch
+ * for them from the server.
  */
 void SearchProductLineEdit::checkForChanges()
 {
 	QString keyword = text();
 
-	if (keyword != "" && (m_Keywords->indexOf(keyword) == -1)) {
-		m_NamesQueue.enqueue(keyword);
+	if (keyword != "" && keyword != m_Keyword && !m_Model->isSearched(keyword)) {
+		m_Keyword = keyword;
 		fetchProducts();
 	}
 }
 
 /**
  * Fetch for more products' names for matching the product name is being search for.
+ * The request of the previous name, if still waiting, is aborted.
  */
 void SearchProductLineEdit::fetchProducts()
 {
-	if (!m_Request->isBusy()) {
-		QUrl url(*m_ServerUrl);
-		url.addQueryItem("cmd", "search_product");
-		url.addQueryItem("keyword", m_NamesQueue.dequeue());
-		url.addQueryItem("include_deactivated", m_IncludeDeactivated ? "1" : "0");
-		url.addQueryItem("type", "xml");
-
-		m_Request->get(url, true);
-	} else {
-		// If there was already a waiting call, clean it.
-		if (m_SenderTimer.timerId() > -1) {
-			m_NamesQueue.dequeue();
-			m_SenderTimer.stop();
-		}
-
-		m_SenderTimer.start();
-	}
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", "search_product");
+	url.addQueryItem("keyword", m_Keyword);
+	url.addQueryItem("include_deactivated", m_IncludeDeactivated ? "1" : "0");
+	url.addQueryItem("type", "xml");
+
+	m_RoundTripClock.start();
+	m_Request->replace(url);
 }
 
 /**
@@ -118,6 +136,12 @@ void SearchProductLineEdit::fetchProducts()
  */
 void SearchProductLineEdit::updateProductModel(QString content)
 {
+	AllocationScope scope(AllocationTracker::SearchProduct);
+
+	// Moving average so a single slow response does not change it much.
+	if (m_RoundTripClock.isValid())
+		m_RoundTrip = (m_RoundTrip * 3 + m_RoundTripClock.elapsed()) / 4;
+
 	XmlTransformer *transformer = XmlTransformerFactory::instance()
 				->create("search_product_results");
 
@@ -126,32 +150,24 @@ void SearchProductLineEdit::updateProductModel(QString content)
 			XmlResponseHandler::Success) {
 
 		QList<QMap<QString, QString>*> list = transformer->content();
-		QMap<QString, QString> *map;
 
 		QString keyword = list[0]->value("keyword");
 
-		QList<QStandardItem*> *itemList;
+		QList<SearchProduct> products;
 		for (int i = 1; i < list.size(); i++) {
-			map = list[i];
-
-			if ((m_Model
-					->findItems(map->value("bar_code"), Qt::MatchExactly, 3))
-					.size() == 0) {
-				itemList = new QList<QStandardItem*>;
-				itemList->append(new QStandardItem(map->value("name")));
-				itemList->append(new QStandardItem(map->value("packaging")));
-				itemList->append(new QStandardItem(map->value("manufacturer")));
-				itemList->append(new QStandardItem(map->value("bar_code")));
-
-				m_Model->appendRow(*itemList);
-				// Add name to the keywords so we don't have to search it againg.
-				*m_Keywords << map->value("name");
-			}
+			QMap<QString, QString> *map = list[i];
+
+			SearchProduct product;
+			product.name = map->value("name");
+			product.packaging = map->value("packaging");
+			product.manufacturer = map->value("manufacturer");
+			product.barCode = map->value("bar_code");
+			products << product;
 		}
 
-		m_Model->sort(0, Qt::AscendingOrder);
+		m_Model->addProducts(products);
 
-		*m_Keywords << keyword;
+		m_Model->addSearchedKeyword(keyword);
 
 		// Display the drop down list if the name value has not change.
 		if (keyword == text())
@@ -176,7 +192,7 @@ void SearchProductLineEdit::itemChose(const QModelIndex &index)
 }
 
 /**
- * Start listening to the name values changes.
+ * Connects the completer to know the chosen product.
  */
 void SearchProductLineEdit::focusInEvent(QFocusEvent *e)
 {
@@ -184,15 +200,17 @@ void SearchProductLineEdit::focusInEvent(QFocusEvent *e)
 	connect(completer(), SIGNAL(activated(const QModelIndex&)), this,
 			SLOT(itemChose(const QModelIndex&)));
 
-	m_CheckerTimer.start();
 	QLineEdit::focusInEvent(e);
 }
 
 /**
- * Stop listening to name values changes.
+ * Stops waiting to search the name typed, unless the focus went to the
+ * completer's popup.
  */
 void SearchProductLineEdit::focusOutEvent(QFocusEvent *e)
 {
-	m_CheckerTimer.stop();
+	if (e->reason() != Qt::PopupFocusReason)
+		m_DebounceTimer.stop();
+
 	QLineEdit::focusOutEvent(e);
 }
@@ -9,10 +9,9 @@
 #define SEARCH_PRODUCT_LINE_EDIT_H_
 
 #include <QLineEdit>
-#include <QQueue>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QFocusEvent>
-#include <QStringList>
 #include "../http_request/http_request.h"
 #include "../xml_response_handler/xml_response_handler.h"
 #include "../console/console.h"
@@ -30,6 +29,7 @@ public:
 	QString barCode();
 
 public slots:
+	void searchKeyword(const QString &keyword);
 	void checkForChanges();
 	void fetchProducts();
 	void updateProductModel(QString content);
@@ -49,11 +49,11 @@ private:
 	HttpRequest *m_Request;
 	XmlResponseHandler *m_Handler;
 
-	QTimer m_CheckerTimer;
-	QTimer m_SenderTimer;
-	QQueue<QString> m_NamesQueue;
+	QTimer m_DebounceTimer;
+	QElapsedTimer m_RoundTripClock;
+	int m_RoundTrip;
+	QString m_Keyword;
 	QString m_BarCode;
-	QStringList *m_Keywords;
 
 	SearchProductModel *m_Model;
 	bool m_IncludeDeactivated;
@@ -7,23 +7,204 @@
 
 #include "search_product_model.h"
 
+#include <QtAlgorithms>
+
 /**
  * @class SearchProductModel
- * Extends the QStandardItemModel a sets the column count property to 3.
+ * Model with the products found by name for the completer, sorted by name
+ * without case so the completer can use a binary search. Each row has the name,
+ * packaging, manufacturer and bar code columns. The products of every response
+ * are merged in place, a bar code already on the model is not added again.
+ * Also keeps the keywords already searched on the server.
  */
 
+// Groups of new rows above which the model is rebuilt instead of inserting
+// each group.
+static const int MAX_INSERT_GROUPS = 32;
+
 /**
  * Constructs the model.
  */
-SearchProductModel::SearchProductModel(QObject *parent) : QStandardItemModel(parent)
+SearchProductModel::SearchProductModel(QObject *parent)
+		: QAbstractTableModel(parent)
 {
-	setColumnCount(4);
+
+}
+
+/**
+ * Returns the number of products.
+ */
+int SearchProductModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : m_Products.size();
+}
+
+/**
+ * Returns 4, the name, packaging, manufacturer and bar code.
+ */
+int SearchProductModel::columnCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : 4;
+}
+
+/**
+ * Returns the value of the column of the product.
+ */
+QVariant SearchProductModel::data(const QModelIndex &index, int role) const
+{
+	if (!index.isValid() || index.row() >= m_Products.size()
+			|| (role != Qt::DisplayRole && role != Qt::EditRole))
+		return QVariant();
+
+	const SearchProduct &product = m_Products.at(index.row());
+
+	switch (index.column()) {
+		case 0:
+			return product.name;
+
+		case 1:
+			return product.packaging;
+
+		case 2:
+			return product.manufacturer;
+
+		case 3:
+			return product.barCode;
+
+		default:
+			return QVariant();
+	}
+}
+
+/**
+ * Inserts the products not on the model yet on their sorted position.
+ */
+void SearchProductModel::addProducts(QList<SearchProduct> products)
+{
+	QList<SearchProduct> newProducts;
+
+	for (int i = 0; i < products.size(); i++) {
+		if (!m_BarCodes.contains(products[i].barCode)) {
+			m_BarCodes.insert(products[i].barCode);
+			newProducts << products[i];
+		}
+	}
+
+	if (newProducts.isEmpty())
+		return;
+
+	qSort(newProducts.begin(), newProducts.end(), lessThan);
+
+	mergeProducts(newProducts);
 }
 
 /**
- * Returns the list of keywords that have been searched.
+ * Removes all the products and forgets the keywords searched, their products
+ * are no longer on the model.
  */
-QStringList* SearchProductModel::keywords()
+void SearchProductModel::clear()
 {
-	return &m_Keywords;
+	beginResetModel();
+	m_Products.clear();
+	m_BarCodes.clear();
+	m_Keywords.clear();
+	endResetModel();
+}
+
+/**
+ * Returns true if the products for the keyword are already on the model. The
+ * server returns every product whose name starts with the keyword, so those of
+ * a longer keyword are among the ones of any of its prefixes searched before.
+ */
+bool SearchProductModel::isSearched(QString keyword)
+{
+	keyword = keyword.toLower();
+
+	for (int i = 1; i <= keyword.size(); i++)
+		if (m_Keywords.contains(keyword.left(i)))
+			return true;
+
+	return false;
+}
+
+/**
+ * Marks the keyword as searched. A backslash escapes the next character on the
+ * server's LIKE, the results of those keywords may miss names starting with
+ * them so they are not kept.
+ */
+void SearchProductModel::addSearchedKeyword(QString keyword)
+{
+	if (keyword != "" && !keyword.contains('\\'))
+		m_Keywords.insert(keyword.toLower());
+}
+
+/**
+ * Returns true if the first product goes before the second one. By name without
+ * case and then by bar code.
+ */
+bool SearchProductModel::lessThan(const SearchProduct &first,
+		const SearchProduct &second)
+{
+	int result = QString::compare(first.name, second.name, Qt::CaseInsensitive);
+
+	return (result != 0) ? result < 0 : first.barCode < second.barCode;
+}
+
+/**
+ * Inserts the sorted products. The ones that go between the same two rows are
+ * inserted together. If they are spread all over the model it is rebuilt
+ * with a single pass instead.
+ */
+void SearchProductModel::mergeProducts(const QList<SearchProduct> &products)
+{
+	// Position of each new product on the rows as they are now.
+	QVector<int> positions(products.size());
+	int groups = 0;
+
+	for (int i = 0; i < products.size(); i++) {
+		positions[i] = qUpperBound(m_Products.begin(), m_Products.end(),
+				products[i], lessThan) - m_Products.begin();
+
+		if (i == 0 || positions[i] != positions[i - 1])
+			groups++;
+	}
+
+	if (groups > MAX_INSERT_GROUPS) {
+		QVector<SearchProduct> merged;
+		merged.reserve(m_Products.size() + products.size());
+
+		int j = 0;
+		for (int i = 0; i < m_Products.size(); i++) {
+			while (j < products.size() && positions[j] == i)
+				merged << products[j++];
+			merged << m_Products[i];
+		}
+		while (j < products.size())
+			merged << products[j++];
+
+		beginResetModel();
+		m_Products = merged;
+		endResetModel();
+		return;
+	}
+
+	// Every group moves the next ones down.
+	int inserted = 0;
+	int i = 0;
+	while (i < products.size()) {
+		int count = 1;
+		while (i + count < products.size() && positions[i + count] == positions[i])
+			count++;
+
+		int row = positions[i] + inserted;
+
+		beginInsertRows(QModelIndex(), row, row + count - 1);
+		m_Products.insert(row, count, SearchProduct());
+		for (int k = 0; k < count; k++)
+			m_Products[row + k] = products[i + k];
+		endInsertRows();
+
+		inserted += count;
+		i += count;
+	}
 }
@@ -8,20 +8,43 @@
 #ifndef SEARCH_PRODUCT_MODEL_H_
 #define SEARCH_PRODUCT_MODEL_H_
 
-#include <QStandardItemModel>
-#include <QStringList>
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QList>
+#include <QSet>
 
-class SearchProductModel : public QStandardItemModel
+struct SearchProduct
+{
+	QString name;
+	QString packaging;
+	QString manufacturer;
+	QString barCode;
+};
+
+Q_DECLARE_TYPEINFO(SearchProduct, Q_MOVABLE_TYPE);
+
+class SearchProductModel : public QAbstractTableModel
 {
 	Q_OBJECT
 
 public:
 	SearchProductModel(QObject *parent = 0);
 	virtual ~SearchProductModel() {};
-	QStringList* keywords();
+	int rowCount(const QModelIndex &parent = QModelIndex()) const;
+	int columnCount(const QModelIndex &parent = QModelIndex()) const;
+	QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+	void addProducts(QList<SearchProduct> products);
+	void clear();
+	bool isSearched(QString keyword);
+	void addSearchedKeyword(QString keyword);
+	static bool lessThan(const SearchProduct &first, const SearchProduct &second);
 
 private:
-	QStringList m_Keywords;
+	QVector<SearchProduct> m_Products;
+	QSet<QString> m_BarCodes;
+	QSet<QString> m_Keywords;
+
+	void mergeProducts(const QList<SearchProduct> &products);
 };
 
 #endif /* SEARCH_PRODUCT_MODEL_H_ */
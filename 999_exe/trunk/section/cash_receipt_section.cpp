@@ -10,11 +10,15 @@
 #include <QMenuBar>
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QRegExp>
 #include "../console/console_factory.h"
 #include "../xml_transformer/xml_transformer_factory.h"
 #include "../registry.h"
 #include "../voucher_dialog/voucher_dialog.h"
 #include "../printer_status_handler/printer_status_handler.h"
+#include "../diagnostics/latency_timer.h"
+#include "../diagnostics/trace_span.h"
+#include "../pricing/pricing_engine.h"
 
 /**
  * @class CashReceiptSection
@@ -35,27 +39,25 @@ CashReceiptSection::CashReceiptSection(QNetworkCookieJar *jar,
 
 	m_Console = ConsoleFactory::instance()->createHtmlConsole();
 	m_CashRequest = new HttpRequest(jar, this);
+	m_WarningRequest = new HttpRequest(jar, this);
 	m_Request = new HttpRequest(jar, this);
 	m_Handler = new XmlResponseHandler(this);
 
 	connect(m_Handler, SIGNAL(sessionStatusChanged(bool)), this,
 			SIGNAL(sessionStatusChanged(bool)));
-	connect(ui.webView, SIGNAL(loadFinished(bool)), this,
-			SLOT(loadFinished(bool)));
 	connect(ui.webView->page()->mainFrame(),
 			SIGNAL(javaScriptWindowObjectCleared()), this, SLOT(addTimerObject()));
 	connect(m_CashRequest, SIGNAL(finished(QString)), this,
 			SLOT(updateChangeValue(QString)));
+	connect(m_WarningRequest, SIGNAL(finished(QString)), this,
+			SLOT(updateCorrelativeWarning(QString)));
 	connect(&m_CheckerTimer, SIGNAL(timeout()), this, SLOT(checkForChanges()));
-	connect(&m_SenderTimer, SIGNAL(timeout()), this, SLOT(setCash()));
 
 	m_Query = new QXmlQuery(QXmlQuery::XSLT20);
 
 	fetchStyleSheet();
 
 	m_CheckerTimer.setInterval(500);
-	m_SenderTimer.setInterval(500);
-	m_SenderTimer.setSingleShot(true);
 }
 
 /**
@@ -82,27 +84,18 @@ void CashReceiptSection::loadFinished(bool ok)
 }
 
 /**
- * Sets the cash amount on the receipt on the server.
+ * Sets the cash amount on the receipt on the server. Only the last value typed
+ * is sent if the server is still busy with a previous one.
  */
 void CashReceiptSection::setCash()
 {
-	if (!m_CashRequest->isBusy()) {
-		QUrl url(*m_ServerUrl);
-		url.addQueryItem("cmd", "set_cash_cash_receipt");
-		url.addQueryItem("key", m_CashReceiptKey);
-		url.addQueryItem("amount", m_CashValues.dequeue());
-		url.addQueryItem("type", "xml");
-
-		m_CashRequest->get(url, true);
-	} else {
-		// If there was already a waiting call, clean it.
-		if (m_SenderTimer.timerId() > -1) {
-			m_CashValues.dequeue();
-			m_SenderTimer.stop();
-		}
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", "set_cash_cash_receipt");
+	url.addQueryItem("key", m_CashReceiptKey);
+	url.addQueryItem("amount", m_CashValue);
+	url.addQueryItem("type", "xml");
 
-		m_SenderTimer.start();
-	}
+	m_CashRequest->supersede(url);
 }
 
 /**
@@ -128,8 +121,8 @@ void CashReceiptSection::loadUrl()
 
 /**
  * Checks if the cash input value has changed.
- * If has change, the new value is sent to the server for setting the new cash
- * value.
+ * If has change, the change computed locally is displayed at once and the new
+ * value is sent to the server for setting the new cash value.
  */
 void CashReceiptSection::checkForChanges()
 {
@@ -139,7 +132,12 @@ void CashReceiptSection::checkForChanges()
 
 	if (cashValue != m_CashValue) {
 		m_CashValue = cashValue;
-		m_CashValues.enqueue(cashValue);
+
+		qint64 change;
+		if (computeChange(&change))
+			ui.webView->page()->mainFrame()->findFirstElement("#change_amount")
+					.setInnerXml(PricingEngine::fromCents(change));
+
 		setCash();
 	}
 }
@@ -161,6 +159,11 @@ void CashReceiptSection::updateChangeValue(QString content)
 		ui.webView->page()->mainFrame()
 				->findFirstElement("#change_amount")
 				.setInnerXml(list[0]->value("change"));
+
+		qint64 change;
+		if (Registry::instance()->pricingCrossCheck() && computeChange(&change))
+			PricingEngine::instance()->crossCheck("change", change,
+					list[0]->value("change"));
 	} else if (response == XmlResponseHandler::Failure) {
 		m_Console->cleanFailure("cash");
 		m_Console->displayFailure(errorMsg, "cash");
@@ -171,6 +174,29 @@ void CashReceiptSection::updateChangeValue(QString content)
 	delete transformer;
 }
 
+/**
+ * Computes the change for the cash typed with the vouchers and invoice totals
+ * on the page. Returns false if the cash is not a valid amount, in which case
+ * the server's response is waited for.
+ */
+bool CashReceiptSection::computeChange(qint64 *change)
+{
+	// Amounts with more than 2 decimals are left to the server.
+	QRegExp amount("\\s*(\\d+\\.?\\d{0,2}|\\.\\d{1,2})\\s*");
+	if (!amount.exactMatch(m_CashValue))
+		return false;
+
+	QWebFrame *frame = ui.webView->page()->mainFrame();
+
+	*change = PricingEngine::change(PricingEngine::toCents(m_CashValue),
+			PricingEngine::toCents(
+					frame->findFirstElement("#vouchers_total").toPlainText()),
+			PricingEngine::toCents(
+					frame->findFirstElement("#invoice_total").toPlainText()));
+
+	return true;
+}
+
 /**
  * Shows the voucher dialog for adding a voucher to the cash receipt on the server.
  */
@@ -264,6 +290,8 @@ void CashReceiptSection::scrollDown()
  */
 void CashReceiptSection::saveCashReceipt()
 {
+	TraceSpan span("saveCashReceipt", true);
+
 	Registry *registry = Registry::instance();
 
 	if (registry->isTMUPrinter()) {
@@ -394,11 +422,16 @@ QString CashReceiptSection::fetchVouchersData()
  */
 void CashReceiptSection::updateVouchers(QString content)
 {
-	m_Query->setFocus(content);
-	m_Query->setQuery(m_StyleSheet);
-
 	QString result;
-	m_Query->evaluateTo(&result);
+	{
+		LatencyTimer timer("xslt");
+
+		m_Query->setFocus(content);
+		m_Query->setQuery(m_StyleSheet);
+		m_Query->evaluateTo(&result);
+	}
+
+	LatencyTimer timer("dom");
 
 	QWebElement div = ui.webView->page()->mainFrame()->findFirstElement("#details");
 	div.setInnerXml(result);
@@ -430,7 +463,7 @@ void CashReceiptSection::updateVouchersTotal(QString content)
 }
 
 /**
- * Fetches for the correlative status.
+ * Fetches for the correlative status in the background.
  */
 void CashReceiptSection::checkCorrelativeWarning()
 {
@@ -438,8 +471,14 @@ void CashReceiptSection::checkCorrelativeWarning()
 	url.addQueryItem("cmd", "get_correlative_warning");
 	url.addQueryItem("type", "xml");
 
-	QString content = m_Request->get(url);
+	m_WarningRequest->defer(url);
+}
 
+/**
+ * Displays the correlative warning if the server sent one.
+ */
+void CashReceiptSection::updateCorrelativeWarning(QString content)
+{
 	XmlTransformer *transformer = XmlTransformerFactory::instance()
 			->create("correlative_warning");
 
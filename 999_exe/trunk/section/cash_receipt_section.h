@@ -12,7 +12,6 @@
 
 #include <QMainWindow>
 #include <QTimer>
-#include <QQueue>
 #include <QXmlQuery>
 #include "../console/console.h"
 #include "../http_request/http_request.h"
@@ -40,6 +39,7 @@ public slots:
 	void scrollUp();
 	void scrollDown();
 	void saveCashReceipt();
+	void updateCorrelativeWarning(QString content);
 
 signals:
 	void cashReceiptSaved(QString newInvoiceId);
@@ -50,10 +50,9 @@ private:
 	Console *m_Console;
 	QMainWindow *m_Window;
 	QTimer m_CheckerTimer;
-	QTimer m_SenderTimer;
 	QString m_CashValue;
-	QQueue<QString> m_CashValues;
 	HttpRequest *m_CashRequest;
+	HttpRequest *m_WarningRequest;
 	XmlResponseHandler *m_Handler;
 	QXmlQuery *m_Query;
 	QString m_StyleSheet;
@@ -78,6 +77,7 @@ private:
 	void updateVouchers(QString content);
 	void updateVouchersTotal(QString content);
 	void checkCorrelativeWarning();
+	bool computeChange(qint64 *change);
 };
 
 #endif /* CASH_RECEIPT_SECTION_H_ */
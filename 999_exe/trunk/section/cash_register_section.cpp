@@ -7,6 +7,10 @@
 
 #include "cash_register_section.h"
 
+#include <QApplication>
+#include <QDateTime>
+#include "../diagnostics/latency_recorder.h"
+
 /**
  * @class CashRegisterSection
  * Section for controlling the cash register actions.
@@ -60,3 +64,13 @@ QUrl CashRegisterSection::formUrl()
 
 	return url;
 }
+
+/**
+ * Saves the latency of the server commands during the shift next to the exe.
+ */
+void CashRegisterSection::closeObjectEvent()
+{
+	LatencyRecorder::instance()->save(QApplication::applicationDirPath()
+			+ "/diagnostics_" + QDateTime::currentDateTime().toString("yyyyMMdd")
+			+ ".txt");
+}
@@ -23,6 +23,7 @@ protected:
 	QUrl closeObjectUrl();
 	QUrl reportUrl(bool isPreliminary);
 	QUrl formUrl();
+	void closeObjectEvent();
 
 private:
 	QString m_CashRegisterKey;
@@ -12,6 +12,7 @@
 #include "../available_cash_dialog/available_cash_dialog.h"
 #include "../search_deposit_dialog/search_deposit_dialog.h"
 #include "../recordset/recordset_searcher_factory.h"
+#include "../diagnostics/allocation_tracker.h"
 
 /**
  * @class DepositSection
@@ -274,6 +275,7 @@ void DepositSection::cancelDocument()
 		element.addClass("cancel_status");
 
 		m_DocumentStatus = Cancelled;
+		invalidateDocumentSnapshot();
 		updateActions();
 	} else {
 		m_AuthenticationDlg->passwordLineEdit()->setText("");
@@ -414,23 +416,38 @@ void DepositSection::setActionsManager()
  */
 void DepositSection::setPlugins()
 {
+	AllocationScope scope(AllocationTracker::Plugins);
+
 	DocumentSection::setPlugins();
 
-	// Ownership taken by the section in case the widget is never shown.
-	m_SlipNumberLineEdit = new LineEditPlugin(this);
-	m_SlipNumberLineEdit->hide();
-	webPluginFactory()
-			->install("application/x-slip_number_line_edit",
-					m_SlipNumberLineEdit);
+	// Reuse the widgets the last page did not take. The ones the section no
+	// longer owns are deleted with the page that has them.
+	m_SlipNumberLineEdit = dynamic_cast<LineEditPlugin*>(webPluginFactory()
+			->widget("application/x-slip_number_line_edit"));
+
+	if (m_SlipNumberLineEdit == 0 || m_SlipNumberLineEdit->parent() != this) {
+		// Ownership taken by the section in case the widget is never shown.
+		m_SlipNumberLineEdit = new LineEditPlugin(this);
+		m_SlipNumberLineEdit->hide();
+		webPluginFactory()
+				->install("application/x-slip_number_line_edit",
+						m_SlipNumberLineEdit);
+	}
 
 	connect(m_SlipNumberLineEdit, SIGNAL(blurAndChanged(QString)), this,
-			SLOT(setNumber(QString)));
-
-	// Ownership taken by the section in case the widget is never shown.
-	m_BankAccountComboBox = new ComboBox(this);
-	m_BankAccountComboBox->hide();
-	webPluginFactory()
-			->install("application/x-bank_account_combo_box", m_BankAccountComboBox);
+			SLOT(setNumber(QString)), Qt::UniqueConnection);
+
+	m_BankAccountComboBox = dynamic_cast<ComboBox*>(webPluginFactory()
+			->widget("application/x-bank_account_combo_box"));
+
+	if (m_BankAccountComboBox == 0 || m_BankAccountComboBox->parent() != this) {
+		// Ownership taken by the section in case the widget is never shown.
+		m_BankAccountComboBox = new ComboBox(this);
+		m_BankAccountComboBox->hide();
+		webPluginFactory()
+				->install("application/x-bank_account_combo_box",
+						m_BankAccountComboBox);
+	}
 }
 
 /**
@@ -519,6 +536,12 @@ void DepositSection::createDocumentEvent(bool ok,
 	if (ok) {
 		// Add bank accounts to the combo box.
 		QMap<QString, QString> *params = list->at(1);
+
+		// The combo box could have been used before by a page that was not shown.
+		disconnect(m_BankAccountComboBox, SIGNAL(currentIndexChanged(int)), this,
+				SLOT(setBankAccount(int)));
+		m_BankAccountComboBox->clear();
+
 		m_BankAccountComboBox->addItem("");
 		QMapIterator<QString, QString> i(*params);
 		while (i.hasNext()) {
@@ -10,6 +10,7 @@
 
 #include "document_section.h"
 
+#include <QPointer>
 #include "../plugins/line_edit_plugin.h"
 #include "../plugins/combo_box.h"
 
@@ -47,8 +48,8 @@ protected:
 	void createDocumentEvent(bool ok, QList<QMap<QString, QString>*> *list = 0);
 
 private:
-	LineEditPlugin *m_SlipNumberLineEdit;
-	ComboBox *m_BankAccountComboBox;
+	QPointer<LineEditPlugin> m_SlipNumberLineEdit;
+	QPointer<ComboBox> m_BankAccountComboBox;
 
 	QString navigateValues();
 };
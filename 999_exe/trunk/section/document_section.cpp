@@ -17,6 +17,9 @@
 #include "../registry.h"
 #include "../console/console_factory.h"
 #include "../xml_transformer/xml_transformer_factory.h"
+#include "../document_cache/document_snapshot_cache.h"
+#include "../diagnostics/latency_timer.h"
+#include "../diagnostics/allocation_tracker.h"
 
 /**
  * Constructs the section.
@@ -32,16 +35,20 @@ DocumentSection::DocumentSection(QNetworkCookieJar *jar, QWebPluginFactory *fact
 
 	m_Console = ConsoleFactory::instance()->createHtmlConsole();
 	m_Request = new HttpRequest(jar, this);
+	m_StatusRequest = new HttpRequest(jar, this);
 	m_Handler = new XmlResponseHandler(this);
 
-	connect(ui.webView, SIGNAL(loadFinished(bool)), this,
-				SLOT(loadFinished(bool)));
 	connect(m_Handler, SIGNAL(sessionStatusChanged(bool)), this,
 			SIGNAL(sessionStatusChanged(bool)));
 	connect(&m_Recordset, SIGNAL(recordChanged(QString)), this,
 			SLOT(fetchDocument(QString)));
+	connect(m_StatusRequest, SIGNAL(finished(QString)), this,
+			SLOT(updateCashRegisterStatus(QString)));
 
 	m_Query = new QXmlQuery(QXmlQuery::XSLT20);
+
+	m_Prefetcher = new DocumentPrefetcher(jar, serverUrl, this);
+	m_Prefetcher->setCashRegisterKey(m_CashRegisterKey);
 }
 
 /**
@@ -64,6 +71,10 @@ void DocumentSection::init()
 
 	fetchStyleSheet();
 
+	m_Prefetcher->setGetDocumentCmd(m_GetDocumentCmd);
+	m_Prefetcher->setGetDocumentDetailsCmd(m_GetDocumentDetailsCmd);
+	m_Prefetcher->setStyleSheet(m_StyleSheet);
+
 	refreshRecordset();
 
 	if (m_Recordset.size() > 0) {
@@ -161,14 +172,9 @@ void DocumentSection::loadFinished(bool ok)
 	Section::loadFinished(ok);
 
 	if (ok) {
-		QWebFrame *frame = ui.webView->page()->mainFrame();
-		m_CashRegisterStatus =
-				CashRegisterStatus(frame->evaluateJavaScript("cashRegisterStatus")
-						.toInt());
-		m_DocumentStatus =
-				DocumentStatus(frame->evaluateJavaScript("documentStatus").toInt());
-
-		m_DocumentKey = frame->evaluateJavaScript("objectKey").toString();
+		m_CashRegisterStatus = CashRegisterStatus(m_PageState.cashRegisterStatus);
+		m_DocumentStatus = DocumentStatus(m_PageState.documentStatus);
+		m_DocumentKey = m_PageState.objectKey;
 	} else {
 		m_CashRegisterStatus = Error;
 	}
@@ -177,7 +183,7 @@ void DocumentSection::loadFinished(bool ok)
 
 	// If a document was loaded.
 	if (m_DocumentKey != "")
-		fetchDocumentDetails(m_DocumentKey);
+		showDocumentDetails();
 
 	updateActions();
 }
@@ -187,10 +193,14 @@ void DocumentSection::loadFinished(bool ok)
  */
 void DocumentSection::fetchDocument(QString id)
 {
+	leaveDocumentEvent();
+
 	// If there was an invoice on the session. Remove it.
 	if (m_DocumentKey != "")
 		removeDocumentFromSession();
 
+	m_DocumentId = id;
+
 	// Reinstall plugins because they will be lost on the page load.
 	setPlugins();
 
@@ -206,6 +216,10 @@ void DocumentSection::fetchDocument(QString id)
  */
 void DocumentSection::unloadSection()
 {
+	m_Prefetcher->stop();
+
+	leaveDocumentEvent();
+
 	// If there was a document on the session. Remove it.
 	if (m_DocumentKey != "")
 		removeDocumentFromSession();
@@ -218,6 +232,8 @@ void DocumentSection::unloadSection()
  */
 void DocumentSection::createDocument()
 {
+	leaveDocumentEvent();
+
 	m_Console->reset();
 
 	QUrl url(*m_ServerUrl);
@@ -282,8 +298,6 @@ void DocumentSection::updateCashRegisterStatus(QString content)
 	}
 
 	delete transformer;
-
-	m_Request->disconnect(this);
 }
 
 /**
@@ -417,8 +431,7 @@ void DocumentSection::refreshRecordset()
 	QString errorMsg;
 	if (m_Handler->handle(content, transformer, &errorMsg) ==
 			XmlResponseHandler::Success) {
-		QList<QMap<QString, QString>*> list = transformer->content();
-		m_Recordset.setList(list);
+		m_Recordset.setList(transformer->takeContent());
 	} else {
 		m_Console->displayError(errorMsg);
 	}
@@ -431,24 +444,10 @@ void DocumentSection::refreshRecordset()
  */
 void DocumentSection::fetchDocumentDetails(QString documentKey)
 {
-	QUrl url(*m_ServerUrl);
-	url.addQueryItem("cmd", m_GetDocumentDetailsCmd);
-	url.addQueryItem("key", documentKey);
-	url.addQueryItem("type", "xml");
-
-	QString content = m_Request->get(url);
-
-	// Must copy object to be reentrant and thread safe.
-	QXmlQuery qry(*m_Query);
-	qry.setFocus(content);
-	qry.setQuery(m_StyleSheet);
-
-	QString result;
-	qry.evaluateTo(&result);
+	QString content = requestDocumentDetails(documentKey);
+	displayDocumentDetails(transformDocumentDetails(content));
 
-	QWebElement div = ui.webView->page()->mainFrame()->findFirstElement("#details");
-	div.setInnerXml(result);
-	div.evaluateJavaScript("this.scrollTop = this.scrollHeight;");
+	fetchDocumentDetailsEvent(content);
 }
 
 /**
@@ -456,6 +455,8 @@ void DocumentSection::fetchDocumentDetails(QString documentKey)
  */
 void DocumentSection::fetchDocumentForm()
 {
+	m_DocumentId = "";
+
 	// Reinstall plugins because they will be lost on the page load.
 	setPlugins();
 
@@ -465,6 +466,14 @@ void DocumentSection::fetchDocumentForm()
 	loadUrl(url);
 }
 
+/**
+ * Discards the snapshot of the document on display because it has changed.
+ */
+void DocumentSection::invalidateDocumentSnapshot()
+{
+	DocumentSnapshotCache::instance()->invalidate(m_GetDocumentCmd, m_DocumentId);
+}
+
 /**
  * Removes the new document object from the session on the server.
  */
@@ -475,7 +484,7 @@ void DocumentSection::removeNewDocumentFromSession()
 	url.addQueryItem("key", m_NewDocumentKey);
 	url.addQueryItem("type", "xml");
 
-	m_Request->get(url, true);
+	m_Request->defer(url);
 }
 
 /**
@@ -510,9 +519,20 @@ WebPluginFactory* DocumentSection::webPluginFactory()
  */
 void DocumentSection::setPlugins()
 {
-	m_RecordsetLabel = new Label();
+	AllocationScope scope(AllocationTracker::Plugins);
+
+	// Reuse the label if the last page did not take it.
+	m_RecordsetLabel = dynamic_cast<Label*>(webPluginFactory()
+			->widget("application/x-recordset"));
+
+	if (m_RecordsetLabel == 0) {
+		// Ownership taken by the section in case the widget is never shown.
+		m_RecordsetLabel = new Label(this);
+		m_RecordsetLabel->hide();
+		webPluginFactory()->install("application/x-recordset", m_RecordsetLabel);
+	}
+
 	m_RecordsetLabel->setText(m_Recordset.text());
-	webPluginFactory()->install("application/x-recordset", m_RecordsetLabel);
 }
 
 /**
@@ -524,6 +544,23 @@ void DocumentSection::createDocumentEvent(bool ok,
 
 }
 
+/**
+ * Reimplement this method for using the details xml fetched from the server.
+ */
+void DocumentSection::fetchDocumentDetailsEvent(QString content)
+{
+
+}
+
+/**
+ * Reimplement this method for finishing the work on the document displayed
+ * before another one takes its place or the section is unloaded.
+ */
+void DocumentSection::leaveDocumentEvent()
+{
+
+}
+
 /**
  * Fetch the xslt style sheet from the server.
  */
@@ -535,6 +572,91 @@ void DocumentSection::fetchStyleSheet()
 	m_StyleSheet = m_Request->get(url);
 }
 
+/**
+ * Displays the details of the loaded document. Finished and cancelled documents
+ * are taken from the snapshot cache if possible. Afterwards the neighbour
+ * documents are prefetched.
+ */
+void DocumentSection::showDocumentDetails()
+{
+	DocumentSnapshotCache *cache = DocumentSnapshotCache::instance();
+
+	// Documents in edition still change.
+	bool isCacheable = (m_DocumentId != "" && m_DocumentStatus != Edit);
+
+	QString details;
+	if (isCacheable && cache->find(m_GetDocumentCmd, m_DocumentId, &details)) {
+		displayDocumentDetails(details);
+	} else {
+		QString content = requestDocumentDetails(m_DocumentKey);
+		details = transformDocumentDetails(content);
+		displayDocumentDetails(details);
+
+		fetchDocumentDetailsEvent(content);
+
+		if (isCacheable) {
+			XmlTransformer *transformer = XmlTransformerFactory::instance()
+					->create("stub");
+
+			// Do not keep error responses.
+			if (m_Handler->handle(content, transformer) ==
+					XmlResponseHandler::Success)
+				cache->insert(m_GetDocumentCmd, m_DocumentId, details);
+
+			delete transformer;
+		}
+	}
+
+	if (m_DocumentId != "")
+		m_Prefetcher->prefetch(m_Recordset
+				.neighbourIds(Registry::instance()->documentPrefetchCount()));
+}
+
+/**
+ * Fetchs the document details xml from the server.
+ */
+QString DocumentSection::requestDocumentDetails(QString documentKey)
+{
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", m_GetDocumentDetailsCmd);
+	url.addQueryItem("key", documentKey);
+	url.addQueryItem("type", "xml");
+
+	return m_Request->get(url);
+}
+
+/**
+ * Transforms the document details xml into html using the style sheet.
+ */
+QString DocumentSection::transformDocumentDetails(QString content)
+{
+	LatencyTimer timer("xslt");
+	AllocationScope scope(AllocationTracker::Details);
+
+	// Must copy object to be reentrant and thread safe.
+	QXmlQuery qry(*m_Query);
+	qry.setFocus(content);
+	qry.setQuery(m_StyleSheet);
+
+	QString result;
+	qry.evaluateTo(&result);
+
+	return result;
+}
+
+/**
+ * Sets the details html into the page's details div.
+ */
+void DocumentSection::displayDocumentDetails(QString details)
+{
+	LatencyTimer timer("dom");
+	AllocationScope scope(AllocationTracker::Details);
+
+	QWebElement div = ui.webView->page()->mainFrame()->findFirstElement("#details");
+	div.setInnerXml(details);
+	div.evaluateJavaScript("this.scrollTop = this.scrollHeight;");
+}
+
 /**
  * Removes the document object from the session on the server.
  */
@@ -545,7 +667,7 @@ void DocumentSection::removeDocumentFromSession()
 	url.addQueryItem("key", m_DocumentKey);
 	url.addQueryItem("type", "xml");
 
-	m_Request->get(url, true);
+	m_Request->defer(url);
 }
 
 /**
@@ -558,8 +680,6 @@ void DocumentSection::fetchCashRegisterStatus()
 	url.addQueryItem("key", m_CashRegisterKey);
 	url.addQueryItem("type", "xml");
 
-	connect(m_Request, SIGNAL(finished(QString)), this,
-			SLOT(updateCashRegisterStatus(QString)));
-
-	m_Request->get(url, true);
+	// Its own request, the deferred removals answer on m_Request.
+	m_StatusRequest->defer(url);
 }
@@ -20,6 +20,7 @@
 #include "../actions_manager/actions_manager.h"
 #include "../authentication_dialog/authentication_dialog.h"
 #include "../plugins/label.h"
+#include "../document_cache/document_prefetcher.h"
 
 class DocumentSection: public Section
 {
@@ -72,6 +73,7 @@ protected:
 
 	QString m_NewDocumentKey;
 	QString m_DocumentKey;
+	QString m_DocumentId;
 	QString m_CashRegisterKey;
 
 	CashRegisterStatus m_CashRegisterStatus;
@@ -100,6 +102,9 @@ protected:
 	void refreshRecordset();
 	void fetchDocumentDetails(QString documentKey);
 	void fetchDocumentForm();
+	void invalidateDocumentSnapshot();
+	QString transformDocumentDetails(QString content);
+	void displayDocumentDetails(QString details);
 	virtual void removeNewDocumentFromSession();
 	virtual void prepareDocumentForm(QString username);
 	WebPluginFactory* webPluginFactory();
@@ -107,6 +112,8 @@ protected:
 
 	virtual void createDocumentEvent(bool ok,
 			QList<QMap<QString, QString>*> *list = 0);
+	virtual void fetchDocumentDetailsEvent(QString content);
+	virtual void leaveDocumentEvent();
 
 	virtual void setActions() = 0;
 	virtual void setMenu() = 0;
@@ -127,7 +134,12 @@ private:
 
 	QString m_ItemsName;
 
+	DocumentPrefetcher *m_Prefetcher;
+	HttpRequest *m_StatusRequest;
+
 	void fetchStyleSheet();
+	void showDocumentDetails();
+	QString requestDocumentDetails(QString documentKey);
 	void removeDocumentFromSession();
 	void fetchCashRegisterStatus();
 };
@@ -34,8 +34,6 @@ ObjectSection::ObjectSection(QNetworkCookieJar *jar,
 	m_Request = new HttpRequest(jar, this);
 	m_Handler = new XmlResponseHandler(this);
 
-	connect(ui.webView, SIGNAL(loadFinished(bool)), this,
-				SLOT(loadFinished(bool)));
 	connect(m_Handler, SIGNAL(sessionStatusChanged(bool)), this,
 			SIGNAL(sessionStatusChanged(bool)));
 }
@@ -100,10 +98,7 @@ void ObjectSection::loadFinished(bool ok)
 	Section::loadFinished(ok);
 
 	if (ok) {
-		QWebFrame *frame = ui.webView->page()->mainFrame();
-		m_ObjectStatus =
-				ObjectStatus(frame->evaluateJavaScript("objectStatus")
-						.toInt());
+		m_ObjectStatus = ObjectStatus(m_PageState.objectStatus);
 	} else {
 		m_ObjectStatus = Error;
 	}
@@ -169,6 +164,8 @@ void ObjectSection::closeObject()
 
 		updateActions();
 
+		closeObjectEvent();
+
 	} else {
 		m_Console->displayError(errorMsg);
 	}
@@ -176,6 +173,14 @@ void ObjectSection::closeObject()
 	delete transformer;
 }
 
+/**
+ * Reimplement this method for extending functionality after closing the object.
+ */
+void ObjectSection::closeObjectEvent()
+{
+
+}
+
 /**
  * Creates the QActions for the menu bar.
  */
@@ -46,6 +46,7 @@ protected:
 	virtual QUrl closeObjectUrl() = 0;
 	virtual QUrl reportUrl(bool isPreliminary) = 0;
 	virtual QUrl formUrl() = 0;
+	virtual void closeObjectEvent();
 
 private:
 	Console *m_Console;
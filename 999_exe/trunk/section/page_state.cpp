@@ -0,0 +1,97 @@
+/*
+ * page_state.cpp
+ *
+ *  Created on: 21/11/2011
+ *      Author: pc
+ */
+
+#include "page_state.h"
+
+#include <QRegExp>
+#include <QVariantMap>
+#include <QWebFrame>
+
+/**
+ * @class PageState
+ * The state the server puts on every page as the pageState javascript object.
+ * It is read once after the page loads, the values missing on the page keep
+ * their defaults.
+ */
+
+/**
+ * Constructs the state of a page without any.
+ */
+PageState::PageState() : isSessionActive(false), cashRegisterStatus(0),
+		documentStatus(0), objectStatus(0)
+{
+
+}
+
+/**
+ * Reads the pageState object from the frame on a single javascript call.
+ */
+PageState PageState::read(QWebFrame *frame)
+{
+	QVariantMap values = frame->evaluateJavaScript("pageState").toMap();
+
+	PageState state;
+	state.isSessionActive = values.value("isSessionActive").toBool();
+	state.cashRegisterStatus = values.value("cashRegisterStatus").toInt();
+	state.documentStatus = values.value("documentStatus").toInt();
+	state.objectStatus = values.value("objectStatus").toInt();
+	state.objectKey = values.value("objectKey").toString();
+
+	return state;
+}
+
+/**
+ * Reads the pageState object from the html of a page that is not displayed.
+ * Takes the object literal first and then the assignments to its fields the
+ * same as the page script does.
+ */
+PageState PageState::parse(QString html)
+{
+	PageState state;
+
+	QRegExp objectRx("var pageState\\s*=\\s*\\{([^}]*)\\}");
+	if (objectRx.indexIn(html) != -1) {
+		QString fields = objectRx.cap(1);
+		QRegExp fieldRx("(\\w+)\\s*:\\s*([^,]+)");
+
+		int pos = 0;
+		while ((pos = fieldRx.indexIn(fields, pos)) != -1) {
+			state.setValue(fieldRx.cap(1), fieldRx.cap(2));
+			pos += fieldRx.matchedLength();
+		}
+	}
+
+	QRegExp assignmentRx("pageState\\.(\\w+)\\s*=\\s*([^;]+);");
+
+	int pos = 0;
+	while ((pos = assignmentRx.indexIn(html, pos)) != -1) {
+		state.setValue(assignmentRx.cap(1), assignmentRx.cap(2));
+		pos += assignmentRx.matchedLength();
+	}
+
+	return state;
+}
+
+/**
+ * Sets the field with the javascript value given.
+ */
+void PageState::setValue(QString name, QString value)
+{
+	value = value.trimmed().remove("'").remove("\"");
+
+	if (name == "isSessionActive") {
+		isSessionActive = (value == "true");
+	} else if (name == "cashRegisterStatus") {
+		cashRegisterStatus = value.toInt();
+	} else if (name == "documentStatus") {
+		documentStatus = value.toInt();
+	} else if (name == "objectStatus") {
+		objectStatus = value.toInt();
+	} else if (name == "objectKey") {
+		objectKey = value;
+	}
+}
@@ -0,0 +1,31 @@
+/*
+ * page_state.h
+ *
+ *  Created on: 21/11/2011
+ *      Author: pc
+ */
+
+#ifndef PAGE_STATE_H_
+#define PAGE_STATE_H_
+
+#include <QString>
+
+class QWebFrame;
+
+struct PageState
+{
+	bool isSessionActive;
+	int cashRegisterStatus;
+	int documentStatus;
+	int objectStatus;
+	QString objectKey;
+
+	PageState();
+	static PageState read(QWebFrame *frame);
+	static PageState parse(QString html);
+
+private:
+	void setValue(QString name, QString value);
+};
+
+#endif /* PAGE_STATE_H_ */
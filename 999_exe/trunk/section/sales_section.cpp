@@ -10,8 +10,14 @@
 #include <QList>
 #include <QPrinter>
 #include <QMessageBox>
+#include <QInputDialog>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <QTextDocument>
 #include "../xml_transformer/xml_transformer_factory.h"
 #include "../customer_dialog/customer_dialog.h"
+#include "../customer_dialog/customer_cache.h"
 #include "../registry.h"
 #include "../discount_dialog/discount_dialog.h"
 #include "cash_receipt_section.h"
@@ -20,12 +26,36 @@
 #include "../search_invoice_dialog/search_invoice_dialog.h"
 #include "../consult_product_dialog/consult_product_dialog.h"
 #include "../printer_status_handler/printer_status_handler.h"
+#include "../sales_journal/sales_journal.h"
+#include "../sales_journal/product_catalog.h"
+#include "../sales_journal/journal_replayer.h"
+#include "../diagnostics/trace_span.h"
+#include "../diagnostics/allocation_tracker.h"
+#include "../pricing/pricing_engine.h"
+#include "../validation/validation_rule_engine.h"
+#include "../logger/logger.h"
+#include "../web_cache/web_cache.h"
+#include "../reference_data/reference_data.h"
 
 /**
  * @class SalesSection
  * Section in charge of managing the invoice documents.
+ * If the server can not be reached the section works offline. The invoices are
+ * then recorded on the SalesJournal, priced with the local ProductCatalog and
+ * paid only with cash. They are sent to the server once it is back.
+ * If a scanner device is set on the Registry the bar codes are read by a
+ * ScannerReader and wait on its queue while a page is loading.
+ * The same bar code scanned again within the Registry's merge interval is added
+ * once with the quantities summed. Each scan is shown at once on a provisional
+ * row until the line is sent.
  */
 
+// Milliseconds between each attempt to reach the server while offline.
+static const int RECONNECT_INTERVAL = 10000;
+
+// Milliseconds to wait for a dialog to close before adding the scans.
+static const int SCAN_RETRY_INTERVAL = 100;
+
 /**
  * Constructs the section.
  */
@@ -34,13 +64,82 @@ SalesSection::SalesSection(QNetworkCookieJar *jar, QWebPluginFactory *factory,
 		: DocumentSection(jar, factory, serverUrl, cashRegisterKey, parent)
 {
 	m_ProductModel = 0;
+
+	m_IsOffline = false;
+	m_OfflineInvoice = 0;
+
+	m_Scanner = 0;
+	m_IsProcessingScans = false;
+
+	m_ScanCoalescer = new ScanCoalescer(this);
+	m_ScanCoalescer->setInterval(Registry::instance()->scanMergeInterval());
+	m_IsSendingProduct = false;
+
+	m_HasDetailRows = false;
+
+	m_ReconnectTimer = new QTimer(this);
+	m_ReconnectTimer->setInterval(RECONNECT_INTERVAL);
+	m_PingRequest = new HttpRequest(jar, this);
+	m_PingRequest->setTimeout(RECONNECT_INTERVAL / 2);
+
+	connect(m_ReconnectTimer, SIGNAL(timeout()), this, SLOT(checkConnection()));
+	connect(m_ScanCoalescer, SIGNAL(timeout()), this, SLOT(sendMergedScan()));
+	connect(ReferenceData::instance(), SIGNAL(listChanged(QString)), this,
+			SLOT(updateList(QString)));
+	connect(m_PingRequest, SIGNAL(finished(QString)), this,
+			SLOT(connectionChecked(QString)), Qt::QueuedConnection);
+	connect(m_Handler, SIGNAL(connectionLost()), this, SLOT(goOffline()),
+			Qt::QueuedConnection);
+	connect(ui.webView, SIGNAL(loadFinished(bool)), this,
+			SLOT(checkPageLoaded(bool)), Qt::QueuedConnection);
 }
 
 /**
- * Sets a customer to the invoice in the server.
+ * Sends the merged line still waiting, stops the scanner and destroys the
+ * offline invoice if any.
+ */
+SalesSection::~SalesSection()
+{
+	flushScans();
+
+	delete m_Scanner;
+	delete m_OfflineInvoice;
+	qDeleteAll(m_DetailRows);
+}
+
+/**
+ * Sends the invoices made offline, sets the V.A.T. percentage and fetches the
+ * validation rules before initializing the section. The most frequent customers
+ * are revalidated in the background for the shift.
+ */
+void SalesSection::init()
+{
+	replayJournal();
+	setVatPercentage();
+	ValidationRuleEngine::instance()->fetch(m_Request, m_Handler, *m_ServerUrl);
+
+	CustomerCache *customers = CustomerCache::instance();
+	customers->setServer(m_Request->cookieJar(), *m_ServerUrl);
+	customers->prefetch(Registry::instance()->customerPrefetchCount());
+
+	DocumentSection::init();
+
+	startScanner();
+}
+
+/**
+ * Sets a customer to the invoice in the server and keeps it on the
+ * CustomerCache.
  */
 void SalesSection::setCustomer()
 {
+	if (m_IsOffline) {
+		setCustomerOfflineInvoice();
+		return;
+	}
+
+	flushScans();
+
 	CustomerDialog dialog(m_Request->cookieJar(), m_ServerUrl, this,
 			Qt::WindowTitleHint);
 
@@ -48,10 +147,19 @@ void SalesSection::setCustomer()
 			SIGNAL(sessionStatusChanged(bool)), Qt::QueuedConnection);
 
 	if (dialog.exec() == QDialog::Accepted) {
+		QString nit = dialog.nitLineEdit()->text();
 		QUrl url(*m_ServerUrl);
-		url.addQueryItem("cmd", "set_customer_invoice");
-		url.addQueryItem("key", m_NewDocumentKey);
-		url.addQueryItem("customer_key", dialog.customerKey());
+
+		// A cached customer is set by its nit, it has no session object.
+		if (dialog.customerKey() == "") {
+			url.addQueryItem("cmd", "set_customer_nit_invoice");
+			url.addQueryItem("key", m_NewDocumentKey);
+			url.addQueryItem("nit", nit);
+		} else {
+			url.addQueryItem("cmd", "set_customer_invoice");
+			url.addQueryItem("key", m_NewDocumentKey);
+			url.addQueryItem("customer_key", dialog.customerKey());
+		}
 		url.addQueryItem("type", "xml");
 
 		QString content = m_Request->get(url);
@@ -60,12 +168,19 @@ void SalesSection::setCustomer()
 				->create("invoice_customer");
 
 		QString errorMsg;
-		if (m_Handler->handle(content, transformer, &errorMsg) ==
-				XmlResponseHandler::Success) {
+		XmlResponseHandler::ResponseType response =
+				m_Handler->handle(content, transformer, &errorMsg);
+		if (response == XmlResponseHandler::Success) {
 			QList<QMap<QString, QString>*> list = transformer->content();
 			updateCustomerData(list[0]->value("nit"), list[0]->value("name"));
 			m_Console->cleanFailure("nit");
+
+			CustomerCache::instance()->insert(nit, list[0]->value("name"));
 		} else {
+			// The cached customer is not on the server anymore.
+			if (response == XmlResponseHandler::Failure)
+				CustomerCache::instance()->remove(nit);
+
 			m_Console->displayError(errorMsg);
 		}
 
@@ -74,28 +189,29 @@ void SalesSection::setCustomer()
 }
 
 /**
- * Adds a product to the invoice in the server.
+ * Adds a product to the invoice in the server. The bar code and quantity are
+ * checked with the validation rules first. A merged line still waiting is sent
+ * before it to keep the order.
  */
 void SalesSection::addProductInvoice(QString barCode, QString quantity)
 {
-	QUrl url(*m_ServerUrl);
-	url.addQueryItem("cmd", "add_product_invoice");
-	url.addQueryItem("key", m_NewDocumentKey);
-	url.addQueryItem("bar_code", barCode);
-	url.addQueryItem("quantity", quantity);
-	url.addQueryItem("type", "xml");
+	TraceSpan span("addProductInvoice");
 
-	QString content = m_Request->get(url);
+	if (m_IsOffline) {
+		addProductOfflineInvoice(barCode, quantity);
+		return;
+	}
 
-	XmlTransformer *transformer = XmlTransformerFactory::instance()
-			->create("stub");
+	flushScans();
+
+	if (!validateProduct(barCode, quantity))
+		return;
 
 	QString errorMsg, elementId;
 	XmlResponseHandler::ResponseType response =
-			m_Handler->handle(content, transformer, &errorMsg, &elementId);
+			sendProductInvoice(barCode, quantity, &errorMsg, &elementId);
 	if (response == XmlResponseHandler::Success) {
 		QApplication::beep();
-		fetchDocumentDetails(m_NewDocumentKey);
 		m_Console->reset();
 		m_BarCodeLineEdit->setText("");
 	} else if (response == XmlResponseHandler::Failure) {
@@ -104,8 +220,119 @@ void SalesSection::addProductInvoice(QString barCode, QString quantity)
 	} else {
 		m_Console->displayError(errorMsg);
 	}
+}
 
-	delete transformer;
+/**
+ * Adds a scanned product. If the same bar code is scanned again before the merge
+ * interval passes both scans are sent as one line with the quantities summed.
+ * Meanwhile the scan is shown on a provisional row.
+ */
+void SalesSection::scanProduct(QString barCode, QString quantity)
+{
+	bool ok;
+	int qty = quantity.toInt(&ok);
+
+	if (m_IsOffline || m_ScanCoalescer->interval() == 0 || !ok || qty < 1) {
+		addProductInvoice(barCode, quantity);
+		return;
+	}
+
+	if (!validateProduct(barCode, quantity))
+		return;
+
+	// A different bar code, the waiting line goes first.
+	bool isSent = true;
+	if (!m_ScanCoalescer->add(barCode, qty)) {
+		isSent = flushScans();
+		m_ScanCoalescer->add(barCode, qty);
+	}
+
+	QApplication::beep();
+	displayPendingScan();
+
+	// Do not hide the failure of the line sent.
+	if (isSent) {
+		m_Console->reset();
+		m_BarCodeLineEdit->setText("");
+	}
+}
+
+/**
+ * Sends the merged line once the interval passed without the same bar code
+ * being scanned. Waits again if a page, a dialog or a request is in the way.
+ */
+void SalesSection::sendMergedScan()
+{
+	if (m_IsSendingProduct || m_CashRegisterStatus == Loading
+			|| QApplication::activeModalWidget() != 0) {
+		m_ScanCoalescer->restart();
+		return;
+	}
+
+	flushScans();
+}
+
+/**
+ * Adds the bar codes read by the scanner to the invoice. If a page is loading
+ * they stay on the queue until it finishes, if a dialog is open until it is
+ * closed. If there is no invoice to add them to they are discarded.
+ */
+void SalesSection::processScans()
+{
+	// Adding a product waits for the server, more scans can arrive meanwhile.
+	if (m_Scanner == 0 || m_IsProcessingScans)
+		return;
+
+	if (m_CashRegisterStatus == Loading)
+		return;
+
+	if (QApplication::activeModalWidget() != 0) {
+		if (m_Scanner->hasScans())
+			QTimer::singleShot(SCAN_RETRY_INTERVAL, this, SLOT(processScans()));
+		return;
+	}
+
+	m_IsProcessingScans = true;
+
+	bool isEditing = m_IsOffline ? m_OfflineInvoice != 0
+			: (m_CashRegisterStatus == Open && m_DocumentStatus == Edit);
+
+	QString barCode, quantity;
+	while (m_CashRegisterStatus != Loading && m_Scanner->take(&barCode, &quantity)) {
+		if (!isEditing) {
+			Logger::log(Logger::Warning, "scan_discarded", "bar_code", barCode);
+			m_Console->displayError("No hay factura abierta, se descarto la "
+					"lectura " + barCode + ".");
+			continue;
+		}
+
+		TraceSpan span("scan", true);
+		Logger::log(Logger::Debug, "scan", "bar_code", barCode, "quantity",
+				quantity);
+
+		// Shown on the line edit in case it fails, as if it was typed.
+		m_BarCodeLineEdit->setText(quantity == "1" ? barCode
+				: quantity + "*" + barCode);
+		scanProduct(barCode, quantity);
+	}
+
+	m_IsProcessingScans = false;
+}
+
+/**
+ * Tells the cashier the scanner stopped working. Until the reader opens it again
+ * the scanner is used as a keyboard on the bar code line edit.
+ */
+void SalesSection::scannerConnectionChanged(bool isConnected)
+{
+	if (isConnected)
+		return;
+
+	m_Console->displayError("Se perdio la conexion con el lector, mientras tanto "
+			"funciona como teclado.");
+
+	if (m_BarCodeLineEdit != 0 && m_BarCodeLineEdit->isEnabled())
+		m_BarCodeLineEdit->setFocus();
 }
 
 /**
@@ -113,6 +340,8 @@ void SalesSection::addProductInvoice(QString barCode, QString quantity)
  */
 void SalesSection::showAuthenticationDialogForDiscount()
 {
+	flushScans();
+
 	m_AuthenticationDlg = new AuthenticationDialog(this, Qt::WindowTitleHint);
 	m_AuthenticationDlg->setAttribute(Qt::WA_DeleteOnClose);
 	m_AuthenticationDlg->setModal(true);
@@ -167,10 +396,19 @@ void SalesSection::createDiscount()
 }
 
 /**
- * Validates the invoice before creating the cash receipt.
+ * Validates the invoice before creating the cash receipt. If the merged line
+ * waiting could not be added the cashier must see it first.
  */
 void SalesSection::validate()
 {
+	if (m_IsOffline) {
+		saveOfflineInvoice();
+		return;
+	}
+
+	if (!flushScans())
+		return;
+
 	QUrl url(*m_ServerUrl);
 	url.addQueryItem("cmd", "validate_invoice");
 	url.addQueryItem("invoice_key", m_NewDocumentKey);
@@ -286,6 +524,7 @@ void SalesSection::showVouchers()
 	QHBoxLayout *layout = new QHBoxLayout(&dialog);
 
 	QWebView view;
+	WebCache::instance()->install(view.page());
 	view.page()->networkAccessManager()->setCookieJar(m_Request->cookieJar());
 	m_Request->cookieJar()->setParent(0);
 	view.load(url);
@@ -350,6 +589,7 @@ void SalesSection::cancelDocument()
 		element.addClass("cancel_status");
 
 		m_DocumentStatus = Cancelled;
+		invalidateDocumentSnapshot();
 		updateActions();
 
 		printCancelInvoice();
@@ -363,6 +603,144 @@ void SalesSection::cancelDocument()
 	delete transformer;
 }
 
+/**
+ * Creates a new invoice on the server or an offline one.
+ */
+void SalesSection::createInvoice()
+{
+	if (m_IsOffline) {
+		createOfflineInvoice();
+	} else {
+		createDocument();
+	}
+}
+
+/**
+ * Discards the new invoice.
+ */
+void SalesSection::discardInvoice()
+{
+	if (m_IsOffline) {
+		discardOfflineInvoice();
+	} else {
+		// The cashier may still decide to keep it.
+		flushScans();
+		discardDocument();
+	}
+}
+
+/**
+ * Deletes a row from the new invoice.
+ */
+void SalesSection::deleteItemInvoice()
+{
+	if (m_IsOffline) {
+		deleteItemOfflineInvoice();
+	} else {
+		flushScans();
+		deleteItemDocument();
+	}
+}
+
+/**
+ * Starts working offline because the server could not be reached. The invoice
+ * being created on the server is lost. Nothing is done if the server said the
+ * cash register is closed.
+ */
+void SalesSection::goOffline()
+{
+	if (m_IsOffline)
+		return;
+
+	QWebFrame *frame = ui.webView->page()->mainFrame();
+	if (m_CashRegisterStatus == Closed
+			&& !frame->findFirstElement("#cash_register_status").isNull())
+		return;
+
+	discardPendingScan();
+
+	m_IsOffline = true;
+	m_NewDocumentKey = "";
+	m_CashReceiptKey = "";
+	m_DocumentKey = "";
+
+	// Use the local copy if the style sheet could not be fetched.
+	if (m_StyleSheet == "") {
+		QFile file(":/resources/invoice_details.xsl");
+		file.open(QIODevice::ReadOnly);
+		QTextStream stream(&file);
+		m_StyleSheet = stream.readAll();
+		file.close();
+	}
+
+	closeOfflineInvoice();
+
+	m_ReconnectTimer->start();
+}
+
+/**
+ * Tries to reach the server if there is no offline invoice in process.
+ */
+void SalesSection::checkConnection()
+{
+	if (m_OfflineInvoice != 0 || m_PingRequest->isBusy())
+		return;
+
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", "get_is_open_cash_register");
+	url.addQueryItem("key", m_CashRegisterKey);
+	url.addQueryItem("type", "xml");
+
+	m_PingRequest->defer(url);
+}
+
+/**
+ * If the server responded it sends the offline invoices and works online again.
+ */
+void SalesSection::connectionChecked(QString content)
+{
+	if (content == "" || m_OfflineInvoice != 0 || !m_IsOffline)
+		return;
+
+	m_ReconnectTimer->stop();
+	m_IsOffline = false;
+
+	replayJournal();
+
+	refreshRecordset();
+
+	if (m_Recordset.size() > 0) {
+		m_Recordset.moveLast();
+	} else {
+		fetchDocumentForm();
+	}
+}
+
+/**
+ * Works offline if the page could not be loaded.
+ */
+void SalesSection::checkPageLoaded(bool ok)
+{
+	if (!ok)
+		goOffline();
+}
+
+/**
+ * Prints the invoice created on the server for the offline one.
+ */
+void SalesSection::offlineInvoiceReplayed(QString localId, QString invoiceId)
+{
+	printInvoice(invoiceId);
+}
+
+/**
+ * Keeps the conflict message for showing it after the replay.
+ */
+void SalesSection::reportConflict(QString localId, QString message)
+{
+	m_ReplayConflicts << "Factura " + localId + ": " + message;
+}
+
 /**
  * Creates the QActions for the menu bar.
  */
@@ -370,7 +748,7 @@ void SalesSection::setActions()
 {
 	m_NewAction = new QAction("Crear", this);
 	m_NewAction->setShortcut(Qt::Key_Insert);
-	connect(m_NewAction, SIGNAL(triggered()), this, SLOT(createDocument()));
+	connect(m_NewAction, SIGNAL(triggered()), this, SLOT(createInvoice()));
 
 	m_SaveAction = new QAction("Guardar", this);
 	m_SaveAction->setShortcut(tr("Ctrl+S"));
@@ -378,7 +756,7 @@ void SalesSection::setActions()
 
 	m_DiscardAction = new QAction("Cancelar", this);
 	m_DiscardAction->setShortcut(Qt::Key_Escape);
-	connect(m_DiscardAction, SIGNAL(triggered()), this, SLOT(discardDocument()));
+	connect(m_DiscardAction, SIGNAL(triggered()), this, SLOT(discardInvoice()));
 
 	m_CancelAction = new QAction("Anular", this);
 	m_CancelAction->setShortcut(Qt::Key_F12);
@@ -401,7 +779,7 @@ void SalesSection::setActions()
 	m_DeleteItemAction = new QAction("Quitar producto", this);
 	m_DeleteItemAction->setShortcut(tr("Ctrl+D"));
 	connect(m_DeleteItemAction, SIGNAL(triggered()), this,
-			SLOT(deleteItemDocument()));
+			SLOT(deleteItemInvoice()));
 
 	m_SearchProductAction = new QAction("Buscar producto", this);
 	m_SearchProductAction->setShortcut(Qt::Key_F5);
@@ -519,14 +897,262 @@ void SalesSection::setActionsManager()
  */
 void SalesSection::setPlugins()
 {
+	AllocationScope scope(AllocationTracker::Plugins);
+
 	DocumentSection::setPlugins();
 
-	m_BarCodeLineEdit = new BarCodeLineEdit();
-	webPluginFactory()
-			->install("application/x-bar_code_line_edit", m_BarCodeLineEdit);
+	// Reuse the line edit if the last page did not take it. One the section no
+	// longer owns is deleted with the page that has it.
+	m_BarCodeLineEdit = dynamic_cast<BarCodeLineEdit*>(webPluginFactory()
+			->widget("application/x-bar_code_line_edit"));
+
+	if (m_BarCodeLineEdit == 0 || m_BarCodeLineEdit->parent() != this) {
+		// Ownership taken by the section in case the widget is never shown.
+		m_BarCodeLineEdit = new BarCodeLineEdit(this);
+		m_BarCodeLineEdit->hide();
+		webPluginFactory()
+				->install("application/x-bar_code_line_edit", m_BarCodeLineEdit);
+	}
 
 	connect(m_BarCodeLineEdit, SIGNAL(returnPressedBarCode(QString, QString)),
-			this, SLOT(addProductInvoice(QString, QString)));
+			this, SLOT(scanProduct(QString, QString)), Qt::UniqueConnection);
+}
+
+/**
+ * Starts reading the scanner device if there is one on the Registry. If it can
+ * not be opened the scanner must be used as a keyboard.
+ */
+void SalesSection::startScanner()
+{
+	Registry *registry = Registry::instance();
+
+	if (registry->scannerDevice() == "")
+		return;
+
+	m_Scanner = new ScannerReader();
+
+	if (!m_Scanner->open(registry->scannerDevice(), registry->scannerType(),
+			registry->scannerBaudRate())) {
+		Logger::log(Logger::Error, "scanner_failed", "device",
+				registry->scannerDevice(), "error", m_Scanner->errorString());
+		QMessageBox::warning(this, "Lector", m_Scanner->errorString());
+
+		delete m_Scanner;
+		m_Scanner = 0;
+		return;
+	}
+
+	connect(m_Scanner, SIGNAL(scanned()), this, SLOT(processScans()),
+			Qt::QueuedConnection);
+	connect(m_Scanner, SIGNAL(connectionChanged(bool)), this,
+			SLOT(scannerConnectionChanged(bool)), Qt::QueuedConnection);
+	m_Scanner->start();
+}
+
+/**
+ * Checks the bar code and quantity with the validation rules.
+ */
+bool SalesSection::validateProduct(QString barCode, QString quantity)
+{
+	QMap<QString, QString> values;
+	values.insert("bar_code", barCode);
+	values.insert("quantity", quantity);
+
+	QString errorMsg, elementId;
+	if (!ValidationRuleEngine::instance()->validate("product_invoice", values,
+			&errorMsg, &elementId)) {
+		m_Console->cleanFailure(elementId);
+		m_Console->displayFailure(errorMsg, elementId);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Adds the product to the invoice on the server and fetches the details again if
+ * it was added. The line and the totals are shown while the server answers.
+ */
+XmlResponseHandler::ResponseType SalesSection::sendProductInvoice(
+		QString barCode, QString quantity, QString *errorMsg, QString *elementId)
+{
+	m_IsSendingProduct = true;
+
+	displayPendingLine(barCode, quantity.toInt());
+
+	QUrl url(*m_ServerUrl);
+	url.addQueryItem("cmd", "add_product_invoice");
+	url.addQueryItem("key", m_NewDocumentKey);
+	url.addQueryItem("bar_code", barCode);
+	url.addQueryItem("quantity", quantity);
+	url.addQueryItem("type", "xml");
+
+	QString content = m_Request->get(url);
+
+	XmlTransformer *transformer = XmlTransformerFactory::instance()
+			->create("stub");
+
+	XmlResponseHandler::ResponseType response =
+			m_Handler->handle(content, transformer, errorMsg, elementId);
+	if (response == XmlResponseHandler::Success) {
+		fetchDocumentDetails(m_NewDocumentKey);
+	} else {
+		removePendingLine();
+	}
+
+	delete transformer;
+
+	m_IsSendingProduct = false;
+
+	return response;
+}
+
+/**
+ * Sends the merged line if there is one. If it fails the provisional row is
+ * removed, the line is left on the bar code line edit and the failure names the
+ * scans merged on it. Returns false if it was not added.
+ */
+bool SalesSection::flushScans()
+{
+	QString barCode;
+	int quantity, scans;
+
+	if (!m_ScanCoalescer->take(&barCode, &quantity, &scans))
+		return true;
+
+	QString errorMsg, elementId;
+	XmlResponseHandler::ResponseType response = sendProductInvoice(barCode,
+			QString::number(quantity), &errorMsg, &elementId);
+
+	if (response == XmlResponseHandler::Success)
+		return true;
+
+	Logger::log(Logger::Warning, "merged_scan_failed", "bar_code", barCode,
+			"quantity", QString::number(quantity), "scans",
+			QString::number(scans));
+
+	if (m_BarCodeLineEdit != 0)
+		m_BarCodeLineEdit->setText(quantity == 1 ? barCode
+				: QString::number(quantity) + "*" + barCode);
+
+	QString scansMsg = (scans == 1) ? "1 lectura" : QString::number(scans)
+			+ " lecturas";
+	errorMsg += " (" + barCode + " x " + QString::number(quantity) + ", "
+			+ scansMsg + ")";
+
+	if (response == XmlResponseHandler::Failure) {
+		m_Console->cleanFailure(elementId);
+		m_Console->displayFailure(errorMsg, elementId);
+	} else {
+		m_Console->displayError(errorMsg);
+	}
+
+	return false;
+}
+
+/**
+ * Discards the merged line because the invoice it belongs to is lost.
+ */
+void SalesSection::discardPendingScan()
+{
+	if (!m_ScanCoalescer->hasPending())
+		return;
+
+	Logger::log(Logger::Warning, "scan_discarded", "bar_code",
+			m_ScanCoalescer->barCode(), "quantity",
+			QString::number(m_ScanCoalescer->quantity()));
+
+	m_ScanCoalescer->clear();
+}
+
+/**
+ * Shows the merged line on a provisional row at the end of the details.
+ */
+void SalesSection::displayPendingScan()
+{
+	displayPendingLine(m_ScanCoalescer->barCode(), m_ScanCoalescer->quantity());
+}
+
+/**
+ * Shows the line on a provisional row at the end of the details, with the name
+ * and price from the local catalog if it is there, and the totals with it.
+ */
+void SalesSection::displayPendingLine(QString barCode, int quantity)
+{
+	QWebFrame *frame = ui.webView->page()->mainFrame();
+
+	QWebElement body = frame->findFirstElement("#details tbody");
+	if (body.isNull())
+		return;
+
+	QWebElement row = frame->findFirstElement("#pending_scan");
+	if (row.isNull()) {
+		body.appendInside("<tr id=\"pending_scan\" class=\"pending\"></tr>");
+		row = frame->findFirstElement("#pending_scan");
+	}
+
+	QString name, price, total;
+	if (ProductCatalog::instance()->find(barCode, &name, &price)) {
+		total = PricingEngine::fromCents(PricingEngine::lineTotal(quantity,
+				PricingEngine::toCents(price)));
+		displayTotals(quantity, price);
+	} else {
+		name = barCode;
+	}
+
+	row.setInnerXml("<td>" + QString::number(quantity) + "</td><td>"
+			+ Qt::escape(name) + "</td><td>" + price + "</td><td class=\"total_col\">"
+			+ total + "</td><td></td>");
+
+	frame->findFirstElement("#details")
+			.evaluateJavaScript("this.scrollTop = this.scrollHeight;");
+}
+
+/**
+ * Removes the provisional row and shows the totals without it.
+ */
+void SalesSection::removePendingLine()
+{
+	QWebElement row = ui.webView->page()->mainFrame()
+			->findFirstElement("#pending_scan");
+
+	if (!row.isNull()) {
+		row.removeFromDocument();
+		displayTotals();
+	}
+}
+
+/**
+ * Shows the invoice totals computed by the PricingEngine from the last details
+ * received plus the provisional line if its quantity is not zero. Returns the
+ * totals shown.
+ */
+InvoiceTotals SalesSection::displayTotals(int quantity, QString price)
+{
+	QList<QMap<QString, QString>*> rows = m_DetailRows;
+
+	QMap<QString, QString> pending;
+	if (quantity != 0) {
+		pending.insert("quantity", QString::number(quantity));
+		pending.insert("price", price);
+		rows << &pending;
+	}
+
+	InvoiceTotals totals = PricingEngine::instance()->invoiceTotals(rows,
+			m_DiscountPercentage);
+
+	if (!m_HasDetailRows)
+		return totals;
+
+	QWebFrame *frame = ui.webView->page()->mainFrame();
+	frame->findFirstElement("#sub_total")
+			.setInnerXml(PricingEngine::fromCents(totals.subTotal));
+	frame->findFirstElement("#discount")
+			.setInnerXml(PricingEngine::fromCents(totals.discount));
+	frame->findFirstElement("#total")
+			.setInnerXml(PricingEngine::fromCents(totals.total));
+
+	return totals;
 }
 
 /**
@@ -536,6 +1162,20 @@ void SalesSection::updateActions()
 {
 	QString values;
 
+	if (m_IsOffline && m_CashRegisterStatus != Loading) {
+		if (m_OfflineInvoice != 0) {
+			values = "011001010110000000";
+			m_BarCodeLineEdit->setEnabled(true);
+		} else {
+			values = "100010000110000000";
+			m_BarCodeLineEdit->setEnabled(false);
+		}
+
+		m_ActionsManager.updateActions(values);
+		processScans();
+		return;
+	}
+
 	switch (m_CashRegisterStatus) {
 		case Open:
 			if (m_DocumentStatus == Edit) {
@@ -567,6 +1207,7 @@ void SalesSection::updateActions()
 	}
 
 	m_ActionsManager.updateActions(values);
+	processScans();
 }
 
 /**
@@ -583,10 +1224,7 @@ void SalesSection::removeNewDocumentFromSession()
 		url.addQueryItem("key", m_CashReceiptKey);
 		url.addQueryItem("type", "xml");
 
-		HttpRequest request(ui.webView->page()->networkAccessManager()
-				->cookieJar(), this);
-
-		request.get(url, true);
+		m_Request->defer(url);
 
 		m_CashReceiptKey = "";
 	}
@@ -648,6 +1286,74 @@ void SalesSection::createDocumentEvent(bool ok, QList<QMap<QString, QString>*> *
 	}
 }
 
+/**
+ * Keeps the rows of the details received and shows the totals computed from
+ * them, with the merged line still waiting if any. The amounts from the server
+ * are only compared with the local ones if the cross check is enabled.
+ */
+void SalesSection::fetchDocumentDetailsEvent(QString content)
+{
+	clearDetailRows();
+
+	XmlTransformer *transformer = XmlTransformerFactory::instance()
+			->create("invoice_totals");
+
+	if (m_Handler->handle(content, transformer) == XmlResponseHandler::Success) {
+		QList<QMap<QString, QString>*> list = transformer->takeContent();
+		QMap<QString, QString> *params = list.takeFirst();
+
+		m_DetailRows = list;
+		m_DiscountPercentage = params->value("discount_percentage");
+		m_HasDetailRows = true;
+
+		InvoiceTotals totals = displayTotals();
+
+		if (m_ScanCoalescer->hasPending())
+			displayPendingScan();
+
+		if (Registry::instance()->pricingCrossCheck()) {
+			PricingEngine *pricing = PricingEngine::instance();
+
+			for (int i = 0; i < m_DetailRows.size(); i++)
+				pricing->crossCheck("line_total", PricingEngine::lineTotal(
+						m_DetailRows[i]->value("quantity").toInt(),
+						PricingEngine::toCents(m_DetailRows[i]->value("price"))),
+						m_DetailRows[i]->value("total"));
+
+			pricing->crossCheck("sub_total", totals.subTotal,
+					params->value("sub_total"));
+			pricing->crossCheck("discount", totals.discount,
+					params->value("discount"));
+			pricing->crossCheck("total", totals.total, params->value("total"));
+		}
+
+		delete params;
+	}
+
+	delete transformer;
+}
+
+/**
+ * Forgets the rows of the details shown.
+ */
+void SalesSection::clearDetailRows()
+{
+	qDeleteAll(m_DetailRows);
+	m_DetailRows.clear();
+	m_DiscountPercentage = "";
+	m_HasDetailRows = false;
+}
+
+/**
+ * Sends the merged line to the invoice it was scanned for before the section
+ * shows another document.
+ */
+void SalesSection::leaveDocumentEvent()
+{
+	flushScans();
+	clearDetailRows();
+}
+
 /**
  * Auxiliary method for updating the QActions related to the recordset.
  */
@@ -777,6 +1483,8 @@ void SalesSection::showCashReceipt()
  */
 void SalesSection::printInvoice(QString id)
 {
+	TraceSpan span("printInvoice");
+
 	QUrl url(*m_ServerUrl);
 	url.addQueryItem("cmd", "print_invoice");
 	url.addQueryItem("id", id);
@@ -825,3 +1533,334 @@ void SalesSection::printCancelInvoice()
 	printer.setPrinterName(Registry::instance()->printerName());
 	webView.print(&printer);
 }
+
+/**
+ * Sets the V.A.T. percentage kept on the ReferenceData for computing the taxes
+ * on the client. Until it is fetched the taxes are not computed.
+ */
+void SalesSection::setVatPercentage()
+{
+	ReferenceData *data = ReferenceData::instance();
+
+	if (data->contains("vat_percentage")) {
+		PricingEngine::instance()->setVatPercentage(data->vatPercentage());
+	} else {
+		data->sync();
+	}
+}
+
+/**
+ * Sets the V.A.T. percentage again if it changed on the server.
+ */
+void SalesSection::updateList(QString name)
+{
+	if (name == "vat_percentage")
+		setVatPercentage();
+}
+
+/**
+ * Sends the invoices on the sales journal to the server. Shows the conflicts
+ * found if any.
+ */
+void SalesSection::replayJournal()
+{
+	JournalReplayer replayer(m_Request->cookieJar(), m_ServerUrl);
+
+	connect(&replayer, SIGNAL(sessionStatusChanged(bool)), this,
+			SIGNAL(sessionStatusChanged(bool)));
+	connect(&replayer, SIGNAL(invoiceReplayed(QString, QString)), this,
+			SLOT(offlineInvoiceReplayed(QString, QString)));
+	connect(&replayer, SIGNAL(conflictFound(QString, QString)), this,
+			SLOT(reportConflict(QString, QString)));
+
+	m_ReplayConflicts.clear();
+
+	replayer.replay();
+
+	if (!m_ReplayConflicts.isEmpty())
+		QMessageBox::warning(this, "Diario de ventas", "Problemas al enviar las "
+				"facturas hechas fuera de linea:\n\n" + m_ReplayConflicts.join("\n"));
+}
+
+/**
+ * Writes a record about the offline invoice on the sales journal.
+ */
+bool SalesSection::recordOfflineInvoice(QString type,
+		QMap<QString, QString> values)
+{
+	values.insert("type", type);
+	values.insert("invoice", m_OfflineInvoice->id());
+
+	if (!SalesJournal::instance()->append(values)) {
+		m_Console->displayError("No se pudo escribir en el diario de ventas: " +
+				SalesJournal::instance()->fileName());
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Creates an invoice on the sales journal.
+ */
+void SalesSection::createOfflineInvoice()
+{
+	m_Console->reset();
+
+	QDateTime now = QDateTime::currentDateTime();
+	m_OfflineInvoice = new OfflineInvoice(now.toString("yyyyMMddhhmmsszzz"),
+			m_CashRegisterKey, now.toString("dd/MM/yyyy hh:mm"));
+
+	QMap<QString, QString> values;
+	values.insert("register_key", m_CashRegisterKey);
+
+	if (!recordOfflineInvoice("invoice", values)) {
+		delete m_OfflineInvoice;
+		m_OfflineInvoice = 0;
+		return;
+	}
+
+	prepareDocumentForm("");
+
+	QWebFrame *frame = ui.webView->page()->mainFrame();
+	QWebElement element;
+
+	element = frame->findFirstElement("#status_label");
+	element.setInnerXml("Fuera de linea");
+
+	element = frame->findFirstElement("#date_time");
+	element.setInnerXml(m_OfflineInvoice->dateTime());
+
+	displayOfflineInvoice();
+
+	m_DocumentStatus = Edit;
+	updateActions();
+
+	setCustomer();
+	m_BarCodeLineEdit->setFocus();
+}
+
+/**
+ * Asks for the customer's data and sets it on the offline invoice.
+ */
+void SalesSection::setCustomerOfflineInvoice()
+{
+	bool ok;
+	QString nit = QInputDialog::getText(this, "Cliente", "Nit:", QLineEdit::Normal,
+			m_OfflineInvoice->nit(), &ok, Qt::WindowTitleHint).trimmed();
+
+	if (!ok || nit == "")
+		return;
+
+	// Known customers come from the cache.
+	QString name = m_OfflineInvoice->name();
+	CustomerCache::instance()->find(nit, &name);
+
+	name = QInputDialog::getText(this, "Cliente", "Nombre:",
+			QLineEdit::Normal, name, &ok, Qt::WindowTitleHint).trimmed();
+
+	if (!ok)
+		return;
+
+	QMap<QString, QString> values;
+	values.insert("nit", nit);
+	values.insert("name", name);
+
+	if (recordOfflineInvoice("customer", values)) {
+		m_OfflineInvoice->setCustomer(nit, name);
+		updateCustomerData(Qt::escape(nit), Qt::escape(name));
+		m_Console->cleanFailure("nit");
+	}
+}
+
+/**
+ * Adds a product from the local catalog to the offline invoice.
+ */
+void SalesSection::addProductOfflineInvoice(QString barCode, QString quantity)
+{
+	QString name, price;
+	int qty = quantity.toInt();
+
+	m_Console->cleanFailure("bar_code");
+
+	if (qty < 1) {
+		m_Console->displayFailure("Cantidad invalida.", "bar_code");
+		return;
+	}
+
+	if (!ProductCatalog::instance()->find(barCode, &name, &price)) {
+		m_Console->displayFailure("Producto no se encuentra en el catalogo local.",
+				"bar_code");
+		return;
+	}
+
+	QMap<QString, QString> values;
+	values.insert("bar_code", barCode);
+	values.insert("name", name);
+	values.insert("quantity", QString::number(qty));
+	values.insert("price", price);
+
+	if (recordOfflineInvoice("product", values)) {
+		m_OfflineInvoice->addProduct(barCode, name, qty, price);
+
+		QApplication::beep();
+		displayOfflineInvoice();
+		m_Console->reset();
+		m_BarCodeLineEdit->setText("");
+	}
+}
+
+/**
+ * Deletes a row from the offline invoice.
+ */
+void SalesSection::deleteItemOfflineInvoice()
+{
+	bool ok;
+	int row = QInputDialog::getInt(this, "Quitar Producto", "Fila #:", 0, 1, 9999,
+			1, &ok, Qt::WindowTitleHint);
+
+	if (ok && row <= m_OfflineInvoice->lines().size()) {
+		QMap<QString, QString> values;
+		values.insert("row", QString::number(row));
+
+		if (recordOfflineInvoice("delete_product", values)) {
+			m_OfflineInvoice->deleteProduct(row);
+			displayOfflineInvoice();
+		}
+	}
+}
+
+/**
+ * Discards the offline invoice.
+ */
+void SalesSection::discardOfflineInvoice()
+{
+	if (QMessageBox::question(this, "Cancelar", "Esta seguro que desea salir sin "
+			"guardar?", QMessageBox::Yes | QMessageBox::No) == QMessageBox::No)
+		return;
+
+	if (recordOfflineInvoice("discard"))
+		closeOfflineInvoice();
+}
+
+/**
+ * Receives the payment in cash and prints the offline invoice.
+ */
+void SalesSection::saveOfflineInvoice()
+{
+	m_Console->reset();
+
+	if (m_OfflineInvoice->nit() == "") {
+		m_Console->displayFailure("Ingrese el nit del cliente.", "nit");
+		return;
+	}
+
+	if (m_OfflineInvoice->lines().isEmpty()) {
+		m_Console->displayFailure("No hay productos en la factura.", "bar_code");
+		return;
+	}
+
+	bool ok;
+	QString amount = QInputDialog::getText(this, "Recibo", "Total: " +
+			m_OfflineInvoice->total() + "\nEfectivo:", QLineEdit::Normal,
+			m_OfflineInvoice->total(), &ok, Qt::WindowTitleHint);
+
+	if (!ok)
+		return;
+
+	qint64 cash = PricingEngine::toCents(amount);
+	if (cash < PricingEngine::toCents(m_OfflineInvoice->total())) {
+		m_Console->displayError("Efectivo insuficiente.");
+		return;
+	}
+
+	QMap<QString, QString> values;
+	values.insert("cash", QString::number(cash / 100) + "."
+			+ QString::number(cash % 100).rightJustified(2, '0'));
+
+	if (!recordOfflineInvoice("cash_receipt", values))
+		return;
+
+	m_OfflineInvoice->setCash(values.value("cash"));
+
+	printOfflineInvoice();
+
+	QMessageBox::information(this, "Cambio", "Cambio: " +
+			m_OfflineInvoice->change());
+
+	closeOfflineInvoice();
+}
+
+/**
+ * Displays the offline invoice details with the style sheet.
+ */
+void SalesSection::displayOfflineInvoice()
+{
+	displayDocumentDetails(transformDocumentDetails(
+			m_OfflineInvoice->detailsXml()));
+}
+
+/**
+ * Prints a provisional ticket for the offline invoice. The invoice is printed
+ * when it is created on the server.
+ */
+void SalesSection::printOfflineInvoice()
+{
+	QString html = "<html><body><p>COMPROBANTE PROVISIONAL</p>"
+			"<p>Fecha: " + m_OfflineInvoice->dateTime() + "<br />"
+			"Nit: " + Qt::escape(m_OfflineInvoice->nit()) + "<br />"
+			"Cliente: " + Qt::escape(m_OfflineInvoice->name()) + "</p><table>";
+
+	QList<QMap<QString, QString>*> lines = m_OfflineInvoice->lines();
+	for (int i = 0; i < lines.size(); i++) {
+		qint64 price = PricingEngine::toCents(lines[i]->value("price"));
+		int quantity = lines[i]->value("quantity").toInt();
+
+		html += "<tr><td>" + lines[i]->value("quantity") + "</td><td>"
+				+ Qt::escape(lines[i]->value("name")) + "</td><td>"
+				+ PricingEngine::fromCents(PricingEngine::lineTotal(quantity, price))
+				+ "</td></tr>";
+	}
+
+	html += "</table><p>Total: " + m_OfflineInvoice->total() + "<br />";
+
+	PricingEngine *pricing = PricingEngine::instance();
+	if (pricing->hasVatPercentage())
+		html += "I.V.A.: " + PricingEngine::fromCents(PricingEngine::vat(
+				PricingEngine::toCents(m_OfflineInvoice->total()), 0,
+				pricing->vatPercentage())) + "<br />";
+
+	html += "Efectivo: " + PricingEngine::fromCents(
+				PricingEngine::toCents(m_OfflineInvoice->cash())) + "<br />"
+			"Cambio: " + m_OfflineInvoice->change() + "</p>"
+			"<p>Su factura sera emitida al restablecerse la conexion.</p>"
+			"</body></html>";
+
+	QWebView webView;
+
+	webView.setHtml(html);
+
+	QPrinter printer;
+	printer.setPrinterName(Registry::instance()->printerName());
+	webView.print(&printer);
+}
+
+/**
+ * Finishes with the offline invoice and loads the offline form.
+ */
+void SalesSection::closeOfflineInvoice()
+{
+	delete m_OfflineInvoice;
+	m_OfflineInvoice = 0;
+
+	// Reinstall plugins because they will be lost on the page load.
+	setPlugins();
+
+	QFile file(":/resources/offline_invoice.html");
+	file.open(QIODevice::ReadOnly);
+	QTextStream stream(&file);
+
+	ui.webView->setHtml(stream.readAll());
+
+	file.close();
+}
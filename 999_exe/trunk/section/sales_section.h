@@ -10,9 +10,16 @@
 
 #include "document_section.h"
 
+#include <QTimer>
+#include <QPointer>
+#include <QStringList>
 #include "../plugins/bar_code_line_edit.h"
 #include "../search_product/search_product_model.h"
 #include "../cancel_invoice_dialog/cancel_invoice_dialog.h"
+#include "../sales_journal/offline_invoice.h"
+#include "../scanner/scanner_reader.h"
+#include "../scanner/scan_coalescer.h"
+#include "../pricing/pricing_engine.h"
 
 class SalesSection: public DocumentSection
 {
@@ -21,11 +28,14 @@ class SalesSection: public DocumentSection
 public:
 	SalesSection(QNetworkCookieJar *jar, QWebPluginFactory *factory,
 			QUrl *serverUrl, QString cashRegisterKey, QWidget *parent = 0);
-	virtual ~SalesSection() {};
+	virtual ~SalesSection();
+	void init();
 
 public slots:
 	void setCustomer();
 	void addProductInvoice(QString barCode, QString quantity);
+	void scanProduct(QString barCode, QString quantity);
+	void sendMergedScan();
 	void showAuthenticationDialogForDiscount();
 	void createDiscount();
 	void validate();
@@ -36,6 +46,18 @@ public slots:
 	void showVouchers();
 	void checkPrinterForCancel();
 	void cancelDocument();
+	void createInvoice();
+	void discardInvoice();
+	void deleteItemInvoice();
+	void goOffline();
+	void checkConnection();
+	void connectionChecked(QString content);
+	void checkPageLoaded(bool ok);
+	void offlineInvoiceReplayed(QString localId, QString invoiceId);
+	void reportConflict(QString localId, QString message);
+	void processScans();
+	void scannerConnectionChanged(bool isConnected);
+	void updateList(QString name);
 
 protected:
 	CancelInvoiceDialog *m_CancelInvoiceDlg;
@@ -58,12 +80,27 @@ protected:
 	void prepareDocumentForm(QString username);
 
 	void createDocumentEvent(bool ok, QList<QMap<QString, QString>*> *list = 0);
+	void fetchDocumentDetailsEvent(QString content);
+	void leaveDocumentEvent();
 
 private:
-	BarCodeLineEdit *m_BarCodeLineEdit;
+	QPointer<BarCodeLineEdit> m_BarCodeLineEdit;
 	QString m_CashReceiptKey;
 	SearchProductModel *m_ProductModel;
 
+	bool m_IsOffline;
+	OfflineInvoice *m_OfflineInvoice;
+	QTimer *m_ReconnectTimer;
+	HttpRequest *m_PingRequest;
+	QStringList m_ReplayConflicts;
+	ScannerReader *m_Scanner;
+	bool m_IsProcessingScans;
+	ScanCoalescer *m_ScanCoalescer;
+	bool m_IsSendingProduct;
+	QList<QMap<QString, QString>*> m_DetailRows;
+	QString m_DiscountPercentage;
+	bool m_HasDetailRows;
+
 	QString navigateValues();
 	void updateCustomerData(QString nit, QString name);
 	void setDiscountInvoice(QString discountKey);
@@ -71,6 +108,30 @@ private:
 	void printInvoice(QString id);
 	void showAuthenticationDialogForCancel();
 	void printCancelInvoice();
+	void setVatPercentage();
+	void startScanner();
+	bool validateProduct(QString barCode, QString quantity);
+	XmlResponseHandler::ResponseType sendProductInvoice(QString barCode,
+			QString quantity, QString *errorMsg, QString *elementId);
+	bool flushScans();
+	void discardPendingScan();
+	void displayPendingScan();
+	void displayPendingLine(QString barCode, int quantity);
+	void removePendingLine();
+	InvoiceTotals displayTotals(int quantity = 0, QString price = "");
+	void clearDetailRows();
+	void replayJournal();
+	bool recordOfflineInvoice(QString type, QMap<QString, QString> values =
+			QMap<QString, QString>());
+	void createOfflineInvoice();
+	void setCustomerOfflineInvoice();
+	void addProductOfflineInvoice(QString barCode, QString quantity);
+	void deleteItemOfflineInvoice();
+	void discardOfflineInvoice();
+	void saveOfflineInvoice();
+	void displayOfflineInvoice();
+	void printOfflineInvoice();
+	void closeOfflineInvoice();
 };
 
 #endif /* SALES_SECTION_H_ */
@@ -4,6 +4,7 @@
 #include <QWebFrame>
 #include <QFile>
 #include <QTextStream>
+#include "../web_cache/web_cache.h"
 
 /**
  * @class Section
@@ -18,6 +19,7 @@ Section::Section(QNetworkCookieJar *jar, QWebPluginFactory *factory,
 {
 	ui.setupUi(this);
 
+	WebCache::instance()->install(ui.webView->page());
 	ui.webView->page()->networkAccessManager()->setCookieJar(jar);
 	jar->setParent(0);
 	ui.webView->page()->setPluginFactory(factory);
@@ -29,17 +31,19 @@ Section::Section(QNetworkCookieJar *jar, QWebPluginFactory *factory,
 
 /**
  * Slot use to detect if the page loads successfully. If not the QWebView displays
- * an error message.
+ * an error message. The page's state is read here once for the whole section.
  */
 void Section::loadFinished(bool ok)
 {
 	QWebFrame *frame = ui.webView->page()->mainFrame();
 
 	if (ok) {
-		bool sessionStatus = frame->evaluateJavaScript("isSessionActive").toBool();
+		m_PageState = PageState::read(frame);
 
-		emit sessionStatusChanged(sessionStatus);
+		emit sessionStatusChanged(m_PageState.isSessionActive);
 	} else {
+		m_PageState = PageState();
+
 		QFile file(":/resources/not_found.html");
 		file.open(QIODevice::ReadOnly);
 		QTextStream stream(&file);
@@ -53,3 +57,11 @@ void Section::loadFinished(bool ok)
 
 	frame->addToJavaScriptWindowObject("mainWindow", parent());
 }
+
+/**
+ * Returns the state of the page last loaded.
+ */
+PageState Section::pageState()
+{
+	return m_PageState;
+}
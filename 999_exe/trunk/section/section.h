@@ -4,6 +4,8 @@
 #include <QtGui/QWidget>
 #include "ui_section.h"
 
+#include "page_state.h"
+
 class Section : public QWidget
 {
     Q_OBJECT
@@ -12,9 +14,10 @@ public:
     Section(QNetworkCookieJar *jar, QWebPluginFactory *factory,
     		QUrl *serverUrl, QWidget *parent = 0);
     ~Section() {};
+    PageState pageState();
 
 public slots:
-	void loadFinished(bool ok);
+	virtual void loadFinished(bool ok);
 
 signals:
 	void sessionStatusChanged(bool isActive);
@@ -22,6 +25,7 @@ signals:
 protected:
     Ui::SectionClass ui;
     QUrl *m_ServerUrl;
+    PageState m_PageState;
 };
 
 #endif // SECTION_H
@@ -0,0 +1,85 @@
+/*
+ * traffic_log_reader.cpp
+ *
+ *  Created on: 15/08/2011
+ *      Author: pc
+ */
+
+#include "traffic_log_reader.h"
+
+#include "traffic_recorder.h"
+
+/**
+ * @class TrafficLogReader
+ * Reads the records of a log written by the TrafficRecorder one at a time, so
+ * the log of a long shift does not need to fit in memory. A record cut short by
+ * a crash ends the reading.
+ */
+
+/**
+ * Constructs the reader for the log.
+ */
+TrafficLogReader::TrafficLogReader(QString fileName) : m_File(fileName)
+{
+}
+
+/**
+ * Closes the log.
+ */
+TrafficLogReader::~TrafficLogReader()
+{
+	m_File.close();
+}
+
+/**
+ * Opens the log and reads its header. Returns false if it is not a traffic log
+ * or its version is not known.
+ */
+bool TrafficLogReader::open()
+{
+	if (!m_File.open(QIODevice::ReadOnly))
+		return false;
+
+	m_Stream.setDevice(&m_File);
+	m_Stream.setVersion(QDataStream::Qt_4_6);
+
+	quint32 magic, version;
+	qint64 started;
+	m_Stream >> magic >> version >> started;
+
+	if (m_Stream.status() != QDataStream::Ok || magic != TRAFFIC_LOG_MAGIC
+			|| version != TRAFFIC_LOG_VERSION)
+		return false;
+
+	m_Started = QDateTime::fromMSecsSinceEpoch(started);
+
+	return true;
+}
+
+/**
+ * Returns when the capture started.
+ */
+QDateTime TrafficLogReader::started()
+{
+	return m_Started;
+}
+
+/**
+ * Reads the next record. Returns false at the end of the log.
+ */
+bool TrafficLogReader::next(TrafficRecord *record)
+{
+	if (m_Stream.atEnd())
+		return false;
+
+	QByteArray url, content;
+	m_Stream >> record->start >> record->duration >> url >> content;
+
+	if (m_Stream.status() != QDataStream::Ok)
+		return false;
+
+	record->url = QUrl::fromEncoded(url);
+	record->content = QString::fromUtf8(qUncompress(content));
+
+	return true;
+}
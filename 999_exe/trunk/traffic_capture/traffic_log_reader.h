@@ -0,0 +1,39 @@
+/*
+ * traffic_log_reader.h
+ *
+ *  Created on: 15/08/2011
+ *      Author: pc
+ */
+
+#ifndef TRAFFIC_LOG_READER_H_
+#define TRAFFIC_LOG_READER_H_
+
+#include <QFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QUrl>
+
+struct TrafficRecord
+{
+	qint64 start;
+	qint64 duration;
+	QUrl url;
+	QString content;
+};
+
+class TrafficLogReader
+{
+public:
+	TrafficLogReader(QString fileName);
+	virtual ~TrafficLogReader();
+	bool open();
+	QDateTime started();
+	bool next(TrafficRecord *record);
+
+private:
+	QFile m_File;
+	QDataStream m_Stream;
+	QDateTime m_Started;
+};
+
+#endif /* TRAFFIC_LOG_READER_H_ */
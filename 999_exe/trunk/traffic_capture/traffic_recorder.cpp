@@ -0,0 +1,101 @@
+/*
+ * traffic_recorder.cpp
+ *
+ *  Created on: 15/08/2011
+ *      Author: pc
+ */
+
+#include "traffic_recorder.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include "../registry.h"
+#include "../diagnostics/latency_recorder.h"
+
+/**
+ * @class TrafficRecorder
+ * Writes every request made through the HttpRequest on a binary log: the url,
+ * when it started, how long it took and the compressed response. A new
+ * traffic_yyyyMMdd_hhmmss.log file is created next to the exe on every run, so
+ * a whole shift can be replayed later against the real or a stand-in server.
+ * Each record is flushed as soon as it is written so a crash loses nothing.
+ * The pages loaded by the web views are not captured.
+ */
+
+TrafficRecorder* TrafficRecorder::m_Instance = 0;
+
+/**
+ * Constructs the recorder and creates the log if isEnabled is true.
+ */
+TrafficRecorder::TrafficRecorder(bool isEnabled, QObject *parent)
+		: QObject(parent)
+{
+	m_Start = LatencyRecorder::instance()->now();
+
+	if (!isEnabled)
+		return;
+
+	QDateTime started = QDateTime::currentDateTime();
+	m_File.setFileName(QApplication::applicationDirPath() + "/traffic_"
+			+ started.toString("yyyyMMdd_hhmmss") + ".log");
+
+	if (!m_File.open(QIODevice::WriteOnly))
+		return;
+
+	m_Stream.setDevice(&m_File);
+	m_Stream.setVersion(QDataStream::Qt_4_6);
+	m_Stream << TRAFFIC_LOG_MAGIC << TRAFFIC_LOG_VERSION
+			<< qint64(started.toMSecsSinceEpoch());
+	m_File.flush();
+}
+
+/**
+ * Closes the log.
+ */
+TrafficRecorder::~TrafficRecorder()
+{
+	m_File.close();
+}
+
+/**
+ * Returns the only instance.
+ */
+TrafficRecorder* TrafficRecorder::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new TrafficRecorder(Registry::instance()->captureTraffic(),
+				qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Returns true if the log is open.
+ */
+bool TrafficRecorder::isEnabled()
+{
+	return m_File.isOpen();
+}
+
+/**
+ * Returns the name of the log, empty if capture is disabled.
+ */
+QString TrafficRecorder::fileName()
+{
+	return isEnabled() ? m_File.fileName() : "";
+}
+
+/**
+ * Writes the request. Start and duration in microseconds on the LatencyRecorder
+ * clock. An empty content means the request failed or timed out.
+ */
+void TrafficRecorder::record(QUrl url, qint64 start, qint64 duration,
+		QString content)
+{
+	if (!m_File.isOpen())
+		return;
+
+	m_Stream << qint64(start - m_Start) << duration << url.toEncoded()
+			<< qCompress(content.toUtf8());
+	m_File.flush();
+}
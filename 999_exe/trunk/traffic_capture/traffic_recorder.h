@@ -0,0 +1,40 @@
+/*
+ * traffic_recorder.h
+ *
+ *  Created on: 15/08/2011
+ *      Author: pc
+ */
+
+#ifndef TRAFFIC_RECORDER_H_
+#define TRAFFIC_RECORDER_H_
+
+#include <QObject>
+#include <QFile>
+#include <QDataStream>
+#include <QUrl>
+
+// Marks the file as a traffic log, "999T".
+const quint32 TRAFFIC_LOG_MAGIC = 0x39393954;
+const quint32 TRAFFIC_LOG_VERSION = 1;
+
+class TrafficRecorder : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~TrafficRecorder();
+	bool isEnabled();
+	QString fileName();
+	void record(QUrl url, qint64 start, qint64 duration, QString content);
+	static TrafficRecorder* instance();
+
+private:
+	QFile m_File;
+	QDataStream m_Stream;
+	qint64 m_Start;
+	static TrafficRecorder *m_Instance;
+
+	TrafficRecorder(bool isEnabled, QObject *parent = 0);
+};
+
+#endif /* TRAFFIC_RECORDER_H_ */
@@ -0,0 +1,172 @@
+/*
+ * validation_rule_engine.cpp
+ *
+ *  Created on: 03/10/2011
+ *      Author: pc
+ */
+
+#include "validation_rule_engine.h"
+
+#include <QApplication>
+#include <QRegExp>
+#include <QDate>
+#include "../xml_transformer/xml_transformer_factory.h"
+
+/**
+ * @class ValidationRuleEngine
+ * Checks the values of a form with the validation rules obtained from the server
+ * before sending them, so the failures are displayed without a round trip. The
+ * rules are evaluated in the same order the server does and the first one that
+ * fails gives the message and the element id. If the rules could not be fetched
+ * every value is accepted and the server does the validation.
+ */
+
+ValidationRuleEngine* ValidationRuleEngine::m_Instance = 0;
+
+/**
+ * Constructs the engine without rules.
+ */
+ValidationRuleEngine::ValidationRuleEngine(QObject *parent) : QObject(parent)
+{
+	m_IsLoaded = false;
+}
+
+/**
+ * Destroys the rules.
+ */
+ValidationRuleEngine::~ValidationRuleEngine()
+{
+	qDeleteAll(m_Rules);
+}
+
+/**
+ * Fetches the rules from the server if they are not loaded yet.
+ */
+void ValidationRuleEngine::fetch(HttpRequest *request,
+		XmlResponseHandler *handler, QUrl url)
+{
+	if (m_IsLoaded)
+		return;
+
+	url.addQueryItem("cmd", "get_validation_rules");
+	url.addQueryItem("type", "xml");
+
+	QString content = request->get(url);
+
+	XmlTransformer *transformer = XmlTransformerFactory::instance()
+			->create("validation_rule_list");
+
+	if (handler->handle(content, transformer) == XmlResponseHandler::Success)
+		setRules(transformer->takeContent());
+
+	delete transformer;
+}
+
+/**
+ * Returns true if the rules were obtained.
+ */
+bool ValidationRuleEngine::isLoaded()
+{
+	return m_IsLoaded;
+}
+
+/**
+ * Replaces the rules. Each one has the form, field, rule, param and message
+ * values. Takes ownership of them.
+ */
+void ValidationRuleEngine::setRules(QList<QMap<QString, QString>*> rules)
+{
+	qDeleteAll(m_Rules);
+	m_Rules = rules;
+	m_IsLoaded = true;
+}
+
+/**
+ * Checks the values of the form by field name. Only the rules of the fields on
+ * the values are evaluated. Returns false with the message and the element id of
+ * the first rule that fails.
+ */
+bool ValidationRuleEngine::validate(QString form,
+		QMap<QString, QString> values, QString *message, QString *elementId)
+{
+	for (int i = 0; i < m_Rules.size(); i++) {
+		QMap<QString, QString> *rule = m_Rules[i];
+		QString field = rule->value("field");
+
+		if (rule->value("form") != form || !values.contains(field))
+			continue;
+
+		if (!check(rule->value("rule"), rule->value("param"),
+				values.value(field))) {
+			*message = rule->value("message");
+			*elementId = field;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Returns true if the value passes the rule. Unknown rules always pass.
+ */
+bool ValidationRuleEngine::check(QString rule, QString param, QString value)
+{
+	if (rule == "required") {
+		// The param has the input mask characters.
+		for (int i = 0; i < param.size(); i++)
+			value.remove(param[i]);
+
+		return value != "";
+	} else if (rule == "greater" || rule == "min") {
+		// The same as php's is_numeric.
+		QRegExp number("\\s*[+-]?(\\d+(\\.\\d*)?|\\.\\d+)([eE][+-]?\\d+)?");
+		if (!number.exactMatch(value))
+			return false;
+
+		double amount = value.trimmed().toDouble();
+		double limit = param.toDouble();
+
+		return rule == "greater" ? amount > limit : amount >= limit;
+	} else if (rule == "regexp") {
+		return QRegExp(param).exactMatch(value);
+	} else if (rule == "month_year") {
+		int month, year;
+		return parseMonthYear(value, &month, &year);
+	} else if (rule == "future_month") {
+		int month, year;
+		if (!parseMonthYear(value, &month, &year))
+			return true;
+
+		return QDate(year, month, 1) > QDate::currentDate();
+	}
+
+	return true;
+}
+
+/**
+ * Returns the only instance.
+ */
+ValidationRuleEngine* ValidationRuleEngine::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new ValidationRuleEngine(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Reads a 'mm/yy' date. Years from 50 are taken as 19yy, as the server does.
+ * Returns false if it is not a valid month.
+ */
+bool ValidationRuleEngine::parseMonthYear(QString value, int *month, int *year)
+{
+	QRegExp date("(\\d+)/(\\d+)");
+	if (!date.exactMatch(value))
+		return false;
+
+	*month = date.cap(1).toInt();
+	*year = ((date.cap(2).toInt() >= 50 ? "19" : "20") + date.cap(2)).toInt();
+
+	return *month >= 1 && *month <= 12;
+}
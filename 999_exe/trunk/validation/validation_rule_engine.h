@@ -0,0 +1,41 @@
+/*
+ * validation_rule_engine.h
+ *
+ *  Created on: 03/10/2011
+ *      Author: pc
+ */
+
+#ifndef VALIDATION_RULE_ENGINE_H_
+#define VALIDATION_RULE_ENGINE_H_
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include <QUrl>
+#include "../http_request/http_request.h"
+#include "../xml_response_handler/xml_response_handler.h"
+
+class ValidationRuleEngine : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~ValidationRuleEngine();
+	void fetch(HttpRequest *request, XmlResponseHandler *handler, QUrl url);
+	bool isLoaded();
+	void setRules(QList<QMap<QString, QString>*> rules);
+	bool validate(QString form, QMap<QString, QString> values, QString *message,
+			QString *elementId);
+	static bool check(QString rule, QString param, QString value);
+	static ValidationRuleEngine* instance();
+
+private:
+	QList<QMap<QString, QString>*> m_Rules;
+	bool m_IsLoaded;
+	static ValidationRuleEngine *m_Instance;
+
+	ValidationRuleEngine(QObject *parent = 0);
+	static bool parseMonthYear(QString value, int *month, int *year);
+};
+
+#endif /* VALIDATION_RULE_ENGINE_H_ */
@@ -3,6 +3,8 @@
 #include <QUrl>
 #include "../console/console_factory.h"
 #include "../xml_transformer/xml_transformer_factory.h"
+#include "../validation/validation_rule_engine.h"
+#include "../reference_data/reference_data.h"
 
 /**
  * @class VoucherDialog
@@ -39,39 +41,56 @@ VoucherDialog::~VoucherDialog()
 }
 
 /**
- * Populates the combo boxes with data from the server.
+ * Populates the combo boxes with the lists kept on the ReferenceData, they are
+ * refilled if they change while the dialog is open. Obtains the validation
+ * rules if they were not loaded yet.
  */
 void VoucherDialog::init()
 {
-	fetchTypes();
-	fetchBrands();
+	ReferenceData *data = ReferenceData::instance();
+	data->fill(ui.paymentCardTypeIdComboBox, "payment_card_type_list");
+	data->fill(ui.paymentCardBrandIdComboBox, "payment_card_brand_list");
+
+	connect(data, SIGNAL(listChanged(QString)), this, SLOT(updateList(QString)));
+
+	ValidationRuleEngine::instance()->fetch(m_Request, m_Handler, *m_ServerUrl);
 }
 
 /**
- * Adds a voucher to the cash receipt on the server.
+ * Adds a voucher to the cash receipt on the server. The values are checked with
+ * the validation rules first.
  */
 void VoucherDialog::addVoucherCashReceipt()
 {
-	QVariant id;
+	QMap<QString, QString> values;
+	values.insert("transaction_number", ui.transactionNumberLineEdit->text());
+	values.insert("payment_card_number", ui.paymentCardNumberLineEdit->text());
+	values.insert("payment_card_type_id", ui.paymentCardTypeIdComboBox
+			->itemData(ui.paymentCardTypeIdComboBox->currentIndex()).toString());
+	values.insert("payment_card_brand_id", ui.paymentCardBrandIdComboBox
+			->itemData(ui.paymentCardBrandIdComboBox->currentIndex()).toString());
+	values.insert("holder_name", ui.holderNameLineEdit->text());
+	values.insert("expiration_date", ui.expirationDateLineEdit->text());
+	values.insert("amount", ui.amountLineEdit->text());
+
+	QString errorMsg, elementId;
+	if (!ValidationRuleEngine::instance()->validate("voucher", values, &errorMsg,
+			&elementId)) {
+		displayFailure(errorMsg, elementId);
+		return;
+	}
 
 	QUrl url(*m_ServerUrl);
 	url.addQueryItem("cmd", "add_voucher_cash_receipt");
 	url.addQueryItem("cash_receipt_key", m_CashReceiptKey);
 	url.addQueryItem("invoice_key", m_InvoiceKey);
-	url.addQueryItem("transaction_number", ui.transactionNumberLineEdit->text());
-	url.addQueryItem("payment_card_number", ui.paymentCardNumberLineEdit->text());
-
-	id = ui.paymentCardTypeIdComboBox
-			->itemData(ui.paymentCardTypeIdComboBox->currentIndex());
-	url.addQueryItem("payment_card_type_id", id.toString());
 
-	id = ui.paymentCardBrandIdComboBox
-			->itemData(ui.paymentCardBrandIdComboBox->currentIndex());
-	url.addQueryItem("payment_card_brand_id", id.toString());
+	QMapIterator<QString, QString> i(values);
+	while (i.hasNext()) {
+		i.next();
+		url.addQueryItem(i.key(), i.value());
+	}
 
-	url.addQueryItem("holder_name", ui.holderNameLineEdit->text());
-	url.addQueryItem("expiration_date", ui.expirationDateLineEdit->text());
-	url.addQueryItem("amount", ui.amountLineEdit->text());
 	url.addQueryItem("type", "xml");
 
 	QString content = m_Request->get(url);
@@ -79,21 +98,12 @@ void VoucherDialog::addVoucherCashReceipt()
 	XmlTransformer *transformer = XmlTransformerFactory::instance()
 			->create("stub");
 
-	QString errorMsg, elementId;
 	XmlResponseHandler::ResponseType response =
 			m_Handler->handle(content, transformer, &errorMsg, &elementId);
 	if (response == XmlResponseHandler::Success) {
 		accept();
 	} else if (response == XmlResponseHandler::Failure) {
-		m_Console->reset();
-		m_Console->displayFailure(errorMsg, elementId);
-
-		m_FocusWidgets.value(elementId)->setFocus();
-
-		QLineEdit *lineEdit =
-				dynamic_cast<QLineEdit*>(m_FocusWidgets.value(elementId));
-		if (lineEdit != 0)
-			lineEdit->selectAll();
+		displayFailure(errorMsg, elementId);
 	} else {
 		m_Console->displayError(errorMsg);
 	}
@@ -101,6 +111,34 @@ void VoucherDialog::addVoucherCashReceipt()
 	delete transformer;
 }
 
+/**
+ * Refills the combo box of the list that changed.
+ */
+void VoucherDialog::updateList(QString name)
+{
+	if (name == "payment_card_type_list") {
+		ReferenceData::instance()->fill(ui.paymentCardTypeIdComboBox, name);
+	} else if (name == "payment_card_brand_list") {
+		ReferenceData::instance()->fill(ui.paymentCardBrandIdComboBox, name);
+	}
+}
+
+/**
+ * Displays the failure message and puts the focus on the field.
+ */
+void VoucherDialog::displayFailure(QString message, QString elementId)
+{
+	m_Console->reset();
+	m_Console->displayFailure(message, elementId);
+
+	m_FocusWidgets.value(elementId)->setFocus();
+
+	QLineEdit *lineEdit =
+			dynamic_cast<QLineEdit*>(m_FocusWidgets.value(elementId));
+	if (lineEdit != 0)
+		lineEdit->selectAll();
+}
+
 /**
  * Sets the Console object.
  */
@@ -126,69 +164,3 @@ void VoucherDialog::setConsole()
 	m_Console = ConsoleFactory::instance()->createWidgetConsole(elements);
 	m_Console->setFrame(ui.webView->page()->mainFrame());
 }
-
-/**
- * Populates the types combo box with data from the server.
- */
-void VoucherDialog::fetchTypes()
-{
-	QUrl url(*m_ServerUrl);
-	url.addQueryItem("cmd", "get_payment_card_type_list");
-	url.addQueryItem("type", "xml");
-
-	QString content = m_Request->get(url);
-
-	XmlTransformer *transformer = XmlTransformerFactory::instance()
-			->create("payment_card_type_list");
-
-	QString errorMsg;
-	if (m_Handler->handle(content, transformer, &errorMsg) ==
-			XmlResponseHandler::Success) {
-		QList<QMap<QString, QString>*> list = transformer->content();
-
-		ui.paymentCardTypeIdComboBox->addItem("", "");
-		QMap<QString, QString> *type;
-		for (int i = 0; i < list.size(); i++) {
-			type = list[i];
-			ui.paymentCardTypeIdComboBox->addItem(type->value("name"),
-					type->value("payment_card_type_id"));
-		}
-	} else {
-		m_Console->displayError(errorMsg);
-	}
-
-	delete transformer;
-}
-
-/**
- * Populates the brands combo box with data from the server.
- */
-void VoucherDialog::fetchBrands()
-{
-	QUrl url(*m_ServerUrl);
-	url.addQueryItem("cmd", "get_payment_card_brand_list");
-	url.addQueryItem("type", "xml");
-
-	QString content = m_Request->get(url);
-
-	XmlTransformer *transformer = XmlTransformerFactory::instance()
-			->create("payment_card_brand_list");
-
-	QString errorMsg;
-	if (m_Handler->handle(content, transformer, &errorMsg) ==
-			XmlResponseHandler::Success) {
-		QList<QMap<QString, QString>*> list = transformer->content();
-
-		ui.paymentCardBrandIdComboBox->addItem("", "");
-		QMap<QString, QString> *brand;
-		for (int i = 0; i < list.size(); i++) {
-			brand = list[i];
-			ui.paymentCardBrandIdComboBox->addItem(brand->value("name"),
-					brand->value("payment_card_brand_id"));
-		}
-	} else {
-		m_Console->displayError(errorMsg);
-	}
-
-	delete transformer;
-}
@@ -20,6 +20,7 @@ public:
 
 public slots:
 	void addVoucherCashReceipt();
+	void updateList(QString name);
 
 signals:
 	void sessionStatusChanged(bool isActive);
@@ -35,8 +36,7 @@ private:
     QMap<QString, QWidget*> m_FocusWidgets;
 
     void setConsole();
-    void fetchTypes();
-    void fetchBrands();
+    void displayFailure(QString message, QString elementId);
 };
 
 #endif // VOUCHER_DIALOG_H
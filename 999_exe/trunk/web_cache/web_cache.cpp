@@ -0,0 +1,137 @@
+/*
+ * web_cache.cpp
+ *
+ *  Created on: 28/11/2011
+ *      Author: pc
+ */
+
+#include "web_cache.h"
+
+#include <QApplication>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include "../registry.h"
+#include "../logger/logger.h"
+
+/**
+ * @class WebCache
+ * Keeps the network access manager shared by all the web views, with a disk
+ * cache on the web_cache directory. The responses are cached following their
+ * headers, so the styles, scripts and images of the server are only fetched
+ * again when they expire. The php pages are never cached because the session
+ * sends them with no-cache.
+ */
+
+// Static files used by the pos pages, relative to the server's url.
+static const char *ASSETS[] = {
+	"../styles/layout.css",
+	"../styles/typography.css",
+	"../styles/decoration.css",
+	"../styles/print.css",
+	"../scripts/core_libs.js",
+	"../scripts/form_libs.js",
+	"../scripts/event_delegator.js",
+	"../scripts/details.js",
+	"../scripts/object_page.js",
+	"../scripts/document_page.js",
+	"../scripts/invoice_page.js",
+	"../scripts/deposit_page.js",
+	"../scripts/set_property.js",
+	"../scripts/text_range.js",
+	"../images/error.png",
+	"../images/info.png",
+	"../images/success.png",
+	"../images/warning.png",
+	0
+};
+
+WebCache* WebCache::m_Instance = 0;
+
+/**
+ * Constructs the manager with the disk cache of the size on the Registry.
+ */
+WebCache::WebCache(QObject *parent) : QObject(parent)
+{
+	m_PendingAssets = 0;
+
+	m_Cache = new QNetworkDiskCache(this);
+	m_Cache->setCacheDirectory(QApplication::applicationDirPath()
+			+ "/web_cache");
+	m_Cache->setMaximumCacheSize(qint64(Registry::instance()->webCacheSize())
+			* 1024 * 1024);
+
+	m_Manager = new QNetworkAccessManager(this);
+	m_Manager->setCache(m_Cache);
+}
+
+/**
+ * Returns the only instance.
+ */
+WebCache* WebCache::instance()
+{
+	if (m_Instance == 0)
+		m_Instance = new WebCache(qApp);
+
+	return m_Instance;
+}
+
+/**
+ * Makes the page use the shared manager. The cookie jar must be set after.
+ */
+void WebCache::install(QWebPage *page)
+{
+	page->setNetworkAccessManager(m_Manager);
+}
+
+/**
+ * Fetches the static files of the pages from the server so they are on the
+ * cache before the first page is shown. They are always asked to the server to
+ * get any new version installed.
+ */
+void WebCache::prewarm(QUrl serverUrl)
+{
+	for (int i = 0; ASSETS[i] != 0; i++) {
+		QNetworkRequest request(serverUrl.resolved(QUrl(ASSETS[i])));
+		request.setAttribute(QNetworkRequest::CacheLoadControlAttribute,
+				QNetworkRequest::AlwaysNetwork);
+
+		QNetworkReply *reply = m_Manager->get(request);
+		connect(reply, SIGNAL(finished()), this, SLOT(assetFetched()));
+		m_PendingAssets++;
+	}
+}
+
+/**
+ * Returns the shared manager.
+ */
+QNetworkAccessManager* WebCache::manager()
+{
+	return m_Manager;
+}
+
+/**
+ * Returns the bytes used by the cache on disk.
+ */
+qint64 WebCache::cacheSize()
+{
+	return m_Cache->cacheSize();
+}
+
+/**
+ * Releases the reply of a prewarmed file. Logs the cache size when the last
+ * one arrives.
+ */
+void WebCache::assetFetched()
+{
+	QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+	if (reply->error() != QNetworkReply::NoError)
+		Logger::log(Logger::Warning, "web_cache_prewarm_failed", "url",
+				reply->url().toString(), "error", reply->errorString());
+
+	reply->deleteLater();
+
+	if (--m_PendingAssets == 0)
+		Logger::log(Logger::Info, "web_cache_prewarmed", "size_kb",
+				QString::number(m_Cache->cacheSize() / 1024));
+}
@@ -0,0 +1,42 @@
+/*
+ * web_cache.h
+ *
+ *  Created on: 28/11/2011
+ *      Author: pc
+ */
+
+#ifndef WEB_CACHE_H_
+#define WEB_CACHE_H_
+
+#include <QObject>
+#include <QUrl>
+#include <QNetworkAccessManager>
+#include <QNetworkDiskCache>
+#include <QWebPage>
+
+class WebCache : public QObject
+{
+	Q_OBJECT
+
+public:
+	virtual ~WebCache() {};
+	void install(QWebPage *page);
+	void prewarm(QUrl serverUrl);
+	QNetworkAccessManager* manager();
+	qint64 cacheSize();
+	static WebCache* instance();
+
+private slots:
+	void assetFetched();
+
+private:
+	QNetworkAccessManager *m_Manager;
+	QNetworkDiskCache *m_Cache;
+	int m_PendingAssets;
+
+	WebCache(QObject *parent = 0);
+
+	static WebCache *m_Instance;
+};
+
+#endif /* WEB_CACHE_H_ */
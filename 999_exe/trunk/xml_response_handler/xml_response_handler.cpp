@@ -8,6 +8,10 @@
 #include "xml_response_handler.h"
 
 #include <QDomDocument>
+#include "../diagnostics/latency_recorder.h"
+#include "../diagnostics/latency_timer.h"
+#include "../logger/logger.h"
+#include "../diagnostics/allocation_tracker.h"
 
 /**
  * @class XmlResponseHandler
@@ -25,23 +29,41 @@ XmlResponseHandler::XmlResponseHandler(QObject *parent) : QObject(parent)
  * Handles the response from the server.
  * Can return 3 types of response, Success, Failure and Error. In case of failure
  * is because a validation and for an error is for a parsing error or an end of
- * session.
+ * session. An empty content means the server could not be reached.
  */
 XmlResponseHandler::ResponseType XmlResponseHandler::handle(QString content,
 		XmlTransformer *transformer, QString *errorMsg, QString *elementId)
 {
+	AllocationScope scope(AllocationTracker::Xml);
+
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+
 	QDomDocument document;
+	bool isParsed;
+	{
+		LatencyTimer timer("parse");
+		isParsed = document.setContent(content);
+	}
 
 	QString msg;
-	if (!document.setContent(content)) {
+	if (!isParsed) {
+		if (content != "")
+			Logger::log(Logger::Error, "response_not_xml", "cmd",
+					recorder->command(), "content", content);
+
 		if (errorMsg != 0)
 			*errorMsg = (content == "") ?
 					"FATAL ERROR: Parse error or connection lost." : content;
 		emit sessionStatusChanged(false);
+		if (content == "")
+			emit connectionLost();
 		return Error;
 	}
 
 	if (checkForError(&document, msg)) {
+		Logger::log(Logger::Warning, "response_error", "cmd", recorder->command(),
+				"message", msg);
+
 		if (errorMsg != 0)
 			*errorMsg = msg;
 		emit sessionStatusChanged(true);
@@ -58,6 +80,9 @@ XmlResponseHandler::ResponseType XmlResponseHandler::handle(QString content,
 
 	QString id;
 	if (!validateResponse(&document, msg, id)) {
+		Logger::log(Logger::Info, "response_failure", "cmd", recorder->command(),
+				"message", msg, "element_id", id);
+
 		if (errorMsg != 0)
 			*errorMsg = msg;
 		if (elementId != 0)
@@ -66,7 +91,10 @@ XmlResponseHandler::ResponseType XmlResponseHandler::handle(QString content,
 		return Failure;
 	}
 
-	transformer->transform(&document);
+	{
+		LatencyTimer timer("transform");
+		transformer->transform(&document);
+	}
 
 	emit sessionStatusChanged(true);
 	return Success;
@@ -25,6 +25,7 @@ public:
 
 signals:
 	void sessionStatusChanged(bool isActive);
+	void connectionLost();
 
 private:
 	bool checkForError(QDomDocument *document, QString &errorMsg);
@@ -0,0 +1,42 @@
+/*
+ * invoice_totals_xml_transformer.cpp
+ *
+ *  Created on: 26/09/2011
+ *      Author: pc
+ */
+
+#include "invoice_totals_xml_transformer.h"
+
+/**
+ * @class InvoiceTotalsXmlTransformer
+ * Transforms the invoice details xml document into its amounts. The first item
+ * has the totals and the next ones the quantity, price and total of every row.
+ */
+
+/**
+ * Stores the totals and the rows into the QList for future retrieval.
+ */
+void InvoiceTotalsXmlTransformer::transform(QDomDocument *document)
+{
+	QDomElement params = document->elementsByTagName("params").at(0).toElement();
+
+	QMap<QString, QString> *totals = new QMap<QString, QString>();
+	totals->insert("sub_total", params.firstChildElement("sub_total").text());
+	totals->insert("discount_percentage",
+			params.firstChildElement("discount_percentage").text());
+	totals->insert("discount", params.firstChildElement("discount").text());
+	totals->insert("total", params.firstChildElement("total").text());
+	m_Content << totals;
+
+	QDomNodeList rows = document->elementsByTagName("row");
+
+	for (int i = 0; i < rows.size(); i++) {
+		QDomElement row = rows.at(i).toElement();
+
+		QMap<QString, QString> *map = new QMap<QString, QString>();
+		map->insert("quantity", row.firstChildElement("quantity").text());
+		map->insert("price", row.firstChildElement("price").text());
+		map->insert("total", row.firstChildElement("total").text());
+		m_Content << map;
+	}
+}
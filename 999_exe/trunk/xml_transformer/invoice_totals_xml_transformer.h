@@ -0,0 +1,21 @@
+/*
+ * invoice_totals_xml_transformer.h
+ *
+ *  Created on: 26/09/2011
+ *      Author: pc
+ */
+
+#ifndef INVOICE_TOTALS_XML_TRANSFORMER_H_
+#define INVOICE_TOTALS_XML_TRANSFORMER_H_
+
+#include "xml_transformer.h"
+
+class InvoiceTotalsXmlTransformer: public XmlTransformer
+{
+public:
+	InvoiceTotalsXmlTransformer() {};
+	virtual ~InvoiceTotalsXmlTransformer() {};
+	virtual void transform(QDomDocument *document);
+};
+
+#endif /* INVOICE_TOTALS_XML_TRANSFORMER_H_ */
@@ -0,0 +1,25 @@
+/*
+ * object_property_xml_transformer.cpp
+ *
+ *  Created on: 26/09/2011
+ *      Author: pc
+ */
+
+#include "object_property_xml_transformer.h"
+
+/**
+ * @class ObjectPropertyXmlTransformer
+ * Transforms an xml document into the value of an object's property.
+ */
+
+/**
+ * Stores the value into the QList for future retrieval.
+ */
+void ObjectPropertyXmlTransformer::transform(QDomDocument *document)
+{
+	QDomNodeList values = document->elementsByTagName("value");
+
+	QMap<QString, QString> *map = new QMap<QString, QString>();
+	map->insert("value", values.at(0).toElement().text());
+	m_Content << map;
+}
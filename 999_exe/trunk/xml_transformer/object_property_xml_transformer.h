@@ -0,0 +1,21 @@
+/*
+ * object_property_xml_transformer.h
+ *
+ *  Created on: 26/09/2011
+ *      Author: pc
+ */
+
+#ifndef OBJECT_PROPERTY_XML_TRANSFORMER_H_
+#define OBJECT_PROPERTY_XML_TRANSFORMER_H_
+
+#include "xml_transformer.h"
+
+class ObjectPropertyXmlTransformer: public XmlTransformer
+{
+public:
+	ObjectPropertyXmlTransformer() {};
+	virtual ~ObjectPropertyXmlTransformer() {};
+	virtual void transform(QDomDocument *document);
+};
+
+#endif /* OBJECT_PROPERTY_XML_TRANSFORMER_H_ */
@@ -0,0 +1,31 @@
+/*
+ * product_catalog_xml_transformer.cpp
+ *
+ *  Created on: 20/12/2011
+ *      Author: pc
+ */
+
+#include "product_catalog_xml_transformer.h"
+
+/**
+ * @class ProductCatalogXmlTransformer
+ * Transforms an xml document into the list of products with their prices.
+ */
+
+/**
+ * Stores the products into the QList for future retrieval.
+ */
+void ProductCatalogXmlTransformer::transform(QDomDocument *document)
+{
+	QDomNodeList barCodes = document->elementsByTagName("bar_code");
+	QDomNodeList names = document->elementsByTagName("name");
+	QDomNodeList prices = document->elementsByTagName("price");
+
+	for (int i = 0; i < barCodes.size(); i++) {
+		QMap<QString, QString> *map = new QMap<QString, QString>();
+		map->insert("bar_code", barCodes.at(i).toElement().text());
+		map->insert("name", names.at(i).toElement().text());
+		map->insert("price", prices.at(i).toElement().text());
+		m_Content << map;
+	}
+}
@@ -0,0 +1,21 @@
+/*
+ * product_catalog_xml_transformer.h
+ *
+ *  Created on: 20/12/2011
+ *      Author: pc
+ */
+
+#ifndef PRODUCT_CATALOG_XML_TRANSFORMER_H_
+#define PRODUCT_CATALOG_XML_TRANSFORMER_H_
+
+#include "xml_transformer.h"
+
+class ProductCatalogXmlTransformer: public XmlTransformer
+{
+public:
+	ProductCatalogXmlTransformer() {};
+	virtual ~ProductCatalogXmlTransformer() {};
+	virtual void transform(QDomDocument *document);
+};
+
+#endif /* PRODUCT_CATALOG_XML_TRANSFORMER_H_ */
@@ -0,0 +1,35 @@
+/*
+ * validation_rule_list_xml_transformer.cpp
+ *
+ *  Created on: 03/10/2011
+ *      Author: pc
+ */
+
+#include "validation_rule_list_xml_transformer.h"
+
+/**
+ * @class ValidationRuleListXmlTransformer
+ * Transforms an xml document into a validation rule list.
+ */
+
+/**
+ * Stores the validation rule list into the QList for future retrieval.
+ */
+void ValidationRuleListXmlTransformer::transform(QDomDocument *document)
+{
+	QDomNodeList forms = document->elementsByTagName("form");
+	QDomNodeList fields = document->elementsByTagName("field");
+	QDomNodeList rules = document->elementsByTagName("rule");
+	QDomNodeList params = document->elementsByTagName("param");
+	QDomNodeList messages = document->elementsByTagName("message");
+
+	for (int i = 0; i < forms.size(); i++) {
+		QMap<QString, QString> *map = new QMap<QString, QString>();
+		map->insert("form", forms.at(i).toElement().text());
+		map->insert("field", fields.at(i).toElement().text());
+		map->insert("rule", rules.at(i).toElement().text());
+		map->insert("param", params.at(i).toElement().text());
+		map->insert("message", messages.at(i).toElement().text());
+		m_Content << map;
+	}
+}
@@ -0,0 +1,21 @@
+/*
+ * validation_rule_list_xml_transformer.h
+ *
+ *  Created on: 03/10/2011
+ *      Author: pc
+ */
+
+#ifndef VALIDATION_RULE_LIST_XML_TRANSFORMER_H_
+#define VALIDATION_RULE_LIST_XML_TRANSFORMER_H_
+
+#include "xml_transformer.h"
+
+class ValidationRuleListXmlTransformer: public XmlTransformer
+{
+public:
+	ValidationRuleListXmlTransformer() {};
+	virtual ~ValidationRuleListXmlTransformer() {};
+	virtual void transform(QDomDocument *document);
+};
+
+#endif /* VALIDATION_RULE_LIST_XML_TRANSFORMER_H_ */
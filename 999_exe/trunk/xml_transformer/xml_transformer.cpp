@@ -9,9 +9,19 @@
 
 /**
  * @class XmlTransformer
- * Abstract class for transforming xml documents into useful data.
+ * Abstract class for transforming xml documents into useful data. The maps of
+ * the content belong to the transformer and are deleted with it, unless they
+ * were taken with takeContent().
  */
 
+/**
+ * Deletes the content.
+ */
+XmlTransformer::~XmlTransformer()
+{
+	qDeleteAll(m_Content);
+}
+
 /**
  * Returns the transformed content.
  */
@@ -19,3 +29,14 @@ QList<QMap<QString, QString>*> XmlTransformer::content()
 {
 	return m_Content;
 }
+
+/**
+ * Returns the transformed content and gives its ownership to the caller.
+ */
+QList<QMap<QString, QString>*> XmlTransformer::takeContent()
+{
+	QList<QMap<QString, QString>*> content = m_Content;
+	m_Content.clear();
+
+	return content;
+}
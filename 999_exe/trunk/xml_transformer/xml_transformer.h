@@ -14,9 +14,10 @@
 class XmlTransformer
 {
 public:
-	virtual ~XmlTransformer() {};
+	virtual ~XmlTransformer();
 	virtual void transform(QDomDocument *document) = 0;
 	QList<QMap<QString, QString>*> content();
+	QList<QMap<QString, QString>*> takeContent();
 
 protected:
 	QList<QMap<QString, QString>*> m_Content;
@@ -28,6 +28,10 @@
 #include "bank_list_xml_transformer.h"
 #include "deposit_list_xml_transformer.h"
 #include "correlative_warning_xml_transformer.h"
+#include "object_property_xml_transformer.h"
+#include "invoice_totals_xml_transformer.h"
+#include "validation_rule_list_xml_transformer.h"
+#include "product_catalog_xml_transformer.h"
 
 /**
  * @class XmlTransformerFactory
@@ -100,6 +104,14 @@ XmlTransformer* XmlTransformerFactory::create(QString name)
 		return new DepositListXmlTransformer();
 	} else if (name == "correlative_warning") {
 			return new CorrelativeWarningXmlTransformer();
+	} else if (name == "object_property") {
+		return new ObjectPropertyXmlTransformer();
+	} else if (name == "invoice_totals") {
+		return new InvoiceTotalsXmlTransformer();
+	} else if (name == "validation_rule_list") {
+		return new ValidationRuleListXmlTransformer();
+	} else if (name == "product_catalog") {
+		return new ProductCatalogXmlTransformer();
 	} else {
 		return 0;
 	}
@@ -0,0 +1,53 @@
+<?php
+/**
+ * Library containing the GetCustomerNameCommand class.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+
+/**
+ * Base class.
+ */
+require_once('presentation/command.php');
+/**
+ * For displaying the results.
+ */
+require_once('presentation/page.php');
+
+/**
+ * Returns the name of a registered customer without creating a session object.
+ * Used by the client for revalidating its cached customers.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+class GetCustomerNameCommand extends Command{
+	/**
+	 * Execute the command.
+	 * @param Request $request
+	 * @param SessionHelper $helper
+	 */
+	public function execute(Request $request, SessionHelper $helper){
+		try{
+			$customer = Customer::getInstance($request->getProperty('nit'));
+		} catch(ValidateException $e){
+			$msg = $e->getMessage();
+			$element_id = $e->getProperty();
+			Page::display(array('success' => '0', 'element_id' => $element_id, 'message' => $msg),
+					'validate_xml.tpl');
+			return;
+		} catch(Exception $e){
+			$msg = $e->getMessage();
+			Page::display(array('message' => $msg), 'error_xml.tpl');
+			return;
+		}
+		
+		if($customer->getStatus() != Persist::CREATED){
+			Page::display(array('success' => '0', 'element_id' => 'nit',
+					'message' => 'Cliente no existe.'), 'validate_xml.tpl');
+			return;
+		}
+		
+		Page::display(array('value' => $customer->getName()), 'object_property_xml.tpl');
+	}
+}
+?>
\ No newline at end of file
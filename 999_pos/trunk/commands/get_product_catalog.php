@@ -0,0 +1,38 @@
+<?php
+/**
+ * Library containing the GetProductCatalogCommand class.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+
+/**
+ * Base class.
+ */
+require_once('presentation/command.php');
+/**
+ * For displaying the results.
+ */
+require_once('presentation/page.php');
+/**
+ * For obtaining the product catalog.
+ */
+require_once('business/list.php');
+
+/**
+ * Returns the bar code, name and price of every active product so the client
+ * can price the invoices it makes while the server can not be reached.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+class GetProductCatalogCommand extends Command{
+	/**
+	 * Execute the command.
+	 * @param Request $request
+	 * @param SessionHelper $helper
+	 */
+	public function execute(Request $request, SessionHelper $helper){
+		$list = ProductCatalogList::getList();
+		Page::display(array('list' => $list), 'product_catalog_xml.tpl');
+	}
+}
+?>
\ No newline at end of file
@@ -0,0 +1,83 @@
+<?php
+/**
+ * Library containing the GetValidationRulesCommand class.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+
+/**
+ * Base class.
+ */
+require_once('presentation/command.php');
+/**
+ * For displaying the results.
+ */
+require_once('presentation/page.php');
+
+/**
+ * Returns the validation rules of the forms on the client so bad input can be
+ * rejected before it is sent. The rules and messages must be kept the same as
+ * the ones on the commands and the business layer, the server validates again
+ * anyway.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+class GetValidationRulesCommand extends Command{
+	/**
+	 * Rules in the order the server checks them: form, field, rule, param and
+	 * message. The rules are: required (the param characters do not count),
+	 * greater and min (numeric value greater than or not less than the param),
+	 * regexp (the whole value matches the param), month_year ('mm/yy' format) and
+	 * future_month (the 'mm/yy' month has not started yet).
+	 * @var array
+	 */
+	private $_mRules = array(
+			array('voucher', 'transaction_number', 'required', '',
+					'Ingrese n&uacute;mero de transacci&oacute;n.'),
+			array('voucher', 'payment_card_number', 'required', '',
+					'Ingrese n&uacute;mero de la tarjeta.'),
+			array('voucher', 'payment_card_type_id', 'required', '',
+					'Seleccione un tipo de tarjeta.'),
+			array('voucher', 'payment_card_brand_id', 'required', '',
+					'Seleccione una marca de tarjeta.'),
+			array('voucher', 'holder_name', 'required', '',
+					'Ingrese el nombre del titular.'),
+			array('voucher', 'expiration_date', 'required', '/',
+					'Ingrese fecha de vencimiento.'),
+			array('voucher', 'amount', 'required', '', 'Ingrese el monto.'),
+			array('voucher', 'expiration_date', 'month_year', '',
+					'Fecha inv&aacute;lida.  No existe o debe ser en formato \'mm/aaaa\'.'),
+			array('voucher', 'expiration_date', 'future_month', '',
+					'Fecha de la tarjeta ya caduco.'),
+			array('voucher', 'payment_card_number', 'greater', '0',
+					'N&uacute;mero de tarjeta inv&aacute;lido. Valor debe ser mayor que cero.'),
+			array('voucher', 'amount', 'greater', '0',
+					'Monto inv&aacute;lido. Valor debe ser mayor que cero.'),
+			array('customer', 'nit', 'regexp', '([cC][\\\\/.]?[fF]\\.?|[0-9]+\\-\\w)',
+					'Nit inv&aacute;lido. Formato debe ser ######-#'),
+			array('customer', 'name', 'required', '',
+					'Nombre inv&aacute;lido. Valor no puede ser vacio.'),
+			array('cash_deposit', 'cash_receipt_id', 'required', '', 'Seleccione un recibo.'),
+			array('cash_deposit', 'amount', 'required', '', 'Ingrese el monto.'),
+			array('cash_deposit', 'amount', 'greater', '0',
+					'Monto inv&aacute;lido. Valor debe ser mayor que cero.'),
+			array('product_invoice', 'bar_code', 'required', '',
+					'C&oacute;digo de barra inv&aacute;lido. Valor no puede ser vac&iacute;o.'),
+			array('product_invoice', 'quantity', 'min', '1',
+					'Cantidad inv&aacute;lida. Valor deber ser mayor que cero.'));
+	
+	/**
+	 * Execute the command.
+	 * @param Request $request
+	 * @param SessionHelper $helper
+	 */
+	public function execute(Request $request, SessionHelper $helper){
+		$list = array();
+		foreach($this->_mRules as $rule)
+			$list[] = array('form' => $rule[0], 'field' => $rule[1], 'rule' => $rule[2],
+					'param' => $rule[3], 'message' => $rule[4]);
+		
+		Page::display(array('list' => $list), 'validation_rule_list_xml.tpl');
+	}
+}
+?>
\ No newline at end of file
@@ -0,0 +1,45 @@
+<?php
+/**
+ * Library containing the GetVatPercentageCommand class.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+
+/**
+ * Base class.
+ */
+require_once('presentation/command.php');
+/**
+ * For displaying the results.
+ */
+require_once('presentation/page.php');
+/**
+ * Library with the V.A.T. class.
+ */
+require_once('business/document.php');
+
+/**
+ * Returns the V.A.T. percentage in xml so the client can compute the invoice
+ * taxes with the same rate as the server.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+class GetVatPercentageCommand extends Command{
+	/**
+	 * Execute the command.
+	 * @param Request $request
+	 * @param SessionHelper $helper
+	 */
+	public function execute(Request $request, SessionHelper $helper){
+		try{
+			$percentage = Vat::getInstance()->getPercentage();
+		} catch(Exception $e){
+			$msg = $e->getMessage();
+			Page::display(array('message' => $msg), 'error_xml.tpl');
+			return;
+		}
+		
+		Page::display(array('value' => $percentage), 'object_property_xml.tpl');
+	}
+}
+?>
\ No newline at end of file
@@ -0,0 +1,58 @@
+<?php
+/**
+ * Library containing the SetCustomerNitInvoiceCommand class.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+
+/**
+ * Base class.
+ */
+require_once('presentation/command.php');
+/**
+ * For displaying the results.
+ */
+require_once('presentation/page.php');
+
+/**
+ * Sets a registered customer on an invoice by its nit, so the client does not
+ * need a customer session object when the name is not changed.
+ * @package Command
+ * @author Roberto Oliveros
+ */
+class SetCustomerNitInvoiceCommand extends Command{
+	/**
+	 * Execute the command.
+	 * @param Request $request
+	 * @param SessionHelper $helper
+	 */
+	public function execute(Request $request, SessionHelper $helper){
+		$invoice = $helper->getObject((int)$request->getProperty('key'));
+		
+		try{
+			$customer = Customer::getInstance($request->getProperty('nit'));
+			
+			if($customer->getStatus() != Persist::CREATED){
+				Page::display(array('success' => '0', 'element_id' => 'nit',
+						'message' => 'Cliente no existe.'), 'validate_xml.tpl');
+				return;
+			}
+			
+			$invoice->setCustomer($customer);
+		} catch(ValidateException $e){
+			$msg = $e->getMessage();
+			$element_id = $e->getProperty();
+			Page::display(array('success' => '0', 'element_id' => $element_id, 'message' => $msg),
+					'validate_xml.tpl');
+			return;
+		} catch(Exception $e){
+			$msg = $e->getMessage();
+			Page::display(array('message' => $msg), 'error_xml.tpl');
+			return;
+		}
+			
+		Page::display(array('nit' => $invoice->getCustomerNit(), 'name' => $invoice->getCustomerName()),
+				'set_customer_invoice_xml.tpl');
+	}
+}
+?>
\ No newline at end of file
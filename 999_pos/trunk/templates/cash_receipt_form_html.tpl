@@ -16,7 +16,7 @@ body {
 </style>
 {/literal}
 <script type="text/javascript">
-	var isSessionActive = true;
+	var pageState = {literal}{isSessionActive: true}{/literal};
 </script>
 </head>
 <body>
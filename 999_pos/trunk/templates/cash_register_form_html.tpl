@@ -1,6 +1,6 @@
 {* Smarty * }
 <script type="text/javascript">
-var objectStatus = {$cash_register_status};
+pageState.objectStatus = {$cash_register_status};
 </script>
 <div id="content">
 	<div id="frm" class="content_small">
@@ -1,9 +1,9 @@
 {* Smarty * }
 <script type="text/javascript">
-var cashRegisterStatus = {$cash_register_status};
-var documentStatus = {$status};
+pageState.cashRegisterStatus = {$cash_register_status};
+pageState.documentStatus = {$status};
 {if $key neq ''}
-var objectKey = {$key};
+pageState.objectKey = {$key};
 {/if}
 </script>
 <div id="content">
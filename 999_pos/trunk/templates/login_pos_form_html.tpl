@@ -42,7 +42,7 @@ input[type="text"], input[type="password"]{
 }
 </style>
 <script type="text/javascript">
-	var isSessionActive = false;
+	var pageState = {isSessionActive: false};
 
 	function init(){
 		var oInput = document.getElementById('username');
@@ -0,0 +1,17 @@
+{* Smarty *}
+{php}
+header('Content-Type: text/xml');
+{/php}
+<?xml version="1.0" encoding="UTF-8"?>
+<response>
+	<success>1</success>
+	<grid>
+		{section name=i loop=$list}
+		<row>
+			<bar_code><![CDATA[{$list[i].bar_code}]]></bar_code>
+			<name><![CDATA[{$list[i].name}]]></name>
+			<price>{$list[i].price}</price>
+		</row>
+		{/section}
+	</grid>
+</response>
\ No newline at end of file
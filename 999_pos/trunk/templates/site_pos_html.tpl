@@ -9,7 +9,7 @@
 <link href="../styles/typography.css" rel="stylesheet" type="text/css" />
 <link href="../styles/decoration.css" rel="stylesheet" type="text/css" />
 <script type="text/javascript">
-	var isSessionActive = true;
+	var pageState = {literal}{isSessionActive: true}{/literal};
 </script>
 </head>
 <body>
@@ -0,0 +1,19 @@
+{* Smarty *}
+{php}
+header('Content-Type: text/xml');
+{/php}
+<?xml version="1.0" encoding="UTF-8"?>
+<response>
+	<success>1</success>
+	<grid>
+		{section name=i loop=$list}
+		<row>
+			<form>{$list[i].form}</form>
+			<field>{$list[i].field}</field>
+			<rule>{$list[i].rule}</rule>
+			<param><![CDATA[{$list[i].param}]]></param>
+			<message><![CDATA[{$list[i].message}]]></message>
+		</row>
+		{/section}
+	</grid>
+</response>
\ No newline at end of file
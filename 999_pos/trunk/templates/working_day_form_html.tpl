@@ -1,6 +1,6 @@
 {* Smarty * }
 <script type="text/javascript">
-var objectStatus = {$working_day_status};
+pageState.objectStatus = {$working_day_status};
 </script>
 <div id="content">
 	<div id="frm" class="content_small">
@@ -17,7 +17,7 @@
 	       	<tfoot>
 	       		<tr>
 	       			<td class="total_col" colspan="3">Sub-Total:</td>
-	       			<td class="total_col"><xsl:value-of select="response/params/sub_total" /></td>
+	       			<td id="sub_total" class="total_col"><xsl:value-of select="response/params/sub_total" /></td>
 	       			<td></td>
 	       		</tr>
 	       		<tr>
@@ -27,12 +27,12 @@
 	       					(<xsl:value-of select="response/params/discount_percentage" />%)
 	       				</span>:
        				</td>
-	       			<td class="total_col"><xsl:value-of select="response/params/discount" /></td>
+	       			<td id="discount" class="total_col"><xsl:value-of select="response/params/discount" /></td>
 	       			<td></td>
 	       		</tr>
 	       		<tr>
 	       			<td class="total_col" colspan="3">Total:</td>
-	       			<td class="total_col"><xsl:value-of select="response/params/total" /></td>
+	       			<td id="total" class="total_col"><xsl:value-of select="response/params/total" /></td>
 	       			<td></td>
 	       		</tr>
 	       	</tfoot>
@@ -0,0 +1,134 @@
+/*
+ * allocation_counter.cpp
+ *
+ *  Created on: 01/08/2011
+ *      Author: pc
+ */
+
+#include "allocation_counter.h"
+
+#include <new>
+#include <cstdlib>
+#include <QAtomicInt>
+#include "diagnostics/allocation_tracker.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/**
+ * @class AllocationCounter
+ * Counts the calls to operator new of the program and the bytes asked for. The
+ * counters wrap around, only the difference between two readings is meaningful.
+ * On Windows the allocations made inside the Qt dlls are not counted because
+ * they use their own runtime. If the client is built with allocation accounting
+ * the counters of the AllocationTracker are used instead, it already replaces
+ * operator new.
+ */
+
+#ifdef ALLOCATION_ACCOUNTING
+
+/**
+ * Returns the number of allocations made.
+ */
+uint AllocationCounter::count()
+{
+	return AllocationTracker::allocations();
+}
+
+/**
+ * Returns the number of bytes allocated.
+ */
+uint AllocationCounter::bytes()
+{
+	return AllocationTracker::allocatedBytes();
+}
+
+#else
+
+static QAtomicInt allocationCount;
+static QAtomicInt allocatedBytes;
+
+/**
+ * Counts the allocation before reserving the memory.
+ */
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+	allocationCount.fetchAndAddRelaxed(1);
+	allocatedBytes.fetchAndAddRelaxed(int(size));
+
+	void *pointer = malloc(size > 0 ? size : 1);
+	if (pointer == 0)
+		throw std::bad_alloc();
+
+	return pointer;
+}
+
+/**
+ * Counts the allocation before reserving the memory.
+ */
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+	return operator new(size);
+}
+
+/**
+ * Frees the memory.
+ */
+void operator delete(void *pointer) throw()
+{
+	free(pointer);
+}
+
+/**
+ * Frees the memory.
+ */
+void operator delete[](void *pointer) throw()
+{
+	free(pointer);
+}
+
+/**
+ * Returns the number of allocations made.
+ */
+uint AllocationCounter::count()
+{
+	return uint(int(allocationCount));
+}
+
+/**
+ * Returns the number of bytes allocated.
+ */
+uint AllocationCounter::bytes()
+{
+	return uint(int(allocatedBytes));
+}
+
+#endif
+
+/**
+ * Returns the peak resident memory of the process in kilobytes.
+ */
+qint64 AllocationCounter::peakResidentSize()
+{
+#ifdef Q_OS_WIN
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+#ifdef Q_OS_MAC
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
@@ -0,0 +1,21 @@
+/*
+ * allocation_counter.h
+ *
+ *  Created on: 01/08/2011
+ *      Author: pc
+ */
+
+#ifndef ALLOCATION_COUNTER_H_
+#define ALLOCATION_COUNTER_H_
+
+#include <QtGlobal>
+
+class AllocationCounter
+{
+public:
+	static uint count();
+	static uint bytes();
+	static qint64 peakResidentSize();
+};
+
+#endif /* ALLOCATION_COUNTER_H_ */
@@ -0,0 +1,47 @@
+/*
+ * benchmark_plugin_factory.cpp
+ *
+ *  Created on: 01/08/2011
+ *      Author: pc
+ */
+
+#include "benchmark_plugin_factory.h"
+
+/**
+ * @class BenchmarkPluginFactory
+ * Plugin factory which remembers the last bar code line edit given to a page, so
+ * the benchmark can type on it the same as the scanner does.
+ */
+
+/**
+ * Constructs the factory.
+ */
+BenchmarkPluginFactory::BenchmarkPluginFactory(QObject *parent)
+		: WebPluginFactory(parent)
+{
+}
+
+/**
+ * Returns the widget of the passed mime type.
+ */
+QObject* BenchmarkPluginFactory::create(const QString &mimeType,
+		const QUrl &url, const QStringList &argumentNames,
+		const QStringList &argumentValues) const
+{
+	QObject *widget =
+			WebPluginFactory::create(mimeType, url, argumentNames, argumentValues);
+
+	BarCodeLineEdit *lineEdit = qobject_cast<BarCodeLineEdit*>(widget);
+	if (lineEdit != 0)
+		m_BarCodeLineEdit = lineEdit;
+
+	return widget;
+}
+
+/**
+ * Returns the bar code line edit on the actual page or 0 if there is none.
+ */
+BarCodeLineEdit* BenchmarkPluginFactory::barCodeLineEdit()
+{
+	return m_BarCodeLineEdit;
+}
@@ -0,0 +1,30 @@
+/*
+ * benchmark_plugin_factory.h
+ *
+ *  Created on: 01/08/2011
+ *      Author: pc
+ */
+
+#ifndef BENCHMARK_PLUGIN_FACTORY_H_
+#define BENCHMARK_PLUGIN_FACTORY_H_
+
+#include "plugins/web_plugin_factory.h"
+
+#include <QPointer>
+#include "plugins/bar_code_line_edit.h"
+
+class BenchmarkPluginFactory : public WebPluginFactory
+{
+public:
+	BenchmarkPluginFactory(QObject *parent = 0);
+	virtual ~BenchmarkPluginFactory() {};
+	QObject* create(const QString &mimeType, const QUrl &url,
+			const QStringList &argumentNames,
+			const QStringList &argumentValues) const;
+	BarCodeLineEdit* barCodeLineEdit();
+
+private:
+	mutable QPointer<BarCodeLineEdit> m_BarCodeLineEdit;
+};
+
+#endif /* BENCHMARK_PLUGIN_FACTORY_H_ */
@@ -0,0 +1,300 @@
+/*
+ * checkout_benchmark.cpp
+ *
+ *  Created on: 01/08/2011
+ *      Author: pc
+ */
+
+#include "checkout_benchmark.h"
+
+#include <QApplication>
+#include <QDialog>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTextStream>
+#include <QWebFrame>
+#include <QWebElement>
+#include "registry.h"
+#include "section/cash_receipt_section.h"
+#include "diagnostics/latency_recorder.h"
+#include "allocation_counter.h"
+
+/**
+ * @class CheckoutBenchmark
+ * Drives the SalesSection through complete sales without anybody at the
+ * keyboard: creates the invoice, scans the products on the bar code line edit,
+ * pays the cash receipt and waits for the saved invoice to load. The dialogs
+ * shown on the way, like the customer one, are dismissed. It measures the time
+ * of every scan and sale and the memory allocated by each sale. The section is
+ * created on the first run, the next runs go on selling on it.
+ */
+
+// Milliseconds to wait for a page or a response before giving up.
+static const int WAIT_TIMEOUT = 30000;
+
+// Cash amount paid on every sale, always enough.
+static const QString CASH_AMOUNT = "1000000.00";
+
+/**
+ * Constructs the benchmark.
+ */
+CheckoutBenchmark::CheckoutBenchmark(QObject *parent) : QObject(parent)
+{
+	m_Window = 0;
+	m_Section = 0;
+	m_Allocations = 0;
+	m_AllocatedBytes = 0;
+	m_Sales = 0;
+	m_Scans = 0;
+	m_DismissedDialogs = 0;
+}
+
+/**
+ * Destroys the window with the section.
+ */
+CheckoutBenchmark::~CheckoutBenchmark()
+{
+	delete m_Window;
+}
+
+/**
+ * Makes the warm up sales and then the measured ones with scans products each.
+ * Returns false if a sale could not be completed.
+ */
+bool CheckoutBenchmark::run(int sales, int scans, int warmUpSales)
+{
+	if (m_Section == 0) {
+		createSection();
+
+		if (!waitFor(webView(m_Section), SIGNAL(loadFinished(bool)))) {
+			m_Error = "La seccion de ventas no cargo.";
+			return false;
+		}
+	}
+
+	qApp->installEventFilter(this);
+
+	for (int i = 0; i < warmUpSales; i++)
+		if (!makeSale(i, scans, false))
+			return false;
+
+	if (warmUpSales > 0)
+		LatencyRecorder::instance()->clear();
+
+	for (int i = 0; i < sales; i++)
+		if (!makeSale(warmUpSales + i, scans, true))
+			return false;
+
+	qApp->removeEventFilter(this);
+
+	return true;
+}
+
+/**
+ * Returns the reason the benchmark did not finish.
+ */
+QString CheckoutBenchmark::error()
+{
+	return m_Error;
+}
+
+/**
+ * Returns the results as name = value lines followed by the latency of every
+ * server command.
+ */
+QString CheckoutBenchmark::report()
+{
+	QString text;
+	QTextStream stream(&text);
+
+	int sales = qMax(m_Sales, 1);
+
+	stream << "sales = " << m_Sales << "\n";
+	stream << "scans = " << m_Scans << "\n";
+	stream << "scan_average_ms = " << m_ScanTimes.average() / 1000.0 << "\n";
+	stream << "scan_p50_ms = " << m_ScanTimes.percentile(50) / 1000.0 << "\n";
+	stream << "scan_p95_ms = " << m_ScanTimes.percentile(95) / 1000.0 << "\n";
+	stream << "scan_p99_ms = " << m_ScanTimes.percentile(99) / 1000.0 << "\n";
+	stream << "scan_max_ms = " << m_ScanTimes.max() / 1000.0 << "\n";
+	stream << "sale_average_ms = " << m_SaleTimes.average() / 1000.0 << "\n";
+	stream << "sale_p50_ms = " << m_SaleTimes.percentile(50) / 1000.0 << "\n";
+	stream << "sale_p95_ms = " << m_SaleTimes.percentile(95) / 1000.0 << "\n";
+	stream << "sale_max_ms = " << m_SaleTimes.max() / 1000.0 << "\n";
+	stream << "allocations_per_sale = " << m_Allocations / sales << "\n";
+	stream << "allocated_kb_per_sale = " << m_AllocatedBytes / sales / 1024 << "\n";
+	stream << "peak_rss_kb = " << AllocationCounter::peakResidentSize() << "\n";
+	stream << "dismissed_dialogs = " << m_DismissedDialogs << "\n";
+	stream << "\n" << LatencyRecorder::instance()->report();
+
+	stream.flush();
+
+	return text;
+}
+
+/**
+ * Rejects every modal dialog as soon as it is shown.
+ */
+bool CheckoutBenchmark::eventFilter(QObject *watched, QEvent *event)
+{
+	if (event->type() == QEvent::Show) {
+		QDialog *dialog = qobject_cast<QDialog*>(watched);
+
+		if (dialog != 0 && dialog->isModal()) {
+			QMetaObject::invokeMethod(dialog, "reject", Qt::QueuedConnection);
+			m_DismissedDialogs++;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Creates the sales section the same way the MainWindow does, but without
+ * asking for the cash register.
+ */
+void CheckoutBenchmark::createSection()
+{
+	m_Window = new MainWindow();
+
+	m_Section = new SalesSection(&m_CookieJar, &m_PluginFactory,
+			Registry::instance()->serverUrl(), "1", m_Window);
+	m_Section->setStyleSheetFileName("invoice_details.xsl");
+	m_Section->setGetDocumentDetailsCmd("get_invoice_details");
+	m_Section->setGetDocumentListCmd("get_invoice_list");
+	m_Section->setShowDocumentFormCmd("show_invoice_form");
+	m_Section->setGetDocumentCmd("get_invoice");
+	m_Section->setCreateDocumentCmd("create_invoice");
+	m_Section->setDeleteItemDocumentCmd("delete_product_invoice");
+
+	m_Section->setCreateDocumentTransformerName("invoice");
+	m_Section->setDocumentListTransformerName("invoice_list");
+
+	m_Section->setItemsName("Producto");
+
+	m_Section->init();
+	m_Window->setCentralWidget(m_Section);
+}
+
+/**
+ * Makes a complete sale. Only measured sales are added to the results.
+ */
+bool CheckoutBenchmark::makeSale(int sale, int scans, bool isMeasured)
+{
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+	qint64 start = recorder->now();
+	uint allocations = AllocationCounter::count();
+	uint bytes = AllocationCounter::bytes();
+
+	// The customer dialog shown after creating it is dismissed.
+	m_Section->createInvoice();
+
+	for (int i = 0; i < scans; i++)
+		scan(QString::number(7502000000000LL + (sale * scans + i) % 1000),
+				isMeasured);
+
+	if (!payCashReceipt())
+		return false;
+
+	if (isMeasured) {
+		m_SaleTimes.add(recorder->now() - start);
+		m_Allocations += AllocationCounter::count() - allocations;
+		m_AllocatedBytes += AllocationCounter::bytes() - bytes;
+		m_Sales++;
+	}
+
+	// The cash receipt window was closed, destroy it now.
+	QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+
+	return true;
+}
+
+/**
+ * Types the bar code on the line edit and hits enter, the same as the scanner.
+ */
+void CheckoutBenchmark::scan(QString barCode, bool isMeasured)
+{
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+	qint64 start = recorder->now();
+
+	BarCodeLineEdit *lineEdit = m_PluginFactory.barCodeLineEdit();
+
+	// If the page did not create the plugin the product is added directly.
+	if (lineEdit != 0) {
+		lineEdit->setText(barCode);
+		lineEdit->returnKeyPressed();
+	} else {
+		m_Section->addProductInvoice(barCode, "1");
+	}
+
+	if (isMeasured) {
+		m_ScanTimes.add(recorder->now() - start);
+		m_Scans++;
+	}
+}
+
+/**
+ * Validates the invoice, pays the cash receipt and waits for the saved invoice to
+ * load on the section.
+ */
+bool CheckoutBenchmark::payCashReceipt()
+{
+	m_Section->validate();
+
+	CashReceiptSection *receipt = m_Section->findChild<CashReceiptSection*>();
+	if (receipt == 0) {
+		m_Error = "No se pudo crear el recibo.";
+		return false;
+	}
+
+	QWebView *view = webView(receipt);
+	if (!waitFor(view, SIGNAL(loadFinished(bool)))) {
+		m_Error = "El recibo no cargo.";
+		return false;
+	}
+
+	view->page()->mainFrame()->findFirstElement("#cash_input")
+			.evaluateJavaScript("this.value = '" + CASH_AMOUNT + "';");
+	receipt->checkForChanges();
+
+	// Emitted once the change response is handled.
+	if (!waitFor(receipt, SIGNAL(sessionStatusChanged(bool)))) {
+		m_Error = "No se recibio el cambio.";
+		return false;
+	}
+
+	receipt->saveCashReceipt();
+
+	if (!waitFor(webView(m_Section), SIGNAL(loadFinished(bool)))) {
+		m_Error = "La factura guardada no cargo.";
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Processes events until the sender emits the signal. Returns false if it was
+ * not emitted on time.
+ */
+bool CheckoutBenchmark::waitFor(QObject *sender, const char *signal)
+{
+	QEventLoop loop;
+	QTimer timer;
+	timer.setSingleShot(true);
+
+	connect(sender, signal, &loop, SLOT(quit()));
+	connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+
+	timer.start(WAIT_TIMEOUT);
+	loop.exec();
+
+	return timer.isActive();
+}
+
+/**
+ * Returns the web view of the section.
+ */
+QWebView* CheckoutBenchmark::webView(QWidget *section)
+{
+	return section->findChild<QWebView*>("webView");
+}
@@ -0,0 +1,55 @@
+/*
+ * checkout_benchmark.h
+ *
+ *  Created on: 01/08/2011
+ *      Author: pc
+ */
+
+#ifndef CHECKOUT_BENCHMARK_H_
+#define CHECKOUT_BENCHMARK_H_
+
+#include <QObject>
+#include <QNetworkCookieJar>
+#include <QWebView>
+#include "main_window.h"
+#include "section/sales_section.h"
+#include "diagnostics/latency_histogram.h"
+#include "benchmark_plugin_factory.h"
+
+class CheckoutBenchmark : public QObject
+{
+	Q_OBJECT
+
+public:
+	CheckoutBenchmark(QObject *parent = 0);
+	virtual ~CheckoutBenchmark();
+	bool run(int sales, int scans, int warmUpSales = 1);
+	QString error();
+	QString report();
+
+protected:
+	bool eventFilter(QObject *watched, QEvent *event);
+
+private:
+	QNetworkCookieJar m_CookieJar;
+	BenchmarkPluginFactory m_PluginFactory;
+	MainWindow *m_Window;
+	SalesSection *m_Section;
+	LatencyHistogram m_ScanTimes;
+	LatencyHistogram m_SaleTimes;
+	qint64 m_Allocations;
+	qint64 m_AllocatedBytes;
+	int m_Sales;
+	int m_Scans;
+	int m_DismissedDialogs;
+	QString m_Error;
+
+	void createSection();
+	bool makeSale(int sale, int scans, bool isMeasured);
+	void scan(QString barCode, bool isMeasured);
+	bool payCashReceipt();
+	bool waitFor(QObject *sender, const char *signal);
+	QWebView* webView(QWidget *section);
+};
+
+#endif /* CHECKOUT_BENCHMARK_H_ */
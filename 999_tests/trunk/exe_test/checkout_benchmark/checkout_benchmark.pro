@@ -0,0 +1,13 @@
+include(../exe.pri)
+include(../mock_server/mock_server.pri)
+
+TARGET = checkout_benchmark
+CONFIG += console
+HEADERS += allocation_counter.h \
+    benchmark_plugin_factory.h \
+    checkout_benchmark.h
+SOURCES += allocation_counter.cpp \
+    benchmark_plugin_factory.cpp \
+    checkout_benchmark.cpp \
+    main.cpp
+win32:LIBS += -lpsapi
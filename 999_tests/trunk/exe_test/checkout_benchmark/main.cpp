@@ -0,0 +1,69 @@
+#include <QApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include "mock_server.h"
+#include "checkout_benchmark.h"
+
+/**
+ * Returns the number after the option name on the arguments or the default value.
+ */
+static int option(const QStringList &arguments, QString name, int value)
+{
+	int index = arguments.indexOf(name);
+
+	return (index != -1 && index + 1 < arguments.size()) ?
+			arguments[index + 1].toInt() : value;
+}
+
+/**
+ * Makes sales against the mock server and prints the results.
+ * Usage: checkout_benchmark [--sales N] [--scans N] [--warm-up N] [--latency MS]
+ * [--jitter MS] [--list-size N] [--padding BYTES]
+ */
+int main(int argc, char *argv[])
+{
+	QApplication a(argc, argv);
+
+	QStringList arguments = a.arguments();
+	QTextStream out(stdout);
+
+	MockServer server;
+	server.setLatency(option(arguments, "--latency", 0));
+	server.setJitter(option(arguments, "--jitter", 0));
+	server.setListSize(option(arguments, "--list-size", 100));
+	server.setPadding(option(arguments, "--padding", 0));
+
+	if (!server.start()) {
+		out << "No se pudo iniciar el servidor: " << server.errorString() << "\n";
+		return 1;
+	}
+
+	// The Registry reads the preferences next to the exe. The printer does not
+	// exist so nothing is printed.
+	QFile file(QApplication::applicationDirPath() + "/preferences.txt");
+	file.open(QIODevice::WriteOnly | QIODevice::Text);
+	QTextStream stream(&file);
+	stream << "commands_address = " << server.commandsAddress() << "\n";
+	stream << "xsl_address = " << server.xslAddress() << "\n";
+	stream << "printer_name = checkout_benchmark\n";
+	stream << "is_tmu_printer = false\n";
+	stream.flush();
+	file.close();
+
+	CheckoutBenchmark benchmark;
+
+	bool ok = benchmark.run(option(arguments, "--sales", 20),
+			option(arguments, "--scans", 10), option(arguments, "--warm-up", 1));
+
+	out << benchmark.report();
+	out << "requests = " << server.requestCount() << "\n";
+	out << "bytes_sent = " << server.bytesSent() << "\n";
+
+	if (!ok) {
+		out << "error = " << benchmark.error() << "\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,15 @@
+# Every source of the client except its main(), for the programs that drive
+# the client from their own main().
+EXE_DIR = $$PWD/../../../999_exe/trunk
+include($$EXE_DIR/_99_exe.pro)
+
+SOURCES -= main.cpp
+for(header, HEADERS):EXE_HEADERS += $$EXE_DIR/$$header
+for(source, SOURCES):EXE_SOURCES += $$EXE_DIR/$$source
+for(form, FORMS):EXE_FORMS += $$EXE_DIR/$$form
+HEADERS = $$EXE_HEADERS
+SOURCES = $$EXE_SOURCES
+FORMS = $$EXE_FORMS
+RESOURCES = $$EXE_DIR/resources.qrc
+TRANSLATIONS =
+INCLUDEPATH += $$EXE_DIR
@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+SUBDIRS = checkout_benchmark \
+    load_generator \
+    micro_benchmark \
+    plugin_soak \
+    scanner_stress \
+    shift_soak \
+    traffic_replay \
+    unit_test
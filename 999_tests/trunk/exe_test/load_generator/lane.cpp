@@ -0,0 +1,395 @@
+/*
+ * lane.cpp
+ *
+ *  Created on: 22/08/2011
+ *      Author: pc
+ */
+
+#include "lane.h"
+
+#include <QTimer>
+#include "xml_transformer/xml_transformer_factory.h"
+
+/**
+ * @class Lane
+ * One simulated cashier. It logs in, opens the cash register of the first
+ * shift and then makes sales until stopped: scans products from the catalog,
+ * pays part with a voucher on some of them and the rest in cash, and finally
+ * closes the cash register and fetches the sales report. It waits a random
+ * think time around the settings ones between scans, before paying and between
+ * sales. All the requests are asynchronous so many lanes share one thread, and
+ * every one is recorded on the LatencyRecorder by the HttpRequest. A failed sale
+ * is discarded and the next one started.
+ */
+
+/**
+ * Constructs the lane with its own session.
+ */
+Lane::Lane(const LaneSettings *settings, QObject *parent) : QObject(parent),
+		m_Settings(settings)
+{
+	m_Request = new HttpRequest(&m_CookieJar, this);
+	connect(m_Request, SIGNAL(finished(QString)), this,
+			SLOT(handleResponse(QString)));
+
+	m_Step = Closed;
+	m_IsStopping = false;
+	m_Sales = 0;
+	m_PendingScans = 0;
+}
+
+/**
+ * Destroys the request before the cookie jar it uses.
+ */
+Lane::~Lane()
+{
+	delete m_Request;
+}
+
+/**
+ * Logs in and opens the cash register.
+ */
+void Lane::start()
+{
+	m_IsStopping = false;
+
+	if (m_Settings->username != "") {
+		send(Login, "", QStringList() << "login" << "1" << "username"
+				<< m_Settings->username << "password" << m_Settings->password);
+	} else {
+		send(ShiftList, "get_shift_list");
+	}
+}
+
+/**
+ * Closes the cash register once the actual sale is finished.
+ */
+void Lane::stop()
+{
+	m_IsStopping = true;
+}
+
+/**
+ * Returns the number of sales completed.
+ */
+int Lane::sales()
+{
+	return m_Sales;
+}
+
+/**
+ * Returns true if the lane is not running.
+ */
+bool Lane::isClosed()
+{
+	return m_Step == Closed;
+}
+
+/**
+ * Handles the response of the actual step and makes the next request.
+ */
+void Lane::handleResponse(QString content)
+{
+	QString value;
+
+	switch (m_Step) {
+		case Login:
+			if (content == "")
+				fail("Sin respuesta del servidor.");
+			else
+				send(ShiftList, "get_shift_list");
+			break;
+
+		case ShiftList:
+			if (handleXml(content, "shift_list", "shift_id", &value))
+				send(CashRegister, "get_cash_register",
+						QStringList() << "shift_id" << value);
+			break;
+
+		case CashRegister:
+			if (handleXml(content, "object_key", "key", &m_RegisterKey))
+				send(CashRegisterStatus, "get_is_open_cash_register",
+						QStringList() << "key" << m_RegisterKey);
+			break;
+
+		case CashRegisterStatus:
+			if (handleXml(content, "cash_register_status", "status", &value)) {
+				if (value == "1")
+					startSale();
+				else
+					fail("Caja cerrada.");
+			}
+			break;
+
+		case CreateInvoice:
+			if (handleXml(content, "invoice", "key", &m_InvoiceKey)) {
+				m_PendingScans = qMax(1, m_Settings->scans / 2
+						+ qrand() % (m_Settings->scans + 1));
+				wait(m_Settings->scanThinkTime);
+			}
+			break;
+
+		case AddProduct:
+			if (handleXml(content, "stub"))
+				send(InvoiceDetails, "get_invoice_details",
+						QStringList() << "key" << m_InvoiceKey);
+			break;
+
+		case InvoiceDetails:
+			if (handleXml(content, "stub")) {
+				if (m_PendingScans > 0)
+					wait(m_Settings->scanThinkTime);
+				else
+					send(ValidateInvoice, "validate_invoice",
+							QStringList() << "invoice_key" << m_InvoiceKey);
+			}
+			break;
+
+		case ValidateInvoice:
+			if (handleXml(content, "stub"))
+				send(CreateCashReceipt, "create_cash_receipt",
+						QStringList() << "invoice_key" << m_InvoiceKey);
+			break;
+
+		case CreateCashReceipt:
+			if (handleXml(content, "object_key", "key", &m_CashReceiptKey))
+				wait(m_Settings->paymentThinkTime);
+			break;
+
+		case CardTypes:
+			if (handleXml(content, "payment_card_type_list",
+					"payment_card_type_id", &m_CardTypeId))
+				send(CardBrands, "get_payment_card_brand_list");
+			break;
+
+		case CardBrands:
+			if (handleXml(content, "payment_card_brand_list",
+					"payment_card_brand_id", &m_CardBrandId))
+				pay();
+			break;
+
+		case AddVoucher:
+			if (handleXml(content, "stub"))
+				send(SetCash, "set_cash_cash_receipt", QStringList() << "key"
+						<< m_CashReceiptKey << "amount" << m_Settings->cashAmount);
+			break;
+
+		case SetCash:
+			if (handleXml(content, "change"))
+				send(SaveCashReceipt, "save_object",
+						QStringList() << "key" << m_CashReceiptKey);
+			break;
+
+		case SaveCashReceipt:
+			if (handleXml(content, "object_id")) {
+				m_Sales++;
+				emit saleCompleted();
+				wait(m_Settings->saleThinkTime);
+			}
+			break;
+
+		case DiscardInvoice:
+			wait(m_Settings->saleThinkTime);
+			break;
+
+		case CloseCashRegister:
+			if (handleXml(content, "stub"))
+				send(SalesReport, "print_sales_report", QStringList()
+						<< "register_key" << m_RegisterKey << "is_preliminary" << "0");
+			break;
+
+		case SalesReport:
+			if (content == "") {
+				fail("Sin respuesta del servidor.");
+			} else {
+				m_Step = Closed;
+				emit closed();
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**
+ * Continues after the think time of the actual step.
+ */
+void Lane::nextStep()
+{
+	switch (m_Step) {
+		case CreateInvoice:
+		case InvoiceDetails:
+			scan();
+			break;
+
+		case CreateCashReceipt:
+			pay();
+			break;
+
+		case SaveCashReceipt:
+		case DiscardInvoice:
+			startSale();
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**
+ * Makes the request of the step. The params are pairs of name and value.
+ */
+void Lane::send(Step step, QString cmd, QStringList params)
+{
+	m_Step = step;
+	m_Cmd = (cmd != "") ? cmd : "login";
+
+	QUrl url(m_Settings->serverUrl);
+
+	if (cmd != "")
+		url.addQueryItem("cmd", cmd);
+
+	for (int i = 0; i + 1 < params.size(); i += 2)
+		url.addQueryItem(params[i], params[i + 1]);
+
+	if (cmd != "" && !cmd.startsWith("print_"))
+		url.addQueryItem("type", "xml");
+
+	m_Request->get(url, true);
+}
+
+/**
+ * Creates a new invoice, or closes the cash register if the lane was stopped.
+ */
+void Lane::startSale()
+{
+	m_InvoiceKey = "";
+	m_CashReceiptKey = "";
+
+	if (m_IsStopping) {
+		closeCashRegister();
+		return;
+	}
+
+	send(CreateInvoice, "create_invoice",
+			QStringList() << "register_key" << m_RegisterKey);
+}
+
+/**
+ * Adds a random product of the catalog, now and then more than one of it.
+ */
+void Lane::scan()
+{
+	m_PendingScans--;
+
+	QString barCode = m_Settings->catalog[qrand() % m_Settings->catalog.size()];
+	int quantity = (qrand() % 10 == 0) ? 2 + qrand() % 4 : 1;
+
+	send(AddProduct, "add_product_invoice", QStringList() << "key"
+			<< m_InvoiceKey << "bar_code" << barCode << "quantity"
+			<< QString::number(quantity));
+}
+
+/**
+ * Pays the cash receipt, some of the times with a voucher first.
+ */
+void Lane::pay()
+{
+	bool isVoucher = (m_Step == CardBrands)
+			|| (qrand() % 100 < m_Settings->voucherPercentage);
+
+	if (!isVoucher) {
+		send(SetCash, "set_cash_cash_receipt", QStringList() << "key"
+				<< m_CashReceiptKey << "amount" << m_Settings->cashAmount);
+	} else if (m_CardTypeId == "" || m_CardBrandId == "") {
+		send(CardTypes, "get_payment_card_type_list");
+	} else {
+		send(AddVoucher, "add_voucher_cash_receipt", QStringList()
+				<< "cash_receipt_key" << m_CashReceiptKey << "invoice_key"
+				<< m_InvoiceKey << "transaction_number"
+				<< QString::number(qrand()) << "payment_card_number"
+				<< "4111111111111111" << "payment_card_type_id" << m_CardTypeId
+				<< "payment_card_brand_id" << m_CardBrandId << "holder_name"
+				<< "Carga" << "expiration_date" << "12/20" << "amount"
+				<< m_Settings->voucherAmount);
+	}
+}
+
+/**
+ * Closes the cash register on the server.
+ */
+void Lane::closeCashRegister()
+{
+	send(CloseCashRegister, "close_cash_register",
+			QStringList() << "key" << m_RegisterKey);
+}
+
+/**
+ * Calls nextStep after a random time between half and one and a half msecs.
+ */
+void Lane::wait(int msecs)
+{
+	QTimer::singleShot(msecs / 2 + qrand() % (msecs + 1), this,
+			SLOT(nextStep()));
+}
+
+/**
+ * Handles the xml response with the transformer. If field is given its value
+ * on the first row is set on value. Returns false and fails the step if the
+ * response was not successful.
+ */
+bool Lane::handleXml(QString content, QString transformerName, QString field,
+		QString *value)
+{
+	XmlTransformer *transformer = XmlTransformerFactory::instance()
+			->create(transformerName);
+
+	QString errorMsg, elementId;
+	XmlResponseHandler::ResponseType response =
+			m_Handler.handle(content, transformer, &errorMsg, &elementId);
+
+	if (response == XmlResponseHandler::Success && field != "") {
+		QList<QMap<QString, QString>*> list = transformer->content();
+
+		if (!list.isEmpty()) {
+			*value = list[0]->value(field);
+		} else {
+			response = XmlResponseHandler::Error;
+			errorMsg = "Respuesta sin " + field + ".";
+		}
+	}
+
+	delete transformer;
+
+	if (response != XmlResponseHandler::Success) {
+		fail((errorMsg != "") ? errorMsg : "Sin respuesta del servidor.");
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Reports the failure and goes on. A failed sale is discarded, a failure while
+ * opening or closing the cash register closes the lane.
+ */
+void Lane::fail(QString message)
+{
+	emit failed(m_Cmd, message);
+
+	if (m_Step >= CreateInvoice && m_Step <= SaveCashReceipt) {
+		if (m_InvoiceKey != "") {
+			send(DiscardInvoice, "discard_document",
+					QStringList() << "key" << m_InvoiceKey);
+		} else {
+			m_Step = DiscardInvoice;
+			wait(m_Settings->saleThinkTime);
+		}
+	} else if (m_Step == DiscardInvoice) {
+		wait(m_Settings->saleThinkTime);
+	} else {
+		m_Step = Closed;
+		emit closed();
+	}
+}
@@ -0,0 +1,102 @@
+/*
+ * lane.h
+ *
+ *  Created on: 22/08/2011
+ *      Author: pc
+ */
+
+#ifndef LANE_H_
+#define LANE_H_
+
+#include <QObject>
+#include <QNetworkCookieJar>
+#include <QStringList>
+#include <QUrl>
+#include "http_request/http_request.h"
+#include "xml_response_handler/xml_response_handler.h"
+
+struct LaneSettings
+{
+	QUrl serverUrl;
+	QString username;
+	QString password;
+	QStringList catalog;
+	int scans;
+	int scanThinkTime;
+	int paymentThinkTime;
+	int saleThinkTime;
+	int voucherPercentage;
+	QString cashAmount;
+	QString voucherAmount;
+};
+
+class Lane : public QObject
+{
+	Q_OBJECT
+
+public:
+	enum Step {
+		Login,
+		ShiftList,
+		CashRegister,
+		CashRegisterStatus,
+		CreateInvoice,
+		AddProduct,
+		InvoiceDetails,
+		ValidateInvoice,
+		CreateCashReceipt,
+		CardTypes,
+		CardBrands,
+		AddVoucher,
+		SetCash,
+		SaveCashReceipt,
+		DiscardInvoice,
+		CloseCashRegister,
+		SalesReport,
+		Closed
+	};
+
+	Lane(const LaneSettings *settings, QObject *parent = 0);
+	virtual ~Lane();
+	void start();
+	void stop();
+	int sales();
+	bool isClosed();
+
+signals:
+	void saleCompleted();
+	void failed(QString cmd, QString message);
+	void closed();
+
+private slots:
+	void handleResponse(QString content);
+	void nextStep();
+
+private:
+	const LaneSettings *m_Settings;
+	QNetworkCookieJar m_CookieJar;
+	HttpRequest *m_Request;
+	XmlResponseHandler m_Handler;
+	Step m_Step;
+	QString m_Cmd;
+	bool m_IsStopping;
+	int m_Sales;
+	int m_PendingScans;
+	QString m_RegisterKey;
+	QString m_InvoiceKey;
+	QString m_CashReceiptKey;
+	QString m_CardTypeId;
+	QString m_CardBrandId;
+
+	void send(Step step, QString cmd, QStringList params = QStringList());
+	void startSale();
+	void scan();
+	void pay();
+	void closeCashRegister();
+	void wait(int msecs);
+	bool handleXml(QString content, QString transformerName,
+			QString field = "", QString *value = 0);
+	void fail(QString message);
+};
+
+#endif /* LANE_H_ */
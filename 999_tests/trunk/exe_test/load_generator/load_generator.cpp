@@ -0,0 +1,230 @@
+/*
+ * load_generator.cpp
+ *
+ *  Created on: 22/08/2011
+ *      Author: pc
+ */
+
+#include "load_generator.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QEventLoop>
+#include <QTimer>
+#include "diagnostics/latency_recorder.h"
+
+/**
+ * @class LoadGenerator
+ * Runs a number of lanes against the server at the same time for a while and
+ * collects the server throughput, the error rate and the latency of every
+ * command. Running it with more and more lanes shows how many cash registers
+ * the server can handle before the latency or the errors grow.
+ */
+
+// Milliseconds between the start of one lane and the next.
+static const int LANE_START_INTERVAL = 100;
+
+// Milliseconds to wait for the lanes to close their cash registers.
+static const int CLOSE_TIMEOUT = 60000;
+
+/**
+ * Constructs the generator. Until a catalog is loaded the products are the ones
+ * of the MockServer.
+ */
+LoadGenerator::LoadGenerator(LaneSettings settings, QObject *parent)
+		: QObject(parent), m_Settings(settings)
+{
+	m_Sales = 0;
+
+	if (m_Settings.catalog.isEmpty())
+		for (int i = 0; i < 1000; i++)
+			m_Settings.catalog << QString::number(7501000000000LL + i);
+}
+
+/**
+ * Destroys the lanes left.
+ */
+LoadGenerator::~LoadGenerator()
+{
+	qDeleteAll(m_Lanes);
+}
+
+/**
+ * Reads the bar codes to scan from the file, one per line. Anything after a
+ * comma or a # is ignored. Returns false if no bar code was read.
+ */
+bool LoadGenerator::loadCatalog(QString fileName)
+{
+	QFile file(fileName);
+
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return false;
+
+	QStringList catalog;
+	QTextStream stream(&file);
+
+	while (!stream.atEnd()) {
+		QString barCode = stream.readLine().section('#', 0, 0).section(',', 0, 0)
+				.trimmed();
+		if (barCode != "")
+			catalog << barCode;
+	}
+
+	file.close();
+
+	if (catalog.isEmpty())
+		return false;
+
+	m_Settings.catalog = catalog;
+
+	return true;
+}
+
+/**
+ * Starts the lanes one after the other, lets them sell for the seconds and then
+ * waits for all of them to close their cash registers.
+ */
+void LoadGenerator::run(int lanes, int seconds)
+{
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+	recorder->clear();
+	m_Report.clear();
+	m_Sales = 0;
+	m_Failures.clear();
+	m_FailureMessages.clear();
+
+	qint64 start = recorder->now();
+
+	for (int i = 0; i < lanes; i++) {
+		Lane *lane = new Lane(&m_Settings);
+		connect(lane, SIGNAL(saleCompleted()), this, SLOT(countSale()));
+		connect(lane, SIGNAL(failed(QString, QString)), this,
+				SLOT(countFailure(QString, QString)));
+		connect(lane, SIGNAL(closed()), this, SLOT(checkClosed()));
+		m_Lanes << lane;
+
+		lane->start();
+		wait(LANE_START_INTERVAL);
+	}
+
+	wait(qMax(seconds * 1000 - lanes * LANE_START_INTERVAL, 0));
+
+	for (int i = 0; i < m_Lanes.size(); i++)
+		m_Lanes[i]->stop();
+
+	wait(CLOSE_TIMEOUT, true);
+
+	addResults(lanes, recorder->now() - start);
+
+	qDeleteAll(m_Lanes);
+	m_Lanes.clear();
+}
+
+/**
+ * Returns the results of the last run.
+ */
+QString LoadGenerator::report()
+{
+	return m_Report;
+}
+
+/**
+ * Counts the sale completed by a lane.
+ */
+void LoadGenerator::countSale()
+{
+	m_Sales++;
+}
+
+/**
+ * Counts the failed command and keeps its first message.
+ */
+void LoadGenerator::countFailure(QString cmd, QString message)
+{
+	m_Failures[cmd]++;
+
+	if (!m_FailureMessages.contains(cmd))
+		m_FailureMessages.insert(cmd, message.simplified().left(100));
+}
+
+/**
+ * Emits allClosed once every lane is closed.
+ */
+void LoadGenerator::checkClosed()
+{
+	for (int i = 0; i < m_Lanes.size(); i++)
+		if (!m_Lanes[i]->isClosed())
+			return;
+
+	emit allClosed();
+}
+
+/**
+ * Processes events for the msecs, or until all the lanes are closed.
+ */
+void LoadGenerator::wait(int msecs, bool untilClosed)
+{
+	QEventLoop loop;
+	QTimer timer;
+	timer.setSingleShot(true);
+
+	connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+	if (untilClosed)
+		connect(this, SIGNAL(allClosed()), &loop, SLOT(quit()));
+
+	timer.start(msecs);
+
+	if (untilClosed)
+		checkClosed();
+
+	loop.exec();
+}
+
+/**
+ * Writes the results of the run on the report as name = value lines followed by the latency of
+ * every command.
+ */
+void LoadGenerator::addResults(int lanes, qint64 usecs)
+{
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+
+	qint64 requests = 0;
+	QStringList keys = recorder->keys();
+	for (int i = 0; i < keys.size(); i++)
+		if (keys[i].startsWith("request "))
+			requests += recorder->histogram(keys[i])->count();
+
+	int failures = 0;
+	QMapIterator<QString, int> i(m_Failures);
+	while (i.hasNext())
+		failures += i.next().value();
+
+	int closed = 0;
+	for (int j = 0; j < m_Lanes.size(); j++)
+		if (m_Lanes[j]->isClosed())
+			closed++;
+
+	double seconds = qMax(usecs / 1000000.0, 0.001);
+
+	QTextStream stream(&m_Report);
+
+	stream << "lanes = " << lanes << "\n";
+	stream << "closed_lanes = " << closed << "\n";
+	stream << "seconds = " << seconds << "\n";
+	stream << "sales = " << m_Sales << "\n";
+	stream << "sales_per_minute = " << m_Sales * 60 / seconds << "\n";
+	stream << "requests = " << requests << "\n";
+	stream << "requests_per_second = " << requests / seconds << "\n";
+	stream << "errors = " << failures << "\n";
+	stream << "error_rate_percent = "
+			<< ((requests > 0) ? failures * 100.0 / requests : 0) << "\n";
+
+	i.toFront();
+	while (i.hasNext()) {
+		i.next();
+		stream << "errors_" << i.key() << " = " << i.value() << " ("
+				<< m_FailureMessages.value(i.key()) << ")\n";
+	}
+
+	stream << "\n" << recorder->report() << "\n";
+}
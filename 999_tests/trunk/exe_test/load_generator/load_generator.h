@@ -0,0 +1,47 @@
+/*
+ * load_generator.h
+ *
+ *  Created on: 22/08/2011
+ *      Author: pc
+ */
+
+#ifndef LOAD_GENERATOR_H_
+#define LOAD_GENERATOR_H_
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include "lane.h"
+
+class LoadGenerator : public QObject
+{
+	Q_OBJECT
+
+public:
+	LoadGenerator(LaneSettings settings, QObject *parent = 0);
+	virtual ~LoadGenerator();
+	bool loadCatalog(QString fileName);
+	void run(int lanes, int seconds);
+	QString report();
+
+signals:
+	void allClosed();
+
+private slots:
+	void countSale();
+	void countFailure(QString cmd, QString message);
+	void checkClosed();
+
+private:
+	LaneSettings m_Settings;
+	QList<Lane*> m_Lanes;
+	int m_Sales;
+	QMap<QString, int> m_Failures;
+	QMap<QString, QString> m_FailureMessages;
+	QString m_Report;
+
+	void wait(int msecs, bool untilClosed = false);
+	void addResults(int lanes, qint64 usecs);
+};
+
+#endif /* LOAD_GENERATOR_H_ */
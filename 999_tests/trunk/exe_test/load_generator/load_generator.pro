@@ -0,0 +1,10 @@
+include(../exe.pri)
+include(../mock_server/mock_server.pri)
+
+TARGET = load_generator
+CONFIG += console
+HEADERS += lane.h \
+    load_generator.h
+SOURCES += lane.cpp \
+    load_generator.cpp \
+    main.cpp
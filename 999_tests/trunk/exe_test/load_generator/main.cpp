@@ -0,0 +1,87 @@
+#include <QApplication>
+#include <QTextStream>
+#include <QStringList>
+#include <QTime>
+#include "mock_server.h"
+#include "load_generator.h"
+
+/**
+ * Returns the value after the option name on the arguments or the default value.
+ */
+static QString option(const QStringList &arguments, QString name, QString value)
+{
+	int index = arguments.indexOf(name);
+
+	return (index != -1 && index + 1 < arguments.size()) ?
+			arguments[index + 1] : value;
+}
+
+/**
+ * Simulates more and more cashiers selling at the same time and prints the
+ * results of every lane count. Without a server address the MockServer is used.
+ * Usage: load_generator [--lanes 1,2,4,8] [--seconds N] [--server ADDRESS]
+ * [--username USER --password PASSWORD] [--catalog FILE] [--scans N]
+ * [--scan-think MS] [--payment-think MS] [--sale-think MS]
+ * [--voucher-percentage N] [--cash AMOUNT] [--voucher-amount AMOUNT]
+ * [--latency MS] [--jitter MS]
+ */
+int main(int argc, char *argv[])
+{
+	QApplication a(argc, argv);
+
+	QStringList arguments = a.arguments();
+	QTextStream out(stdout);
+
+	qsrand(QTime::currentTime().msec());
+
+	MockServer server;
+	QString address = option(arguments, "--server", "");
+
+	if (address == "") {
+		server.setLatency(option(arguments, "--latency", "0").toInt());
+		server.setJitter(option(arguments, "--jitter", "0").toInt());
+
+		if (!server.start()) {
+			out << "No se pudo iniciar el servidor: " << server.errorString()
+					<< "\n";
+			return 1;
+		}
+
+		address = server.commandsAddress();
+	}
+
+	LaneSettings settings;
+	settings.serverUrl = QUrl("http://" + address);
+	settings.username = option(arguments, "--username", "");
+	settings.password = option(arguments, "--password", "");
+	settings.scans = option(arguments, "--scans", "10").toInt();
+	settings.scanThinkTime = option(arguments, "--scan-think", "2000").toInt();
+	settings.paymentThinkTime =
+			option(arguments, "--payment-think", "10000").toInt();
+	settings.saleThinkTime = option(arguments, "--sale-think", "20000").toInt();
+	settings.voucherPercentage =
+			option(arguments, "--voucher-percentage", "30").toInt();
+	settings.cashAmount = option(arguments, "--cash", "1000000.00");
+	settings.voucherAmount = option(arguments, "--voucher-amount", "1.00");
+
+	LoadGenerator generator(settings);
+
+	QString catalog = option(arguments, "--catalog", "");
+	if (catalog != "" && !generator.loadCatalog(catalog)) {
+		out << "No se pudo leer el catalogo: " << catalog << "\n";
+		return 1;
+	}
+
+	int seconds = option(arguments, "--seconds", "60").toInt();
+	QStringList lanes = option(arguments, "--lanes", "1,2,4,8").split(",");
+
+	out << "server = " << address << "\n\n";
+
+	for (int i = 0; i < lanes.size(); i++) {
+		generator.run(lanes[i].toInt(), seconds);
+		out << generator.report();
+		out.flush();
+	}
+
+	return 0;
+}
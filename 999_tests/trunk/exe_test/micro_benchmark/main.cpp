@@ -0,0 +1,22 @@
+#include <QApplication>
+#include <QStringList>
+#include <QtTest/QtTest>
+#include "micro_benchmark.h"
+
+/**
+ * Runs the benchmarks. The results are written as xml, for comparing them
+ * between releases, unless another format is given.
+ */
+int main(int argc, char *argv[])
+{
+	QApplication a(argc, argv);
+
+	QStringList arguments = a.arguments();
+	if (!arguments.contains("-lightxml") && !arguments.contains("-xunitxml")
+			&& !arguments.contains("-xml"))
+		arguments << "-xml";
+
+	MicroBenchmark benchmark;
+
+	return QTest::qExec(&benchmark, arguments);
+}
@@ -0,0 +1,335 @@
+/*
+ * micro_benchmark.cpp
+ *
+ *  Created on: 08/08/2011
+ *      Author: pc
+ */
+
+#include "micro_benchmark.h"
+
+#include <QtTest/QtTest>
+#include <QNetworkCookieJar>
+#include <QWebPage>
+#include <QWebFrame>
+#include "xml_transformer/xml_transformer_factory.h"
+#include "xml_response_handler/xml_response_handler.h"
+#include "recordset/recordset.h"
+#include "recordset/recordset_searcher_factory.h"
+#include "search_product/search_product_line_edit.h"
+#include "search_product/search_product_model.h"
+#include "console/console_factory.h"
+
+/**
+ * @class MicroBenchmark
+ * Measures the client code that runs for every response: the xml transformers,
+ * the response handler, the recordset, the product search model and the console.
+ * The responses are made up with the number of rows of every test row. The
+ * results are written as xml unless other output is asked for on the arguments.
+ */
+
+/**
+ * Sets the tags of the rows on the responses of every transformer.
+ */
+void MicroBenchmark::initTestCase()
+{
+	m_Tags.insert("shift_list", QStringList() << "shift_id" << "name");
+	m_Tags.insert("object_key", QStringList() << "key");
+	m_Tags.insert("invoice_list",
+			QStringList() << "id" << "serial_number" << "number");
+	m_Tags.insert("invoice", QStringList() << "key" << "username");
+	m_Tags.insert("cash_register_status", QStringList() << "status");
+	m_Tags.insert("stub", QStringList() << "id");
+	m_Tags.insert("customer", QStringList() << "key" << "name");
+	m_Tags.insert("invoice_customer", QStringList() << "nit" << "name");
+	m_Tags.insert("change", QStringList() << "change");
+	m_Tags.insert("payment_card_type_list",
+			QStringList() << "payment_card_type_id" << "name");
+	m_Tags.insert("payment_card_brand_list",
+			QStringList() << "payment_card_brand_id" << "name");
+	m_Tags.insert("total", QStringList() << "total");
+	m_Tags.insert("object_id", QStringList() << "id");
+	m_Tags.insert("search_product_results", QStringList() << "bar_code" << "name"
+			<< "packaging" << "manufacturer");
+	m_Tags.insert("deposit", QStringList() << "key" << "username"
+			<< "bank_account_id" << "holder_name");
+	m_Tags.insert("bank", QStringList() << "bank");
+	m_Tags.insert("available_cash_receipt_list", QStringList() << "id"
+			<< "serial_number" << "number" << "received_cash" << "available_cash");
+	m_Tags.insert("bank_list", QStringList() << "bank_id" << "name");
+	m_Tags.insert("deposit_list",
+			QStringList() << "id" << "bank_id" << "number" << "status");
+	m_Tags.insert("correlative_warning", QStringList() << "status" << "message");
+	m_Tags.insert("object_property", QStringList() << "value");
+	m_Tags.insert("invoice_totals",
+			QStringList() << "quantity" << "price" << "total");
+	m_Tags.insert("validation_rule_list", QStringList() << "form" << "field"
+			<< "rule" << "param" << "message");
+}
+
+/**
+ * Every transformer with 10, 1k and 100k rows.
+ */
+void MicroBenchmark::transform_data()
+{
+	addTransformerRows();
+}
+
+/**
+ * Measures the transformation of an already parsed document.
+ */
+void MicroBenchmark::transform()
+{
+	QFETCH(QString, name);
+	QFETCH(int, rows);
+
+	QDomDocument document;
+	QVERIFY(document.setContent(response(name, rows)));
+
+	QBENCHMARK {
+		XmlTransformer *transformer = XmlTransformerFactory::instance()
+				->create(name);
+		transformer->transform(&document);
+
+		delete transformer;
+	}
+}
+
+/**
+ * Every transformer with 10, 1k and 100k rows.
+ */
+void MicroBenchmark::handle_data()
+{
+	addTransformerRows();
+}
+
+/**
+ * Measures the parsing, validation and transformation of a response.
+ */
+void MicroBenchmark::handle()
+{
+	QFETCH(QString, name);
+	QFETCH(int, rows);
+
+	XmlResponseHandler handler;
+	QString content = response(name, rows);
+
+	QBENCHMARK {
+		XmlTransformer *transformer = XmlTransformerFactory::instance()
+				->create(name);
+
+		QString errorMsg;
+		handler.handle(content, transformer, &errorMsg);
+
+		delete transformer;
+	}
+}
+
+/**
+ * Lists of 10, 1k and 100k documents.
+ */
+void MicroBenchmark::recordsetNavigation_data()
+{
+	addSizeRows(QList<int>() << 10 << 1000 << 100000);
+}
+
+/**
+ * Measures moving through all the documents one by one.
+ */
+void MicroBenchmark::recordsetNavigation()
+{
+	QFETCH(int, rows);
+
+	QList<QMap<QString, QString>*> list = invoiceList(rows);
+
+	Recordset recordset;
+	recordset.setList(list);
+
+	QBENCHMARK {
+		recordset.moveFirst();
+		while (!recordset.isLast())
+			recordset.moveNext();
+		recordset.movePrevious();
+		recordset.moveLast();
+	}
+}
+
+/**
+ * Lists of 10, 1k and 100k documents.
+ */
+void MicroBenchmark::recordsetSearch_data()
+{
+	addSizeRows(QList<int>() << 10 << 1000 << 100000);
+}
+
+/**
+ * Measures searching for the last invoice, the worst case.
+ */
+void MicroBenchmark::recordsetSearch()
+{
+	QFETCH(int, rows);
+
+	QList<QMap<QString, QString>*> list = invoiceList(rows);
+
+	Recordset recordset;
+	recordset.setList(list);
+
+	RecordsetSearcher *searcher =
+			RecordsetSearcherFactory::instance()->create("invoice");
+	recordset.installSearcher(searcher);
+
+	QString value = "A " + QString::number(rows);
+
+	QBENCHMARK {
+		QVERIFY(recordset.search(value));
+	}
+
+	delete searcher;
+}
+
+/**
+ * Search results of 10, 1k and 100k products.
+ */
+void MicroBenchmark::updateProductModel_data()
+{
+	addSizeRows(QList<int>() << 10 << 1000 << 100000);
+}
+
+/**
+ * Measures merging the search results on an empty model.
+ */
+void MicroBenchmark::updateProductModel()
+{
+	QFETCH(int, rows);
+
+	QNetworkCookieJar jar;
+	QUrl url("http://127.0.0.1/");
+	Console *console = ConsoleFactory::instance()->createHtmlConsole();
+	SearchProductModel model;
+
+	SearchProductLineEdit lineEdit;
+	lineEdit.init(&jar, &url, console, &model);
+
+	QString content = response("search_product_results", rows);
+
+	QBENCHMARK {
+		model.clear();
+		lineEdit.updateProductModel(content);
+	}
+
+	QCOMPARE(model.rowCount(), rows);
+
+	delete console;
+}
+
+/**
+ * 10, 100 and 1k messages.
+ */
+void MicroBenchmark::consoleMessages_data()
+{
+	addSizeRows(QList<int>() << 10 << 100 << 1000);
+}
+
+/**
+ * Measures displaying the messages on the page's console and cleaning it.
+ */
+void MicroBenchmark::consoleMessages()
+{
+	QFETCH(int, rows);
+
+	QWebPage page;
+	page.mainFrame()->setHtml("<html><body><div id=\"console\"></div></body>"
+			"</html>");
+
+	Console *console = ConsoleFactory::instance()->createHtmlConsole();
+	console->setFrame(page.mainFrame());
+
+	QBENCHMARK {
+		for (int i = 0; i < rows; i++) {
+			console->displayFailure("Valor invalido.", "field" + QString::number(i));
+			console->displayError("Error " + QString::number(i));
+		}
+		console->reset();
+	}
+
+	delete console;
+}
+
+/**
+ * Adds a test row for every transformer and size.
+ */
+void MicroBenchmark::addTransformerRows()
+{
+	QTest::addColumn<QString>("name");
+	QTest::addColumn<int>("rows");
+
+	QList<int> sizes;
+	sizes << 10 << 1000 << 100000;
+
+	QMapIterator<QString, QStringList> i(m_Tags);
+	while (i.hasNext()) {
+		i.next();
+
+		for (int j = 0; j < sizes.size(); j++)
+			QTest::newRow(qPrintable(i.key() + " " + QString::number(sizes[j])))
+					<< i.key() << sizes[j];
+	}
+}
+
+/**
+ * Adds a test row for every size.
+ */
+void MicroBenchmark::addSizeRows(QList<int> sizes)
+{
+	QTest::addColumn<int>("rows");
+
+	for (int i = 0; i < sizes.size(); i++)
+		QTest::newRow(qPrintable(QString::number(sizes[i]))) << sizes[i];
+}
+
+/**
+ * Returns a successful response for the transformer with the number of rows.
+ */
+QString MicroBenchmark::response(QString name, int rows)
+{
+	QStringList tags = m_Tags.value(name);
+
+	QString content = "<?xml version=\"1.0\" encoding=\"UTF-8\"?><response>"
+			"<success>1</success>";
+
+	if (name == "search_product_results")
+		content += "<keyword><![CDATA[producto]]></keyword>";
+
+	content += "<grid>";
+
+	for (int i = 0; i < rows; i++) {
+		content += "<row>";
+
+		for (int j = 0; j < tags.size(); j++)
+			content += "<" + tags[j] + "><![CDATA[" + tags[j] + " "
+					+ QString::number(i) + "]]></" + tags[j] + ">";
+
+		content += "</row>";
+	}
+
+	content += "</grid></response>";
+
+	return content;
+}
+
+/**
+ * Returns a list of invoices numbered from 1.
+ */
+QList<QMap<QString, QString>*> MicroBenchmark::invoiceList(int rows)
+{
+	QList<QMap<QString, QString>*> list;
+
+	for (int i = 0; i < rows; i++) {
+		QMap<QString, QString> *map = new QMap<QString, QString>();
+		map->insert("id", QString::number(i + 1));
+		map->insert("serial_number", "A");
+		map->insert("number", QString::number(i + 1));
+		list << map;
+	}
+
+	return list;
+}
@@ -0,0 +1,43 @@
+/*
+ * micro_benchmark.h
+ *
+ *  Created on: 08/08/2011
+ *      Author: pc
+ */
+
+#ifndef MICRO_BENCHMARK_H_
+#define MICRO_BENCHMARK_H_
+
+#include <QObject>
+#include <QMap>
+#include <QStringList>
+
+class MicroBenchmark : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+	void transform_data();
+	void transform();
+	void handle_data();
+	void handle();
+	void recordsetNavigation_data();
+	void recordsetNavigation();
+	void recordsetSearch_data();
+	void recordsetSearch();
+	void updateProductModel_data();
+	void updateProductModel();
+	void consoleMessages_data();
+	void consoleMessages();
+
+private:
+	QMap<QString, QStringList> m_Tags;
+
+	void addTransformerRows();
+	void addSizeRows(QList<int> sizes);
+	QString response(QString name, int rows);
+	QList<QMap<QString, QString>*> invoiceList(int rows);
+};
+
+#endif /* MICRO_BENCHMARK_H_ */
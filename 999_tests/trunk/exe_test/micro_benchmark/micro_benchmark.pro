@@ -0,0 +1,8 @@
+include(../exe.pri)
+
+TARGET = micro_benchmark
+CONFIG += console
+QT += testlib
+HEADERS += micro_benchmark.h
+SOURCES += micro_benchmark.cpp \
+    main.cpp
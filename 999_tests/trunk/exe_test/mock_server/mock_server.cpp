@@ -0,0 +1,797 @@
+/*
+ * mock_server.cpp
+ *
+ *  Created on: 01/08/2011
+ *      Author: pc
+ */
+
+#include "mock_server.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QHostAddress>
+#include "../../../../999_exe/trunk/pricing/pricing_engine.h"
+
+/**
+ * @class MockServer
+ * Stand-in for the pos server listening on 127.0.0.1. It serves the xml
+ * commands, pages and xsl style sheets the client uses for opening the cash
+ * register, making sales and closing it, keeping the invoices in memory. Every response can be delayed by a fixed latency plus
+ * a random jitter and padded with extra bytes for simulating slower networks and
+ * bigger payloads. It runs on the same event loop as the client.
+ */
+
+/**
+ * Constructs the server. Nothing is listened until start is called.
+ */
+MockServer::MockServer(QObject *parent) : QTcpServer(parent)
+{
+	m_Latency = 0;
+	m_Jitter = 0;
+	m_ListSize = 0;
+	m_Padding = 0;
+	m_RequestCount = 0;
+	m_BytesSent = 0;
+	m_NextKey = 1000;
+	m_NextId = 1;
+
+	m_SendTimer.setSingleShot(true);
+	connect(&m_SendTimer, SIGNAL(timeout()), this, SLOT(sendResponses()));
+}
+
+/**
+ * Destroys the invoices.
+ */
+MockServer::~MockServer()
+{
+	qDeleteAll(m_Invoices);
+	qDeleteAll(m_NewInvoices);
+}
+
+/**
+ * Creates the invoice history and starts listening. Port 0 takes any free one.
+ */
+bool MockServer::start(quint16 port)
+{
+	for (int i = 0; i < m_ListSize; i++) {
+		MockInvoice *invoice = createInvoice();
+
+		for (int j = 0; j < 3; j++) {
+			QString barCode = QString::number(7501000000000LL + i * 3 + j);
+			invoice->details << (QStringList() << barCode << "Producto " + barCode
+					<< "1" << PricingEngine::fromCents(price(barCode)));
+		}
+
+		invoice->cash = PricingEngine::fromCents(total(invoice));
+		saveInvoice(invoice);
+	}
+
+	return listen(QHostAddress::LocalHost, port);
+}
+
+/**
+ * Returns the address for the commands_address preference.
+ */
+QString MockServer::commandsAddress()
+{
+	return "127.0.0.1:" + QString::number(serverPort()) + "/pos/";
+}
+
+/**
+ * Returns the address for the xsl_address preference.
+ */
+QString MockServer::xslAddress()
+{
+	return "127.0.0.1:" + QString::number(serverPort()) + "/xsl/";
+}
+
+/**
+ * Sets the milliseconds every response is delayed.
+ */
+void MockServer::setLatency(int msecs)
+{
+	m_Latency = msecs;
+}
+
+/**
+ * Sets the maximum milliseconds added or taken randomly from the latency.
+ */
+void MockServer::setJitter(int msecs)
+{
+	m_Jitter = msecs;
+}
+
+/**
+ * Sets the number of invoices already made and of products found on a search.
+ */
+void MockServer::setListSize(int size)
+{
+	m_ListSize = size;
+}
+
+/**
+ * Sets the bytes added to every successful xml response.
+ */
+void MockServer::setPadding(int bytes)
+{
+	m_Padding = bytes;
+}
+
+/**
+ * Sets the directory with the xsl files. By default the ones on the resources.
+ */
+void MockServer::setXslDir(QString dir)
+{
+	m_XslDir = dir;
+}
+
+/**
+ * Returns the number of requests received.
+ */
+int MockServer::requestCount()
+{
+	return m_RequestCount;
+}
+
+/**
+ * Returns the urls of the commands received in order, without the xsl files.
+ */
+QList<QUrl> MockServer::receivedCommands()
+{
+	return m_ReceivedCommands;
+}
+
+/**
+ * Returns the number of bytes sent on the responses.
+ */
+qint64 MockServer::bytesSent()
+{
+	return m_BytesSent;
+}
+
+/**
+ * Accepts the connection from the client.
+ */
+void MockServer::incomingConnection(int socketDescriptor)
+{
+	QTcpSocket *socket = new QTcpSocket(this);
+	socket->setSocketDescriptor(socketDescriptor);
+
+	connect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+	connect(socket, SIGNAL(disconnected()), this, SLOT(removeConnection()));
+
+	m_Buffers.insert(socket, QByteArray());
+}
+
+/**
+ * Reads the http requests received on the connection and queues their responses.
+ * Only GET requests are made by the client, they have no body.
+ */
+void MockServer::readRequest()
+{
+	QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+	QByteArray &buffer = m_Buffers[socket];
+
+	buffer += socket->readAll();
+
+	int end;
+	while ((end = buffer.indexOf("\r\n\r\n")) != -1) {
+		QByteArray header = buffer.left(end);
+		buffer.remove(0, end + 4);
+
+		QList<QByteArray> words = header.left(header.indexOf("\r\n")).split(' ');
+		if (words.size() < 2) {
+			socket->disconnectFromHost();
+			return;
+		}
+
+		m_RequestCount++;
+
+		QByteArray contentType;
+		int delay = 0;
+		QByteArray body = respond(QString::fromLatin1(words[1]), &contentType,
+				&delay);
+
+		QByteArray data = (contentType != "") ? "HTTP/1.1 200 OK\r\n" :
+				"HTTP/1.1 404 Not Found\r\n";
+		if (contentType != "")
+			data += "Content-Type: " + contentType + "\r\n";
+		data += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+		data += "Connection: keep-alive\r\n\r\n";
+		data += body;
+
+		queue(socket, data, delay);
+	}
+}
+
+/**
+ * Forgets the connection closed by the client.
+ */
+void MockServer::removeConnection()
+{
+	QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+
+	m_Buffers.remove(socket);
+	socket->deleteLater();
+}
+
+/**
+ * Writes the responses whose delay has passed and waits for the next one.
+ */
+void MockServer::sendResponses()
+{
+	qint64 time = now();
+
+	for (int i = 0; i < m_Responses.size();) {
+		MockResponse &response = m_Responses[i];
+
+		if (response.due <= time) {
+			if (!response.socket.isNull()) {
+				response.socket->write(response.data);
+				m_BytesSent += response.data.size();
+			}
+			m_Responses.removeAt(i);
+		} else {
+			i++;
+		}
+	}
+
+	scheduleResponses();
+}
+
+/**
+ * Returns the actual time in milliseconds.
+ */
+qint64 MockServer::now()
+{
+	return QDateTime::currentMSecsSinceEpoch();
+}
+
+/**
+ * Sends the response after delay milliseconds.
+ */
+void MockServer::queue(QTcpSocket *socket, QByteArray data, int delay)
+{
+	if (delay <= 0) {
+		socket->write(data);
+		m_BytesSent += data.size();
+		return;
+	}
+
+	MockResponse response;
+	response.socket = socket;
+	response.data = data;
+	response.due = now() + delay;
+	m_Responses << response;
+
+	scheduleResponses();
+}
+
+/**
+ * Starts the timer for the response due the soonest.
+ */
+void MockServer::scheduleResponses()
+{
+	if (m_Responses.isEmpty()) {
+		m_SendTimer.stop();
+		return;
+	}
+
+	qint64 next = m_Responses[0].due;
+	for (int i = 1; i < m_Responses.size(); i++)
+		next = qMin(next, m_Responses[i].due);
+
+	m_SendTimer.start(int(qMax(next - now(), qint64(0))));
+}
+
+/**
+ * Returns the body for the requested target and the milliseconds to wait before
+ * sending it, the latency plus jitter. An empty content type means the target
+ * was not found.
+ */
+QByteArray MockServer::respond(QString target, QByteArray *contentType,
+		int *delay)
+{
+	*delay = m_Latency;
+	if (m_Jitter > 0)
+		*delay += qrand() % (2 * m_Jitter + 1) - m_Jitter;
+
+	QUrl url = QUrl::fromEncoded(target.toAscii());
+
+	if (url.path().startsWith("/xsl/")) {
+		QString dir = (m_XslDir != "") ? m_XslDir : ":/xsl";
+		QFile file(dir + "/" + url.path().mid(5));
+
+		if (!file.open(QIODevice::ReadOnly))
+			return QByteArray();
+
+		*contentType = "text/xml";
+		return file.readAll();
+	}
+
+	m_ReceivedCommands << url;
+
+	*contentType = "text/xml";
+	return command(url.queryItemValue("cmd"), url, contentType).toUtf8();
+}
+
+/**
+ * Executes the command and returns its response. Pages change the content type.
+ */
+QString MockServer::command(QString cmd, QUrl url, QByteArray *contentType)
+{
+	QString key = url.queryItemValue("key");
+	MockInvoice *invoice = m_SessionInvoices.value(key);
+
+	if (cmd == "" || cmd.startsWith("show_") || cmd == "get_invoice"
+			|| cmd.startsWith("print_"))
+		*contentType = "text/html; charset=UTF-8";
+
+	if (cmd == "") {
+		return page("main", QMap<QString, QString>());
+
+	} else if (cmd == "show_invoice_form") {
+		return invoicePage(0, "");
+
+	} else if (cmd == "get_invoice") {
+		invoice = m_Invoices.value(url.queryItemValue("id"));
+		if (invoice == 0)
+			return page("main", QMap<QString, QString>());
+
+		key = newKey();
+		m_SessionInvoices.insert(key, invoice);
+		return invoicePage(invoice, key);
+
+	} else if (cmd == "show_cash_receipt_form") {
+		invoice = m_SessionInvoices.value(m_CashReceipts.value(key));
+		if (invoice == 0)
+			return page("main", QMap<QString, QString>());
+
+		QMap<QString, QString> values;
+		values.insert("cash", PricingEngine::fromCents(
+				PricingEngine::toCents(invoice->cash)));
+		values.insert("total_vouchers", "0.00");
+		values.insert("invoice_total", PricingEngine::fromCents(total(invoice)));
+		values.insert("change", "0.00");
+		return page("cash_receipt_form", values);
+
+	} else if (cmd.startsWith("print_")) {
+		invoice = m_Invoices.value(url.queryItemValue("id"));
+		return (invoice != 0) ? printPage(invoice) :
+				page("main", QMap<QString, QString>());
+
+	} else if (cmd.startsWith("show_")) {
+		return page("main", QMap<QString, QString>());
+
+	} else if (cmd == "get_shift_list") {
+		return success("<grid><row><shift_id>1</shift_id><name><![CDATA[Diurno]]>"
+				"</name></row></grid>");
+
+	} else if (cmd == "get_cash_register") {
+		return success("<key>" + newKey() + "</key>");
+
+	} else if (cmd == "get_is_open_cash_register") {
+		return success("<status>1</status>");
+
+	} else if (cmd == "close_cash_register") {
+		return success();
+
+	} else if (cmd == "get_vat_percentage") {
+		return success("<value>12.00</value>");
+
+	} else if (cmd == "get_validation_rules") {
+		return success("<grid><row><form>product_invoice</form><field>bar_code"
+				"</field><rule>required</rule><param><![CDATA[]]></param><message>"
+				"<![CDATA[Codigo de barra invalido.]]></message></row><row><form>"
+				"product_invoice</form><field>quantity</field><rule>min</rule><param>"
+				"<![CDATA[1]]></param><message><![CDATA[Cantidad invalida.]]>"
+				"</message></row></grid>");
+
+	} else if (cmd == "get_product_catalog") {
+		QString grid;
+		for (int i = 0; i < m_ListSize * 3; i++) {
+			QString barCode = QString::number(7501000000000LL + i);
+			grid += "<row><bar_code><![CDATA[" + barCode + "]]></bar_code><name>"
+					"<![CDATA[Producto " + barCode + "]]></name><price>"
+					+ PricingEngine::fromCents(price(barCode)) + "</price></row>";
+		}
+		return success("<grid>" + grid + "</grid>");
+
+	} else if (cmd == "get_payment_card_type_list") {
+		return success("<grid><row><payment_card_type_id>1</payment_card_type_id>"
+				"<name><![CDATA[Credito]]></name></row></grid>");
+
+	} else if (cmd == "get_payment_card_brand_list") {
+		return success("<grid><row><payment_card_brand_id>1"
+				"</payment_card_brand_id><name><![CDATA[Visa]]></name></row></grid>");
+
+	} else if (cmd == "get_bank_list") {
+		return success("<grid><row><bank_id>1</bank_id><name><![CDATA[Industrial]]>"
+				"</name></row></grid>");
+
+	} else if (cmd == "get_invoice_list") {
+		QString grid;
+		for (int i = 0; i < m_SavedInvoices.size(); i++) {
+			MockInvoice *saved = m_SavedInvoices[i];
+			grid += "<row><id>" + saved->id + "</id><serial_number>"
+					+ saved->serialNumber + "</serial_number><number>"
+					+ saved->number + "</number></row>";
+		}
+		return success("<grid>" + grid + "</grid>");
+
+	} else if (cmd == "create_invoice") {
+		invoice = createInvoice();
+		key = newKey();
+		m_SessionInvoices.insert(key, invoice);
+		return success("<key>" + key + "</key><date_time>" + invoice->dateTime
+				+ "</date_time><username>benchmark</username>");
+
+	} else if (cmd == "get_invoice_details") {
+		return (invoice != 0) ? invoiceDetails(invoice) :
+				error("Factura no existe en la sesion.");
+
+	} else if (cmd == "add_product_invoice") {
+		if (invoice == 0)
+			return error("Factura no existe en la sesion.");
+
+		QString barCode = url.queryItemValue("bar_code");
+		if (barCode == "")
+			return failure("Producto no existe.", "bar_code");
+
+		bool ok;
+		int quantity = url.queryItemValue("quantity").toInt(&ok);
+		if (!ok || quantity < 1)
+			return failure("Cantidad invalida.", "bar_code");
+
+		for (int i = 0; i < invoice->details.size(); i++) {
+			QStringList &detail = invoice->details[i];
+			if (detail[0] == barCode) {
+				detail[2] = QString::number(detail[2].toInt() + quantity);
+				return success();
+			}
+		}
+
+		invoice->details << (QStringList() << barCode << "Producto " + barCode
+				<< QString::number(quantity)
+				<< PricingEngine::fromCents(price(barCode)));
+		return success();
+
+	} else if (cmd == "delete_product_invoice") {
+		if (invoice == 0)
+			return error("Factura no existe en la sesion.");
+
+		int row = url.queryItemValue("detail_id").toInt() - 1;
+		if (row >= 0 && row < invoice->details.size())
+			invoice->details.removeAt(row);
+		return success();
+
+	} else if (cmd == "get_customer") {
+		QString nit = url.queryItemValue("nit");
+		return success("<key>" + newKey() + "</key><name><![CDATA[Cliente " + nit
+				+ "]]></name>");
+
+	} else if (cmd == "get_customer_name") {
+		return success("<value><![CDATA[Cliente " + url.queryItemValue("nit")
+				+ "]]></value>");
+
+	} else if (cmd == "set_customer_nit_invoice") {
+		if (invoice == 0)
+			return error("Factura no existe en la sesion.");
+
+		invoice->nit = url.queryItemValue("nit");
+		invoice->customer = "Cliente " + invoice->nit;
+		return success("<nit>" + invoice->nit + "</nit><name><![CDATA["
+				+ invoice->customer + "]]></name>");
+
+	} else if (cmd == "set_customer_invoice") {
+		if (invoice == 0)
+			return error("Factura no existe en la sesion.");
+
+		invoice->nit = "C/F";
+		invoice->customer = "Consumidor Final";
+		return success("<nit>" + invoice->nit + "</nit><name><![CDATA["
+				+ invoice->customer + "]]></name>");
+
+	} else if (cmd == "validate_invoice") {
+		invoice = m_SessionInvoices.value(url.queryItemValue("invoice_key"));
+		if (invoice == 0)
+			return error("Factura no existe en la sesion.");
+
+		return invoice->details.isEmpty() ?
+				failure("Factura no contiene productos.", "bar_code") : success();
+
+	} else if (cmd == "create_cash_receipt") {
+		QString invoiceKey = url.queryItemValue("invoice_key");
+		if (!m_SessionInvoices.contains(invoiceKey))
+			return error("Factura no existe en la sesion.");
+
+		key = newKey();
+		m_CashReceipts.insert(key, invoiceKey);
+		return success("<key>" + key + "</key>");
+
+	} else if (cmd == "get_cash_receipt_vouchers") {
+		invoice = m_SessionInvoices.value(m_CashReceipts.value(key));
+		return success("<params><page>1</page><page_items>0</page_items>"
+				"<total>" + ((invoice != 0) ? invoice->vouchers : "0.00")
+				+ "</total></params><grid></grid>");
+
+	} else if (cmd == "add_voucher_cash_receipt") {
+		invoice = m_SessionInvoices.value(
+				m_CashReceipts.value(url.queryItemValue("cash_receipt_key")));
+		if (invoice == 0)
+			return error("Recibo no existe en la sesion.");
+
+		qint64 amount = PricingEngine::toCents(url.queryItemValue("amount"));
+		if (amount <= 0)
+			return failure("Monto invalido.", "amount");
+
+		invoice->vouchers = PricingEngine::fromCents(
+				PricingEngine::toCents(invoice->vouchers) + amount);
+		return success();
+
+	} else if (cmd == "get_correlative_warning") {
+		return success("<status>0</status><message><![CDATA[]]></message>");
+
+	} else if (cmd == "set_cash_cash_receipt") {
+		invoice = m_SessionInvoices.value(m_CashReceipts.value(key));
+		if (invoice == 0)
+			return error("Recibo no existe en la sesion.");
+
+		qint64 cash = PricingEngine::toCents(url.queryItemValue("amount"));
+		if (cash < 0)
+			return failure("Efectivo invalido.", "cash");
+
+		invoice->cash = PricingEngine::fromCents(cash);
+		qint64 paid = cash + PricingEngine::toCents(invoice->vouchers);
+		return success("<change>" + PricingEngine::fromCents(
+				qMax(paid - total(invoice), qint64(0))) + "</change>");
+
+	} else if (cmd == "save_object") {
+		if (!m_CashReceipts.contains(key))
+			return success("<id><![CDATA[" + QString::number(m_NextId++)
+					+ "]]></id>");
+
+		invoice = m_SessionInvoices.value(m_CashReceipts.value(key));
+		if (invoice == 0)
+			return error("Factura no existe en la sesion.");
+
+		if (PricingEngine::toCents(invoice->cash)
+				+ PricingEngine::toCents(invoice->vouchers) < total(invoice))
+			return failure("Efectivo insuficiente.", "cash");
+
+		saveInvoice(invoice);
+		return success("<id><![CDATA[" + invoice->id + "]]></id>");
+
+	} else if (cmd == "discard_document" || cmd == "remove_session_object") {
+		removeInvoice(key);
+		return success();
+
+	} else if (cmd == "search_product") {
+		QString keyword = url.queryItemValue("keyword");
+		QString results = "<keyword><![CDATA[" + keyword + "]]></keyword>";
+
+		for (int i = 0; i < m_ListSize; i++) {
+			QString barCode = QString::number(7501000000000LL + i);
+			results += "<result><bar_code><![CDATA[" + barCode + "]]></bar_code>"
+					"<name><![CDATA[" + keyword + " " + QString::number(i)
+					+ "]]></name><manufacturer><![CDATA[Fabricante]]>"
+					"</manufacturer></result>";
+		}
+		return success(results);
+
+	} else if (cmd.startsWith("set_") || cmd.startsWith("delete_")) {
+		return success();
+
+	} else {
+		return error("Comando " + cmd + " no soportado.");
+	}
+}
+
+/**
+ * Returns the page from the resources with its {$name} fields replaced.
+ */
+QString MockServer::page(QString name, QMap<QString, QString> values)
+{
+	QFile file(":/pages/" + name + ".html");
+	file.open(QIODevice::ReadOnly);
+	QTextStream stream(&file);
+	stream.setCodec("UTF-8");
+
+	QString content = stream.readAll();
+
+	QMapIterator<QString, QString> i(values);
+	while (i.hasNext()) {
+		i.next();
+		content.replace("{$" + i.key() + "}", i.value());
+	}
+
+	return content;
+}
+
+/**
+ * Returns a new session key.
+ */
+QString MockServer::newKey()
+{
+	return QString::number(m_NextKey++);
+}
+
+/**
+ * Returns a new invoice without id, which means it has not been saved.
+ */
+MockInvoice* MockServer::createInvoice()
+{
+	MockInvoice *invoice = new MockInvoice();
+	invoice->dateTime =
+			QDateTime::currentDateTime().toString("dd/MM/yyyy hh:mm:ss");
+	invoice->nit = "C/F";
+	invoice->customer = "Consumidor Final";
+	invoice->cash = "0.00";
+	invoice->vouchers = "0.00";
+
+	m_NewInvoices << invoice;
+
+	return invoice;
+}
+
+/**
+ * Gives the invoice an id and number and adds it to the list.
+ */
+void MockServer::saveInvoice(MockInvoice *invoice)
+{
+	invoice->id = QString::number(m_NextId++);
+	invoice->serialNumber = "A";
+	invoice->number = QString::number(m_SavedInvoices.size() + 1);
+
+	m_NewInvoices.removeOne(invoice);
+	m_Invoices.insert(invoice->id, invoice);
+	m_SavedInvoices << invoice;
+}
+
+/**
+ * Removes the object from the session. An invoice never saved is destroyed.
+ */
+void MockServer::removeInvoice(QString key)
+{
+	m_CashReceipts.remove(key);
+
+	MockInvoice *invoice = m_SessionInvoices.take(key);
+	if (invoice != 0 && m_NewInvoices.contains(invoice)) {
+		m_NewInvoices.removeOne(invoice);
+		delete invoice;
+	}
+}
+
+/**
+ * Returns a successful response with the body and the padding.
+ */
+QString MockServer::success(QString body)
+{
+	QString padding = (m_Padding > 0) ?
+			"<!-- " + QString(m_Padding, 'x') + " -->" : "";
+
+	return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<response>"
+			"<success>1</success>" + body + padding + "</response>";
+}
+
+/**
+ * Returns a failed validation response.
+ */
+QString MockServer::failure(QString message, QString elementId)
+{
+	return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<response>"
+			"<success>0</success><message><![CDATA[" + message + "]]></message>"
+			"<element_id>" + elementId + "</element_id></response>";
+}
+
+/**
+ * Returns an error response.
+ */
+QString MockServer::error(QString message)
+{
+	return "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<response><error />"
+			"<message><![CDATA[" + message + "]]></message></response>";
+}
+
+/**
+ * Returns the invoice details the same as the get_invoice_details command.
+ */
+QString MockServer::invoiceDetails(MockInvoice *invoice)
+{
+	QString amount = PricingEngine::fromCents(total(invoice));
+	int items = 0;
+
+	QString grid;
+	for (int i = 0; i < invoice->details.size(); i++) {
+		QStringList &detail = invoice->details[i];
+		QString pos = QString::number(i + 1);
+		int quantity = detail[2].toInt();
+
+		grid += "<row><row_pos>" + pos + "</row_pos><is_bonus>0</is_bonus>"
+				"<percentage>0</percentage><detail_id>" + pos + "</detail_id>"
+				"<product><![CDATA[" + detail[1] + "]]></product>"
+				"<quantity>" + detail[2] + "</quantity>"
+				"<price>" + detail[3] + "</price>"
+				"<total>" + PricingEngine::fromCents(
+						PricingEngine::toCents(detail[3]) * quantity) + "</total>"
+				"</row>";
+
+		items += quantity;
+	}
+
+	return success("<params><sub_total>" + amount + "</sub_total>"
+			"<discount_percentage>0.00</discount_percentage>"
+			"<discount>0.00</discount><total>" + amount + "</total>"
+			"<total_items>" + QString::number(items) + "</total_items></params>"
+			"<grid>" + grid + "</grid>");
+}
+
+/**
+ * Returns the invoice form page. With no invoice the form is empty.
+ */
+QString MockServer::invoicePage(MockInvoice *invoice, QString key)
+{
+	QMap<QString, QString> values;
+	values.insert("object_key", (key != "") ? "pageState.objectKey = " + key + ";" : "");
+	values.insert("status_label", (invoice != 0) ? "Creado" : "");
+	values.insert("serial_number", (invoice != 0) ? invoice->serialNumber : "");
+	values.insert("number", (invoice != 0) ? invoice->number : "");
+	values.insert("date_time", (invoice != 0) ? invoice->dateTime : "");
+	values.insert("username", (invoice != 0) ? "benchmark" : "");
+	values.insert("nit", (invoice != 0) ? invoice->nit : "");
+	values.insert("customer", (invoice != 0) ? invoice->customer : "");
+	values.insert("cash_amount", (invoice != 0) ? invoice->cash : "0.00");
+	values.insert("change_amount", (invoice != 0) ?
+			PricingEngine::fromCents(PricingEngine::toCents(invoice->cash)
+					- total(invoice)) : "0.00");
+
+	return page("invoice", values);
+}
+
+/**
+ * Returns the page for printing the invoice.
+ */
+QString MockServer::printPage(MockInvoice *invoice)
+{
+	QString details;
+	for (int i = 0; i < invoice->details.size(); i++) {
+		QStringList &detail = invoice->details[i];
+		details += "<tr><td>" + detail[2] + "</td><td>" + detail[1] + "</td><td>"
+				+ detail[3] + "</td></tr>";
+	}
+
+	QMap<QString, QString> values;
+	values.insert("serial_number", invoice->serialNumber);
+	values.insert("number", invoice->number);
+	values.insert("date_time", invoice->dateTime);
+	values.insert("nit", invoice->nit);
+	values.insert("customer", invoice->customer);
+	values.insert("details", details);
+	values.insert("total", PricingEngine::fromCents(total(invoice)));
+	values.insert("cash", invoice->cash);
+
+	return page("print_invoice", values);
+}
+
+/**
+ * Returns the invoice total in cents.
+ */
+qint64 MockServer::total(MockInvoice *invoice)
+{
+	qint64 cents = 0;
+
+	for (int i = 0; i < invoice->details.size(); i++)
+		cents += PricingEngine::toCents(invoice->details[i][3])
+				* invoice->details[i][2].toInt();
+
+	return cents;
+}
+
+/**
+ * Returns the price in cents of the product, always the same for a bar code.
+ */
+qint64 MockServer::price(QString barCode)
+{
+	return 100 + qHash(barCode) % 9900;
+}
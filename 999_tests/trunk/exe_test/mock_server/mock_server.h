@@ -0,0 +1,110 @@
+/*
+ * mock_server.h
+ *
+ *  Created on: 01/08/2011
+ *      Author: pc
+ */
+
+#ifndef MOCK_SERVER_H_
+#define MOCK_SERVER_H_
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QPointer>
+#include <QTimer>
+#include <QHash>
+#include <QMap>
+#include <QList>
+#include <QStringList>
+#include <QUrl>
+
+struct MockInvoice
+{
+	QString id;
+	QString serialNumber;
+	QString number;
+	QString dateTime;
+	QString nit;
+	QString customer;
+	QString cash;
+	QString vouchers;
+	QList<QStringList> details;
+};
+
+struct MockResponse
+{
+	QPointer<QTcpSocket> socket;
+	QByteArray data;
+	qint64 due;
+};
+
+class MockServer : public QTcpServer
+{
+	Q_OBJECT
+
+public:
+	MockServer(QObject *parent = 0);
+	virtual ~MockServer();
+	bool start(quint16 port = 0);
+	QString commandsAddress();
+	QString xslAddress();
+	void setLatency(int msecs);
+	void setJitter(int msecs);
+	void setListSize(int size);
+	void setPadding(int bytes);
+	void setXslDir(QString dir);
+	int requestCount();
+	QList<QUrl> receivedCommands();
+	qint64 bytesSent();
+
+protected:
+	void incomingConnection(int socketDescriptor);
+	virtual QByteArray respond(QString target, QByteArray *contentType,
+			int *delay);
+
+private slots:
+	void readRequest();
+	void removeConnection();
+	void sendResponses();
+
+private:
+	QHash<QTcpSocket*, QByteArray> m_Buffers;
+	QList<MockResponse> m_Responses;
+	QTimer m_SendTimer;
+	int m_Latency;
+	int m_Jitter;
+	int m_ListSize;
+	int m_Padding;
+	QString m_XslDir;
+	int m_RequestCount;
+	QList<QUrl> m_ReceivedCommands;
+	qint64 m_BytesSent;
+
+	int m_NextKey;
+	int m_NextId;
+	QMap<QString, MockInvoice*> m_Invoices;
+	QList<MockInvoice*> m_NewInvoices;
+	QMap<QString, MockInvoice*> m_SessionInvoices;
+	QMap<QString, QString> m_CashReceipts;
+	QList<MockInvoice*> m_SavedInvoices;
+
+	qint64 now();
+	void queue(QTcpSocket *socket, QByteArray data, int delay);
+	void scheduleResponses();
+	QString command(QString cmd, QUrl url, QByteArray *contentType);
+	QString page(QString name, QMap<QString, QString> values);
+	QString newKey();
+	MockInvoice* createInvoice();
+	void saveInvoice(MockInvoice *invoice);
+	void removeInvoice(QString key);
+	QString success(QString body = "");
+	QString failure(QString message, QString elementId = "");
+	QString error(QString message);
+	QString invoiceDetails(MockInvoice *invoice);
+	QString invoicePage(MockInvoice *invoice, QString key);
+	QString printPage(MockInvoice *invoice);
+	qint64 total(MockInvoice *invoice);
+	qint64 price(QString barCode);
+};
+
+#endif /* MOCK_SERVER_H_ */
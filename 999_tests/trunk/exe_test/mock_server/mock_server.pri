@@ -0,0 +1,6 @@
+# Stand-in for the pos server, for the programs that measure the client.
+QT += network
+INCLUDEPATH += $$PWD
+HEADERS += $$PWD/mock_server.h
+SOURCES += $$PWD/mock_server.cpp
+RESOURCES += $$PWD/mock_server.qrc
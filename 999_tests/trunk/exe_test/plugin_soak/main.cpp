@@ -0,0 +1,70 @@
+#include <QApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include "mock_server.h"
+#include "plugin_soak.h"
+
+/**
+ * Returns the number after the option name on the arguments or the default value.
+ */
+static int option(const QStringList &arguments, QString name, int value)
+{
+	int index = arguments.indexOf(name);
+
+	return (index != -1 && index + 1 < arguments.size()) ?
+			arguments[index + 1].toInt() : value;
+}
+
+/**
+ * Loads pages against the mock server and fails if the widgets alive grew more
+ * than the budget.
+ * Usage: plugin_soak [--loads N] [--documents N] [--warm-up N]
+ * [--widget-budget N]
+ */
+int main(int argc, char *argv[])
+{
+	QApplication a(argc, argv);
+
+	QStringList arguments = a.arguments();
+	QTextStream out(stdout);
+
+	int documents = option(arguments, "--documents", 20);
+
+	MockServer server;
+	server.setListSize(documents);
+
+	if (!server.start()) {
+		out << "No se pudo iniciar el servidor: " << server.errorString() << "\n";
+		return 1;
+	}
+
+	// The Registry reads the preferences next to the exe.
+	QFile file(QApplication::applicationDirPath() + "/preferences.txt");
+	file.open(QIODevice::WriteOnly | QIODevice::Text);
+	QTextStream stream(&file);
+	stream << "commands_address = " << server.commandsAddress() << "\n";
+	stream << "xsl_address = " << server.xslAddress() << "\n";
+	stream.flush();
+	file.close();
+
+	PluginSoak soak;
+
+	bool ok = soak.run(option(arguments, "--loads", 2000), documents,
+			option(arguments, "--warm-up", 10));
+
+	out << soak.report();
+
+	if (!ok) {
+		out << "error = " << soak.error() << "\n";
+		return 1;
+	}
+
+	int budget = option(arguments, "--widget-budget", 0);
+	if (soak.widgetGrowth() > budget) {
+		out << "error = Los widgets crecieron mas de " << budget << ".\n";
+		return 1;
+	}
+
+	return 0;
+}
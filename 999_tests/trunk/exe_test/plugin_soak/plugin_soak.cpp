@@ -0,0 +1,224 @@
+/*
+ * plugin_soak.cpp
+ *
+ *  Created on: 12/09/2011
+ *      Author: pc
+ */
+
+#include "plugin_soak.h"
+
+#include <QApplication>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTextStream>
+#include "registry.h"
+#include "plugins/plugin_widget.h"
+#include "allocation_counter.h"
+
+/**
+ * @class PluginSoak
+ * Loads the invoices on the SalesSection one after the other, the same as a
+ * cashier browsing them for a whole shift. Every page takes the plugin widgets
+ * of the factory so the number of widgets alive must stay the same no matter
+ * how many pages are loaded.
+ */
+
+// Milliseconds to wait for a page before giving up.
+static const int WAIT_TIMEOUT = 30000;
+
+/**
+ * Constructs the soak test.
+ */
+PluginSoak::PluginSoak(QObject *parent) : QObject(parent)
+{
+	m_Window = 0;
+	m_Section = 0;
+	m_Loads = 0;
+	m_StartWidgets = 0;
+	m_EndWidgets = 0;
+	m_MaxWidgets = 0;
+	m_EndPluginWidgets = 0;
+	m_Allocations = 0;
+	m_AllocatedBytes = 0;
+}
+
+/**
+ * Destroys the window with the section.
+ */
+PluginSoak::~PluginSoak()
+{
+	delete m_Window;
+}
+
+/**
+ * Makes the warm up loads and then the measured ones going through the first
+ * documents of the list. Returns false if a page did not load.
+ */
+bool PluginSoak::run(int loads, int documents, int warmUpLoads)
+{
+	createSection();
+
+	if (!waitFor(webView(m_Section), SIGNAL(loadFinished(bool)))) {
+		m_Error = "La seccion de ventas no cargo.";
+		return false;
+	}
+
+	documents = qMax(documents, 1);
+
+	for (int i = 0; i < warmUpLoads; i++)
+		if (!loadDocument(QString::number(i % documents + 1)))
+			return false;
+
+	int pluginWidgets;
+	countWidgets(&m_StartWidgets, &pluginWidgets);
+	m_MaxWidgets = m_StartWidgets;
+
+	uint allocations = AllocationCounter::count();
+	uint bytes = AllocationCounter::bytes();
+
+	for (int i = 0; i < loads; i++) {
+		if (!loadDocument(QString::number((warmUpLoads + i) % documents + 1)))
+			return false;
+
+		int widgets;
+		countWidgets(&widgets, &pluginWidgets);
+		m_MaxWidgets = qMax(m_MaxWidgets, widgets);
+		m_Loads++;
+	}
+
+	m_Allocations = AllocationCounter::count() - allocations;
+	m_AllocatedBytes = AllocationCounter::bytes() - bytes;
+
+	countWidgets(&m_EndWidgets, &m_EndPluginWidgets);
+
+	return true;
+}
+
+/**
+ * Returns the reason the test did not finish.
+ */
+QString PluginSoak::error()
+{
+	return m_Error;
+}
+
+/**
+ * Returns the results as name = value lines.
+ */
+QString PluginSoak::report()
+{
+	QString text;
+	QTextStream stream(&text);
+
+	int loads = qMax(m_Loads, 1);
+
+	stream << "loads = " << m_Loads << "\n";
+	stream << "start_widgets = " << m_StartWidgets << "\n";
+	stream << "end_widgets = " << m_EndWidgets << "\n";
+	stream << "max_widgets = " << m_MaxWidgets << "\n";
+	stream << "widget_growth = " << widgetGrowth() << "\n";
+	stream << "end_plugin_widgets = " << m_EndPluginWidgets << "\n";
+	stream << "allocations_per_load = " << m_Allocations / loads << "\n";
+	stream << "allocated_kb_per_load = " << m_AllocatedBytes / loads / 1024
+			<< "\n";
+	stream << "peak_rss_kb = " << AllocationCounter::peakResidentSize() << "\n";
+
+	stream.flush();
+
+	return text;
+}
+
+/**
+ * Returns how many more widgets are alive after the measured loads than before.
+ */
+int PluginSoak::widgetGrowth()
+{
+	return m_EndWidgets - m_StartWidgets;
+}
+
+/**
+ * Creates the sales section the same way the MainWindow does, but without
+ * asking for the cash register.
+ */
+void PluginSoak::createSection()
+{
+	m_Window = new MainWindow();
+
+	m_Section = new SalesSection(&m_CookieJar, &m_PluginFactory,
+			Registry::instance()->serverUrl(), "1", m_Window);
+	m_Section->setStyleSheetFileName("invoice_details.xsl");
+	m_Section->setGetDocumentDetailsCmd("get_invoice_details");
+	m_Section->setGetDocumentListCmd("get_invoice_list");
+	m_Section->setShowDocumentFormCmd("show_invoice_form");
+	m_Section->setGetDocumentCmd("get_invoice");
+	m_Section->setCreateDocumentCmd("create_invoice");
+	m_Section->setDeleteItemDocumentCmd("delete_product_invoice");
+
+	m_Section->setCreateDocumentTransformerName("invoice");
+	m_Section->setDocumentListTransformerName("invoice_list");
+
+	m_Section->setItemsName("Producto");
+
+	m_Section->init();
+	m_Window->setCentralWidget(m_Section);
+}
+
+/**
+ * Loads the document and destroys the widgets of the previous page.
+ */
+bool PluginSoak::loadDocument(QString id)
+{
+	m_Section->fetchDocument(id);
+
+	if (!waitFor(webView(m_Section), SIGNAL(loadFinished(bool)))) {
+		m_Error = "La factura " + id + " no cargo.";
+		return false;
+	}
+
+	// The page deletes its plugin widgets later.
+	QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+
+	return true;
+}
+
+/**
+ * Counts all the widgets alive and the plugin ones among them.
+ */
+void PluginSoak::countWidgets(int *widgets, int *pluginWidgets)
+{
+	QWidgetList list = QApplication::allWidgets();
+
+	*widgets = list.size();
+	*pluginWidgets = 0;
+
+	for (int i = 0; i < list.size(); i++)
+		if (dynamic_cast<PluginWidget*>(list[i]) != 0)
+			(*pluginWidgets)++;
+}
+
+/**
+ * Processes events until the sender emits the signal. Returns false if it was
+ * not emitted on time.
+ */
+bool PluginSoak::waitFor(QObject *sender, const char *signal)
+{
+	QEventLoop loop;
+	QTimer timer;
+	timer.setSingleShot(true);
+
+	connect(sender, signal, &loop, SLOT(quit()));
+	connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+
+	timer.start(WAIT_TIMEOUT);
+	loop.exec();
+
+	return timer.isActive();
+}
+
+/**
+ * Returns the web view of the section.
+ */
+QWebView* PluginSoak::webView(QWidget *section)
+{
+	return section->findChild<QWebView*>("webView");
+}
@@ -0,0 +1,51 @@
+/*
+ * plugin_soak.h
+ *
+ *  Created on: 12/09/2011
+ *      Author: pc
+ */
+
+#ifndef PLUGIN_SOAK_H_
+#define PLUGIN_SOAK_H_
+
+#include <QObject>
+#include <QNetworkCookieJar>
+#include <QWebView>
+#include "main_window.h"
+#include "section/sales_section.h"
+#include "plugins/web_plugin_factory.h"
+
+class PluginSoak : public QObject
+{
+	Q_OBJECT
+
+public:
+	PluginSoak(QObject *parent = 0);
+	virtual ~PluginSoak();
+	bool run(int loads, int documents, int warmUpLoads = 10);
+	QString error();
+	QString report();
+	int widgetGrowth();
+
+private:
+	QNetworkCookieJar m_CookieJar;
+	WebPluginFactory m_PluginFactory;
+	MainWindow *m_Window;
+	SalesSection *m_Section;
+	int m_Loads;
+	int m_StartWidgets;
+	int m_EndWidgets;
+	int m_MaxWidgets;
+	int m_EndPluginWidgets;
+	qint64 m_Allocations;
+	qint64 m_AllocatedBytes;
+	QString m_Error;
+
+	void createSection();
+	bool loadDocument(QString id);
+	void countWidgets(int *widgets, int *pluginWidgets);
+	bool waitFor(QObject *sender, const char *signal);
+	QWebView* webView(QWidget *section);
+};
+
+#endif /* PLUGIN_SOAK_H_ */
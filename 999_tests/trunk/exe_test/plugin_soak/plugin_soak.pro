@@ -0,0 +1,12 @@
+include(../exe.pri)
+include(../mock_server/mock_server.pri)
+
+TARGET = plugin_soak
+CONFIG += console
+INCLUDEPATH += ../checkout_benchmark
+HEADERS += ../checkout_benchmark/allocation_counter.h \
+    plugin_soak.h
+SOURCES += ../checkout_benchmark/allocation_counter.cpp \
+    main.cpp \
+    plugin_soak.cpp
+win32:LIBS += -lpsapi
@@ -0,0 +1,52 @@
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QStringList>
+#include "scanner_stress.h"
+
+/**
+ * Returns the number after the option name on the arguments or the default value.
+ */
+static int option(const QStringList &arguments, QString name, int value)
+{
+	int index = arguments.indexOf(name);
+
+	return (index != -1 && index + 1 < arguments.size()) ?
+			arguments[index + 1].toInt() : value;
+}
+
+/**
+ * Sends bar codes through a pty while the main thread is blocked and fails if
+ * any of them was lost or altered, or if closing the pty went unnoticed.
+ * Usage: scanner_stress [--scans N] [--burst N] [--stall-ms N]
+ */
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	QStringList arguments = a.arguments();
+	QTextStream out(stdout);
+
+	ScannerStress stress;
+
+	bool ok = stress.run(option(arguments, "--scans", 10000),
+			option(arguments, "--burst", 50), option(arguments, "--stall-ms", 200));
+
+	out << stress.report();
+
+	if (!ok) {
+		out << "error = " << stress.error() << "\n";
+		return 1;
+	}
+
+	if (stress.lostCount() > 0) {
+		out << "error = Se perdieron " << stress.lostCount() << " lecturas.\n";
+		return 1;
+	}
+
+	if (!stress.isUnplugDetected()) {
+		out << "error = No se detecto el cierre del lector.\n";
+		return 1;
+	}
+
+	return 0;
+}
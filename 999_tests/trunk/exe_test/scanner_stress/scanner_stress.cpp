@@ -0,0 +1,234 @@
+/*
+ * scanner_stress.cpp
+ *
+ *  Created on: 10/10/2011
+ *      Author: pc
+ */
+
+#include "scanner_stress.h"
+
+#include <QCoreApplication>
+#include <QTextStream>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * @class ScannerStress
+ * Feeds bar codes to a ScannerReader through a pty, the same as a serial scanner.
+ * The bar codes are sent in bursts and after each one the main thread stays
+ * blocked for a while, like during a page load, before taking them. Every bar
+ * code must arrive once, in order and with its quantity. It measures the time
+ * from the write to the take. At the end the pty is closed during a stall, like
+ * a scanner unplugged while a page loads, and the reader must notice it.
+ */
+
+// First bar code sent, the next ones are consecutive.
+static const qint64 FIRST_BAR_CODE = 7502000000000LL;
+
+/**
+ * Constructs the test.
+ */
+ScannerStress::ScannerStress(QObject *parent) : QObject(parent)
+{
+	m_Master = -1;
+	m_Reader = 0;
+	m_Sent = 0;
+	m_Received = 0;
+	m_OutOfOrder = 0;
+	m_BadQuantities = 0;
+	m_IsUnplugDetected = false;
+}
+
+/**
+ * Stops the reader and closes the pty.
+ */
+ScannerStress::~ScannerStress()
+{
+	delete m_Reader;
+
+	if (m_Master != -1)
+		::close(m_Master);
+}
+
+/**
+ * Sends the scans in bursts blocking the main thread after each one. Returns
+ * false if the pty could not be opened.
+ */
+bool ScannerStress::run(int scans, int burst, int stallMsecs)
+{
+	if (!openPty())
+		return false;
+
+	m_Clock.start();
+	m_SentTimes.resize(scans);
+	burst = qMax(burst, 1);
+
+	while (m_Sent < scans) {
+		for (int i = 0; i < burst && m_Sent < scans; i++)
+			send(m_Sent);
+
+		// The page is loading, nothing is taken meanwhile.
+		usleep(stallMsecs * 1000);
+
+		receive();
+	}
+
+	// Give the reader time for the last burst.
+	for (int i = 0; i < 50 && m_Received < m_Sent; i++) {
+		usleep(10000);
+		receive();
+	}
+
+	unplug(burst, stallMsecs);
+
+	return true;
+}
+
+/**
+ * Returns the reason the test did not run.
+ */
+QString ScannerStress::error()
+{
+	return m_Error;
+}
+
+/**
+ * Returns the results as name = value lines.
+ */
+QString ScannerStress::report()
+{
+	QString text;
+	QTextStream stream(&text);
+
+	stream << "scans_sent = " << m_Sent << "\n";
+	stream << "scans_received = " << m_Received << "\n";
+	stream << "scans_lost = " << lostCount() << "\n";
+	stream << "scans_dropped = " << (m_Reader != 0 ? m_Reader->droppedCount() : 0)
+			<< "\n";
+	stream << "out_of_order = " << m_OutOfOrder << "\n";
+	stream << "bad_quantities = " << m_BadQuantities << "\n";
+	stream << "unplug_detected = " << (m_IsUnplugDetected ? 1 : 0) << "\n";
+	stream << "wait_p50_ms = " << m_WaitTimes.percentile(50) / 1000.0 << "\n";
+	stream << "wait_p99_ms = " << m_WaitTimes.percentile(99) / 1000.0 << "\n";
+	stream << "wait_max_ms = " << m_WaitTimes.max() / 1000.0 << "\n";
+
+	stream.flush();
+
+	return text;
+}
+
+/**
+ * Returns the scans sent that were not received.
+ */
+int ScannerStress::lostCount()
+{
+	return m_Sent - m_Received;
+}
+
+/**
+ * Returns true if the reader noticed the closed pty.
+ */
+bool ScannerStress::isUnplugDetected()
+{
+	return m_IsUnplugDetected;
+}
+
+/**
+ * Opens a pty and starts the reader on its slave side.
+ */
+bool ScannerStress::openPty()
+{
+	m_Master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (m_Master == -1 || grantpt(m_Master) != 0 || unlockpt(m_Master) != 0) {
+		m_Error = "No se pudo crear el pty.";
+		return false;
+	}
+
+	m_Reader = new ScannerReader();
+	if (!m_Reader->open(ptsname(m_Master), "serial", 9600)) {
+		m_Error = m_Reader->errorString();
+		return false;
+	}
+
+	m_Reader->start();
+
+	return true;
+}
+
+/**
+ * Sends a burst and closes the pty while the main thread is blocked. The scans
+ * the reader got before must still be taken afterwards, the same as when the
+ * sales section finishes loading a page.
+ */
+void ScannerStress::unplug(int burst, int stallMsecs)
+{
+	m_SentTimes.resize(m_Sent + burst);
+
+	for (int i = 0; i < burst; i++)
+		send(m_Sent);
+
+	// The reader needs the data before the pty goes away.
+	usleep(stallMsecs * 1000);
+
+	::close(m_Master);
+	m_Master = -1;
+
+	for (int i = 0; i < 100 && m_Reader->isConnected(); i++)
+		usleep(10000);
+
+	m_IsUnplugDetected = !m_Reader->isConnected();
+
+	receive();
+}
+
+/**
+ * Writes the bar code with its quantity followed by a carriage return.
+ */
+void ScannerStress::send(int scan)
+{
+	QByteArray data = QByteArray::number(FIRST_BAR_CODE + scan) + "\r";
+
+	QString qty = quantity(scan);
+	if (qty != "1")
+		data.prepend(qty.toLatin1() + "*");
+
+	m_SentTimes[scan] = m_Clock.nsecsElapsed() / 1000;
+
+	if (::write(m_Master, data.constData(), data.size()) == data.size())
+		m_Sent++;
+}
+
+/**
+ * Takes all the scans on the queue and checks them.
+ */
+void ScannerStress::receive()
+{
+	// The reader emits scanned, nobody listens here.
+	QCoreApplication::processEvents();
+
+	QString barCode, qty;
+	while (m_Reader->take(&barCode, &qty)) {
+		int scan = int(barCode.toLongLong() - FIRST_BAR_CODE);
+
+		if (scan != m_Received)
+			m_OutOfOrder++;
+
+		if (scan >= 0 && scan < m_SentTimes.size()) {
+			m_WaitTimes.add(m_Clock.nsecsElapsed() / 1000 - m_SentTimes[scan]);
+
+			if (qty != quantity(scan))
+				m_BadQuantities++;
+		}
+
+		m_Received++;
+	}
+}
+
+/**
+ * Returns the quantity of the scan, one of every 5 has more than 1.
+ */
+QString ScannerStress::quantity(int scan)
+{
+	return (scan % 5 == 0) ? QString::number(scan % 7 + 2) : "1";
+}
@@ -0,0 +1,50 @@
+/*
+ * scanner_stress.h
+ *
+ *  Created on: 10/10/2011
+ *      Author: pc
+ */
+
+#ifndef SCANNER_STRESS_H_
+#define SCANNER_STRESS_H_
+
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+#include "scanner/scanner_reader.h"
+#include "diagnostics/latency_histogram.h"
+
+class ScannerStress : public QObject
+{
+	Q_OBJECT
+
+public:
+	ScannerStress(QObject *parent = 0);
+	virtual ~ScannerStress();
+	bool run(int scans, int burst, int stallMsecs);
+	QString error();
+	QString report();
+	int lostCount();
+	bool isUnplugDetected();
+
+private:
+	int m_Master;
+	ScannerReader *m_Reader;
+	QElapsedTimer m_Clock;
+	QVector<qint64> m_SentTimes;
+	LatencyHistogram m_WaitTimes;
+	int m_Sent;
+	int m_Received;
+	int m_OutOfOrder;
+	int m_BadQuantities;
+	bool m_IsUnplugDetected;
+	QString m_Error;
+
+	bool openPty();
+	void unplug(int burst, int stallMsecs);
+	void send(int scan);
+	void receive();
+	static QString quantity(int scan);
+};
+
+#endif /* SCANNER_STRESS_H_ */
@@ -0,0 +1,7 @@
+include(../exe.pri)
+
+TARGET = scanner_stress
+CONFIG += console
+HEADERS += scanner_stress.h
+SOURCES += main.cpp \
+    scanner_stress.cpp
@@ -0,0 +1,87 @@
+#include <QApplication>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include "mock_server.h"
+#include "shift_soak.h"
+
+/**
+ * Returns the number after the option name on the arguments or the default value.
+ */
+static int option(const QStringList &arguments, QString name, int value)
+{
+	int index = arguments.indexOf(name);
+
+	return (index != -1 && index + 1 < arguments.size()) ?
+			arguments[index + 1].toInt() : value;
+}
+
+/**
+ * Sells for a shift against the mock server and fails if the memory or the
+ * objects grew more than their budgets.
+ * Usage: shift_soak [--sales N] [--sample-every N] [--scans N] [--warm-up N]
+ * [--latency MS] [--list-size N] [--resident-budget KB] [--live-budget KB]
+ * [--object-budget N]
+ */
+int main(int argc, char *argv[])
+{
+	QApplication a(argc, argv);
+
+	QStringList arguments = a.arguments();
+	QTextStream out(stdout);
+
+	MockServer server;
+	server.setLatency(option(arguments, "--latency", 0));
+	server.setListSize(option(arguments, "--list-size", 100));
+
+	if (!server.start()) {
+		out << "No se pudo iniciar el servidor: " << server.errorString() << "\n";
+		return 1;
+	}
+
+	// The Registry reads the preferences next to the exe. The printer does not
+	// exist so nothing is printed.
+	QFile file(QApplication::applicationDirPath() + "/preferences.txt");
+	file.open(QIODevice::WriteOnly | QIODevice::Text);
+	QTextStream stream(&file);
+	stream << "commands_address = " << server.commandsAddress() << "\n";
+	stream << "xsl_address = " << server.xslAddress() << "\n";
+	stream << "printer_name = shift_soak\n";
+	stream << "is_tmu_printer = false\n";
+	stream.flush();
+	file.close();
+
+	ShiftSoak soak;
+
+	bool ok = soak.run(option(arguments, "--sales", 2000),
+			option(arguments, "--sample-every", 100), option(arguments, "--scans", 10),
+			option(arguments, "--warm-up", 5));
+
+	out << soak.report();
+
+	if (!ok) {
+		out << "error = " << soak.error() << "\n";
+		return 1;
+	}
+
+	QStringList errors;
+
+	int budget = option(arguments, "--resident-budget", 20480);
+	if (soak.residentGrowth() > budget)
+		errors << "La memoria residente crecio mas de " + QString::number(budget)
+				+ " KB.";
+
+	budget = option(arguments, "--live-budget", 1024);
+	if (soak.liveGrowth() / 1024 > budget)
+		errors << "La memoria de los subsistemas crecio mas de "
+				+ QString::number(budget) + " KB.";
+
+	budget = option(arguments, "--object-budget", 0);
+	if (soak.objectGrowth() > budget)
+		errors << "Los objetos crecieron mas de " + QString::number(budget) + ".";
+
+	for (int i = 0; i < errors.size(); i++)
+		out << "error = " << errors[i] << "\n";
+
+	return errors.isEmpty() ? 0 : 1;
+}
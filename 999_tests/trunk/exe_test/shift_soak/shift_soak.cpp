@@ -0,0 +1,206 @@
+/*
+ * shift_soak.cpp
+ *
+ *  Created on: 19/09/2011
+ *      Author: pc
+ */
+
+#include "shift_soak.h"
+
+#include <QApplication>
+#include <QWidget>
+#include <QTextStream>
+
+/**
+ * @class ShiftSoak
+ * Sells for a whole shift on the CheckoutBenchmark and takes a sample of the
+ * memory every some sales: the resident size, the memory alive of every
+ * subsystem of the client and the number of objects of every class. The first
+ * sample is taken after the warm up sales and the growth is measured from it to
+ * the last one. The memory of the subsystems is only known if the client was
+ * built with allocation accounting. The mock server runs on the same process,
+ * what it allocates counts on the resident size and on the other subsystem,
+ * which is left out of the live memory growth.
+ */
+
+/**
+ * Constructs the soak test.
+ */
+ShiftSoak::ShiftSoak(QObject *parent) : QObject(parent)
+{
+}
+
+/**
+ * Makes the warm up sales and then the measured ones, sampling every
+ * sampleSales sales. Returns false if a sale could not be completed.
+ */
+bool ShiftSoak::run(int sales, int sampleSales, int scans, int warmUpSales)
+{
+	sampleSales = qMax(sampleSales, 1);
+
+	if (!m_Benchmark.run(0, scans, warmUpSales)) {
+		m_Error = m_Benchmark.error();
+		return false;
+	}
+
+	sample(0);
+
+	for (int made = 0; made < sales; ) {
+		int count = qMin(sampleSales, sales - made);
+
+		if (!m_Benchmark.run(count, scans, 0)) {
+			m_Error = m_Benchmark.error();
+			return false;
+		}
+
+		made += count;
+		sample(made);
+	}
+
+	return true;
+}
+
+/**
+ * Returns the reason the test did not finish.
+ */
+QString ShiftSoak::error()
+{
+	return m_Error;
+}
+
+/**
+ * Returns the samples and the growth as name = value lines, followed by the
+ * subsystems and classes that grew.
+ */
+QString ShiftSoak::report()
+{
+	QString text;
+	QTextStream stream(&text);
+
+	for (int i = 0; i < m_Samples.size(); i++) {
+		const SoakSample &sample = m_Samples[i];
+		stream << "sample = sales " << sample.sales << " resident_kb "
+				<< sample.residentSize << " live_kb "
+				<< clientLiveBytes(sample) / 1024 << " objects " << sample.objects
+				<< "\n";
+	}
+
+	stream << "resident_growth_kb = " << residentGrowth() << "\n";
+	stream << "live_growth_kb = " << liveGrowth() / 1024 << "\n";
+	stream << "object_growth = " << objectGrowth() << "\n";
+	stream << "peak_resident_kb = " << AllocationTracker::peakResidentSize()
+			<< "\n";
+
+	if (m_Samples.size() > 1) {
+		const SoakSample &first = m_Samples.first();
+		const SoakSample &last = m_Samples.last();
+
+		if (AllocationTracker::isEnabled()) {
+			for (int i = 0; i < AllocationTracker::SubsystemCount; i++) {
+				qint64 growth = last.liveBytes[i] - first.liveBytes[i];
+				if (growth != 0)
+					stream << AllocationTracker::name(AllocationTracker::Subsystem(i))
+							<< "_growth_bytes = " << growth << "\n";
+			}
+		}
+
+		QStringList classes = last.classes.keys() + first.classes.keys();
+		classes.removeDuplicates();
+		classes.sort();
+
+		for (int i = 0; i < classes.size(); i++) {
+			int growth = last.classes.value(classes[i])
+					- first.classes.value(classes[i]);
+			if (growth != 0)
+				stream << "objects_" << classes[i] << "_growth = " << growth << "\n";
+		}
+	}
+
+	stream << "\n" << m_Benchmark.report();
+
+	stream.flush();
+
+	return text;
+}
+
+/**
+ * Returns how much the resident size grew in kilobytes.
+ */
+qint64 ShiftSoak::residentGrowth()
+{
+	return m_Samples.size() > 1 ?
+			m_Samples.last().residentSize - m_Samples.first().residentSize : 0;
+}
+
+/**
+ * Returns how much the memory alive of the client grew in bytes.
+ */
+qint64 ShiftSoak::liveGrowth()
+{
+	return m_Samples.size() > 1 ? clientLiveBytes(m_Samples.last())
+			- clientLiveBytes(m_Samples.first()) : 0;
+}
+
+/**
+ * Returns how much the number of objects grew.
+ */
+int ShiftSoak::objectGrowth()
+{
+	return m_Samples.size() > 1 ?
+			m_Samples.last().objects - m_Samples.first().objects : 0;
+}
+
+/**
+ * Takes a sample once the objects waiting to be deleted are gone.
+ */
+void ShiftSoak::sample(int sales)
+{
+	QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+
+	SoakSample sample;
+	sample.sales = sales;
+	sample.residentSize = AllocationTracker::residentSize();
+	sample.objects = 0;
+
+	for (int i = 0; i < AllocationTracker::SubsystemCount; i++)
+		sample.liveBytes[i] =
+				AllocationTracker::liveBytes(AllocationTracker::Subsystem(i));
+
+	// The objects without parent other than the windows are not found.
+	countObjects(qApp, &sample);
+
+	QWidgetList widgets = QApplication::topLevelWidgets();
+	for (int i = 0; i < widgets.size(); i++)
+		if (widgets[i]->parent() == 0)
+			countObjects(widgets[i], &sample);
+
+	m_Samples << sample;
+}
+
+/**
+ * Counts the object and all its children by class.
+ */
+void ShiftSoak::countObjects(QObject *object, SoakSample *sample)
+{
+	QList<QObject*> objects = object->findChildren<QObject*>();
+	objects.prepend(object);
+
+	for (int i = 0; i < objects.size(); i++)
+		sample->classes[objects[i]->metaObject()->className()]++;
+
+	sample->objects += objects.size();
+}
+
+/**
+ * Returns the bytes alive of the client subsystems.
+ */
+qint64 ShiftSoak::clientLiveBytes(const SoakSample &sample)
+{
+	qint64 total = 0;
+
+	for (int i = 0; i < AllocationTracker::SubsystemCount; i++)
+		if (i != AllocationTracker::Other)
+			total += sample.liveBytes[i];
+
+	return total;
+}
@@ -0,0 +1,50 @@
+/*
+ * shift_soak.h
+ *
+ *  Created on: 19/09/2011
+ *      Author: pc
+ */
+
+#ifndef SHIFT_SOAK_H_
+#define SHIFT_SOAK_H_
+
+#include <QObject>
+#include <QList>
+#include <QMap>
+#include "checkout_benchmark.h"
+#include "diagnostics/allocation_tracker.h"
+
+struct SoakSample
+{
+	int sales;
+	qint64 residentSize;
+	qint64 liveBytes[AllocationTracker::SubsystemCount];
+	int objects;
+	QMap<QString, int> classes;
+};
+
+class ShiftSoak : public QObject
+{
+	Q_OBJECT
+
+public:
+	ShiftSoak(QObject *parent = 0);
+	virtual ~ShiftSoak() {};
+	bool run(int sales, int sampleSales, int scans, int warmUpSales = 5);
+	QString error();
+	QString report();
+	qint64 residentGrowth();
+	qint64 liveGrowth();
+	int objectGrowth();
+
+private:
+	CheckoutBenchmark m_Benchmark;
+	QList<SoakSample> m_Samples;
+	QString m_Error;
+
+	void sample(int sales);
+	void countObjects(QObject *object, SoakSample *sample);
+	qint64 clientLiveBytes(const SoakSample &sample);
+};
+
+#endif /* SHIFT_SOAK_H_ */
@@ -0,0 +1,17 @@
+# Subsystem memory is only counted on the platforms with allocation accounting.
+CONFIG += allocation_accounting
+include(../exe.pri)
+include(../mock_server/mock_server.pri)
+
+TARGET = shift_soak
+CONFIG += console
+INCLUDEPATH += ../checkout_benchmark
+HEADERS += ../checkout_benchmark/allocation_counter.h \
+    ../checkout_benchmark/benchmark_plugin_factory.h \
+    ../checkout_benchmark/checkout_benchmark.h \
+    shift_soak.h
+SOURCES += ../checkout_benchmark/allocation_counter.cpp \
+    ../checkout_benchmark/benchmark_plugin_factory.cpp \
+    ../checkout_benchmark/checkout_benchmark.cpp \
+    main.cpp \
+    shift_soak.cpp
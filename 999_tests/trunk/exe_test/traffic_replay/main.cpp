@@ -0,0 +1,82 @@
+#include <QApplication>
+#include <QTextStream>
+#include <QStringList>
+#include "replay_server.h"
+#include "traffic_replay.h"
+
+/**
+ * Returns the value after the option name on the arguments or the default value.
+ */
+static QString option(const QStringList &arguments, QString name, QString value)
+{
+	int index = arguments.indexOf(name);
+
+	return (index != -1 && index + 1 < arguments.size()) ?
+			arguments[index + 1] : value;
+}
+
+/**
+ * Replays a traffic log and prints the results. Without a server address the
+ * recorded responses are served by a stand-in on 127.0.0.1.
+ * Usage: traffic_replay LOG [--server ADDRESS] [--speed FACTOR] [--no-handle]
+ */
+int main(int argc, char *argv[])
+{
+	QApplication a(argc, argv);
+
+	QStringList arguments = a.arguments();
+	QTextStream out(stdout);
+
+	if (arguments.size() < 2 || arguments[1].startsWith("--")) {
+		out << "Uso: traffic_replay LOG [--server DIRECCION] [--speed FACTOR] "
+				"[--no-handle]\n";
+		return 1;
+	}
+
+	TrafficLogReader reader(arguments[1]);
+	if (!reader.open()) {
+		out << "No se pudo leer el archivo: " << arguments[1] << "\n";
+		return 1;
+	}
+
+	QList<TrafficRecord> records;
+	TrafficRecord record;
+	while (reader.next(&record))
+		records << record;
+
+	double speed = option(arguments, "--speed", "1").toDouble();
+	QString address = option(arguments, "--server", "");
+
+	ReplayServer server;
+	server.setSpeed(speed);
+
+	if (address == "") {
+		for (int i = 0; i < records.size(); i++)
+			server.add(records[i]);
+
+		if (!server.start()) {
+			out << "No se pudo iniciar el servidor: " << server.errorString()
+					<< "\n";
+			return 1;
+		}
+
+		address = server.commandsAddress();
+	}
+
+	TrafficReplay replay;
+	replay.setServerAddress(address);
+	replay.setSpeed(speed);
+	replay.setHandleResponses(!arguments.contains("--no-handle"));
+
+	bool ok = replay.run(records);
+
+	out << "log = " << arguments[1] << "\n";
+	out << "captured_at = " << reader.started().toString(Qt::ISODate) << "\n";
+	out << "speed = " << speed << "\n";
+	out << replay.report();
+
+	if (server.isListening())
+		out << "missing_responses = " << server.missCount() << "\n";
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+/*
+ * replay_server.cpp
+ *
+ *  Created on: 15/08/2011
+ *      Author: pc
+ */
+
+#include "replay_server.h"
+
+/**
+ * @class ReplayServer
+ * Stand-in server that answers with the responses captured on a traffic log
+ * instead of making them up. Each request gets the next recorded response of
+ * the same command and parameters after the time the real server took, divided
+ * by the speed. Once they are used up the last one is repeated, and requests
+ * never recorded, like the xsl files, are served by the MockServer.
+ */
+
+/**
+ * Constructs the server with the original speed.
+ */
+ReplayServer::ReplayServer(QObject *parent) : MockServer(parent)
+{
+	m_Speed = 1;
+	m_MissCount = 0;
+}
+
+/**
+ * Sets how many times faster than recorded the responses are sent. Zero sends
+ * them right away.
+ */
+void ReplayServer::setSpeed(double speed)
+{
+	m_Speed = speed;
+}
+
+/**
+ * Adds the recorded response, answered after the ones added before it for the
+ * same request.
+ */
+void ReplayServer::add(const TrafficRecord &record)
+{
+	m_Records[key(record.url)] << record;
+}
+
+/**
+ * Returns the number of requests that were not on the log.
+ */
+int ReplayServer::missCount()
+{
+	return m_MissCount;
+}
+
+/**
+ * Returns the command file and query of the url, the part that does not depend
+ * on the server address.
+ */
+QString ReplayServer::key(QUrl url)
+{
+	return url.path().section('/', -1) + "?"
+			+ QString::fromLatin1(url.encodedQuery());
+}
+
+/**
+ * Returns the next recorded response for the target.
+ */
+QByteArray ReplayServer::respond(QString target, QByteArray *contentType,
+		int *delay)
+{
+	QString name = key(QUrl::fromEncoded(target.toAscii()));
+
+	TrafficRecord record;
+	QList<TrafficRecord> &records = m_Records[name];
+
+	if (!records.isEmpty()) {
+		record = records.takeFirst();
+		m_LastRecords.insert(name, record);
+	} else if (m_LastRecords.contains(name)) {
+		record = m_LastRecords.value(name);
+	} else {
+		m_MissCount++;
+		return MockServer::respond(target, contentType, delay);
+	}
+
+	*delay = (m_Speed > 0) ? int(record.duration / 1000 / m_Speed) : 0;
+	*contentType = record.content.startsWith("<?xml") ? "text/xml" :
+			"text/html; charset=UTF-8";
+
+	return record.content.toUtf8();
+}
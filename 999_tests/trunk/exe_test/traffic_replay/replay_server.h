@@ -0,0 +1,35 @@
+/*
+ * replay_server.h
+ *
+ *  Created on: 15/08/2011
+ *      Author: pc
+ */
+
+#ifndef REPLAY_SERVER_H_
+#define REPLAY_SERVER_H_
+
+#include "mock_server.h"
+#include "traffic_capture/traffic_log_reader.h"
+
+class ReplayServer : public MockServer
+{
+	Q_OBJECT
+
+public:
+	ReplayServer(QObject *parent = 0);
+	void setSpeed(double speed);
+	void add(const TrafficRecord &record);
+	int missCount();
+	static QString key(QUrl url);
+
+protected:
+	QByteArray respond(QString target, QByteArray *contentType, int *delay);
+
+private:
+	double m_Speed;
+	QHash<QString, QList<TrafficRecord> > m_Records;
+	QHash<QString, TrafficRecord> m_LastRecords;
+	int m_MissCount;
+};
+
+#endif /* REPLAY_SERVER_H_ */
@@ -0,0 +1,202 @@
+/*
+ * traffic_replay.cpp
+ *
+ *  Created on: 15/08/2011
+ *      Author: pc
+ */
+
+#include "traffic_replay.h"
+
+#include <QEventLoop>
+#include <QTimer>
+#include <QTextStream>
+#include "http_request/http_request.h"
+#include "xml_response_handler/xml_response_handler.h"
+#include "xml_transformer/xml_transformer_factory.h"
+#include "diagnostics/latency_recorder.h"
+
+/**
+ * @class TrafficReplay
+ * Sends again the requests of a traffic log through the HttpRequest, at the
+ * moment they were made on the shift divided by the speed, and passes the
+ * responses through the XmlResponseHandler with the transformer the client uses
+ * for each command. The requests are made one after the other, a request that
+ * takes longer than recorded delays the next ones. Both the recorded and the
+ * replayed durations are kept on the LatencyRecorder.
+ */
+
+/**
+ * Constructs the replay at the original speed.
+ */
+TrafficReplay::TrafficReplay(QObject *parent) : QObject(parent)
+{
+	m_Speed = 1;
+	m_IsHandled = true;
+	m_Requests = 0;
+	m_Failures = 0;
+	m_Differences = 0;
+	m_MaxLag = 0;
+
+	m_Transformers.insert("get_invoice_list", "invoice_list");
+	m_Transformers.insert("create_invoice", "invoice");
+	m_Transformers.insert("get_deposit_list", "deposit_list");
+	m_Transformers.insert("create_deposit", "deposit");
+	m_Transformers.insert("get_is_open_cash_register", "cash_register_status");
+	m_Transformers.insert("set_customer_invoice", "invoice_customer");
+	m_Transformers.insert("get_customer", "customer");
+	m_Transformers.insert("create_discount", "object_key");
+	m_Transformers.insert("create_cash_receipt", "object_key");
+	m_Transformers.insert("get_cash_register", "object_key");
+	m_Transformers.insert("set_cash_cash_receipt", "change");
+	m_Transformers.insert("get_cash_receipt_vouchers", "total");
+	m_Transformers.insert("get_correlative_warning", "correlative_warning");
+	m_Transformers.insert("search_product", "search_product_results");
+	m_Transformers.insert("get_shift_list", "shift_list");
+	m_Transformers.insert("get_payment_card_type_list", "payment_card_type_list");
+	m_Transformers.insert("get_payment_card_brand_list",
+			"payment_card_brand_list");
+	m_Transformers.insert("get_bank_list", "bank_list");
+	m_Transformers.insert("set_bank_account_deposit", "bank");
+	m_Transformers.insert("get_available_cash_receipt_list",
+			"available_cash_receipt_list");
+}
+
+/**
+ * Sets the address the requests are sent to, like the commands_address
+ * preference. Empty keeps the recorded one.
+ */
+void TrafficReplay::setServerAddress(QString address)
+{
+	m_ServerAddress = address;
+}
+
+/**
+ * Sets how many times faster than recorded the requests are made. Zero makes
+ * them one after the other without waiting.
+ */
+void TrafficReplay::setSpeed(double speed)
+{
+	m_Speed = speed;
+}
+
+/**
+ * Sets if the responses are parsed and transformed like the client does.
+ */
+void TrafficReplay::setHandleResponses(bool isHandled)
+{
+	m_IsHandled = isHandled;
+}
+
+/**
+ * Makes the requests of the records. Returns false if there were none.
+ */
+bool TrafficReplay::run(const QList<TrafficRecord> &records)
+{
+	if (records.isEmpty())
+		return false;
+
+	LatencyRecorder *recorder = LatencyRecorder::instance();
+	HttpRequest request(&m_CookieJar);
+
+	qint64 first = records[0].start;
+	qint64 start = recorder->now();
+
+	for (int i = 0; i < records.size(); i++) {
+		const TrafficRecord &record = records[i];
+		QUrl url = target(record.url);
+		QString cmd = url.queryItemValue("cmd");
+
+		wait(record.start - first, start);
+
+		recorder->record("recorded", cmd, record.duration);
+
+		QString content = request.get(url);
+		m_Requests++;
+
+		if (content == "")
+			m_Failures++;
+		else if (content != record.content)
+			m_Differences++;
+
+		if (m_IsHandled && content != "")
+			handle(cmd, content);
+	}
+
+	return true;
+}
+
+/**
+ * Returns the results as name = value lines followed by the recorded and
+ * replayed latency of every command.
+ */
+QString TrafficReplay::report()
+{
+	QString text;
+	QTextStream stream(&text);
+
+	stream << "requests = " << m_Requests << "\n";
+	stream << "failures = " << m_Failures << "\n";
+	stream << "different_responses = " << m_Differences << "\n";
+	stream << "max_lag_ms = " << m_MaxLag / 1000.0 << "\n";
+	stream << "\n" << LatencyRecorder::instance()->report();
+
+	stream.flush();
+
+	return text;
+}
+
+/**
+ * Processes events until due microseconds, divided by the speed, have passed
+ * since start. Keeps how late the request is if the time already passed.
+ */
+void TrafficReplay::wait(qint64 due, qint64 start)
+{
+	if (m_Speed <= 0)
+		return;
+
+	qint64 remaining = qint64(due / m_Speed) - (LatencyRecorder::instance()->now()
+			- start);
+
+	if (remaining < 0) {
+		m_MaxLag = qMax(m_MaxLag, -remaining);
+		return;
+	}
+
+	QEventLoop loop;
+	QTimer::singleShot(int(remaining / 1000), &loop, SLOT(quit()));
+	loop.exec();
+}
+
+/**
+ * Returns the url on the server address.
+ */
+QUrl TrafficReplay::target(QUrl url)
+{
+	if (m_ServerAddress == "")
+		return url;
+
+	QUrl address("http://" + m_ServerAddress);
+	address.setPath(address.path() + url.path().section('/', -1));
+	address.setEncodedQuery(url.encodedQuery());
+
+	return address;
+}
+
+/**
+ * Parses and transforms the response like the client does. The commands that
+ * answer pages are not handled.
+ */
+void TrafficReplay::handle(QString cmd, QString content)
+{
+	if (!content.startsWith("<?xml"))
+		return;
+
+	XmlTransformer *transformer = XmlTransformerFactory::instance()->create(
+			m_Transformers.value(cmd, "stub"));
+
+	XmlResponseHandler handler;
+	QString errorMsg;
+	handler.handle(content, transformer, &errorMsg);
+
+	delete transformer;
+}
@@ -0,0 +1,44 @@
+/*
+ * traffic_replay.h
+ *
+ *  Created on: 15/08/2011
+ *      Author: pc
+ */
+
+#ifndef TRAFFIC_REPLAY_H_
+#define TRAFFIC_REPLAY_H_
+
+#include <QObject>
+#include <QMap>
+#include <QNetworkCookieJar>
+#include "traffic_capture/traffic_log_reader.h"
+
+class TrafficReplay : public QObject
+{
+	Q_OBJECT
+
+public:
+	TrafficReplay(QObject *parent = 0);
+	void setServerAddress(QString address);
+	void setSpeed(double speed);
+	void setHandleResponses(bool isHandled);
+	bool run(const QList<TrafficRecord> &records);
+	QString report();
+
+private:
+	QString m_ServerAddress;
+	double m_Speed;
+	bool m_IsHandled;
+	QNetworkCookieJar m_CookieJar;
+	QMap<QString, QString> m_Transformers;
+	int m_Requests;
+	int m_Failures;
+	int m_Differences;
+	qint64 m_MaxLag;
+
+	void wait(qint64 due, qint64 start);
+	QUrl target(QUrl url);
+	void handle(QString cmd, QString content);
+};
+
+#endif /* TRAFFIC_REPLAY_H_ */
@@ -0,0 +1,10 @@
+include(../exe.pri)
+include(../mock_server/mock_server.pri)
+
+TARGET = traffic_replay
+CONFIG += console
+HEADERS += replay_server.h \
+    traffic_replay.h
+SOURCES += replay_server.cpp \
+    traffic_replay.cpp \
+    main.cpp
@@ -0,0 +1,236 @@
+/*
+ * document_prefetcher_test.cpp
+ *
+ *  Created on: 19/12/2011
+ *      Author: pc
+ */
+
+#include "document_prefetcher_test.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QRegExp>
+#include <QNetworkCookieJar>
+#include "section/page_state.h"
+#include "document_cache/document_prefetcher.h"
+#include "document_cache/document_snapshot_cache.h"
+
+/**
+ * @class TemplatePageServer
+ * Mock server that answers the get_invoice command with the page rendered from
+ * the pos server templates, so the prefetcher reads what the real server sends.
+ */
+
+/**
+ * Constructs the server. The documents are finished unless told otherwise.
+ */
+TemplatePageServer::TemplatePageServer(QObject *parent) : MockServer(parent)
+{
+	m_DocumentStatus = 1;
+}
+
+/**
+ * Sets the status put on the pages of the documents.
+ */
+void TemplatePageServer::setDocumentStatus(int status)
+{
+	m_DocumentStatus = status;
+}
+
+/**
+ * Returns the commands received in order.
+ */
+QStringList TemplatePageServer::commands()
+{
+	return m_Commands;
+}
+
+/**
+ * Answers the document and its details, the rest goes to the mock server.
+ */
+QByteArray TemplatePageServer::respond(QString target, QByteArray *contentType,
+		int *delay)
+{
+	QUrl url = QUrl::fromEncoded(target.toAscii());
+	QString cmd = url.queryItemValue("cmd");
+	m_Commands << cmd;
+
+	*delay = 0;
+
+	if (cmd == "get_invoice") {
+		*contentType = "text/html; charset=UTF-8";
+		return DocumentPrefetcherTest::invoicePage(
+				QString::number(m_DocumentStatus), "1001").toUtf8();
+
+	} else if (cmd == "get_invoice_details") {
+		*contentType = "text/xml";
+		return QByteArray("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+				"<response><success>1</success><params><total>10.00</total>"
+				"</params><grid></grid></response>");
+	}
+
+	return MockServer::respond(target, contentType, delay);
+}
+
+/**
+ * @class DocumentPrefetcherTest
+ * Feeds the prefetcher the pages rendered from the templates of the pos server.
+ */
+
+/**
+ * Empties the cache shared by the tests.
+ */
+void DocumentPrefetcherTest::init()
+{
+	DocumentSnapshotCache::instance()->clear();
+}
+
+/**
+ * The invoice form with every status and a deposit form.
+ */
+void DocumentPrefetcherTest::readTemplatePage_data()
+{
+	QTest::addColumn<QString>("page");
+	QTest::addColumn<QString>("key");
+	QTest::addColumn<int>("status");
+
+	QTest::newRow("edit") << invoicePage("0", "1001") << "1001" << 0;
+	QTest::newRow("idle") << invoicePage("1", "1002") << "1002" << 1;
+	QTest::newRow("cancelled") << invoicePage("2", "1003") << "1003" << 2;
+
+	QMap<QString, QString> values;
+	values.insert("content", "deposit_form_html.tpl");
+	values.insert("cash_register_status", "1");
+	values.insert("status", "1");
+	values.insert("key", "1004");
+	QTest::newRow("deposit") << renderTemplate("site_pos_html.tpl", values)
+			<< "1004" << 1;
+}
+
+/**
+ * The key and status read from the html are the ones on the page script.
+ */
+void DocumentPrefetcherTest::readTemplatePage()
+{
+	QFETCH(QString, page);
+	QFETCH(QString, key);
+	QFETCH(int, status);
+
+	PageState state = PageState::parse(page);
+
+	QVERIFY(state.isSessionActive);
+	QCOMPARE(state.cashRegisterStatus, 1);
+	QCOMPARE(state.documentStatus, status);
+	QCOMPARE(state.objectKey, key);
+}
+
+/**
+ * A finished document is stored on the cache and removed from the session.
+ */
+void DocumentPrefetcherTest::prefetchFinishedDocument()
+{
+	TemplatePageServer server;
+	QVERIFY(server.start());
+
+	QUrl serverUrl("http://" + server.commandsAddress());
+	QNetworkCookieJar jar;
+
+	DocumentPrefetcher prefetcher(&jar, &serverUrl);
+	prefetcher.setGetDocumentCmd("get_invoice");
+	prefetcher.setGetDocumentDetailsCmd("get_invoice_details");
+	prefetcher.setStyleSheet("<xsl:stylesheet version=\"2.0\" "
+			"xmlns:xsl=\"http://www.w3.org/1999/XSL/Transform\">"
+			"<xsl:template match=\"/\"><p><xsl:value-of "
+			"select=\"response/params/total\" /></p></xsl:template>"
+			"</xsl:stylesheet>");
+	prefetcher.prefetch(QStringList() << "7");
+
+	for (int i = 0; i < 50 && !server.commands().contains("remove_session_object");
+			i++)
+		QTest::qWait(100);
+
+	QCOMPARE(server.commands(), QStringList() << "get_invoice"
+			<< "get_invoice_details" << "remove_session_object");
+
+	QString snapshot;
+	QVERIFY(DocumentSnapshotCache::instance()->find("get_invoice", "7",
+			&snapshot));
+	QVERIFY(snapshot.contains("10.00"));
+}
+
+/**
+ * A document still on edit is only removed from the session.
+ */
+void DocumentPrefetcherTest::skipEditedDocument()
+{
+	TemplatePageServer server;
+	server.setDocumentStatus(0);
+	QVERIFY(server.start());
+
+	QUrl serverUrl("http://" + server.commandsAddress());
+	QNetworkCookieJar jar;
+
+	DocumentPrefetcher prefetcher(&jar, &serverUrl);
+	prefetcher.setGetDocumentCmd("get_invoice");
+	prefetcher.setGetDocumentDetailsCmd("get_invoice_details");
+	prefetcher.setStyleSheet("<xsl:stylesheet version=\"2.0\" "
+			"xmlns:xsl=\"http://www.w3.org/1999/XSL/Transform\">"
+			"<xsl:template match=\"/\" /></xsl:stylesheet>");
+	prefetcher.prefetch(QStringList() << "8");
+
+	for (int i = 0; i < 50 && !server.commands().contains("remove_session_object");
+			i++)
+		QTest::qWait(100);
+
+	QCOMPARE(server.commands(), QStringList() << "get_invoice"
+			<< "remove_session_object");
+	QVERIFY(!DocumentSnapshotCache::instance()->contains("get_invoice", "8"));
+}
+
+/**
+ * Renders the template the way Smarty does for the tags the page script
+ * depends on: the variables, the includes and the if and literal blocks. The
+ * conditions are taken as true.
+ */
+QString DocumentPrefetcherTest::renderTemplate(QString name,
+		QMap<QString, QString> values)
+{
+	QFile file(QString(TEMPLATES_DIR) + "/" + name);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return "";
+
+	QString html = QString::fromUtf8(file.readAll());
+
+	QRegExp includeRx("\\{include file=(\\$content|'([^']+)')\\}");
+	int pos;
+	while ((pos = includeRx.indexIn(html)) != -1) {
+		QString included = (includeRx.cap(1) == "$content") ?
+				values.value("content") : includeRx.cap(2);
+		html.replace(pos, includeRx.matchedLength(),
+				renderTemplate(included, values));
+	}
+
+	QMapIterator<QString, QString> i(values);
+	while (i.hasNext()) {
+		i.next();
+		html.replace("{$" + i.key() + "}", i.value());
+	}
+
+	html.remove(QRegExp("\\{/?(if|literal)\\b[^}]*\\}"));
+
+	return html;
+}
+
+/**
+ * Returns the page the get_invoice command shows for the invoice.
+ */
+QString DocumentPrefetcherTest::invoicePage(QString status, QString key)
+{
+	QMap<QString, QString> values;
+	values.insert("content", "invoice_form_html.tpl");
+	values.insert("cash_register_status", "1");
+	values.insert("status", status);
+	values.insert("key", key);
+
+	return renderTemplate("site_pos_html.tpl", values);
+}
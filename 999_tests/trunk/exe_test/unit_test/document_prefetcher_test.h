@@ -0,0 +1,46 @@
+/*
+ * document_prefetcher_test.h
+ *
+ *  Created on: 19/12/2011
+ *      Author: pc
+ */
+
+#ifndef DOCUMENT_PREFETCHER_TEST_H_
+#define DOCUMENT_PREFETCHER_TEST_H_
+
+#include <QObject>
+#include <QMap>
+#include "mock_server.h"
+
+class TemplatePageServer : public MockServer
+{
+public:
+	TemplatePageServer(QObject *parent = 0);
+	void setDocumentStatus(int status);
+	QStringList commands();
+
+protected:
+	QByteArray respond(QString target, QByteArray *contentType, int *delay);
+
+private:
+	int m_DocumentStatus;
+	QStringList m_Commands;
+};
+
+class DocumentPrefetcherTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void init();
+	void readTemplatePage_data();
+	void readTemplatePage();
+	void prefetchFinishedDocument();
+	void skipEditedDocument();
+
+public:
+	static QString renderTemplate(QString name, QMap<QString, QString> values);
+	static QString invoicePage(QString status, QString key);
+};
+
+#endif /* DOCUMENT_PREFETCHER_TEST_H_ */
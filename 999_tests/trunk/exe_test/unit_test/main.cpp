@@ -0,0 +1,60 @@
+#include <QApplication>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <QtTest/QtTest>
+#include "mock_server.h"
+#include "document_prefetcher_test.h"
+#include "page_state_test.h"
+#include "pricing_engine_test.h"
+#include "sales_journal_test.h"
+#include "scan_coalescer_test.h"
+
+/**
+ * Runs every test class. Fails if any of them fails. The Registry reads the
+ * preferences next to the exe, they point to a mock server and keep the merged
+ * scans waiting longer than any test.
+ */
+int main(int argc, char *argv[])
+{
+	QApplication a(argc, argv);
+
+	QStringList arguments = a.arguments();
+	QTextStream out(stdout);
+
+	MockServer server;
+	if (!server.start()) {
+		out << "No se pudo iniciar el servidor: " << server.errorString() << "\n";
+		return 1;
+	}
+
+	QFile file(QApplication::applicationDirPath() + "/preferences.txt");
+	file.open(QIODevice::WriteOnly | QIODevice::Text);
+	QTextStream stream(&file);
+	stream << "commands_address = " << server.commandsAddress() << "\n";
+	stream << "xsl_address = " << server.xslAddress() << "\n";
+	stream << "printer_name = unit_test\n";
+	stream << "is_tmu_printer = false\n";
+	stream << "scan_merge_interval = 60000\n";
+	stream.flush();
+	file.close();
+
+	int result = 0;
+
+	DocumentPrefetcherTest prefetcherTest;
+	result |= QTest::qExec(&prefetcherTest, arguments);
+
+	PageStateTest pageStateTest;
+	result |= QTest::qExec(&pageStateTest, arguments);
+
+	PricingEngineTest pricingTest;
+	result |= QTest::qExec(&pricingTest, arguments);
+
+	SalesJournalTest journalTest(&server);
+	result |= QTest::qExec(&journalTest, arguments);
+
+	ScanCoalescerTest coalescerTest(&server);
+	result |= QTest::qExec(&coalescerTest, arguments);
+
+	return result;
+}
@@ -0,0 +1,87 @@
+/*
+ * page_state_test.cpp
+ *
+ *  Created on: 20/12/2011
+ *      Author: pc
+ */
+
+#include "page_state_test.h"
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+#include <QRegExp>
+#include "section/page_state.h"
+
+/**
+ * @class PageStateTest
+ * Checks that every page the client loads puts its state on the pageState
+ * object. A page with the old globals is read with the defaults, which closes
+ * the session on the client.
+ */
+
+/**
+ * Reads the whole file as Latin-1, the encoding of the pages.
+ */
+static QString readPage(QString fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return "";
+
+	return QString::fromLatin1(file.readAll());
+}
+
+/**
+ * The client's own pages, the mock server pages and the pos server templates.
+ */
+void PageStateTest::noBareGlobals_data()
+{
+	QTest::addColumn<QString>("fileName");
+
+	QStringList dirs;
+	dirs << ":/resources" << ":/pages" << TEMPLATES_DIR;
+
+	foreach (QString path, dirs) {
+		QDir dir(path);
+		QStringList names = dir.entryList(QStringList() << "*.html" << "*.tpl",
+				QDir::Files);
+
+		foreach (QString name, names) {
+			QString fileName = dir.filePath(name);
+			QTest::newRow(fileName.toLatin1()) << fileName;
+		}
+	}
+}
+
+/**
+ * Fails if the page declares any of the fields as a global variable.
+ */
+void PageStateTest::noBareGlobals()
+{
+	QFETCH(QString, fileName);
+
+	QString html = readPage(fileName);
+	QVERIFY(html != "");
+
+	QRegExp globalRx("var\\s+(isSessionActive|cashRegisterStatus|documentStatus"
+			"|objectStatus|objectKey)\\b");
+
+	if (globalRx.indexIn(html) != -1)
+		QFAIL(qPrintable(fileName + " declares " + globalRx.cap(1)
+				+ " outside pageState"));
+}
+
+/**
+ * The offline invoice keeps the session open on a document being edited with
+ * the cash register open.
+ */
+void PageStateTest::offlineInvoice()
+{
+	PageState state =
+			PageState::parse(readPage(":/resources/offline_invoice.html"));
+
+	QCOMPARE(state.isSessionActive, true);
+	QCOMPARE(state.cashRegisterStatus, 1);
+	QCOMPARE(state.documentStatus, 1);
+}
@@ -0,0 +1,23 @@
+/*
+ * page_state_test.h
+ *
+ *  Created on: 20/12/2011
+ *      Author: pc
+ */
+
+#ifndef PAGE_STATE_TEST_H_
+#define PAGE_STATE_TEST_H_
+
+#include <QObject>
+
+class PageStateTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void noBareGlobals_data();
+	void noBareGlobals();
+	void offlineInvoice();
+};
+
+#endif /* PAGE_STATE_TEST_H_ */
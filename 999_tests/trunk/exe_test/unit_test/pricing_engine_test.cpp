@@ -0,0 +1,159 @@
+/*
+ * pricing_engine_test.cpp
+ *
+ *  Created on: 19/12/2011
+ *      Author: pc
+ */
+
+#include "pricing_engine_test.h"
+
+#include <QtTest/QtTest>
+#include <QMap>
+#include "pricing/pricing_engine.h"
+
+/**
+ * @class PricingEngineTest
+ * Checks the engine's rounding and the invoice amounts against the ones the
+ * server computed for the same invoices. The expected amounts come from the
+ * server's business tests and the V.A.T. from the sales report query, which
+ * applies the percentage to the total less the unrounded discount.
+ */
+
+/**
+ * Exact divisions, halves and the values next to them on both signs.
+ */
+void PricingEngineTest::roundedDivide_data()
+{
+	QTest::addColumn<qint64>("dividend");
+	QTest::addColumn<qint64>("divisor");
+	QTest::addColumn<qint64>("result");
+
+	QTest::newRow("zero") << Q_INT64_C(0) << Q_INT64_C(100) << Q_INT64_C(0);
+	QTest::newRow("exact") << Q_INT64_C(300) << Q_INT64_C(100) << Q_INT64_C(3);
+	QTest::newRow("below half") << Q_INT64_C(149) << Q_INT64_C(100)
+			<< Q_INT64_C(1);
+	QTest::newRow("half") << Q_INT64_C(150) << Q_INT64_C(100) << Q_INT64_C(2);
+	QTest::newRow("even half") << Q_INT64_C(250) << Q_INT64_C(100)
+			<< Q_INT64_C(3);
+	QTest::newRow("above half") << Q_INT64_C(151) << Q_INT64_C(100)
+			<< Q_INT64_C(2);
+	QTest::newRow("negative exact") << Q_INT64_C(-300) << Q_INT64_C(100)
+			<< Q_INT64_C(-3);
+	QTest::newRow("negative below half") << Q_INT64_C(-149) << Q_INT64_C(100)
+			<< Q_INT64_C(-1);
+	QTest::newRow("negative half") << Q_INT64_C(-150) << Q_INT64_C(100)
+			<< Q_INT64_C(-2);
+	QTest::newRow("negative even half") << Q_INT64_C(-250) << Q_INT64_C(100)
+			<< Q_INT64_C(-3);
+	QTest::newRow("negative above half") << Q_INT64_C(-151) << Q_INT64_C(100)
+			<< Q_INT64_C(-2);
+	QTest::newRow("small negative") << Q_INT64_C(-4) << Q_INT64_C(10)
+			<< Q_INT64_C(0);
+	QTest::newRow("discount") << Q_INT64_C(16786350) << Q_INT64_C(10000)
+			<< Q_INT64_C(1679);
+	QTest::newRow("vat") << Q_INT64_C(111256380000) << Q_INT64_C(100000000)
+			<< Q_INT64_C(1113);
+}
+
+/**
+ * Rounds half away from zero.
+ */
+void PricingEngineTest::roundedDivide()
+{
+	QFETCH(qint64, dividend);
+	QFETCH(qint64, divisor);
+	QFETCH(qint64, result);
+
+	QCOMPARE(PricingEngine::roundedDivide(dividend, divisor), result);
+}
+
+/**
+ * Invoices with their lines as quantity x price, the discount percentage and
+ * the amounts the server returned for them with a 12% V.A.T.
+ */
+void PricingEngineTest::invoiceTotals_data()
+{
+	QTest::addColumn<QStringList>("lines");
+	QTest::addColumn<QString>("discountPercentage");
+	QTest::addColumn<QString>("subTotal");
+	QTest::addColumn<QString>("discount");
+	QTest::addColumn<QString>("total");
+	QTest::addColumn<QString>("vat");
+
+	QTest::newRow("one line") << (QStringList() << "4 x 23.21") << "0.00"
+			<< "92.84" << "0.00" << "92.84" << "11.14";
+	QTest::newRow("two lines") << (QStringList() << "4 x 23.21" << "1 x 15.95")
+			<< "0.00" << "108.79" << "0.00" << "108.79" << "13.05";
+	QTest::newRow("bonus") << (QStringList() << "4 x 23.21" << "1 x 15.95"
+			<< "1 x -34.60") << "0.00" << "74.19" << "0.00" << "74.19" << "8.90";
+	QTest::newRow("discount") << (QStringList() << "5 x 10.00") << "15.00"
+			<< "50.00" << "7.50" << "42.50" << "5.10";
+	QTest::newRow("rounded discount") << (QStringList() << "5 x 21.90")
+			<< "15.33" << "109.50" << "16.79" << "92.71" << "11.13";
+}
+
+/**
+ * The engine gives the same amounts as the server.
+ */
+void PricingEngineTest::invoiceTotals()
+{
+	QFETCH(QStringList, lines);
+	QFETCH(QString, discountPercentage);
+	QFETCH(QString, subTotal);
+	QFETCH(QString, discount);
+	QFETCH(QString, total);
+	QFETCH(QString, vat);
+
+	QList<QMap<QString, QString>*> rows;
+	for (int i = 0; i < lines.size(); i++) {
+		QStringList values = lines[i].split(" x ");
+		QMap<QString, QString> *row = new QMap<QString, QString>();
+		row->insert("quantity", values[0]);
+		row->insert("price", values[1]);
+		rows << row;
+	}
+
+	PricingEngine *engine = PricingEngine::instance();
+	engine->setVatPercentage("12.00");
+
+	InvoiceTotals totals = engine->invoiceTotals(rows, discountPercentage);
+	qDeleteAll(rows);
+
+	QCOMPARE(PricingEngine::fromCents(totals.subTotal), subTotal);
+	QCOMPARE(PricingEngine::fromCents(totals.discount), discount);
+	QCOMPARE(PricingEngine::fromCents(totals.total), total);
+	QCOMPARE(PricingEngine::fromCents(totals.vat), vat);
+}
+
+/**
+ * Cash, vouchers and total in cents with the change expected.
+ */
+void PricingEngineTest::change_data()
+{
+	QTest::addColumn<qint64>("cash");
+	QTest::addColumn<qint64>("vouchers");
+	QTest::addColumn<qint64>("total");
+	QTest::addColumn<qint64>("change");
+
+	QTest::newRow("cash") << Q_INT64_C(10000) << Q_INT64_C(0) << Q_INT64_C(9271)
+			<< Q_INT64_C(729);
+	QTest::newRow("vouchers") << Q_INT64_C(5000) << Q_INT64_C(5000)
+			<< Q_INT64_C(9271) << Q_INT64_C(729);
+	QTest::newRow("exact") << Q_INT64_C(9271) << Q_INT64_C(0) << Q_INT64_C(9271)
+			<< Q_INT64_C(0);
+	QTest::newRow("short") << Q_INT64_C(5000) << Q_INT64_C(0) << Q_INT64_C(9271)
+			<< Q_INT64_C(0);
+}
+
+/**
+ * The change is never below zero.
+ */
+void PricingEngineTest::change()
+{
+	QFETCH(qint64, cash);
+	QFETCH(qint64, vouchers);
+	QFETCH(qint64, total);
+	QFETCH(qint64, change);
+
+	QCOMPARE(PricingEngine::change(cash, vouchers, total), change);
+}
@@ -0,0 +1,26 @@
+/*
+ * pricing_engine_test.h
+ *
+ *  Created on: 19/12/2011
+ *      Author: pc
+ */
+
+#ifndef PRICING_ENGINE_TEST_H_
+#define PRICING_ENGINE_TEST_H_
+
+#include <QObject>
+
+class PricingEngineTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void roundedDivide_data();
+	void roundedDivide();
+	void invoiceTotals_data();
+	void invoiceTotals();
+	void change_data();
+	void change();
+};
+
+#endif /* PRICING_ENGINE_TEST_H_ */
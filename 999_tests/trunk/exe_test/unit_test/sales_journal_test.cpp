@@ -0,0 +1,244 @@
+/*
+ * sales_journal_test.cpp
+ *
+ *  Created on: 20/12/2011
+ *      Author: pc
+ */
+
+#include "sales_journal_test.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QHostAddress>
+#include "registry.h"
+#include "sales_journal/sales_journal.h"
+#include "sales_journal/journal_replayer.h"
+
+/**
+ * @class SalesJournalTest
+ * Checks that the records survive on the journal, that a line left by a write
+ * that did not finish does not take the next record with it, and that the
+ * replayer sends the invoices in order once the server comes back, never twice.
+ * The journal is the one next to the exe, emptied before every test.
+ */
+
+// Customer name with the characters the journal encodes.
+static const char NAME[] = "Pe\xf1" "a & C\xed" "a=|%";
+
+/**
+ * Constructs the test with the server the invoices are replayed on.
+ */
+SalesJournalTest::SalesJournalTest(MockServer *server, QObject *parent)
+		: QObject(parent), m_Server(server)
+{
+
+}
+
+/**
+ * Starts every test with an empty journal.
+ */
+void SalesJournalTest::init()
+{
+	SalesJournal *journal = SalesJournal::instance();
+	journal->close();
+	QFile::remove(journal->fileName());
+}
+
+/**
+ * Leaves no journal behind.
+ */
+void SalesJournalTest::cleanupTestCase()
+{
+	init();
+}
+
+/**
+ * The records come back in the order they were written with their values and
+ * time, whatever characters the values have.
+ */
+void SalesJournalTest::append()
+{
+	SalesJournal *journal = SalesJournal::instance();
+
+	appendRecord("invoice", "1", "register_key", "123");
+	appendRecord("customer", "1", "name", QString::fromLatin1(NAME));
+
+	QList<QMap<QString, QString>*> records = journal->records();
+	QCOMPARE(records.size(), 2);
+
+	QCOMPARE(records[0]->value("type"), QString("invoice"));
+	QCOMPARE(records[0]->value("register_key"), QString("123"));
+	QVERIFY(records[0]->value("time") != "");
+
+	QCOMPARE(records[1]->value("type"), QString("customer"));
+	QCOMPARE(records[1]->value("invoice"), QString("1"));
+	QCOMPARE(records[1]->value("name"), QString::fromLatin1(NAME));
+
+	qDeleteAll(records);
+}
+
+/**
+ * A crash in the middle of a write leaves a line without end. It is not read
+ * and the first record written after opening the journal again is complete.
+ */
+void SalesJournalTest::tornTail()
+{
+	SalesJournal *journal = SalesJournal::instance();
+
+	appendRecord("invoice", "1", "register_key", "123");
+	journal->close();
+
+	QFile file(journal->fileName());
+	QVERIFY(file.open(QIODevice::Append));
+	file.write("type=product&invoice=1&bar_co");
+	file.close();
+
+	QList<QMap<QString, QString>*> records = journal->records();
+	QCOMPARE(records.size(), 1);
+	qDeleteAll(records);
+
+	appendRecord("cash_receipt", "1", "cash", "100.00");
+
+	records = journal->records();
+	QCOMPARE(records.size(), 2);
+	QCOMPARE(records[0]->value("type"), QString("invoice"));
+	QCOMPARE(records[1]->value("type"), QString("cash_receipt"));
+	QCOMPARE(records[1]->value("cash"), QString("100.00"));
+	qDeleteAll(records);
+}
+
+/**
+ * An invoice whose replay was interrupted after it was created on the server is
+ * marked as failed once and never sent again.
+ */
+void SalesJournalTest::interruptedReplay()
+{
+	writeInvoice("1", "7501000000001", 2);
+	appendRecord("replaying", "1");
+
+	int from = m_Server->receivedCommands().size();
+
+	JournalReplayer replayer(&m_CookieJar, Registry::instance()->serverUrl());
+	QCOMPARE(replayer.replay(), 0);
+	QCOMPARE(replayer.replay(), 0);
+
+	QCOMPARE(commands(from, "create_invoice").size(), 0);
+	QCOMPARE(countRecords("failed", "1"), 1);
+	QCOMPARE(countRecords("replayed", "1"), 0);
+}
+
+/**
+ * Nothing is lost while the server is down and once it is back the invoices
+ * are created in the order they were made, each one only once.
+ */
+void SalesJournalTest::replayOrder()
+{
+	writeInvoice("1", "7501000000001", 2);
+	writeInvoice("2", "7501000000002", 1);
+	writeInvoice("3", "7501000000003", 3);
+
+	JournalReplayer replayer(&m_CookieJar, Registry::instance()->serverUrl());
+	QSignalSpy spy(&replayer, SIGNAL(invoiceReplayed(QString, QString)));
+
+	quint16 port = m_Server->serverPort();
+	m_Server->close();
+
+	QCOMPARE(replayer.replay(), 0);
+	QCOMPARE(spy.count(), 0);
+	QCOMPARE(countRecords("replaying", "1"), 0);
+	QCOMPARE(countRecords("failed", "1"), 0);
+
+	QVERIFY(m_Server->listen(QHostAddress::LocalHost, port));
+
+	int from = m_Server->receivedCommands().size();
+
+	QCOMPARE(replayer.replay(), 3);
+	QCOMPARE(spy.count(), 3);
+	QCOMPARE(spy[0][0].toString(), QString("1"));
+	QCOMPARE(spy[1][0].toString(), QString("2"));
+	QCOMPARE(spy[2][0].toString(), QString("3"));
+
+	QList<QUrl> added = commands(from, "add_product_invoice");
+	QCOMPARE(added.size(), 3);
+	QCOMPARE(added[0].queryItemValue("bar_code"), QString("7501000000001"));
+	QCOMPARE(added[0].queryItemValue("quantity"), QString("2"));
+	QCOMPARE(added[1].queryItemValue("bar_code"), QString("7501000000002"));
+	QCOMPARE(added[2].queryItemValue("bar_code"), QString("7501000000003"));
+	QCOMPARE(added[2].queryItemValue("quantity"), QString("3"));
+
+	for (int i = 1; i <= 3; i++)
+		QCOMPARE(countRecords("replayed", QString::number(i)), 1);
+
+	from = m_Server->receivedCommands().size();
+
+	QCOMPARE(replayer.replay(), 0);
+	QCOMPARE(commands(from, "create_invoice").size(), 0);
+}
+
+/**
+ * Writes a paid invoice with one product, the cash is more than any price.
+ */
+void SalesJournalTest::writeInvoice(QString id, QString barCode, int quantity)
+{
+	appendRecord("invoice", id, "register_key", "1");
+
+	QMap<QString, QString> record;
+	record.insert("type", "product");
+	record.insert("invoice", id);
+	record.insert("bar_code", barCode);
+	record.insert("name", "Producto " + barCode);
+	record.insert("quantity", QString::number(quantity));
+	record.insert("price", "1.00");
+	QVERIFY(SalesJournal::instance()->append(record));
+
+	appendRecord("cash_receipt", id, "cash", "1000.00");
+}
+
+/**
+ * Appends a record with one value.
+ */
+void SalesJournalTest::appendRecord(QString type, QString id, QString name,
+		QString value)
+{
+	QMap<QString, QString> record;
+	record.insert("type", type);
+	record.insert("invoice", id);
+
+	if (name != "")
+		record.insert(name, value);
+
+	QVERIFY(SalesJournal::instance()->append(record));
+}
+
+/**
+ * Returns how many records of the type the invoice has on the journal.
+ */
+int SalesJournalTest::countRecords(QString type, QString id)
+{
+	QList<QMap<QString, QString>*> records = SalesJournal::instance()->records();
+
+	int count = 0;
+	for (int i = 0; i < records.size(); i++)
+		if (records[i]->value("type") == type
+				&& records[i]->value("invoice") == id)
+			count++;
+
+	qDeleteAll(records);
+
+	return count;
+}
+
+/**
+ * Returns the commands of the kind received after the first ones.
+ */
+QList<QUrl> SalesJournalTest::commands(int from, QString cmd)
+{
+	QList<QUrl> received = m_Server->receivedCommands().mid(from);
+
+	QList<QUrl> found;
+	for (int i = 0; i < received.size(); i++)
+		if (received[i].queryItemValue("cmd") == cmd)
+			found << received[i];
+
+	return found;
+}
@@ -0,0 +1,42 @@
+/*
+ * sales_journal_test.h
+ *
+ *  Created on: 20/12/2011
+ *      Author: pc
+ */
+
+#ifndef SALES_JOURNAL_TEST_H_
+#define SALES_JOURNAL_TEST_H_
+
+#include <QObject>
+#include <QMap>
+#include <QNetworkCookieJar>
+#include "mock_server.h"
+
+class SalesJournalTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	SalesJournalTest(MockServer *server, QObject *parent = 0);
+
+private slots:
+	void init();
+	void cleanupTestCase();
+	void append();
+	void tornTail();
+	void interruptedReplay();
+	void replayOrder();
+
+private:
+	MockServer *m_Server;
+	QNetworkCookieJar m_CookieJar;
+
+	void writeInvoice(QString id, QString barCode, int quantity);
+	void appendRecord(QString type, QString id, QString name = "",
+			QString value = "");
+	int countRecords(QString type, QString id);
+	QList<QUrl> commands(int from, QString cmd);
+};
+
+#endif /* SALES_JOURNAL_TEST_H_ */
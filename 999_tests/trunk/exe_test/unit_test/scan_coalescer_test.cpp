@@ -0,0 +1,176 @@
+/*
+ * scan_coalescer_test.cpp
+ *
+ *  Created on: 19/12/2011
+ *      Author: pc
+ */
+
+#include "scan_coalescer_test.h"
+
+#include <QtTest/QtTest>
+#include <QDialog>
+#include <QWebView>
+#include "registry.h"
+#include "main_window.h"
+#include "scanner/scan_coalescer.h"
+#include "section/sales_section.h"
+
+/**
+ * @class ScanCoalescerTest
+ * Checks the merging of the same bar code, the window after the last scan and
+ * that the sales section sends the line still waiting when it is destroyed. The
+ * section works against the mock server the preferences point to, with a merge
+ * interval long enough for the line to still be waiting.
+ */
+
+// Milliseconds to wait for a page before giving up.
+static const int WAIT_TIMEOUT = 30000;
+
+/**
+ * Constructs the test with the server the section works with.
+ */
+ScanCoalescerTest::ScanCoalescerTest(MockServer *server, QObject *parent)
+		: QObject(parent), m_Server(server)
+{
+
+}
+
+/**
+ * Rejects the modal dialogs, like the customer one, as soon as they are shown.
+ */
+bool ScanCoalescerTest::eventFilter(QObject *watched, QEvent *event)
+{
+	if (event->type() == QEvent::Show) {
+		QDialog *dialog = qobject_cast<QDialog*>(watched);
+
+		if (dialog != 0 && dialog->isModal())
+			QMetaObject::invokeMethod(dialog, "reject", Qt::QueuedConnection);
+	}
+
+	return false;
+}
+
+/**
+ * The scans of the same bar code add up on one line, a different one is
+ * refused until the line is taken.
+ */
+void ScanCoalescerTest::merge()
+{
+	ScanCoalescer coalescer;
+	coalescer.setInterval(1000);
+
+	QVERIFY(!coalescer.hasPending());
+	QVERIFY(coalescer.add("7502000000001", 1));
+	QVERIFY(coalescer.add("7502000000001", 2));
+	QVERIFY(coalescer.add("7502000000001", 1));
+	QVERIFY(!coalescer.add("7502000000002", 1));
+
+	QCOMPARE(coalescer.barCode(), QString("7502000000001"));
+	QCOMPARE(coalescer.quantity(), 4);
+	QCOMPARE(coalescer.scanCount(), 3);
+
+	QString barCode;
+	int quantity, scans;
+	QVERIFY(coalescer.take(&barCode, &quantity, &scans));
+	QCOMPARE(barCode, QString("7502000000001"));
+	QCOMPARE(quantity, 4);
+	QCOMPARE(scans, 3);
+
+	QVERIFY(!coalescer.hasPending());
+	QVERIFY(!coalescer.take(&barCode, &quantity, &scans));
+	QVERIFY(coalescer.add("7502000000002", 1));
+}
+
+/**
+ * The timeout comes once the interval passes without scans, every scan waits
+ * the whole interval again.
+ */
+void ScanCoalescerTest::windowTimeout()
+{
+	ScanCoalescer coalescer;
+	coalescer.setInterval(300);
+
+	QSignalSpy spy(&coalescer, SIGNAL(timeout()));
+
+	coalescer.add("7502000000001", 1);
+	QTest::qWait(200);
+	QCOMPARE(spy.count(), 0);
+
+	coalescer.add("7502000000001", 1);
+	QTest::qWait(200);
+	QCOMPARE(spy.count(), 0);
+
+	QTest::qWait(300);
+	QCOMPARE(spy.count(), 1);
+
+	// Taking the line stops the wait.
+	coalescer.add("7502000000001", 1);
+	coalescer.clear();
+	QTest::qWait(500);
+	QCOMPARE(spy.count(), 1);
+}
+
+/**
+ * The merged line waiting when the section is destroyed reaches the server.
+ */
+void ScanCoalescerTest::flushOnDestruction()
+{
+	QVERIFY(Registry::instance()->scanMergeInterval() > WAIT_TIMEOUT);
+
+	MainWindow *window = new MainWindow();
+
+	SalesSection *section = new SalesSection(&m_CookieJar, &m_PluginFactory,
+			Registry::instance()->serverUrl(), "1", window);
+	section->setStyleSheetFileName("invoice_details.xsl");
+	section->setGetDocumentDetailsCmd("get_invoice_details");
+	section->setGetDocumentListCmd("get_invoice_list");
+	section->setShowDocumentFormCmd("show_invoice_form");
+	section->setGetDocumentCmd("get_invoice");
+	section->setCreateDocumentCmd("create_invoice");
+	section->setDeleteItemDocumentCmd("delete_product_invoice");
+	section->setCreateDocumentTransformerName("invoice");
+	section->setDocumentListTransformerName("invoice_list");
+	section->setItemsName("Producto");
+
+	section->init();
+	window->setCentralWidget(section);
+
+	QSignalSpy loadSpy(section->findChild<QWebView*>(),
+			SIGNAL(loadFinished(bool)));
+	for (int i = 0; i < WAIT_TIMEOUT / 100 && loadSpy.count() == 0; i++)
+		QTest::qWait(100);
+	QVERIFY(loadSpy.count() > 0);
+
+	qApp->installEventFilter(this);
+	section->createInvoice();
+
+	int from = m_Server->receivedCommands().size();
+
+	section->scanProduct("7502000000001", "1");
+	section->scanProduct("7502000000001", "2");
+	section->scanProduct("7502000000001", "1");
+	QCOMPARE(productsAdded(from).size(), 0);
+
+	delete window;
+	qApp->removeEventFilter(this);
+
+	QList<QUrl> added = productsAdded(from);
+	QCOMPARE(added.size(), 1);
+	QCOMPARE(added[0].queryItemValue("bar_code"), QString("7502000000001"));
+	QCOMPARE(added[0].queryItemValue("quantity"), QString("4"));
+}
+
+/**
+ * Returns the add_product_invoice commands received after the first ones.
+ */
+QList<QUrl> ScanCoalescerTest::productsAdded(int from)
+{
+	QList<QUrl> commands = m_Server->receivedCommands().mid(from);
+
+	QList<QUrl> added;
+	for (int i = 0; i < commands.size(); i++)
+		if (commands[i].queryItemValue("cmd") == "add_product_invoice")
+			added << commands[i];
+
+	return added;
+}
@@ -0,0 +1,39 @@
+/*
+ * scan_coalescer_test.h
+ *
+ *  Created on: 19/12/2011
+ *      Author: pc
+ */
+
+#ifndef SCAN_COALESCER_TEST_H_
+#define SCAN_COALESCER_TEST_H_
+
+#include <QObject>
+#include <QNetworkCookieJar>
+#include "mock_server.h"
+#include "plugins/web_plugin_factory.h"
+
+class ScanCoalescerTest : public QObject
+{
+	Q_OBJECT
+
+public:
+	ScanCoalescerTest(MockServer *server, QObject *parent = 0);
+
+protected:
+	bool eventFilter(QObject *watched, QEvent *event);
+
+private slots:
+	void merge();
+	void windowTimeout();
+	void flushOnDestruction();
+
+private:
+	MockServer *m_Server;
+	QNetworkCookieJar m_CookieJar;
+	WebPluginFactory m_PluginFactory;
+
+	QList<QUrl> productsAdded(int from);
+};
+
+#endif /* SCAN_COALESCER_TEST_H_ */
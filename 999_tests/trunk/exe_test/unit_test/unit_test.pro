@@ -0,0 +1,18 @@
+include(../exe.pri)
+include(../mock_server/mock_server.pri)
+
+TARGET = unit_test
+CONFIG += console
+QT += testlib
+DEFINES += TEMPLATES_DIR=\\\"$$PWD/../../../../999_pos/trunk/templates\\\"
+HEADERS += document_prefetcher_test.h \
+    page_state_test.h \
+    pricing_engine_test.h \
+    sales_journal_test.h \
+    scan_coalescer_test.h
+SOURCES += document_prefetcher_test.cpp \
+    page_state_test.cpp \
+    pricing_engine_test.cpp \
+    sales_journal_test.cpp \
+    scan_coalescer_test.cpp \
+    main.cpp
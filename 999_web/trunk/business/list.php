@@ -380,4 +380,29 @@ class UnitOfMeasureList extends DataList{
 		return UnitOfMeasureListDAM::getList($totalPages, $totalItems, $page);
 	}
 }
+
+
+/**
+ * Utility class for obtaining the catalog of the products sold from the database.
+ * @package List
+ * @author Roberto Oliveros
+ */
+class ProductCatalogList extends DataList{
+	/**
+	 * Returns an array with the active products' bar_code, name and price from the database.
+	 *
+	 * The totalPages and totalItems arguments are necessary to return their respective values. If no page
+	 * argument is passed or a cero is passed, all the details are returned.
+	 * @param integer &$totalPages
+	 * @param integer &$totalItems
+	 * @param integer $page
+	 * @return array
+	 */
+	static public function getList(&$totalPages = 0, &$totalItems = 0, $page = 0){
+		if($page !== 0)
+			Number::validatePositiveInteger($page, 'Pagina inv&aacute;lida.');
+			
+		return ProductCatalogListDAM::getList($totalPages, $totalItems, $page);
+	}
+}
 ?>
\ No newline at end of file
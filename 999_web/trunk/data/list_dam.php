@@ -542,4 +542,42 @@ class UnitOfMeasureListDAM{
 		}
 	}
 }
+
+
+/**
+ * Class for accesing database data for creating the product catalog.
+ * @package ListDAM
+ * @author Roberto Oliveros
+ */
+class ProductCatalogListDAM{
+	/**
+	 * Returns an array with the fields bar_code, name and price from the active products in the database.
+	 *
+	 * The totalPages and totalItems parameters are necessary to return their respective values.
+	 * @param integer &$totalPages
+	 * @param integer &$totalItems
+	 * @param integer $page
+	 * @return array
+	 */
+	static public function getList(&$totalPages, &$totalItems, $page){
+		$sql = 'CALL product_catalog_count()';
+		$totalItems = (int)DatabaseHandler::getOne($sql);
+		
+		if($totalItems > 0){
+			$totalPages = ceil($totalItems / PRODUCTS_PER_PAGE);
+			
+			if($page > 0)
+				$params = array(':start_item' => ($page - 1) * PRODUCTS_PER_PAGE, 'items_per_page' => PRODUCTS_PER_PAGE);
+			else
+				$params = array(':start_item' => 0, ':items_per_page' => $totalItems);
+			
+			$sql = 'CALL product_catalog_get(:start_item, :items_per_page)';
+			return DatabaseHandler::getAll($sql, $params);
+		}
+		else{
+			$totalPages = 0;
+			return array();
+		}
+	}
+}
 ?>
\ No newline at end of file